@@ -72,6 +72,43 @@ func (s *NoTopoSuite) TestHttpStaticProm() {
 	s.assertNil(err)
 }
 
+func (s *NoTopoSuite) TestHttpStaticPromDelta() {
+	vpp := s.getContainerByName("vpp").vppInstance
+	serverAddress := s.netInterfaces[tapInterfaceName].peer.ip4AddressString()
+	url := "http://" + serverAddress + ":80/stats.prom"
+	gauge := "vpp_vlib_test_gauge"
+	s.log(vpp.vppctl("http static server uri tcp://" + serverAddress + "/80 url-handlers"))
+	s.log(vpp.vppctl("test counter gauge publish value 100"))
+	s.log(vpp.vppctl("test counter histogram publish"))
+	s.log(vpp.vppctl("prom enable min-scrape-interval 0 stat-patterns /vlib/test-"))
+
+	scrape := func() string {
+		o, err := newCommand([]string{"curl", "-s", "--noproxy", "*", url}, "").Output()
+		s.assertNil(err)
+		return string(o)
+	}
+
+	full := scrape()
+	s.assertContains(full, gauge+`{thread="0",index="0"} 100`)
+	s.log(vpp.vppctl("prom delta-scrape"))
+	s.assertEqual(full, scrape())
+
+	// nothing changed, the cached text is served as is
+	s.assertEqual(full, scrape())
+	s.assertContains(vpp.vppctl("show prom"), "last scrape re-rendered 0")
+
+	// only the gauge is rendered again, as the full scrape would
+	s.log(vpp.vppctl("test counter gauge publish value 5"))
+	delta := scrape()
+	o := vpp.vppctl("show prom")
+	s.log(o)
+	s.assertContains(o, "last scrape re-rendered 1")
+	s.assertContains(o, gauge)
+	s.assertContains(delta, gauge+`{thread="0",index="0"} 5`)
+	s.log(vpp.vppctl("prom full-scrape"))
+	s.assertEqual(scrape(), delta)
+}
+
 func (s *NoTopoSuite) TestNginxAsServer() {
 	query := "return_ok"
 	finished := make(chan error, 1)
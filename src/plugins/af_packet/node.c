@@ -373,7 +373,8 @@ af_packet_v3_device_input_fn (vlib_main_t *vm, vlib_node_runtime_t *node,
 			       last_empty_buffer);
 		  n_free_bufs--;
 
-		  /* copy data */
+		  /* copy data, the ring blocks are kernel memory outside the
+		   * buffer pools so they cannot be handed out as buffers */
 		  u32 bytes_to_copy =
 		    data_len > n_buffer_bytes ? n_buffer_bytes : data_len;
 		  u32 vlan_len = 0;
@@ -24,6 +24,17 @@
 
 #define AF_XDP_NUM_RX_QUEUES_ALL        ((u16)-1)
 
+/* multi-buffer (jumbo frames) needs Linux 6.6+ uapi, define what we use */
+#ifndef XDP_USE_SG
+#define XDP_USE_SG (1 << 4)
+#endif
+#ifndef XDP_PKT_CONTD
+#define XDP_PKT_CONTD (1 << 0)
+#endif
+
+/* the kernel refuses tx packets with more fragments than MAX_SKB_FRAGS */
+#define AF_XDP_TX_MAX_SEGS 17
+
 #define af_xdp_log(lvl, dev, f, ...) \
   vlib_log(lvl, af_xdp_main.log_class, "%v: " f, (dev)->name, ##__VA_ARGS__)
 
@@ -33,7 +44,8 @@
   _ (2, ADMIN_UP, "admin-up")                                                 \
   _ (3, LINK_UP, "link-up")                                                   \
   _ (4, ZEROCOPY, "zero-copy")                                                \
-  _ (5, SYSCALL_LOCK, "syscall-lock")
+  _ (5, SYSCALL_LOCK, "syscall-lock")                                         \
+  _ (6, MULTI_BUFFER, "multi-buffer")
 
 enum
 {
@@ -193,7 +205,9 @@ typedef struct
 #define foreach_af_xdp_tx_func_error                                          \
   _ (NO_FREE_SLOTS, "no free tx slots")                                       \
   _ (SYSCALL_REQUIRED, "syscall required")                                    \
-  _ (SYSCALL_FAILURES, "syscall failures")
+  _ (SYSCALL_FAILURES, "syscall failures")                                    \
+  _ (TOO_MANY_SEGS, "too many buffers in chain")                              \
+  _ (LINEARIZE_FAILED, "failed to copy out a shared chain")
 
 typedef enum
 {
@@ -78,6 +78,11 @@ af_xdp_set_max_frame_size (vnet_main_t *vnm, vnet_hw_interface_t *hw,
 {
   af_xdp_main_t *am = &af_xdp_main;
   af_xdp_device_t *ad = vec_elt_at_index (am->devices, hw->dev_instance);
+
+  /* the linux netdev mtu is what limits rx, chained buffers do the rest */
+  if (ad->flags & AF_XDP_DEVICE_F_MULTI_BUFFER)
+    return 0;
+
   af_xdp_log (VLIB_LOG_LEVEL_ERR, ad, "set mtu not supported yet");
   return vnet_error (VNET_ERR_UNSUPPORTED, 0);
 }
@@ -343,6 +348,21 @@ af_xdp_create_queue (vlib_main_t *vm, af_xdp_create_if_args_t *args,
     }
   if (args->prog)
     sock_config.libbpf_flags = XSK_LIBBPF_FLAGS__INHIBIT_PROG_LOAD;
+  if (qid == 0)
+    {
+      /* multi-buffer needs Linux 6.6+ and driver support, if the first
+       * queue cannot get it the interface is single buffer only */
+      sock_config.bind_flags |= XDP_USE_SG;
+      if (0 == xsk_socket__create (xsk, ad->linux_ifname, qid, *umem, rx, tx,
+				   &sock_config))
+	{
+	  ad->flags |= AF_XDP_DEVICE_F_MULTI_BUFFER;
+	  goto created;
+	}
+      sock_config.bind_flags &= ~XDP_USE_SG;
+    }
+  else if (ad->flags & AF_XDP_DEVICE_F_MULTI_BUFFER)
+    sock_config.bind_flags |= XDP_USE_SG;
   if (xsk_socket__create
       (xsk, ad->linux_ifname, qid, *umem, rx, tx, &sock_config))
     {
@@ -354,6 +374,7 @@ af_xdp_create_queue (vlib_main_t *vm, af_xdp_create_if_args_t *args,
       goto err1;
     }
 
+created:
   fd = xsk_socket__fd (*xsk);
   if (args->prog)
     {
@@ -277,6 +277,62 @@ af_xdp_device_input_bufs (vlib_main_t *vm, const af_xdp_device_t *ad,
   return bytes;
 }
 
+/* packets spanning several descriptors (XDP_PKT_CONTD) become buffer chains,
+ * returns the number of whole packets, a trailing partial packet is left on
+ * the ring until the rest of it arrives */
+static_always_inline u32
+af_xdp_device_input_bufs_mb (vlib_main_t *vm, af_xdp_rxq_t *rxq, u32 *bis,
+			     const u32 n_desc, vlib_buffer_t *bt, u32 idx,
+			     u32 *n_rx_bytes)
+{
+  const u32 mask = rxq->rx.mask;
+  vlib_buffer_t *hb = 0, *lb = 0;
+  u32 n_rx = 0, n_done = 0, bytes = 0;
+
+  for (u32 i = 0; i < n_desc; i++)
+    {
+      const struct xdp_desc *desc =
+	xsk_ring_cons__rx_desc (&rxq->rx, (idx + i) & mask);
+      const u64 addr = desc->addr;
+      const u32 bi = addr2bi (xsk_umem__extract_addr (addr));
+      vlib_buffer_t *b = vlib_get_buffer (vm, bi);
+
+      ASSERT (vlib_buffer_is_known (vm, bi) == VLIB_BUFFER_KNOWN_ALLOCATED);
+      vlib_buffer_copy_template (b, bt);
+      b->current_data = xsk_umem__extract_offset (addr) - sizeof (*b);
+      b->current_length = desc->len;
+
+      if (hb == 0)
+	{
+	  hb = b;
+	  hb->total_length_not_including_first_buffer = 0;
+	  bis[n_rx] = bi;
+	}
+      else
+	{
+	  lb->next_buffer = bi;
+	  lb->flags |= VLIB_BUFFER_NEXT_PRESENT;
+	  hb->total_length_not_including_first_buffer += desc->len;
+	}
+      lb = b;
+
+      if (desc->options & XDP_PKT_CONTD)
+	continue;
+
+      bytes += hb->current_length +
+	       hb->total_length_not_including_first_buffer;
+      hb = 0;
+      n_rx++;
+      n_done = i + 1;
+    }
+
+  /* un-peek the descriptors of the incomplete packet */
+  rxq->rx.cached_cons -= n_desc - n_done;
+  xsk_ring_cons__release (&rxq->rx, n_done);
+  *n_rx_bytes = bytes;
+  return n_rx;
+}
+
 static_always_inline uword
 af_xdp_device_input_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 			    vlib_frame_t *frame, af_xdp_device_t *ad, u16 qid)
@@ -300,8 +356,12 @@ af_xdp_device_input_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 
   vlib_get_new_next_frame (vm, node, next_index, to_next, n_left_to_next);
 
-  n_rx_bytes =
-    af_xdp_device_input_bufs (vm, ad, rxq, to_next, n_rx_packets, &bt, idx);
+  if (ad->flags & AF_XDP_DEVICE_F_MULTI_BUFFER)
+    n_rx_packets = af_xdp_device_input_bufs_mb (vm, rxq, to_next, n_rx_packets,
+						&bt, idx, &n_rx_bytes);
+  else
+    n_rx_bytes = af_xdp_device_input_bufs (vm, ad, rxq, to_next,
+					   n_rx_packets, &bt, idx);
   af_xdp_device_input_ethernet (vm, node, next_index, ad->sw_if_index,
 				ad->hw_if_index);
 
@@ -88,9 +88,9 @@ static_always_inline void
 af_xdp_device_output_tx_db (vlib_main_t * vm,
 			    const vlib_node_runtime_t * node,
 			    af_xdp_device_t * ad,
-			    af_xdp_txq_t * txq, const u32 n_tx)
+			    af_xdp_txq_t * txq, const u32 n_desc)
 {
-  xsk_ring_prod__submit (&txq->tx, n_tx);
+  xsk_ring_prod__submit (&txq->tx, n_desc);
 
   if (!xsk_ring_prod__needs_wakeup (&txq->tx))
     return;
@@ -123,11 +123,107 @@ af_xdp_device_output_tx_db (vlib_main_t * vm,
   clib_spinlock_unlock_if_init (&txq->syscall_lock);
 }
 
+/* multi-buffer tx: one descriptor per buffer, XDP_PKT_CONTD on all but the
+ * last one, only whole packets are queued. Returns the number of packets
+ * consumed, the number of descriptors reserved is returned in n_desc_ret */
+static_always_inline u32
+af_xdp_device_output_tx_chain (vlib_main_t *vm,
+			       const vlib_node_runtime_t *node,
+			       af_xdp_txq_t *txq, u32 n_tx, vlib_buffer_t **b,
+			       u32 *n_desc_ret)
+{
+  const uword start = vm->buffer_main->buffer_mem_start;
+  const u32 n_free = xsk_prod_nb_free (&txq->tx, txq->tx.size);
+  u32 n = 0, n_desc = 0, idx;
+
+  *n_desc_ret = 0;
+
+  while (n < n_tx)
+    {
+      u32 n_segs = 1;
+      vlib_buffer_t *s = b[n];
+      u8 shared = s->ref_count > 1;
+
+      while (s->flags & VLIB_BUFFER_NEXT_PRESENT)
+	{
+	  s = vlib_get_buffer (vm, s->next_buffer);
+	  shared |= s->ref_count > 1;
+	  n_segs++;
+	}
+
+      /* the links are cut below, which other packets sharing a cloned
+       * segment still need: copy those out into buffers of our own. That
+       * needs the head to ourselves, a shared head is dropped */
+      if (PREDICT_FALSE (n_segs > AF_XDP_TX_MAX_SEGS || shared))
+	{
+	  n_segs = b[n]->ref_count == 1 ?
+		     vlib_buffer_chain_linearize (vm, b[n]) :
+		     0;
+	  if (n_segs > AF_XDP_TX_MAX_SEGS || n_segs == 0)
+	    {
+	      /* send what we have so far, drop it next round */
+	      if (n)
+		break;
+	      vlib_error_count (vm, node->node_index,
+				n_segs ? AF_XDP_TX_ERROR_TOO_MANY_SEGS :
+					 AF_XDP_TX_ERROR_LINEARIZE_FAILED,
+				1);
+	      /* consumed, but no descriptor reserved */
+	      vlib_buffer_free_one (vm, vlib_get_buffer_index (vm, b[0]));
+	      return 1;
+	    }
+	}
+
+      if (n_desc + n_segs > n_free)
+	break;
+
+      n_desc += n_segs;
+      n++;
+    }
+
+  if (0 == n)
+    return 0;
+
+  n_desc = xsk_ring_prod__reserve (&txq->tx, n_desc, &idx);
+  ASSERT (n_desc);
+  *n_desc_ret = n_desc;
+
+  for (u32 i = 0; i < n; i++)
+    {
+      vlib_buffer_t *s = b[i];
+
+      while (1)
+	{
+	  struct xdp_desc *desc = xsk_ring_prod__tx_desc (&txq->tx, idx++);
+	  const u64 offset = (sizeof (vlib_buffer_t) + s->current_data)
+			     << XSK_UNALIGNED_BUF_OFFSET_SHIFT;
+
+	  desc->addr = offset | (pointer_to_uword (s) - start);
+	  desc->len = s->current_length;
+
+	  if (!(s->flags & VLIB_BUFFER_NEXT_PRESENT))
+	    {
+	      desc->options = 0;
+	      break;
+	    }
+
+	  /* every buffer comes back on its own through the completion queue */
+	  desc->options = XDP_PKT_CONTD;
+	  s->flags &= ~VLIB_BUFFER_NEXT_PRESENT;
+	  s = vlib_get_buffer (vm, s->next_buffer);
+	}
+    }
+
+  return n;
+}
+
+/* returns the number of packets consumed, the number of descriptors
+ * reserved (which differs for buffer chains) is added to n_desc */
 static_always_inline u32
 af_xdp_device_output_tx_try (vlib_main_t * vm,
 			     const vlib_node_runtime_t * node,
 			     af_xdp_device_t * ad, af_xdp_txq_t * txq,
-			     u32 n_tx, u32 * bi)
+			     u32 n_tx, u32 * bi, u32 * n_desc)
 {
   vlib_buffer_t *bufs[VLIB_FRAME_SIZE], **b = bufs;
   const uword start = vm->buffer_main->buffer_mem_start;
@@ -170,6 +266,7 @@ wrap_around:
       addr = pointer_to_uword (b[0]) - start;
       desc[0].addr = offset | addr;
       desc[0].len = b[0]->current_length;
+      desc[0].options = 0;
 
       vlib_prefetch_buffer_header (b[5], LOAD);
       offset =
@@ -178,6 +275,7 @@ wrap_around:
       addr = pointer_to_uword (b[1]) - start;
       desc[1].addr = offset | addr;
       desc[1].len = b[1]->current_length;
+      desc[1].options = 0;
 
       vlib_prefetch_buffer_header (b[6], LOAD);
       offset =
@@ -186,6 +284,7 @@ wrap_around:
       addr = pointer_to_uword (b[2]) - start;
       desc[2].addr = offset | addr;
       desc[2].len = b[2]->current_length;
+      desc[2].options = 0;
 
       vlib_prefetch_buffer_header (b[7], LOAD);
       offset =
@@ -194,6 +293,7 @@ wrap_around:
       addr = pointer_to_uword (b[3]) - start;
       desc[3].addr = offset | addr;
       desc[3].len = b[3]->current_length;
+      desc[3].options = 0;
 
       desc += 4;
       b += 4;
@@ -204,6 +304,18 @@ wrap_around:
     {
       if (PREDICT_FALSE (b[0]->flags & VLIB_BUFFER_NEXT_PRESENT))
 	{
+	  if (ad->flags & AF_XDP_DEVICE_F_MULTI_BUFFER)
+	    {
+	      /* give back the slots we did not fill, the chain path reserves
+	       * its own */
+	      const u32 n_left = n + n_wrap;
+	      u32 n_chain, n_chain_desc;
+	      txq->tx.cached_prod -= n_left;
+	      n_chain = af_xdp_device_output_tx_chain (vm, node, txq, n_left,
+						       b, &n_chain_desc);
+	      *n_desc += n_tx - n_left + n_chain_desc;
+	      return n_tx - n_left + n_chain;
+	    }
 	  if (vlib_buffer_chain_linearize (vm, b[0]) != 1)
 	    {
 	      af_xdp_log (VLIB_LOG_LEVEL_ERR, ad,
@@ -219,6 +331,7 @@ wrap_around:
       addr = pointer_to_uword (b[0]) - start;
       desc[0].addr = offset | addr;
       desc[0].len = b[0]->current_length;
+      desc[0].options = 0;
       desc += 1;
       b += 1;
       n -= 1;
@@ -232,6 +345,7 @@ wrap_around:
       goto wrap_around;
     }
 
+  *n_desc += n_tx;
   return n_tx;
 }
 
@@ -246,7 +360,7 @@ VNET_DEVICE_CLASS_TX_FN (af_xdp_device_class) (vlib_main_t * vm,
   const int shared_queue = tf->shared_queue;
   af_xdp_txq_t *txq = vec_elt_at_index (ad->txqs, tf->queue_id);
   u32 *from;
-  u32 n, n_tx;
+  u32 n, n_tx, n_desc = 0;
   int i;
 
   from = vlib_frame_vector_args (frame);
@@ -259,12 +373,12 @@ VNET_DEVICE_CLASS_TX_FN (af_xdp_device_class) (vlib_main_t * vm,
     {
       u32 n_enq;
       af_xdp_device_output_free (vm, node, txq);
-      n_enq =
-	af_xdp_device_output_tx_try (vm, node, ad, txq, n_tx - n, from + n);
+      n_enq = af_xdp_device_output_tx_try (vm, node, ad, txq, n_tx - n,
+					   from + n, &n_desc);
       n += n_enq;
     }
 
-  af_xdp_device_output_tx_db (vm, node, ad, txq, n);
+  af_xdp_device_output_tx_db (vm, node, ad, txq, n_desc);
 
   if (shared_queue)
     clib_spinlock_unlock (&txq->lock);
@@ -32,6 +32,27 @@ typedef enum crypto_sw_scheduler_queue_type_t_
   CRYPTO_SW_SCHED_QUEUE_N_TYPES
 } crypto_sw_scheduler_queue_type_t;
 
+typedef enum crypto_sw_scheduler_mode_t_
+{
+  /* every crypto worker scans all producer queues in turn */
+  CRYPTO_SW_SCHED_MODE_ROUND_ROBIN = 0,
+  /* crypto workers serve their home producer queues first and only steal
+   * frames from other producers when their own queues are empty */
+  CRYPTO_SW_SCHED_MODE_WORK_STEALING,
+  CRYPTO_SW_SCHED_N_MODES
+} crypto_sw_scheduler_mode_t;
+
+typedef struct
+{
+  u64 n_polls;
+  u64 n_idle_polls;
+  u64 n_frames;
+  u64 n_elts;
+  u64 n_frames_stolen;
+  u64 n_frames_completed;
+  u64 busy_clocks;
+} crypto_sw_scheduler_stats_t;
+
 typedef struct
 {
   CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
@@ -53,18 +74,30 @@ typedef struct
   vnet_crypto_op_t *chained_integ_ops;
   vnet_crypto_op_chunk_t *chunks;
   u8 self_crypto_enabled;
+
+  /* work-stealing mode: producer threads whose queues this worker owns */
+  u32 *home_queues;
+  u32 last_serve_home;
+  u32 last_steal_lcore_id;
+
+  crypto_sw_scheduler_stats_t stats;
 } crypto_sw_scheduler_per_thread_data_t;
 
 typedef struct
 {
   u32 crypto_engine_index;
+  crypto_sw_scheduler_mode_t mode;
   crypto_sw_scheduler_per_thread_data_t *per_thread_data;
+  /* work-stealing mode: crypto worker owning each producer thread queue */
+  u32 *queue_owner;
   vnet_crypto_key_t *keys;
+  u64 stats_clear_time;
 } crypto_sw_scheduler_main_t;
 
 extern crypto_sw_scheduler_main_t crypto_sw_scheduler_main;
 
 extern int crypto_sw_scheduler_set_worker_crypto (u32 worker_idx, u8 enabled);
+extern int crypto_sw_scheduler_set_mode (crypto_sw_scheduler_mode_t mode);
 
 extern clib_error_t *crypto_sw_scheduler_api_init (vlib_main_t * vm);
 
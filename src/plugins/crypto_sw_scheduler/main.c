@@ -19,11 +19,47 @@
 
 #include "crypto_sw_scheduler.h"
 
+static void
+crypto_sw_scheduler_update_home_queues (void)
+{
+  crypto_sw_scheduler_main_t *cm = &crypto_sw_scheduler_main;
+  crypto_sw_scheduler_per_thread_data_t *ptd;
+  u32 *crypto_threads = 0, i, n, next = 0;
+
+  vec_foreach (ptd, cm->per_thread_data)
+    {
+      vec_reset_length (ptd->home_queues);
+      ptd->last_serve_home = 0;
+      if (ptd->self_crypto_enabled)
+	vec_add1 (crypto_threads, ptd - cm->per_thread_data);
+    }
+
+  n = vec_len (crypto_threads);
+  if (n == 0)
+    return;
+
+  /* a crypto worker always owns its own queues, the queues of the
+   * remaining producers are spread evenly over the crypto workers */
+  vec_foreach_index (i, cm->per_thread_data)
+    {
+      u32 owner = i;
+
+      if (!cm->per_thread_data[i].self_crypto_enabled)
+	owner = crypto_threads[next++ % n];
+
+      vec_add1 (cm->per_thread_data[owner].home_queues, i);
+      cm->queue_owner[i] = owner;
+    }
+
+  vec_free (crypto_threads);
+}
+
 int
 crypto_sw_scheduler_set_worker_crypto (u32 worker_idx, u8 enabled)
 {
   crypto_sw_scheduler_main_t *cm = &crypto_sw_scheduler_main;
   vlib_thread_main_t *tm = vlib_get_thread_main ();
+  vlib_main_t *vm = vlib_get_main ();
   crypto_sw_scheduler_per_thread_data_t *ptd = 0;
   u32 count = 0, i;
 
@@ -40,8 +76,11 @@ crypto_sw_scheduler_set_worker_crypto (u32 worker_idx, u8 enabled)
 
   if (enabled || count > 1)
     {
+      vlib_worker_thread_barrier_sync (vm);
       cm->per_thread_data[vlib_get_worker_thread_index
 			  (worker_idx)].self_crypto_enabled = enabled;
+      crypto_sw_scheduler_update_home_queues ();
+      vlib_worker_thread_barrier_release (vm);
     }
   else				/* cannot disable all crypto workers */
     {
@@ -50,6 +89,22 @@ crypto_sw_scheduler_set_worker_crypto (u32 worker_idx, u8 enabled)
   return 0;
 }
 
+int
+crypto_sw_scheduler_set_mode (crypto_sw_scheduler_mode_t mode)
+{
+  crypto_sw_scheduler_main_t *cm = &crypto_sw_scheduler_main;
+  vlib_main_t *vm = vlib_get_main ();
+
+  if (mode >= CRYPTO_SW_SCHED_N_MODES)
+    return VNET_API_ERROR_INVALID_VALUE;
+
+  vlib_worker_thread_barrier_sync (vm);
+  cm->mode = mode;
+  crypto_sw_scheduler_update_home_queues ();
+  vlib_worker_thread_barrier_release (vm);
+  return 0;
+}
+
 static void
 crypto_sw_scheduler_key_handler (vlib_main_t * vm, vnet_crypto_key_op_t kop,
 				 vnet_crypto_key_index_t idx)
@@ -311,6 +366,26 @@ process_chained_ops (vlib_main_t * vm, vnet_crypto_async_frame_t * f,
     }
 }
 
+static_always_inline void
+crypto_sw_scheduler_reset_ops (crypto_sw_scheduler_per_thread_data_t *ptd)
+{
+  vec_reset_length (ptd->crypto_ops);
+  vec_reset_length (ptd->integ_ops);
+  vec_reset_length (ptd->chained_crypto_ops);
+  vec_reset_length (ptd->chained_integ_ops);
+  vec_reset_length (ptd->chunks);
+}
+
+/* frames larger than VNET_CRYPTO_FRAME_SIZE are processed in chunks, and
+ * each processed chunk is published so the submitter can forward it while
+ * the rest of the frame is still being worked on */
+static_always_inline void
+crypto_sw_scheduler_publish_chunk (vnet_crypto_async_frame_t *f, u32 end)
+{
+  if (end < f->n_elts)
+    clib_atomic_store_rel_n (&f->n_elts_ready, end);
+}
+
 static_always_inline void
 crypto_sw_scheduler_process_aead (vlib_main_t *vm,
 				  crypto_sw_scheduler_per_thread_data_t *ptd,
@@ -319,33 +394,36 @@ crypto_sw_scheduler_process_aead (vlib_main_t *vm,
 {
   vnet_crypto_async_frame_elt_t *fe;
   u32 *bi;
-  u32 n_elts = f->n_elts;
+  u32 n_elts = f->n_elts, start, end;
   u8 state = VNET_CRYPTO_FRAME_STATE_SUCCESS;
 
-  vec_reset_length (ptd->crypto_ops);
-  vec_reset_length (ptd->integ_ops);
-  vec_reset_length (ptd->chained_crypto_ops);
-  vec_reset_length (ptd->chained_integ_ops);
-  vec_reset_length (ptd->chunks);
-
-  fe = f->elts;
-  bi = f->buffer_indices;
-
-  while (n_elts--)
+  for (start = 0; start < n_elts; start = end)
     {
-      if (n_elts > 1)
-	clib_prefetch_load (fe + 1);
+      end = clib_min (start + VNET_CRYPTO_FRAME_SIZE, n_elts);
+      crypto_sw_scheduler_reset_ops (ptd);
 
-      crypto_sw_scheduler_convert_aead (vm, ptd, fe, fe - f->elts, bi[0],
-					aead_op, aad_len, digest_len);
-      bi++;
-      fe++;
-    }
+      fe = f->elts + start;
+      bi = f->buffer_indices + start;
+
+      while (fe < f->elts + end)
+	{
+	  if (fe + 1 < f->elts + end)
+	    clib_prefetch_load (fe + 1);
+
+	  fe->status = VNET_CRYPTO_OP_STATUS_COMPLETED;
+	  crypto_sw_scheduler_convert_aead (vm, ptd, fe, fe - f->elts, bi[0],
+					    aead_op, aad_len, digest_len);
+	  bi++;
+	  fe++;
+	}
 
       process_ops (vm, f, ptd->crypto_ops, &state);
       process_chained_ops (vm, f, ptd->chained_crypto_ops, ptd->chunks,
 			   &state);
-      f->state = state;
+      crypto_sw_scheduler_publish_chunk (f, end);
+    }
+
+  f->state = state;
 }
 
 static_always_inline void
@@ -357,44 +435,49 @@ crypto_sw_scheduler_process_link (vlib_main_t *vm,
 {
   vnet_crypto_async_frame_elt_t *fe;
   u32 *bi;
-  u32 n_elts = f->n_elts;
+  u32 n_elts = f->n_elts, start, end;
   u8 state = VNET_CRYPTO_FRAME_STATE_SUCCESS;
 
-  vec_reset_length (ptd->crypto_ops);
-  vec_reset_length (ptd->integ_ops);
-  vec_reset_length (ptd->chained_crypto_ops);
-  vec_reset_length (ptd->chained_integ_ops);
-  vec_reset_length (ptd->chunks);
-  fe = f->elts;
-  bi = f->buffer_indices;
-
-  while (n_elts--)
+  for (start = 0; start < n_elts; start = end)
     {
-      if (n_elts > 1)
-	clib_prefetch_load (fe + 1);
+      end = clib_min (start + VNET_CRYPTO_FRAME_SIZE, n_elts);
+      crypto_sw_scheduler_reset_ops (ptd);
 
-      crypto_sw_scheduler_convert_link_crypto (
-	vm, ptd, cm->keys + fe->key_index, fe, fe - f->elts, bi[0], crypto_op,
-	auth_op, digest_len, is_enc);
-      bi++;
-      fe++;
-    }
+      fe = f->elts + start;
+      bi = f->buffer_indices + start;
 
-  if (is_enc)
-    {
-      process_ops (vm, f, ptd->crypto_ops, &state);
-      process_chained_ops (vm, f, ptd->chained_crypto_ops, ptd->chunks,
-			   &state);
-      process_ops (vm, f, ptd->integ_ops, &state);
-      process_chained_ops (vm, f, ptd->chained_integ_ops, ptd->chunks, &state);
-    }
-  else
-    {
-      process_ops (vm, f, ptd->integ_ops, &state);
-      process_chained_ops (vm, f, ptd->chained_integ_ops, ptd->chunks, &state);
-      process_ops (vm, f, ptd->crypto_ops, &state);
-      process_chained_ops (vm, f, ptd->chained_crypto_ops, ptd->chunks,
-			   &state);
+      while (fe < f->elts + end)
+	{
+	  if (fe + 1 < f->elts + end)
+	    clib_prefetch_load (fe + 1);
+
+	  fe->status = VNET_CRYPTO_OP_STATUS_COMPLETED;
+	  crypto_sw_scheduler_convert_link_crypto (
+	    vm, ptd, cm->keys + fe->key_index, fe, fe - f->elts, bi[0],
+	    crypto_op, auth_op, digest_len, is_enc);
+	  bi++;
+	  fe++;
+	}
+
+      if (is_enc)
+	{
+	  process_ops (vm, f, ptd->crypto_ops, &state);
+	  process_chained_ops (vm, f, ptd->chained_crypto_ops, ptd->chunks,
+			       &state);
+	  process_ops (vm, f, ptd->integ_ops, &state);
+	  process_chained_ops (vm, f, ptd->chained_integ_ops, ptd->chunks,
+			       &state);
+	}
+      else
+	{
+	  process_ops (vm, f, ptd->integ_ops, &state);
+	  process_chained_ops (vm, f, ptd->chained_integ_ops, ptd->chunks,
+			       &state);
+	  process_ops (vm, f, ptd->crypto_ops, &state);
+	  process_chained_ops (vm, f, ptd->chained_crypto_ops, ptd->chunks,
+			       &state);
+	}
+      crypto_sw_scheduler_publish_chunk (f, end);
     }
 
   f->state = state;
@@ -445,87 +528,177 @@ convert_async_crypto_id (vnet_crypto_async_op_id_t async_op_id, u32 *crypto_op,
 }
 
 static_always_inline vnet_crypto_async_frame_t *
-crypto_sw_scheduler_dequeue (vlib_main_t *vm, u32 *nb_elts_processed,
-			     u32 *enqueue_thread_idx)
+crypto_sw_scheduler_get_pending_frame (crypto_sw_scheduler_queue_t *q)
 {
-  crypto_sw_scheduler_main_t *cm = &crypto_sw_scheduler_main;
-  crypto_sw_scheduler_per_thread_data_t *ptd =
-    cm->per_thread_data + vm->thread_index;
-  vnet_crypto_async_frame_t *f = 0;
-  crypto_sw_scheduler_queue_t *current_queue = 0;
-  u32 tail, head;
-  u8 found = 0;
+  vnet_crypto_async_frame_t *f;
+  u32 tail = q->tail;
+  u32 head = q->head;
+  u32 j;
+
+  /* Skip this queue unless tail < head or head has overflowed
+   * and tail has not. At the point where tail overflows (== 0),
+   * the largest possible value of head is (queue size - 1).
+   * Prior to that, the largest possible value of head is
+   * (queue size - 2).
+   */
+  if ((tail > head) && (head >= CRYPTO_SW_SCHEDULER_QUEUE_MASK))
+    return 0;
 
-  /* get a pending frame to process */
-  if (ptd->self_crypto_enabled)
+  for (j = tail; j != head; j++)
     {
-      u32 i = ptd->last_serve_lcore_id + 1;
+      f = q->jobs[j & CRYPTO_SW_SCHEDULER_QUEUE_MASK];
 
-      while (1)
-	{
-	  crypto_sw_scheduler_per_thread_data_t *st;
-	  u32 j;
+      if (!f)
+	continue;
+
+      if (clib_atomic_bool_cmp_and_swap (
+	    &f->state, VNET_CRYPTO_FRAME_STATE_PENDING,
+	    VNET_CRYPTO_FRAME_STATE_WORK_IN_PROGRESS))
+	return f;
+    }
 
-	  if (i >= vec_len (cm->per_thread_data))
-	    i = 0;
+  return 0;
+}
 
-	  st = cm->per_thread_data + i;
+/* try both queues of a producer, alternating which one is served first */
+static_always_inline vnet_crypto_async_frame_t *
+crypto_sw_scheduler_get_producer_frame (
+  crypto_sw_scheduler_per_thread_data_t *ptd,
+  crypto_sw_scheduler_per_thread_data_t *st)
+{
+  vnet_crypto_async_frame_t *f;
+  u32 i;
 
-	  if (ptd->last_serve_encrypt)
-	    current_queue = &st->queue[CRYPTO_SW_SCHED_QUEUE_TYPE_DECRYPT];
-	  else
-	    current_queue = &st->queue[CRYPTO_SW_SCHED_QUEUE_TYPE_ENCRYPT];
+  for (i = 0; i < CRYPTO_SW_SCHED_QUEUE_N_TYPES; i++)
+    {
+      crypto_sw_scheduler_queue_t *q =
+	ptd->last_serve_encrypt ?
+	  &st->queue[CRYPTO_SW_SCHED_QUEUE_TYPE_DECRYPT] :
+	  &st->queue[CRYPTO_SW_SCHED_QUEUE_TYPE_ENCRYPT];
 
-	  tail = current_queue->tail;
-	  head = current_queue->head;
+      ptd->last_serve_encrypt = !ptd->last_serve_encrypt;
 
-	  /* Skip this queue unless tail < head or head has overflowed
-	   * and tail has not. At the point where tail overflows (== 0),
-	   * the largest possible value of head is (queue size - 1).
-	   * Prior to that, the largest possible value of head is
-	   * (queue size - 2).
-	   */
-	  if ((tail > head) && (head >= CRYPTO_SW_SCHEDULER_QUEUE_MASK))
-	    goto skip_queue;
+      if ((f = crypto_sw_scheduler_get_pending_frame (q)))
+	return f;
+    }
 
-	  for (j = tail; j != head; j++)
-	    {
+  return 0;
+}
+
+static_always_inline vnet_crypto_async_frame_t *
+crypto_sw_scheduler_get_frame_round_robin (
+  crypto_sw_scheduler_main_t *cm, crypto_sw_scheduler_per_thread_data_t *ptd)
+{
+  vnet_crypto_async_frame_t *f = 0;
+  u32 i = ptd->last_serve_lcore_id + 1;
 
-	      f = current_queue->jobs[j & CRYPTO_SW_SCHEDULER_QUEUE_MASK];
+  while (1)
+    {
+      crypto_sw_scheduler_per_thread_data_t *st;
+      crypto_sw_scheduler_queue_t *current_queue;
 
-	      if (!f)
-		continue;
+      if (i >= vec_len (cm->per_thread_data))
+	i = 0;
 
-	      if (clib_atomic_bool_cmp_and_swap (
-		    &f->state, VNET_CRYPTO_FRAME_STATE_PENDING,
-		    VNET_CRYPTO_FRAME_STATE_WORK_IN_PROGRESS))
-		{
-		  found = 1;
-		  break;
-		}
-	    }
+      st = cm->per_thread_data + i;
 
-	skip_queue:
-	  if (found || i == ptd->last_serve_lcore_id)
-	    {
-	      CLIB_MEMORY_STORE_BARRIER ();
-	      ptd->last_serve_encrypt = !ptd->last_serve_encrypt;
-	      break;
-	    }
+      if (ptd->last_serve_encrypt)
+	current_queue = &st->queue[CRYPTO_SW_SCHED_QUEUE_TYPE_DECRYPT];
+      else
+	current_queue = &st->queue[CRYPTO_SW_SCHED_QUEUE_TYPE_ENCRYPT];
+
+      f = crypto_sw_scheduler_get_pending_frame (current_queue);
+
+      if (f || i == ptd->last_serve_lcore_id)
+	{
+	  CLIB_MEMORY_STORE_BARRIER ();
+	  ptd->last_serve_encrypt = !ptd->last_serve_encrypt;
+	  break;
+	}
+
+      i++;
+    }
 
-	  i++;
+  ptd->last_serve_lcore_id = i;
+  return f;
+}
+
+static_always_inline vnet_crypto_async_frame_t *
+crypto_sw_scheduler_get_frame_work_stealing (
+  crypto_sw_scheduler_main_t *cm, crypto_sw_scheduler_per_thread_data_t *ptd,
+  u32 thread_index)
+{
+  vnet_crypto_async_frame_t *f;
+  u32 n_home = vec_len (ptd->home_queues);
+  u32 n_threads = vec_len (cm->per_thread_data);
+  u32 i, idx;
+
+  /* serve the producers we own first */
+  for (i = 1; i <= n_home; i++)
+    {
+      idx = (ptd->last_serve_home + i) % n_home;
+      f = crypto_sw_scheduler_get_producer_frame (
+	ptd, cm->per_thread_data + ptd->home_queues[idx]);
+      if (f)
+	{
+	  ptd->last_serve_home = idx;
+	  return f;
+	}
+    }
+
+  /* nothing to do at home, steal from producers owned by other workers */
+  for (i = 1; i <= n_threads; i++)
+    {
+      idx = (ptd->last_steal_lcore_id + i) % n_threads;
+      if (cm->queue_owner[idx] == thread_index)
+	continue;
+
+      f = crypto_sw_scheduler_get_producer_frame (ptd,
+						  cm->per_thread_data + idx);
+      if (f)
+	{
+	  ptd->last_steal_lcore_id = idx;
+	  ptd->stats.n_frames_stolen++;
+	  return f;
 	}
+    }
+
+  return 0;
+}
+
+static_always_inline vnet_crypto_async_frame_t *
+crypto_sw_scheduler_dequeue (vlib_main_t *vm, u32 *nb_elts_processed,
+			     u32 *enqueue_thread_idx)
+{
+  crypto_sw_scheduler_main_t *cm = &crypto_sw_scheduler_main;
+  crypto_sw_scheduler_per_thread_data_t *ptd =
+    cm->per_thread_data + vm->thread_index;
+  vnet_crypto_async_frame_t *f = 0;
+  crypto_sw_scheduler_queue_t *current_queue = 0;
+  u32 tail;
 
-      ptd->last_serve_lcore_id = i;
+  /* get a pending frame to process */
+  if (ptd->self_crypto_enabled)
+    {
+      ptd->stats.n_polls++;
+
+      if (cm->mode == CRYPTO_SW_SCHED_MODE_WORK_STEALING)
+	f = crypto_sw_scheduler_get_frame_work_stealing (cm, ptd,
+							 vm->thread_index);
+      else
+	f = crypto_sw_scheduler_get_frame_round_robin (cm, ptd);
     }
 
-  if (found)
+  if (f)
     {
       u32 crypto_op, auth_op_or_aad_len;
       u16 digest_len;
       u8 is_enc;
+      u64 t0;
       int ret;
 
+      t0 = clib_cpu_time_now ();
+
       ret = convert_async_crypto_id (f->op, &crypto_op, &auth_op_or_aad_len,
 				     &digest_len, &is_enc);
 
@@ -538,7 +711,13 @@ crypto_sw_scheduler_dequeue (vlib_main_t *vm, u32 *nb_elts_processed,
 
       *enqueue_thread_idx = f->enqueue_thread_index;
       *nb_elts_processed = f->n_elts;
+
+      ptd->stats.busy_clocks += clib_cpu_time_now () - t0;
+      ptd->stats.n_frames++;
+      ptd->stats.n_elts += f->n_elts;
     }
+  else if (ptd->self_crypto_enabled)
+    ptd->stats.n_idle_polls++;
 
   if (ptd->last_return_queue)
     {
@@ -552,29 +731,68 @@ crypto_sw_scheduler_dequeue (vlib_main_t *vm, u32 *nb_elts_processed,
     }
 
   tail = current_queue->tail & CRYPTO_SW_SCHEDULER_QUEUE_MASK;
+  f = current_queue->jobs[tail];
 
-  if (current_queue->jobs[tail] &&
-      current_queue->jobs[tail]->state >= VNET_CRYPTO_FRAME_STATE_SUCCESS)
+  if (f && f->state >= VNET_CRYPTO_FRAME_STATE_SUCCESS)
     {
 
       CLIB_MEMORY_STORE_BARRIER ();
       current_queue->tail++;
-      f = current_queue->jobs[tail];
       current_queue->jobs[tail] = 0;
+      ptd->stats.n_frames_completed++;
 
       return f;
     }
 
+  /* large frame still in flight, hand out the chunks already processed */
+  if (f && f->state == VNET_CRYPTO_FRAME_STATE_WORK_IN_PROGRESS)
+    return vnet_crypto_async_frame_dequeue_partial (f);
+
   return 0;
 }
 
+static uword
+unformat_crypto_sw_scheduler_mode (unformat_input_t *input, va_list *args)
+{
+  crypto_sw_scheduler_mode_t *mode =
+    va_arg (*args, crypto_sw_scheduler_mode_t *);
+
+  if (unformat (input, "round-robin"))
+    *mode = CRYPTO_SW_SCHED_MODE_ROUND_ROBIN;
+  else if (unformat (input, "work-stealing"))
+    *mode = CRYPTO_SW_SCHED_MODE_WORK_STEALING;
+  else
+    return 0;
+
+  return 1;
+}
+
+static u8 *
+format_crypto_sw_scheduler_mode (u8 *s, va_list *args)
+{
+  crypto_sw_scheduler_mode_t mode = va_arg (*args, int);
+
+  switch (mode)
+    {
+    case CRYPTO_SW_SCHED_MODE_ROUND_ROBIN:
+      return format (s, "round-robin");
+    case CRYPTO_SW_SCHED_MODE_WORK_STEALING:
+      return format (s, "work-stealing");
+    default:
+      break;
+    }
+  return format (s, "unknown");
+}
+
 static clib_error_t *
 sw_scheduler_set_worker_crypto (vlib_main_t * vm, unformat_input_t * input,
 				vlib_cli_command_t * cmd)
 {
   unformat_input_t _line_input, *line_input = &_line_input;
-  u32 worker_index;
-  u8 crypto_enable;
+  crypto_sw_scheduler_mode_t mode;
+  u32 worker_index = ~0;
+  u8 crypto_enable = ~0;
+  u8 mode_set = 0;
   int rv;
 
   /* Get a line of input. */
@@ -600,11 +818,27 @@ sw_scheduler_set_worker_crypto (vlib_main_t * vm, unformat_input_t * input,
 	    return (clib_error_return (0, "unknown input '%U'",
 				       format_unformat_error, line_input));
 	}
+      else if (unformat (line_input, "mode %U",
+			 unformat_crypto_sw_scheduler_mode, &mode))
+	mode_set = 1;
       else
 	return (clib_error_return (0, "unknown input '%U'",
 				   format_unformat_error, line_input));
     }
 
+  if (mode_set)
+    {
+      rv = crypto_sw_scheduler_set_mode (mode);
+      if (rv)
+	return (clib_error_return (0, "failed to set mode: %d", rv));
+    }
+
+  if (worker_index == ~0)
+    return 0;
+
+  if (crypto_enable == (u8) ~0)
+    return (clib_error_return (0, "please specify crypto on or off"));
+
   rv = crypto_sw_scheduler_set_worker_crypto (worker_index, crypto_enable);
   if (rv == VNET_API_ERROR_INVALID_VALUE)
     {
@@ -618,17 +852,25 @@ sw_scheduler_set_worker_crypto (vlib_main_t * vm, unformat_input_t * input,
 }
 
 /*?
- * This command sets if worker will do crypto processing.
+ * This command sets if worker will do crypto processing, and how crypto
+ * workers pick up frames submitted by other threads. In round-robin mode
+ * every crypto worker scans all producer queues in turn. In work-stealing
+ * mode each producer queue is owned by one crypto worker, and workers only
+ * take frames from queues they do not own when their own are empty.
  *
  * @cliexpar
  * Example of how to set worker crypto processing off:
  * @cliexstart{set sw_scheduler worker 0 crypto off}
  * @cliexend
+ * Example of how to enable work stealing between crypto workers:
+ * @cliexstart{set sw_scheduler mode work-stealing}
+ * @cliexend
  ?*/
 /* *INDENT-OFF* */
 VLIB_CLI_COMMAND (cmd_set_sw_scheduler_worker_crypto, static) = {
   .path = "set sw_scheduler",
-  .short_help = "set sw_scheduler worker <idx> crypto <on|off>",
+  .short_help = "set sw_scheduler [worker <idx> crypto <on|off>] "
+		"[mode <round-robin|work-stealing>]",
   .function = sw_scheduler_set_worker_crypto,
   .is_mp_safe = 1,
 };
@@ -639,15 +881,24 @@ sw_scheduler_show_workers (vlib_main_t * vm, unformat_input_t * input,
 			   vlib_cli_command_t * cmd)
 {
   crypto_sw_scheduler_main_t *cm = &crypto_sw_scheduler_main;
-  u32 i;
+  u32 i, *q;
 
-  vlib_cli_output (vm, "%-7s%-20s%-8s", "ID", "Name", "Crypto");
+  vlib_cli_output (vm, "Mode: %U", format_crypto_sw_scheduler_mode,
+		   cm->mode);
+  vlib_cli_output (vm, "%-7s%-20s%-8s%s", "ID", "Name", "Crypto",
+		   "Home queues");
   for (i = 1; i < vlib_thread_main.n_vlib_mains; i++)
     {
-      vlib_cli_output (vm, "%-7d%-20s%-8s", vlib_get_worker_index (i),
+      crypto_sw_scheduler_per_thread_data_t *ptd = cm->per_thread_data + i;
+      u8 *s = 0;
+
+      vec_foreach (q, ptd->home_queues)
+	s = format (s, "%s%u", q == ptd->home_queues ? "" : " ", q[0]);
+
+      vlib_cli_output (vm, "%-7d%-20s%-8s%v", vlib_get_worker_index (i),
 		       (vlib_worker_threads + i)->name,
-		       cm->
-		       per_thread_data[i].self_crypto_enabled ? "on" : "off");
+		       ptd->self_crypto_enabled ? "on" : "off", s);
+      vec_free (s);
     }
 
   return 0;
@@ -670,6 +921,69 @@ VLIB_CLI_COMMAND (cmd_show_sw_scheduler_workers, static) = {
 };
 /* *INDENT-ON* */
 
+static clib_error_t *
+sw_scheduler_show_stats (vlib_main_t *vm, unformat_input_t *input,
+			 vlib_cli_command_t *cmd)
+{
+  crypto_sw_scheduler_main_t *cm = &crypto_sw_scheduler_main;
+  u64 elapsed = clib_cpu_time_now () - cm->stats_clear_time;
+  u32 i;
+
+  vlib_cli_output (vm, "%-7s%-20s%-12s%-12s%-12s%-12s%-12s%-8s", "ID",
+		   "Name", "Frames", "Elts", "Stolen", "Completed",
+		   "Idle-polls", "Util %");
+  for (i = 1; i < vlib_thread_main.n_vlib_mains; i++)
+    {
+      crypto_sw_scheduler_stats_t *st = &cm->per_thread_data[i].stats;
+
+      vlib_cli_output (
+	vm, "%-7d%-20s%-12lu%-12lu%-12lu%-12lu%-12lu%-8.2f",
+	vlib_get_worker_index (i), (vlib_worker_threads + i)->name,
+	st->n_frames, st->n_elts, st->n_frames_stolen, st->n_frames_completed,
+	st->n_idle_polls,
+	elapsed ? 100.0 * (f64) st->busy_clocks / (f64) elapsed : 0.0);
+    }
+
+  return 0;
+}
+
+/*?
+ * This command displays per-worker sw_scheduler statistics: frames and
+ * elements processed, frames stolen from queues owned by other crypto
+ * workers, frames returned to the submitting thread, idle polls and the
+ * share of cycles spent processing crypto since the last clear.
+ *
+ * @cliexpar
+ * @cliexstart{show sw_scheduler stats}
+ * @cliexend
+ ?*/
+VLIB_CLI_COMMAND (cmd_show_sw_scheduler_stats, static) = {
+  .path = "show sw_scheduler stats",
+  .short_help = "show sw_scheduler stats",
+  .function = sw_scheduler_show_stats,
+  .is_mp_safe = 1,
+};
+
+static clib_error_t *
+sw_scheduler_clear_stats (vlib_main_t *vm, unformat_input_t *input,
+			  vlib_cli_command_t *cmd)
+{
+  crypto_sw_scheduler_main_t *cm = &crypto_sw_scheduler_main;
+  crypto_sw_scheduler_per_thread_data_t *ptd;
+
+  vec_foreach (ptd, cm->per_thread_data)
+    clib_memset (&ptd->stats, 0, sizeof (ptd->stats));
+  cm->stats_clear_time = clib_cpu_time_now ();
+
+  return 0;
+}
+
+VLIB_CLI_COMMAND (cmd_clear_sw_scheduler_stats, static) = {
+  .path = "clear sw_scheduler stats",
+  .short_help = "clear sw_scheduler stats",
+  .function = sw_scheduler_clear_stats,
+};
+
 clib_error_t *
 sw_scheduler_cli_init (vlib_main_t * vm)
 {
@@ -714,6 +1028,10 @@ crypto_sw_scheduler_init (vlib_main_t * vm)
 	CRYPTO_SW_SCHEDULER_QUEUE_SIZE - 1, CLIB_CACHE_LINE_BYTES);
     }
 
+  vec_validate (cm->queue_owner, tm->n_vlib_mains - 1);
+  crypto_sw_scheduler_update_home_queues ();
+  cm->stats_clear_time = clib_cpu_time_now ();
+
   cm->crypto_engine_index =
     vnet_crypto_register_engine (vm, "sw_scheduler", 100,
 				 "SW Scheduler Async Engine");
@@ -721,6 +1039,9 @@ crypto_sw_scheduler_init (vlib_main_t * vm)
   vnet_crypto_register_key_handler (vm, cm->crypto_engine_index,
 				    crypto_sw_scheduler_key_handler);
 
+  vnet_crypto_register_async_frame_size (vm, cm->crypto_engine_index,
+					 VNET_CRYPTO_FRAME_SIZE_MAX);
+
   crypto_sw_scheduler_api_init (vm);
 
   /* *INDENT-OFF* */
@@ -4,6 +4,7 @@
 
 #include <vnet/vnet.h>
 #include <vnet/dev/dev.h>
+#include <vnet/dev/rx_funcs.h>
 #include <vnet/ethernet/ethernet.h>
 #include <vppinfra/vector/mask_compare.h>
 #include <vppinfra/vector/compress.h>
@@ -199,7 +200,7 @@ ena_device_input_refill (vlib_main_t *vm, ena_rx_ctx_t *ctx,
   ena_rxq_t *q = vnet_dev_get_rx_queue_data (rxq);
   const u64x2 flip_phase = (ena_rx_desc_t){ .lo.phase = 1 }.as_u64x2;
   u32 buffer_indices[ENA_RX_REFILL_BATCH];
-  uword dma_addr[ENA_RX_REFILL_BATCH];
+  u64 dma_addr[ENA_RX_REFILL_BATCH];
   u32 n_alloc, n_compl_sqes = q->n_compl_sqes;
   u16 *csi = ctx->comp_sqe_indices;
   ena_rx_desc_t *sqes = q->sqes;
@@ -213,13 +214,8 @@ ena_device_input_refill (vlib_main_t *vm, ena_rx_ctx_t *ctx,
       if (PREDICT_FALSE (n_alloc == 0))
 	break;
 
-      vlib_get_buffers_with_offset (vm, buffer_indices, (void **) dma_addr,
-				    ENA_RX_REFILL_BATCH,
-				    STRUCT_OFFSET_OF (vlib_buffer_t, data));
-
-      if (!use_va)
-	for (u32 i = 0; i < n_alloc; i++)
-	  dma_addr[i] = vlib_physmem_get_pa (vm, (void *) dma_addr[i]);
+      vnet_dev_rx_buffers_dma_addr (vm, buffer_indices, dma_addr, n_alloc,
+				    use_va);
 
       for (u32 i = 0; i < n_alloc; i++)
 	{
@@ -253,16 +249,16 @@ ena_device_input_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
   ena_rxq_t *q = vnet_dev_get_rx_queue_data (rxq);
   vnet_dev_port_t *port = rxq->port;
   vnet_main_t *vnm = vnet_get_main ();
-  vlib_buffer_t *buffers[VLIB_FRAME_SIZE], **b;
+  vlib_buffer_t *buffers[VLIB_FRAME_SIZE];
   ena_rx_cdesc_status_t statuses[VLIB_FRAME_SIZE + 8];
-  u16 lengths[VLIB_FRAME_SIZE + 8], *l;
-  u32 flags[VLIB_FRAME_SIZE + 8], *f;
+  u16 lengths[VLIB_FRAME_SIZE + 8];
+  u32 flags[VLIB_FRAME_SIZE + 8];
   u16 *csi;
   uword n_rx_packets = 0, n_rx_bytes = 0;
   vlib_frame_bitmap_t head_bmp = {};
   u32 sw_if_index = port->intf.sw_if_index;
   u32 hw_if_index = port->intf.hw_if_index;
-  u32 n_trace, n_deq, n_left;
+  u32 n_trace, n_deq;
   u32 cq_next = q->cq_next;
   u32 next_index = rxq->next_index;
   vlib_frame_t *next_frame;
@@ -311,33 +307,7 @@ ena_device_input_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
   else
     ena_device_input_status_to_flags (statuses, flags, n_deq, head_bmp, 0);
 
-  for (b = buffers, l = lengths, f = flags, n_left = n_deq; n_left >= 8;
-       b += 4, f += 4, l += 4, n_left -= 4)
-    {
-      clib_prefetch_store (b[4]);
-      clib_prefetch_store (b[5]);
-      clib_prefetch_store (b[6]);
-      clib_prefetch_store (b[7]);
-      b[0]->template = bt;
-      n_rx_bytes += b[0]->current_length = l[0];
-      b[0]->flags = f[0];
-      b[1]->template = bt;
-      n_rx_bytes += b[1]->current_length = l[1];
-      b[1]->flags = f[1];
-      b[2]->template = bt;
-      n_rx_bytes += b[2]->current_length = l[2];
-      b[2]->flags = f[2];
-      b[3]->template = bt;
-      n_rx_bytes += b[3]->current_length = l[3];
-      b[3]->flags = f[3];
-    }
-
-  for (; n_left > 0; b += 1, f += 1, l += 1, n_left -= 1)
-    {
-      b[0]->template = bt;
-      n_rx_bytes += b[0]->current_length = l[0];
-      b[0]->flags = f[0];
-    }
+  n_rx_bytes = vnet_dev_rx_buffers_init (buffers, &bt, lengths, flags, n_deq);
 
   if (maybe_chained)
     {
@@ -430,7 +400,8 @@ ena_device_input_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
       vlib_frame_no_append (next_frame);
     }
 
-  vlib_put_next_frame (vm, node, next_index, VLIB_FRAME_SIZE - n_rx_packets);
+  vlib_put_next_frame (vm, node, next_index,
+		       next_frame->max_vectors - n_rx_packets);
 
   vlib_increment_combined_counter (
     vnm->interface_main.combined_sw_if_counters + VNET_INTERFACE_COUNTER_RX,
@@ -4,6 +4,7 @@
 
 #include <vlib/vlib.h>
 #include <vnet/dev/dev.h>
+#include <vnet/dev/rx_funcs.h>
 #include <vnet/ethernet/ethernet.h>
 #include <dev_iavf/iavf.h>
 
@@ -44,9 +45,8 @@ iavf_rxq_refill (vlib_main_t *vm, vlib_node_runtime_t *node,
 {
   u16 n_refill, mask, n_alloc, slot, size;
   iavf_rxq_t *arq = vnet_dev_get_rx_queue_data (rxq);
-  vlib_buffer_t *b[8];
   iavf_rx_desc_t *d, *first_d;
-  void *p[8];
+  u64 dma_addr[8];
 
   size = rxq->size;
   mask = size - 1;
@@ -80,31 +80,10 @@ iavf_rxq_refill (vlib_main_t *vm, vlib_node_runtime_t *node,
     {
       d = first_d + slot;
 
-      if (use_va_dma)
-	{
-	  vlib_get_buffers_with_offset (vm, arq->buffer_indices + slot, p, 8,
-					sizeof (vlib_buffer_t));
-	  iavf_rx_desc_write (d + 0, pointer_to_uword (p[0]));
-	  iavf_rx_desc_write (d + 1, pointer_to_uword (p[1]));
-	  iavf_rx_desc_write (d + 2, pointer_to_uword (p[2]));
-	  iavf_rx_desc_write (d + 3, pointer_to_uword (p[3]));
-	  iavf_rx_desc_write (d + 4, pointer_to_uword (p[4]));
-	  iavf_rx_desc_write (d + 5, pointer_to_uword (p[5]));
-	  iavf_rx_desc_write (d + 6, pointer_to_uword (p[6]));
-	  iavf_rx_desc_write (d + 7, pointer_to_uword (p[7]));
-	}
-      else
-	{
-	  vlib_get_buffers (vm, arq->buffer_indices + slot, b, 8);
-	  iavf_rx_desc_write (d + 0, vlib_buffer_get_pa (vm, b[0]));
-	  iavf_rx_desc_write (d + 1, vlib_buffer_get_pa (vm, b[1]));
-	  iavf_rx_desc_write (d + 2, vlib_buffer_get_pa (vm, b[2]));
-	  iavf_rx_desc_write (d + 3, vlib_buffer_get_pa (vm, b[3]));
-	  iavf_rx_desc_write (d + 4, vlib_buffer_get_pa (vm, b[4]));
-	  iavf_rx_desc_write (d + 5, vlib_buffer_get_pa (vm, b[5]));
-	  iavf_rx_desc_write (d + 6, vlib_buffer_get_pa (vm, b[6]));
-	  iavf_rx_desc_write (d + 7, vlib_buffer_get_pa (vm, b[7]));
-	}
+      vnet_dev_rx_buffers_dma_addr (vm, arq->buffer_indices + slot, dma_addr,
+				    8, use_va_dma);
+      for (u32 i = 0; i < 8; i++)
+	iavf_rx_desc_write (d + i, dma_addr[i]);
 
       /* next */
       slot = (slot + 8) & mask;
@@ -123,6 +102,7 @@ iavf_rx_attach_tail (vlib_main_t *vm, vlib_buffer_template_t *bt,
 {
   vlib_buffer_t *hb = b;
   u32 tlnifb = 0, i = 0;
+  u16 len;
 
   if (qw1 & mask_eop.as_u64)
     return 0;
@@ -135,8 +115,9 @@ iavf_rx_attach_tail (vlib_main_t *vm, vlib_buffer_template_t *bt,
       b->next_buffer = t->buffers[i];
       b->flags |= VLIB_BUFFER_NEXT_PRESENT;
       b = vlib_get_buffer (vm, b->next_buffer);
-      b->template = *bt;
-      tlnifb += b->current_length = ((iavf_rx_desc_qw1_t) qw1).length;
+      len = ((iavf_rx_desc_qw1_t) qw1).length;
+      vnet_dev_rx_buffer_init (b, bt, len, 0);
+      tlnifb += len;
       i++;
     }
 
@@ -181,6 +162,7 @@ iavf_process_rx_burst (vlib_main_t *vm, vlib_node_runtime_t *node,
   u64 *qw1 = rtd->qw1s;
   iavf_rx_tail_t *tail = rtd->tails;
   uword n_rx_bytes = 0;
+  u16 lengths[4];
 
   while (n_left >= 4)
     {
@@ -192,19 +174,11 @@ iavf_process_rx_burst (vlib_main_t *vm, vlib_node_runtime_t *node,
 	  vlib_prefetch_buffer_header (b[11], LOAD);
 	}
 
-      b[0]->template = *bt;
-      b[1]->template = *bt;
-      b[2]->template = *bt;
-      b[3]->template = *bt;
-
-      n_rx_bytes += b[0]->current_length =
-	((iavf_rx_desc_qw1_t) qw1[0]).length;
-      n_rx_bytes += b[1]->current_length =
-	((iavf_rx_desc_qw1_t) qw1[1]).length;
-      n_rx_bytes += b[2]->current_length =
-	((iavf_rx_desc_qw1_t) qw1[2]).length;
-      n_rx_bytes += b[3]->current_length =
-	((iavf_rx_desc_qw1_t) qw1[3]).length;
+      lengths[0] = ((iavf_rx_desc_qw1_t) qw1[0]).length;
+      lengths[1] = ((iavf_rx_desc_qw1_t) qw1[1]).length;
+      lengths[2] = ((iavf_rx_desc_qw1_t) qw1[2]).length;
+      lengths[3] = ((iavf_rx_desc_qw1_t) qw1[3]).length;
+      n_rx_bytes += vnet_dev_rx_buffers_init (b, bt, lengths, 0, 4);
 
       if (maybe_multiseg)
 	{
@@ -223,10 +197,8 @@ iavf_process_rx_burst (vlib_main_t *vm, vlib_node_runtime_t *node,
 
   while (n_left)
     {
-      b[0]->template = *bt;
-
-      n_rx_bytes += b[0]->current_length =
-	((iavf_rx_desc_qw1_t) qw1[0]).length;
+      lengths[0] = ((iavf_rx_desc_qw1_t) qw1[0]).length;
+      n_rx_bytes += vnet_dev_rx_buffers_init (b, bt, lengths, 0, 1);
 
       if (maybe_multiseg)
 	n_rx_bytes += iavf_rx_attach_tail (vm, bt, b[0], qw1[0], tail + 0);
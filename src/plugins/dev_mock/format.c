@@ -0,0 +1,94 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2024 Cisco Systems, Inc.
+ */
+
+#include <vnet/vnet.h>
+#include <vnet/dev/dev.h>
+#include <dev_mock/mock.h>
+
+static u8 *
+format_mock_rx_desc_status (u8 *s, va_list *args)
+{
+  u32 status = va_arg (*args, u32);
+  char *sep = "";
+
+#define _(b, n)                                                               \
+  if (status & MOCK_RX_DESC_STATUS_##n)                                       \
+    {                                                                         \
+      s = format (s, "%s%s", sep, #n);                                        \
+      sep = " ";                                                              \
+    }
+  foreach_mock_rx_desc_status
+#undef _
+    return s;
+}
+
+u8 *
+format_mock_dev_info (u8 *s, va_list *args)
+{
+  vnet_dev_format_args_t __clib_unused *a =
+    va_arg (*args, vnet_dev_format_args_t *);
+  vnet_dev_t __clib_unused *dev = va_arg (*args, vnet_dev_t *);
+
+  return format (s, "Software NIC, synthetic UDP traffic generator");
+}
+
+u8 *
+format_mock_port_status (u8 *s, va_list *args)
+{
+  vnet_dev_format_args_t __clib_unused *a =
+    va_arg (*args, vnet_dev_format_args_t *);
+  vnet_dev_port_t *port = va_arg (*args, vnet_dev_port_t *);
+  mock_port_t *mp = vnet_dev_get_port_data (port);
+  u32 indent = format_get_indent (s);
+
+  s = format (s, "rate ");
+  if (mp->pps)
+    s = format (s, "%u pps", mp->pps);
+  else
+    s = format (s, "unlimited");
+  s = format (s, ", %u flows, frame size %u", mp->n_flows, mp->frame_size);
+  s = format (s, "\n%Uchecksum offload %s, RSS redirection table size %u",
+	      format_white_space, indent,
+	      mp->csum_offload ? "enabled" : "disabled", MOCK_RETA_SIZE);
+  return s;
+}
+
+u8 *
+format_mock_rx_queue_info (u8 *s, va_list *args)
+{
+  vnet_dev_format_args_t __clib_unused *a =
+    va_arg (*args, vnet_dev_format_args_t *);
+  vnet_dev_rx_queue_t *rxq = va_arg (*args, vnet_dev_rx_queue_t *);
+  mock_rxq_t *mq = vnet_dev_get_rx_queue_data (rxq);
+  u32 indent = format_get_indent (s);
+
+  s = format (s, "%u flows steered here, rate ", vec_len (mq->flows));
+  if (mq->pps)
+    s = format (s, "%u pps", mq->pps);
+  else
+    s = format (s, "unlimited");
+  s = format (s, ", %lu missed", mq->n_missed);
+  s = format (s, "\n%Uhead %u tail %u device %u", format_white_space, indent,
+	      mq->head, mq->tail, mq->dev_next);
+  return s;
+}
+
+u8 *
+format_mock_rx_trace (u8 *s, va_list *args)
+{
+  vlib_main_t *vm = va_arg (*args, vlib_main_t *);
+  vlib_node_t *node = va_arg (*args, vlib_node_t *);
+  mock_rx_trace_t *t = va_arg (*args, mock_rx_trace_t *);
+  vnet_main_t *vnm = vnet_get_main ();
+  vnet_hw_interface_t *hi = vnet_get_hw_interface (vnm, t->hw_if_index);
+  u32 indent = format_get_indent (s);
+
+  s = format (s, "mock: %v (%d) qid %u next-node %U", hi->name,
+	      t->hw_if_index, t->qid, format_vlib_next_node_name, vm,
+	      node->index, t->next_index);
+  s = format (s, "\n%Ulength %u flow %u rss-hash 0x%08x status %U",
+	      format_white_space, indent + 2, t->length, t->flow, t->hash,
+	      format_mock_rx_desc_status, t->status);
+  return s;
+}
@@ -0,0 +1,291 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2024 Cisco Systems, Inc.
+ */
+
+#include <vnet/vnet.h>
+#include <vnet/dev/dev.h>
+#include <vnet/ethernet/ethernet.h>
+#include <vnet/plugin/plugin.h>
+#include <vpp/app/version.h>
+#include <dev_mock/mock.h>
+
+VLIB_REGISTER_LOG_CLASS (mock_log, static) = {
+  .class_name = "mock",
+  .subclass_name = "init",
+};
+
+#define _(f, n, s, d)                                                         \
+  { .name = #n, .desc = d, .severity = VL_COUNTER_SEVERITY_##s },
+
+static vlib_error_desc_t mock_rx_node_counters[] = {
+  foreach_mock_rx_node_counter
+};
+static vlib_error_desc_t mock_tx_node_counters[] = {
+  foreach_mock_tx_node_counter
+};
+#undef _
+
+vnet_dev_node_t mock_rx_node = {
+  .error_counters = mock_rx_node_counters,
+  .n_error_counters = ARRAY_LEN (mock_rx_node_counters),
+  .format_trace = format_mock_rx_trace,
+};
+
+vnet_dev_node_t mock_tx_node = {
+  .error_counters = mock_tx_node_counters,
+  .n_error_counters = ARRAY_LEN (mock_tx_node_counters),
+};
+
+static vnet_dev_arg_t mock_port_args[] = {
+  {
+    .id = MOCK_PORT_ARG_PPS,
+    .name = "pps",
+    .desc = "Packets per second offered by the wire, 0 keeps the rx rings "
+	    "full",
+    .type = VNET_DEV_ARG_TYPE_UINT32,
+    .default_val.uint32 = 0,
+  },
+  {
+    .id = MOCK_PORT_ARG_FLOWS,
+    .name = "flows",
+    .desc = "Number of distinct UDP flows spread over rx queues by RSS",
+    .type = VNET_DEV_ARG_TYPE_UINT32,
+    .min = 1,
+    .max = 65536,
+    .default_val.uint32 = 1024,
+  },
+  {
+    .id = MOCK_PORT_ARG_FRAME_SIZE,
+    .name = "frame_size",
+    .desc = "Size of received frames, without FCS",
+    .type = VNET_DEV_ARG_TYPE_UINT32,
+    .min = MOCK_MIN_FRAME_SIZE,
+    .max = 9000,
+    .default_val.uint32 = MOCK_MIN_FRAME_SIZE,
+  },
+  {
+    .id = MOCK_PORT_ARG_CSUM_OFFLOAD,
+    .name = "csum_offload",
+    .desc = "Report IPv4 and L4 checksums as verified in rx descriptors",
+    .type = VNET_DEV_ARG_TYPE_BOOL,
+    .default_val.boolean = 1,
+  },
+  {
+    .type = VNET_DEV_ARG_END,
+  },
+};
+
+/* bus */
+
+static int
+mock_bus_device_id_to_instance (u32 *instance, char *str)
+{
+  unformat_input_t input;
+  uword rv;
+
+  unformat_init_string (&input, str, strlen (str));
+  rv =
+    unformat (&input, "mock" VNET_DEV_DEVICE_ID_PREFIX_DELIMITER "%u",
+	      instance);
+  unformat_free (&input);
+  return rv;
+}
+
+static void *
+mock_bus_get_device_info (vlib_main_t *vm, char *device)
+{
+  mock_bus_device_info_t *info;
+  u32 instance;
+
+  if (mock_bus_device_id_to_instance (&instance, device) == 0)
+    return 0;
+
+  info = clib_mem_alloc (sizeof (mock_bus_device_info_t));
+  *info = (mock_bus_device_info_t){ .instance = instance };
+
+  return info;
+}
+
+static void
+mock_bus_free_device_info (vlib_main_t *vm, void *dev_info)
+{
+  clib_mem_free (dev_info);
+}
+
+static vnet_dev_rv_t
+mock_bus_device_open (vlib_main_t *vm, vnet_dev_t *dev)
+{
+  mock_bus_device_data_t *bd = (void *) dev->bus_data;
+  u32 instance;
+
+  if (mock_bus_device_id_to_instance (&instance, dev->device_id) == 0)
+    return VNET_DEV_ERR_INVALID_DEVICE_ID;
+
+  dev->numa_node = 0;
+  dev->va_dma = 1;
+  bd->instance = instance;
+
+  return VNET_DEV_OK;
+}
+
+static void
+mock_bus_device_close (vlib_main_t *vm, vnet_dev_t *dev)
+{
+}
+
+static vnet_dev_rv_t
+mock_bus_dma_mem_alloc (vlib_main_t *vm, vnet_dev_t *dev, u32 size, u32 align,
+			void **pp)
+{
+  void *p = clib_mem_alloc_aligned (size, clib_max (align, 64));
+
+  clib_memset (p, 0, size);
+  *pp = p;
+  return VNET_DEV_OK;
+}
+
+static void
+mock_bus_dma_mem_free (vlib_main_t *vm, vnet_dev_t *dev, void *p)
+{
+  clib_mem_free (p);
+}
+
+static u8 *
+format_mock_bus_device_info (u8 *s, va_list *args)
+{
+  va_arg (*args, vnet_dev_format_args_t *);
+  vnet_dev_t *dev = va_arg (*args, vnet_dev_t *);
+  mock_bus_device_data_t *bd = (void *) dev->bus_data;
+
+  return format (s, "Software device instance %u", bd->instance);
+}
+
+static u8 *
+format_mock_bus_device_addr (u8 *s, va_list *args)
+{
+  vnet_dev_t *dev = va_arg (*args, vnet_dev_t *);
+  mock_bus_device_data_t *bd = (void *) dev->bus_data;
+
+  return format (s, "mock/%u", bd->instance);
+}
+
+VNET_DEV_REGISTER_BUS (mock) = {
+  .name = "mock",
+  .device_data_size = sizeof (mock_bus_device_data_t),
+  .ops = {
+    .device_open = mock_bus_device_open,
+    .device_close = mock_bus_device_close,
+    .get_device_info = mock_bus_get_device_info,
+    .free_device_info = mock_bus_free_device_info,
+    .dma_mem_alloc_fn = mock_bus_dma_mem_alloc,
+    .dma_mem_free_fn = mock_bus_dma_mem_free,
+    .format_device_info = format_mock_bus_device_info,
+    .format_device_addr = format_mock_bus_device_addr,
+  },
+};
+
+/* driver */
+
+static vnet_dev_rv_t
+mock_init (vlib_main_t *vm, vnet_dev_t *dev)
+{
+  mock_bus_device_data_t *bd = (void *) dev->bus_data;
+  u8 mac_addr[6] = { 0x02, 0xfe, 0x6d, 0x6f, bd->instance >> 8,
+		     bd->instance };
+
+  vnet_dev_port_add_args_t port = {
+    .port = {
+      .attr = {
+        .type = VNET_DEV_PORT_TYPE_ETHERNET,
+        .max_rx_queues = 64,
+        .max_tx_queues = 64,
+        .max_supported_rx_frame_size = 9216,
+        .caps = {
+          .interrupt_mode = 1,
+          .rss = 1,
+        },
+        .rx_offloads = {
+          .ip4_cksum = 1,
+        },
+      },
+      .ops = {
+        .init = mock_port_init,
+        .deinit = mock_port_deinit,
+        .start = mock_port_start,
+        .stop = mock_port_stop,
+        .config_change = mock_port_cfg_change,
+        .config_change_validate = mock_port_cfg_change_validate,
+        .format_status = format_mock_port_status,
+      },
+      .data_size = sizeof (mock_port_t),
+      .args = mock_port_args,
+    },
+    .rx_node = &mock_rx_node,
+    .tx_node = &mock_tx_node,
+    .rx_queue = {
+      .config = {
+        .data_size = sizeof (mock_rxq_t),
+        .default_size = 512,
+        .min_size = MOCK_RX_REFILL_BATCH,
+        .max_size = 4096,
+        .size_is_power_of_two = 1,
+      },
+      .ops = {
+        .alloc = mock_rx_queue_alloc,
+        .start = mock_rx_queue_start,
+        .stop = mock_rx_queue_stop,
+        .free = mock_rx_queue_free,
+        .format_info = format_mock_rx_queue_info,
+      },
+    },
+    .tx_queue = {
+      .config = {
+        .data_size = sizeof (mock_txq_t),
+        .default_size = 512,
+        .min_size = 32,
+        .max_size = 4096,
+        .size_is_power_of_two = 1,
+      },
+      .ops = {
+        .alloc = mock_tx_queue_alloc,
+        .start = mock_tx_queue_start,
+        .stop = mock_tx_queue_stop,
+        .free = mock_tx_queue_free,
+      },
+    },
+  };
+
+  log_debug (dev, "instance %u", bd->instance);
+
+  vnet_dev_set_hw_addr_eth_mac (&port.port.attr.hw_addr, mac_addr);
+
+  return vnet_dev_port_add (vm, dev, 0, &port);
+}
+
+static u8 *
+mock_probe (vlib_main_t *vm, vnet_dev_bus_index_t bus_index, void *dev_info)
+{
+  vnet_dev_bus_t *bus = pool_elt_at_index (vnet_dev_main.buses, bus_index);
+  mock_bus_device_info_t *di = dev_info;
+
+  if (strcmp (bus->registration->name, "mock"))
+    return 0;
+
+  return format (0, "Software NIC instance %u", di->instance);
+}
+
+VNET_DEV_REGISTER_DRIVER (mock) = {
+  .name = "mock",
+  .bus = "mock",
+  .device_data_sz = sizeof (mock_device_t),
+  .ops = {
+    .init = mock_init,
+    .format_info = format_mock_dev_info,
+    .probe = mock_probe,
+  },
+};
+
+VLIB_PLUGIN_REGISTER () = {
+  .version = VPP_BUILD_VER,
+  .description = "dev_mock",
+};
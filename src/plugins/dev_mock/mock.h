@@ -0,0 +1,200 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2024 Cisco Systems, Inc.
+ */
+
+#ifndef _MOCK_H_
+#define _MOCK_H_
+
+#include <vppinfra/clib.h>
+#include <vppinfra/error_bootstrap.h>
+#include <vppinfra/format.h>
+#include <vppinfra/vector/toeplitz.h>
+#include <vnet/vnet.h>
+#include <vnet/dev/types.h>
+#include <vnet/ip/ip4_packet.h>
+#include <vnet/udp/udp_packet.h>
+#include <vnet/ethernet/packet.h>
+
+#define MOCK_RETA_SIZE	     128
+#define MOCK_RX_REFILL_BATCH 32
+#define MOCK_MIN_FRAME_SIZE  60
+#define MOCK_INTR_INTERVAL   1e-3
+
+/* bus */
+
+typedef struct
+{
+  u32 instance;
+  /* same layout as the pci device info, so pci drivers probing mock
+   * devices see vendor id 0 and pass */
+  u16 vendor_id;
+  u16 device_id;
+  u8 revision;
+} mock_bus_device_info_t;
+
+typedef struct
+{
+  u32 instance;
+} mock_bus_device_data_t;
+
+/* descriptors */
+
+#define foreach_mock_rx_desc_status                                           \
+  _ (0, DD)                                                                   \
+  _ (1, EOP)                                                                  \
+  _ (2, IP4_CSUM_OK)                                                          \
+  _ (3, L4_CSUM_OK)
+
+typedef enum
+{
+#define _(b, n) MOCK_RX_DESC_STATUS_##n = (1 << (b)),
+  foreach_mock_rx_desc_status
+#undef _
+} mock_rx_desc_status_t;
+
+typedef struct
+{
+  u64 addr;
+  u16 length;
+  u16 flow;
+  u32 status;
+} mock_rx_desc_t;
+
+STATIC_ASSERT_SIZEOF (mock_rx_desc_t, 16);
+
+/* synthetic eth / ip4 / udp headers, one per flow */
+typedef struct
+{
+  ethernet_header_t eth;
+  ip4_header_t ip4;
+  udp_header_t udp;
+} __clib_packed mock_flow_hdr_t;
+
+typedef struct
+{
+  CLIB_ALIGN_MARK (align, 64);
+  mock_flow_hdr_t hdr;
+  u32 hash;
+} mock_flow_t;
+
+typedef enum
+{
+  MOCK_PORT_ARG_PPS = 1,
+  MOCK_PORT_ARG_FLOWS,
+  MOCK_PORT_ARG_FRAME_SIZE,
+  MOCK_PORT_ARG_CSUM_OFFLOAD,
+} mock_port_args_t;
+
+typedef struct
+{
+} mock_device_t;
+
+typedef struct
+{
+  u32 pps;
+  u32 n_flows;
+  u16 frame_size;
+  u8 csum_offload : 1;
+  clib_toeplitz_hash_key_t *rss_key;
+  u16 reta[MOCK_RETA_SIZE];
+} mock_port_t;
+
+typedef struct
+{
+  mock_rx_desc_t *descs;
+  u32 *buffer_indices;
+  /* flows the emulated RSS steers to this queue */
+  mock_flow_t *flows;
+  u32 next_flow;
+  /* driver side */
+  u32 head;
+  u32 tail;
+  /* device side */
+  u32 dev_next;
+  u32 pps;
+  f64 last_time;
+  f64 credit;
+  u64 n_missed;
+} mock_rxq_t;
+
+typedef struct
+{
+  u32 *buffer_indices;
+  u32 head;
+  u32 tail;
+} mock_txq_t;
+
+typedef struct
+{
+  u16 qid;
+  u16 next_index;
+  u32 hw_if_index;
+  u32 status;
+  u16 length;
+  u16 flow;
+  u32 hash;
+} mock_rx_trace_t;
+
+/* port.c */
+vnet_dev_rv_t mock_port_init (vlib_main_t *, vnet_dev_port_t *);
+void mock_port_deinit (vlib_main_t *, vnet_dev_port_t *);
+vnet_dev_rv_t mock_port_start (vlib_main_t *, vnet_dev_port_t *);
+void mock_port_stop (vlib_main_t *, vnet_dev_port_t *);
+vnet_dev_rv_t mock_port_cfg_change (vlib_main_t *, vnet_dev_port_t *,
+				    vnet_dev_port_cfg_change_req_t *);
+vnet_dev_rv_t mock_port_cfg_change_validate (vlib_main_t *, vnet_dev_port_t *,
+					     vnet_dev_port_cfg_change_req_t *);
+
+/* queue.c */
+vnet_dev_rv_t mock_rx_queue_alloc (vlib_main_t *, vnet_dev_rx_queue_t *);
+vnet_dev_rv_t mock_tx_queue_alloc (vlib_main_t *, vnet_dev_tx_queue_t *);
+void mock_rx_queue_free (vlib_main_t *, vnet_dev_rx_queue_t *);
+void mock_tx_queue_free (vlib_main_t *, vnet_dev_tx_queue_t *);
+vnet_dev_rv_t mock_rx_queue_start (vlib_main_t *, vnet_dev_rx_queue_t *);
+vnet_dev_rv_t mock_tx_queue_start (vlib_main_t *, vnet_dev_tx_queue_t *);
+void mock_rx_queue_stop (vlib_main_t *, vnet_dev_rx_queue_t *);
+void mock_tx_queue_stop (vlib_main_t *, vnet_dev_tx_queue_t *);
+
+/* format.c */
+format_function_t format_mock_dev_info;
+format_function_t format_mock_port_status;
+format_function_t format_mock_rx_queue_info;
+format_function_t format_mock_rx_trace;
+
+#define foreach_mock_rx_node_counter                                          \
+  _ (BUFFER_ALLOC, buffer_alloc, ERROR, "buffer alloc error")
+
+typedef enum
+{
+#define _(f, lf, t, s) MOCK_RX_NODE_CTR_##f,
+  foreach_mock_rx_node_counter
+#undef _
+    MOCK_RX_NODE_N_CTRS,
+} mock_rx_node_ctr_t;
+
+#define foreach_mock_tx_node_counter                                          \
+  _ (NO_FREE_SLOTS, no_free_slots, ERROR, "no free tx slots")
+
+typedef enum
+{
+#define _(f, lf, t, s) MOCK_TX_NODE_CTR_##f,
+  foreach_mock_tx_node_counter
+#undef _
+    MOCK_TX_NODE_N_CTRS,
+} mock_tx_node_ctr_t;
+
+#define log_debug(dev, f, ...)                                                \
+  vlib_log (VLIB_LOG_LEVEL_DEBUG, mock_log.class, "%U" f,                     \
+	    format_vnet_dev_log, (dev),                                       \
+	    clib_string_skip_prefix (__func__, "mock_"), ##__VA_ARGS__)
+#define log_info(dev, f, ...)                                                 \
+  vlib_log (VLIB_LOG_LEVEL_INFO, mock_log.class, "%U: " f,                    \
+	    format_vnet_dev_addr, (dev), ##__VA_ARGS__)
+#define log_warn(dev, f, ...)                                                 \
+  vlib_log (VLIB_LOG_LEVEL_WARNING, mock_log.class, "%U: " f,                 \
+	    format_vnet_dev_addr, (dev), ##__VA_ARGS__)
+#define log_err(dev, f, ...)                                                  \
+  vlib_log (VLIB_LOG_LEVEL_ERR, mock_log.class, "%U: " f,                     \
+	    format_vnet_dev_addr, (dev), ##__VA_ARGS__)
+
+#endif /* _MOCK_H_ */
@@ -0,0 +1,56 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2024 Cisco Systems, Inc.
+ */
+
+#ifndef _MOCK_INLINES_H_
+#define _MOCK_INLINES_H_
+
+#include <vnet/dev/dev.h>
+#include <vnet/dev/rx_funcs.h>
+#include <dev_mock/mock.h>
+
+/* post fresh buffers to free descriptors, always in full batches so the
+ * tail stays batch aligned and a batch never wraps the ring */
+static_always_inline u32
+mock_rx_queue_refill (vlib_main_t *vm, vnet_dev_rx_queue_t *rxq)
+{
+  mock_rxq_t *mq = vnet_dev_get_rx_queue_data (rxq);
+  u8 bpi = vnet_dev_get_rx_queue_buffer_pool_index (rxq);
+  int use_va = rxq->port->dev->va_dma;
+  u32 mask = rxq->size - 1;
+  u32 n_free = rxq->size - (mq->tail - mq->head);
+  u64 dma_addr[MOCK_RX_REFILL_BATCH];
+  u32 n_refilled = 0;
+
+  while (n_free >= MOCK_RX_REFILL_BATCH)
+    {
+      u32 slot = mq->tail & mask;
+      u32 *bi = mq->buffer_indices + slot;
+      mock_rx_desc_t *d = mq->descs + slot;
+      u32 n_alloc;
+
+      n_alloc =
+	vlib_buffer_alloc_from_pool (vm, bi, MOCK_RX_REFILL_BATCH, bpi);
+
+      if (PREDICT_FALSE (n_alloc != MOCK_RX_REFILL_BATCH))
+	{
+	  if (n_alloc)
+	    vlib_buffer_free (vm, bi, n_alloc);
+	  break;
+	}
+
+      vnet_dev_rx_buffers_dma_addr (vm, bi, dma_addr, MOCK_RX_REFILL_BATCH,
+				    use_va);
+
+      for (u32 i = 0; i < MOCK_RX_REFILL_BATCH; i++)
+	d[i] = (mock_rx_desc_t){ .addr = dma_addr[i] };
+
+      mq->tail += MOCK_RX_REFILL_BATCH;
+      n_free -= MOCK_RX_REFILL_BATCH;
+      n_refilled += MOCK_RX_REFILL_BATCH;
+    }
+
+  return n_refilled;
+}
+
+#endif /* _MOCK_INLINES_H_ */
@@ -0,0 +1,259 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2024 Cisco Systems, Inc.
+ */
+
+#include <vnet/vnet.h>
+#include <vnet/dev/dev.h>
+#include <vnet/ethernet/ethernet.h>
+#include <dev_mock/mock.h>
+
+VLIB_REGISTER_LOG_CLASS (mock_log, static) = {
+  .class_name = "mock",
+  .subclass_name = "port",
+};
+
+static void
+mock_port_flow_hdr_init (mock_flow_hdr_t *h, vnet_dev_port_t *port, u32 flow,
+			 u16 frame_size)
+{
+  static const u8 src_mac[6] = { 0x02, 0xfe, 0x00, 0x00, 0x00, 0x01 };
+
+  clib_memset (h, 0, sizeof (*h));
+  clib_memcpy (h->eth.dst_address, port->primary_hw_addr.eth_mac, 6);
+  clib_memcpy (h->eth.src_address, src_mac, 6);
+  h->eth.type = clib_host_to_net_u16 (ETHERNET_TYPE_IP4);
+
+  h->ip4.ip_version_and_header_length = 0x45;
+  h->ip4.ttl = 64;
+  h->ip4.protocol = IP_PROTOCOL_UDP;
+  h->ip4.length = clib_host_to_net_u16 (frame_size - sizeof (h->eth));
+  h->ip4.src_address.as_u32 = clib_host_to_net_u32 (0x0a000000 | flow);
+  h->ip4.dst_address.as_u32 = clib_host_to_net_u32 (0xc0a80001);
+  h->ip4.checksum = ip4_header_checksum (&h->ip4);
+
+  h->udp.src_port = clib_host_to_net_u16 (1024 + (flow & 0x7fff));
+  h->udp.dst_port = clib_host_to_net_u16 (4789);
+  h->udp.length =
+    clib_host_to_net_u16 (frame_size - sizeof (h->eth) - sizeof (h->ip4));
+}
+
+/* steer flows the way a NIC would, toeplitz hash over addresses and ports
+ * indexes the redirection table which names the rx queue */
+static void
+mock_port_rss_init (vlib_main_t *vm, vnet_dev_port_t *port)
+{
+  mock_port_t *mp = vnet_dev_get_port_data (port);
+  u16 n_rxq = port->intf.num_rx_queues;
+
+  for (u32 i = 0; i < MOCK_RETA_SIZE; i++)
+    mp->reta[i] = i % n_rxq;
+
+  foreach_vnet_dev_port_rx_queue (q, port)
+    vec_reset_length (((mock_rxq_t *) vnet_dev_get_rx_queue_data (q))->flows);
+
+  for (u32 f = 0; f < mp->n_flows; f++)
+    {
+      vnet_dev_rx_queue_t *rxq;
+      mock_flow_t *flow;
+      mock_rxq_t *mq;
+      mock_flow_hdr_t h;
+      u32 hash;
+
+      mock_port_flow_hdr_init (&h, port, f, mp->frame_size);
+      /* ip4 addresses and udp ports are contiguous, 12 bytes */
+      hash = clib_toeplitz_hash (mp->rss_key, (u8 *) &h.ip4.src_address, 12);
+      rxq = vnet_dev_port_get_rx_queue_by_id (
+	port, mp->reta[hash % MOCK_RETA_SIZE]);
+      mq = vnet_dev_get_rx_queue_data (rxq);
+      vec_add2_aligned (mq->flows, flow, 1, CLIB_CACHE_LINE_BYTES);
+      flow->hdr = h;
+      flow->hash = hash;
+    }
+
+  foreach_vnet_dev_port_rx_queue (q, port)
+    {
+      mock_rxq_t *mq = vnet_dev_get_rx_queue_data (q);
+      u32 n = vec_len (mq->flows);
+
+      /* the wire rate splits over queues by their share of flows */
+      mq->pps = (u64) mp->pps * n / mp->n_flows;
+      if (mp->pps && n && mq->pps == 0)
+	mq->pps = 1;
+      log_debug (port->dev, "rx queue %u: %u flows, %u pps", q->queue_id, n,
+		 mq->pps);
+    }
+}
+
+vnet_dev_rv_t
+mock_port_init (vlib_main_t *vm, vnet_dev_port_t *port)
+{
+  mock_port_t *mp = vnet_dev_get_port_data (port);
+  vnet_dev_t *dev = port->dev;
+
+  log_debug (dev, "port %u", port->port_id);
+
+  foreach_vnet_dev_port_args (arg, port)
+    {
+      if (arg->id == MOCK_PORT_ARG_PPS)
+	mp->pps = vnet_dev_arg_get_uint32 (arg);
+      else if (arg->id == MOCK_PORT_ARG_FLOWS)
+	mp->n_flows = vnet_dev_arg_get_uint32 (arg);
+      else if (arg->id == MOCK_PORT_ARG_FRAME_SIZE)
+	mp->frame_size = vnet_dev_arg_get_uint32 (arg);
+      else if (arg->id == MOCK_PORT_ARG_CSUM_OFFLOAD)
+	mp->csum_offload = vnet_dev_arg_get_bool (arg);
+    }
+
+  /* no scatter, each frame must fit into a single buffer */
+  if (mp->frame_size > vlib_buffer_get_default_data_size (vm))
+    {
+      log_err (dev, "frame size %u doesn't fit into a buffer",
+	       mp->frame_size);
+      return VNET_DEV_ERR_UNSUPPORTED_CONFIG;
+    }
+
+  mp->rss_key = clib_toeplitz_hash_key_init (0, 0);
+  mock_port_rss_init (vm, port);
+
+  return VNET_DEV_OK;
+}
+
+void
+mock_port_deinit (vlib_main_t *vm, vnet_dev_port_t *port)
+{
+  mock_port_t *mp = vnet_dev_get_port_data (port);
+
+  log_debug (port->dev, "port %u", port->port_id);
+
+  foreach_vnet_dev_port_rx_queue (q, port)
+    vec_free (((mock_rxq_t *) vnet_dev_get_rx_queue_data (q))->flows);
+
+  if (mp->rss_key)
+    clib_toeplitz_hash_key_free (mp->rss_key);
+  mp->rss_key = 0;
+}
+
+/* the emulated device moderates interrupts to one per queue per interval */
+static void
+mock_port_poll (vlib_main_t *vm, vnet_dev_port_t *port)
+{
+  foreach_vnet_dev_port_rx_queue (q, port)
+    {
+      mock_rxq_t *mq = vnet_dev_get_rx_queue_data (q);
+
+      if (q->started && q->interrupt_mode && vec_len (mq->flows))
+	vlib_node_set_interrupt_pending (
+	  vlib_get_main_by_index (q->rx_thread_index),
+	  port->intf.rx_node_index);
+    }
+}
+
+vnet_dev_rv_t
+mock_port_start (vlib_main_t *vm, vnet_dev_port_t *port)
+{
+  vnet_dev_rv_t rv;
+
+  log_debug (port->dev, "port %u", port->port_id);
+
+  if ((rv = vnet_dev_port_start_all_rx_queues (vm, port)))
+    return rv;
+
+  if ((rv = vnet_dev_port_start_all_tx_queues (vm, port)))
+    return rv;
+
+  vnet_dev_poll_port_add (vm, port, MOCK_INTR_INTERVAL, mock_port_poll);
+
+  vnet_dev_port_state_change (vm, port,
+			      (vnet_dev_port_state_changes_t){
+				.change.link_state = 1,
+				.change.link_speed = 1,
+				.link_speed = 100000000,
+				.link_state = 1,
+			      });
+
+  return VNET_DEV_OK;
+}
+
+void
+mock_port_stop (vlib_main_t *vm, vnet_dev_port_t *port)
+{
+  log_debug (port->dev, "port %u", port->port_id);
+
+  vnet_dev_poll_port_remove (vm, port, mock_port_poll);
+
+  foreach_vnet_dev_port_rx_queue (rxq, port)
+    mock_rx_queue_stop (vm, rxq);
+
+  foreach_vnet_dev_port_tx_queue (txq, port)
+    mock_tx_queue_stop (vm, txq);
+
+  vnet_dev_port_state_change (vm, port,
+			      (vnet_dev_port_state_changes_t){
+				.change.link_state = 1,
+				.change.link_speed = 1,
+				.link_speed = 0,
+				.link_state = 0,
+			      });
+}
+
+vnet_dev_rv_t
+mock_port_cfg_change_validate (vlib_main_t *vm, vnet_dev_port_t *port,
+			       vnet_dev_port_cfg_change_req_t *req)
+{
+  vnet_dev_rv_t rv = VNET_DEV_OK;
+
+  switch (req->type)
+    {
+    case VNET_DEV_PORT_CFG_MAX_RX_FRAME_SIZE:
+      if (port->started)
+	rv = VNET_DEV_ERR_PORT_STARTED;
+      break;
+
+    case VNET_DEV_PORT_CFG_PROMISC_MODE:
+    case VNET_DEV_PORT_CFG_CHANGE_PRIMARY_HW_ADDR:
+    case VNET_DEV_PORT_CFG_ADD_SECONDARY_HW_ADDR:
+    case VNET_DEV_PORT_CFG_REMOVE_SECONDARY_HW_ADDR:
+    case VNET_DEV_PORT_CFG_RXQ_INTR_MODE_ENABLE:
+    case VNET_DEV_PORT_CFG_RXQ_INTR_MODE_DISABLE:
+      break;
+
+    default:
+      rv = VNET_DEV_ERR_NOT_SUPPORTED;
+    };
+
+  return rv;
+}
+
+vnet_dev_rv_t
+mock_port_cfg_change (vlib_main_t *vm, vnet_dev_port_t *port,
+		      vnet_dev_port_cfg_change_req_t *req)
+{
+  vnet_dev_rv_t rv = VNET_DEV_OK;
+
+  switch (req->type)
+    {
+    case VNET_DEV_PORT_CFG_CHANGE_PRIMARY_HW_ADDR:
+      /* synthetic traffic keeps following the port address */
+      foreach_vnet_dev_port_rx_queue (q, port)
+	{
+	  mock_rxq_t *mq = vnet_dev_get_rx_queue_data (q);
+	  mock_flow_t *f;
+	  vec_foreach (f, mq->flows)
+	    clib_memcpy (f->hdr.eth.dst_address, req->addr.eth_mac, 6);
+	}
+      break;
+
+    case VNET_DEV_PORT_CFG_MAX_RX_FRAME_SIZE:
+    case VNET_DEV_PORT_CFG_PROMISC_MODE:
+    case VNET_DEV_PORT_CFG_ADD_SECONDARY_HW_ADDR:
+    case VNET_DEV_PORT_CFG_REMOVE_SECONDARY_HW_ADDR:
+    case VNET_DEV_PORT_CFG_RXQ_INTR_MODE_ENABLE:
+    case VNET_DEV_PORT_CFG_RXQ_INTR_MODE_DISABLE:
+      break;
+
+    default:
+      return VNET_DEV_ERR_NOT_SUPPORTED;
+    };
+
+  return rv;
+}
@@ -0,0 +1,145 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2024 Cisco Systems, Inc.
+ */
+
+#include <vlib/vlib.h>
+#include <vnet/dev/dev.h>
+#include <dev_mock/mock.h>
+#include <dev_mock/mock_inlines.h>
+
+VLIB_REGISTER_LOG_CLASS (mock_log, static) = {
+  .class_name = "mock",
+  .subclass_name = "queue",
+};
+
+void
+mock_rx_queue_free (vlib_main_t *vm, vnet_dev_rx_queue_t *rxq)
+{
+  mock_rxq_t *mq = vnet_dev_get_rx_queue_data (rxq);
+  vnet_dev_t *dev = rxq->port->dev;
+
+  ASSERT (rxq->started == 0);
+
+  log_debug (dev, "queue %u", rxq->queue_id);
+
+  if (mq->buffer_indices)
+    clib_mem_free (mq->buffer_indices);
+  vnet_dev_dma_mem_free (vm, dev, mq->descs);
+  vec_free (mq->flows);
+  mq->buffer_indices = 0;
+  mq->descs = 0;
+}
+
+vnet_dev_rv_t
+mock_rx_queue_alloc (vlib_main_t *vm, vnet_dev_rx_queue_t *rxq)
+{
+  mock_rxq_t *mq = vnet_dev_get_rx_queue_data (rxq);
+  vnet_dev_t *dev = rxq->port->dev;
+  u16 size = rxq->size;
+  vnet_dev_rv_t rv;
+
+  ASSERT (mq->buffer_indices == 0);
+  ASSERT (mq->descs == 0);
+
+  log_debug (dev, "queue %u", rxq->queue_id);
+
+  mq->buffer_indices = clib_mem_alloc_aligned (
+    sizeof (mq->buffer_indices[0]) * size, CLIB_CACHE_LINE_BYTES);
+
+  if ((rv = vnet_dev_dma_mem_alloc (vm, dev, sizeof (mq->descs[0]) * size, 0,
+				    (void **) &mq->descs)))
+    mock_rx_queue_free (vm, rxq);
+
+  return rv;
+}
+
+vnet_dev_rv_t
+mock_rx_queue_start (vlib_main_t *vm, vnet_dev_rx_queue_t *rxq)
+{
+  mock_rxq_t *mq = vnet_dev_get_rx_queue_data (rxq);
+
+  log_debug (rxq->port->dev, "queue %u", rxq->queue_id);
+
+  mq->head = mq->tail = mq->dev_next = 0;
+  mq->next_flow = 0;
+  mq->last_time = vlib_time_now (vm);
+  mq->credit = 0;
+
+  if (mock_rx_queue_refill (vm, rxq) != rxq->size)
+    {
+      log_err (rxq->port->dev, "queue %u: buffer alloc failed",
+	       rxq->queue_id);
+      mock_rx_queue_stop (vm, rxq);
+      return VNET_DEV_ERR_BUFFER_ALLOC_FAIL;
+    }
+
+  return VNET_DEV_OK;
+}
+
+void
+mock_rx_queue_stop (vlib_main_t *vm, vnet_dev_rx_queue_t *rxq)
+{
+  mock_rxq_t *mq = vnet_dev_get_rx_queue_data (rxq);
+  u32 n = mq->tail - mq->head;
+
+  log_debug (rxq->port->dev, "queue %u", rxq->queue_id);
+
+  if (n)
+    vlib_buffer_free_from_ring_no_next (vm, mq->buffer_indices,
+					mq->head & (rxq->size - 1),
+					rxq->size, n);
+  mq->head = mq->tail = mq->dev_next = 0;
+}
+
+void
+mock_tx_queue_free (vlib_main_t *vm, vnet_dev_tx_queue_t *txq)
+{
+  mock_txq_t *mq = vnet_dev_get_tx_queue_data (txq);
+
+  ASSERT (txq->started == 0);
+
+  log_debug (txq->port->dev, "queue %u", txq->queue_id);
+
+  if (mq->buffer_indices)
+    clib_mem_free (mq->buffer_indices);
+  mq->buffer_indices = 0;
+}
+
+vnet_dev_rv_t
+mock_tx_queue_alloc (vlib_main_t *vm, vnet_dev_tx_queue_t *txq)
+{
+  mock_txq_t *mq = vnet_dev_get_tx_queue_data (txq);
+
+  log_debug (txq->port->dev, "queue %u", txq->queue_id);
+
+  mq->buffer_indices = clib_mem_alloc_aligned (
+    sizeof (mq->buffer_indices[0]) * txq->size, CLIB_CACHE_LINE_BYTES);
+
+  return VNET_DEV_OK;
+}
+
+vnet_dev_rv_t
+mock_tx_queue_start (vlib_main_t *vm, vnet_dev_tx_queue_t *txq)
+{
+  mock_txq_t *mq = vnet_dev_get_tx_queue_data (txq);
+
+  log_debug (txq->port->dev, "queue %u", txq->queue_id);
+
+  mq->head = mq->tail = 0;
+  return VNET_DEV_OK;
+}
+
+void
+mock_tx_queue_stop (vlib_main_t *vm, vnet_dev_tx_queue_t *txq)
+{
+  mock_txq_t *mq = vnet_dev_get_tx_queue_data (txq);
+  u32 n = mq->tail - mq->head;
+
+  log_debug (txq->port->dev, "queue %u", txq->queue_id);
+
+  if (n)
+    vlib_buffer_free_from_ring_no_next (vm, mq->buffer_indices,
+					mq->head & (txq->size - 1),
+					txq->size, n);
+  mq->head = mq->tail = 0;
+}
@@ -0,0 +1,219 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2024 Cisco Systems, Inc.
+ */
+
+#include <vnet/vnet.h>
+#include <vnet/dev/dev.h>
+#include <vnet/dev/rx_funcs.h>
+#include <vnet/ethernet/ethernet.h>
+
+#include <dev_mock/mock.h>
+#include <dev_mock/mock_inlines.h>
+
+static const vnet_dev_rx_flag_map_t mock_rx_flag_map[] = {
+  {
+    .mask = MOCK_RX_DESC_STATUS_L4_CSUM_OK,
+    .match = MOCK_RX_DESC_STATUS_L4_CSUM_OK,
+    .flags =
+      VNET_BUFFER_F_L4_CHECKSUM_COMPUTED | VNET_BUFFER_F_L4_CHECKSUM_CORRECT,
+  },
+};
+
+/* the device side, frames arriving from the wire are written to posted
+ * buffers and their descriptors completed, frames finding no posted
+ * buffer are missed */
+static_always_inline void
+mock_device_receive (vlib_main_t *vm, mock_port_t *mp, mock_rxq_t *mq,
+		     u32 mask)
+{
+  u32 n_flows = vec_len (mq->flows);
+  u32 n_avail = mq->tail - mq->dev_next;
+  u32 status = MOCK_RX_DESC_STATUS_DD | MOCK_RX_DESC_STATUS_EOP;
+  u32 flow = mq->next_flow;
+  u16 frame_size = mp->frame_size;
+  u32 n = n_avail;
+
+  if (PREDICT_FALSE (n_flows == 0))
+    return;
+
+  if (mq->pps)
+    {
+      f64 now = vlib_time_now (vm);
+      f64 credit = mq->credit + (now - mq->last_time) * mq->pps;
+
+      mq->last_time = now;
+      if (credit > n_avail)
+	{
+	  mq->n_missed += (u64) credit - n_avail;
+	  credit = n_avail;
+	}
+      n = credit;
+      mq->credit = credit - n;
+    }
+
+  if (mp->csum_offload)
+    status |= MOCK_RX_DESC_STATUS_IP4_CSUM_OK | MOCK_RX_DESC_STATUS_L4_CSUM_OK;
+
+  for (u32 i = 0; i < n; i++)
+    {
+      mock_rx_desc_t *d = mq->descs + ((mq->dev_next + i) & mask);
+      mock_flow_t *f = mq->flows + flow;
+
+      clib_memcpy_fast (uword_to_pointer (d->addr, void *), &f->hdr,
+			sizeof (f->hdr));
+      d->length = frame_size;
+      d->flow = flow;
+      __atomic_store_n (&d->status, status, __ATOMIC_RELEASE);
+
+      if (++flow == n_flows)
+	flow = 0;
+    }
+
+  mq->dev_next += n;
+  mq->next_flow = flow;
+}
+
+static_always_inline u32
+mock_rx_dequeue (mock_rxq_t *mq, u32 size, u32 *status, u16 *lengths,
+		 u32 *st_and)
+{
+  u32 mask = size - 1, n_deq = 0, and = ~0;
+  u32 n_posted = clib_min (mq->tail - mq->head, VLIB_FRAME_SIZE);
+
+  /* at most two chunks, the second one starting after ring wrap, slots
+   * past the tail still hold stale completions */
+  for (int i = 0; i < 2 && n_deq < n_posted; i++)
+    {
+      u32 slot = (mq->head + n_deq) & mask;
+      u32 n_try = clib_min (n_posted - n_deq, size - slot);
+      mock_rx_desc_t *d = mq->descs + slot;
+      u32 n;
+
+      vnet_dev_rx_desc_get_u32 (d, sizeof (d[0]),
+				STRUCT_OFFSET_OF (mock_rx_desc_t, status),
+				status + n_deq, n_try);
+
+      for (n = 0; n < n_try; n++)
+	{
+	  if ((status[n_deq + n] & MOCK_RX_DESC_STATUS_DD) == 0)
+	    break;
+	  and &= status[n_deq + n];
+	}
+
+      vnet_dev_rx_desc_get_u16 (d, sizeof (d[0]),
+				STRUCT_OFFSET_OF (mock_rx_desc_t, length),
+				lengths + n_deq, n);
+      n_deq += n;
+
+      if (n < n_try)
+	break;
+    }
+
+  *st_and = and;
+  return n_deq;
+}
+
+static_always_inline uword
+mock_rx_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
+		vnet_dev_rx_queue_t *rxq)
+{
+  mock_rxq_t *mq = vnet_dev_get_rx_queue_data (rxq);
+  vnet_dev_port_t *port = rxq->port;
+  mock_port_t *mp = vnet_dev_get_port_data (port);
+  vnet_main_t *vnm = vnet_get_main ();
+  vlib_buffer_t *buffers[VLIB_FRAME_SIZE];
+  u32 status[VLIB_FRAME_SIZE + VNET_DEV_RX_BURST_PAD];
+  u32 flags[VLIB_FRAME_SIZE + VNET_DEV_RX_BURST_PAD];
+  u16 lengths[VLIB_FRAME_SIZE + VNET_DEV_RX_BURST_PAD];
+  u32 sw_if_index = port->intf.sw_if_index;
+  u32 hw_if_index = port->intf.hw_if_index;
+  u32 next_index = rxq->next_index;
+  u32 mask = rxq->size - 1;
+  uword n_rx_packets, n_rx_bytes;
+  vlib_frame_t *next_frame;
+  u32 n_trace, st_and;
+  u32 *bi;
+
+  mock_device_receive (vm, mp, mq, mask);
+
+  n_rx_packets = mock_rx_dequeue (mq, rxq->size, status, lengths, &st_and);
+
+  if (n_rx_packets == 0)
+    goto refill;
+
+  next_frame =
+    vlib_get_next_frame_internal (vm, node, next_index, /* new frame */ 1);
+  bi = vlib_frame_vector_args (next_frame);
+
+  vlib_buffer_copy_indices_from_ring (bi, mq->buffer_indices, mq->head & mask,
+				      rxq->size, n_rx_packets);
+  vlib_get_buffers (vm, bi, buffers, n_rx_packets);
+
+  vnet_dev_rx_status_to_flags (status, flags, n_rx_packets, mock_rx_flag_map,
+			       ARRAY_LEN (mock_rx_flag_map));
+  n_rx_bytes = vnet_dev_rx_buffers_init (buffers, &rxq->buffer_template,
+					 lengths, flags, n_rx_packets);
+
+  /* packet tracing */
+  if (PREDICT_FALSE ((n_trace = vlib_get_trace_count (vm, node))))
+    {
+      for (u32 i = 0; i < n_rx_packets && n_trace > 0; i++)
+	{
+	  vlib_buffer_t *b = buffers[i];
+	  mock_rx_desc_t *d = mq->descs + ((mq->head + i) & mask);
+	  if (vlib_trace_buffer (vm, node, next_index, b, 0))
+	    {
+	      mock_rx_trace_t *tr = vlib_add_trace (vm, node, b, sizeof (*tr));
+	      tr->next_index = next_index;
+	      tr->qid = rxq->queue_id;
+	      tr->hw_if_index = hw_if_index;
+	      tr->status = status[i];
+	      tr->length = lengths[i];
+	      tr->flow = d->flow;
+	      tr->hash = mq->flows[d->flow].hash;
+	      n_trace--;
+	    }
+	}
+      vlib_set_trace_count (vm, node, n_trace);
+    }
+
+  if (PREDICT_TRUE (next_index == VNET_DEVICE_INPUT_NEXT_ETHERNET_INPUT))
+    {
+      ethernet_input_frame_t *ef;
+      next_frame->flags = ETH_INPUT_FRAME_F_SINGLE_SW_IF_IDX;
+
+      ef = vlib_frame_scalar_args (next_frame);
+      ef->sw_if_index = sw_if_index;
+      ef->hw_if_index = hw_if_index;
+
+      if (st_and & MOCK_RX_DESC_STATUS_IP4_CSUM_OK)
+	next_frame->flags |= ETH_INPUT_FRAME_F_IP4_CKSUM_OK;
+      vlib_frame_no_append (next_frame);
+    }
+
+  vlib_put_next_frame (vm, node, next_index,
+		       next_frame->max_vectors - n_rx_packets);
+
+  vlib_increment_combined_counter (
+    vnm->interface_main.combined_sw_if_counters + VNET_INTERFACE_COUNTER_RX,
+    vm->thread_index, hw_if_index, n_rx_packets, n_rx_bytes);
+
+  mq->head += n_rx_packets;
+
+refill:
+  mock_rx_queue_refill (vm, rxq);
+  if (PREDICT_FALSE (rxq->size - (mq->tail - mq->head) >=
+		     MOCK_RX_REFILL_BATCH))
+    vlib_error_count (vm, node->node_index, MOCK_RX_NODE_CTR_BUFFER_ALLOC, 1);
+
+  return n_rx_packets;
+}
+
+VNET_DEV_NODE_FN (mock_rx_node)
+(vlib_main_t *vm, vlib_node_runtime_t *node, vlib_frame_t *frame)
+{
+  u32 n_rx = 0;
+  foreach_vnet_dev_rx_queue_runtime (rxq, node)
+    n_rx += mock_rx_inline (vm, node, rxq);
+  return n_rx;
+}
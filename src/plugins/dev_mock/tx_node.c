@@ -0,0 +1,61 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2024 Cisco Systems, Inc.
+ */
+
+#include <vnet/vnet.h>
+#include <vnet/dev/dev.h>
+#include <vnet/ethernet/ethernet.h>
+
+#include <dev_mock/mock.h>
+
+VNET_DEV_NODE_FN (mock_tx_node)
+(vlib_main_t *vm, vlib_node_runtime_t *node, vlib_frame_t *frame)
+{
+  vnet_dev_tx_node_runtime_t *tnr = vnet_dev_get_tx_node_runtime (node);
+  vnet_dev_tx_queue_t *txq = tnr->tx_queue;
+  mock_txq_t *mq = vnet_dev_get_tx_queue_data (txq);
+  vlib_buffer_t *buffers[VLIB_FRAME_SIZE];
+  u32 *from = vlib_frame_vector_args (frame);
+  u32 mask = txq->size - 1;
+  u32 n_pkts, n_free;
+  uword n_bytes = 0;
+
+  vnet_dev_tx_queue_lock_if_needed (txq);
+
+  /* the device has sent everything posted on previous calls by now, free
+   * completed buffers before posting new ones */
+  if (mq->tail != mq->head)
+    {
+      vlib_buffer_free_from_ring (vm, mq->buffer_indices, mq->head & mask,
+				  txq->size, mq->tail - mq->head);
+      mq->head = mq->tail;
+    }
+
+  n_free = txq->size - (mq->tail - mq->head);
+  n_pkts = clib_min (frame->n_vectors, n_free);
+
+  vlib_get_buffers (vm, from, buffers, n_pkts);
+  for (u32 i = 0; i < n_pkts; i++)
+    n_bytes += vlib_buffer_length_in_chain (vm, buffers[i]);
+
+  vlib_buffer_copy_indices_to_ring (mq->buffer_indices, from, mq->tail & mask,
+				    txq->size, n_pkts);
+  mq->tail += n_pkts;
+
+  vnet_dev_tx_queue_unlock_if_needed (txq);
+
+  vlib_increment_combined_counter (
+    vnet_get_main ()->interface_main.combined_sw_if_counters +
+      VNET_INTERFACE_COUNTER_TX,
+    vm->thread_index, tnr->hw_if_index, n_pkts, n_bytes);
+
+  if (PREDICT_FALSE (n_pkts < frame->n_vectors))
+    {
+      u32 n_left = frame->n_vectors - n_pkts;
+      vlib_buffer_free (vm, from + n_pkts, n_left);
+      vlib_error_count (vm, node->node_index, MOCK_TX_NODE_CTR_NO_FREE_SLOTS,
+			n_left);
+    }
+
+  return n_pkts;
+}
@@ -297,35 +297,63 @@ static void
 intel_dsa_config_del_fn (vlib_main_t *vm, vlib_dma_config_data_t *cd)
 {
   intel_dsa_main_t *idm = &intel_dsa_main;
-  intel_dsa_thread_t *t =
-    vec_elt_at_index (idm->dsa_threads, vm->thread_index);
-  u32 n_pending, n_threads, config_heap_index, n = 0;
+  intel_dsa_thread_t *t;
+  u32 n_threads, config_heap_index;
+  intel_dsa_batch_t *b;
+  int with_barrier = 0;
   n_threads = vlib_get_n_threads ();
 
-  if (!t->pending_batches)
-    goto free_heap;
-
-  n_pending = vec_len (t->pending_batches);
-  intel_dsa_batch_t *b;
+  /* batches of this config may be pending on any thread */
+  if (n_threads > 1 && vlib_worker_thread_barrier_held () == 0)
+    {
+      with_barrier = 1;
+      vlib_worker_thread_barrier_sync (vm);
+    }
 
-  /* clean pending list and free list */
-  for (u32 i = 0; i < n_pending; i++)
+  /*
+   * Wait for the copies the device was handed, and redo in software the
+   * ones it failed, so the caller may release the memory on return. Their
+   * completions are dropped.
+   */
+  vec_foreach (t, idm->dsa_threads)
     {
-      b = t->pending_batches[i];
-      if (b->config_index == cd->config_index)
+      u32 n = 0;
+
+      for (u32 i = 0; i < vec_len (t->pending_batches); i++)
 	{
+	  u8 status;
+
+	  b = t->pending_batches[i];
+	  if (b->config_index != cd->config_index)
+	    {
+	      t->pending_batches[n++] = b;
+	      continue;
+	    }
+
+	  while ((status = __atomic_load_n (&b->status, __ATOMIC_ACQUIRE)) ==
+		 INTEL_DSA_STATUS_BUSY)
+	    CLIB_PAUSE ();
+
+	  if (status != INTEL_DSA_STATUS_SUCCESS &&
+	      status != INTEL_DSA_STATUS_CPU_SUCCESS)
+	    intel_dsa_batch_fallback (vm, b, b->ch);
+
+	  /* same accounting as the completion node */
+	  intel_dsa_channel_lock (b->ch);
+	  if (status == INTEL_DSA_STATUS_SUCCESS)
+	    {
+	      b->ch->n_enq--;
+	      b->ch->completed++;
+	    }
+	  else
+	    b->ch->sw_fallback++;
+	  intel_dsa_channel_unlock (b->ch);
+
 	  vec_add1 (idm->dsa_config_heap[b->config_heap_index].freelist, b);
-	  if (b->status == INTEL_DSA_STATUS_SUCCESS ||
-	      b->status == INTEL_DSA_STATUS_BUSY)
-	    b->ch->n_enq--;
 	}
-      else
-	t->pending_batches[n++] = b;
+      vec_set_len (t->pending_batches, n);
     }
 
-  vec_set_len (t->pending_batches, n);
-
-free_heap:
   for (u32 thread = 0; thread < n_threads; thread++)
     {
       config_heap_index = cd->private_data + thread;
@@ -339,6 +367,9 @@ free_heap:
   heap_dealloc (idm->dsa_config_heap,
 		idm->dsa_config_heap_handle_by_config_index[cd->config_index]);
 
+  if (with_barrier)
+    vlib_worker_thread_barrier_release (vm);
+
   dsa_log_debug ("config %u removed", cd->private_data);
 }
 
@@ -1946,27 +1946,6 @@ ikev2_mk_remote_sa_id (u32 sai, u32 ci, u32 ti)
   return (0xc0000000 | (ti << 24) | (sai << 12) | ci);
 }
 
-typedef struct
-{
-  u32 sw_if_index;
-  u32 salt_local;
-  u32 salt_remote;
-  u32 local_sa_id;
-  u32 remote_sa_id;
-  ipsec_sa_flags_t flags;
-  u32 local_spi;
-  u32 remote_spi;
-  ipsec_crypto_alg_t encr_type;
-  ipsec_integ_alg_t integ_type;
-  ip_address_t local_ip;
-  ip_address_t remote_ip;
-  ipsec_key_t loc_ckey, rem_ckey, loc_ikey, rem_ikey;
-  u8 is_rekey;
-  u32 old_remote_sa_id;
-  u16 ipsec_over_udp_port;
-  u16 src_port;
-  u16 dst_port;
-} ikev2_add_ipsec_tunnel_args_t;
 
 static void
 ikev2_add_tunnel_from_main (ikev2_add_ipsec_tunnel_args_t * a)
@@ -2081,6 +2060,7 @@ ikev2_create_tunnel_interface (vlib_main_t *vm, ikev2_sa_t *sa,
   ikev2_sa_proposal_t *proposals;
   u8 is_aead = 0;
   ikev2_add_ipsec_tunnel_args_t a;
+  ikev2_tunnel_op_t *op;
 
   clib_memset (&a, 0, sizeof (a));
 
@@ -2304,19 +2284,12 @@ ikev2_create_tunnel_interface (vlib_main_t *vm, ikev2_sa_t *sa,
   a.sw_if_index = (sa->is_tun_itf_set ? sa->tun_itf : ~0);
   a.ipsec_over_udp_port = sa->ipsec_over_udp_port;
 
-  vl_api_rpc_call_main_thread (ikev2_add_tunnel_from_main,
-			       (u8 *) & a, sizeof (a));
+  vec_add2 (ikev2_get_per_thread_data ()->tunnel_ops, op, 1);
+  op->is_add = 1;
+  op->add = a;
   return 0;
 }
 
-typedef struct
-{
-  ip46_address_t local_ip;
-  ip46_address_t remote_ip;
-  u32 remote_sa_id;
-  u32 local_sa_id;
-  u32 sw_if_index;
-} ikev2_del_ipsec_tunnel_args_t;
 
 static u32
 ikev2_flip_alternate_sa_bit (u32 id)
@@ -2372,11 +2345,47 @@ ikev2_del_tunnel_from_main (ikev2_del_ipsec_tunnel_args_t * a)
     ipip_del_tunnel (ipip->sw_if_index);
 }
 
+static void
+ikev2_tunnel_ops_from_main (ikev2_tunnel_op_t **opsp)
+{
+  ikev2_tunnel_op_t *op, *ops = *opsp;
+
+  vec_foreach (op, ops)
+    {
+      if (op->is_add)
+	ikev2_add_tunnel_from_main (&op->add);
+      else
+	ikev2_del_tunnel_from_main (&op->del);
+    }
+
+  vec_free (ops);
+}
+
+/*
+ * Child SA tunnels are not installed one at a time. The changes made while
+ * handling a frame of IKE messages, or a manager process round, are handed
+ * to the main thread together so that they cost a single barrier sync.
+ */
+static void
+ikev2_flush_tunnel_ops (void)
+{
+  ikev2_main_per_thread_data_t *ptd = ikev2_get_per_thread_data ();
+
+  if (vec_len (ptd->tunnel_ops) == 0)
+    return;
+
+  vl_api_rpc_call_main_thread (ikev2_tunnel_ops_from_main,
+			       (u8 *) &ptd->tunnel_ops,
+			       sizeof (ptd->tunnel_ops));
+  ptd->tunnel_ops = 0;
+}
+
 static int
 ikev2_delete_tunnel_interface (vnet_main_t * vnm, ikev2_sa_t * sa,
 			       ikev2_child_sa_t * child)
 {
   ikev2_del_ipsec_tunnel_args_t a;
+  ikev2_tunnel_op_t *op;
 
   clib_memset (&a, 0, sizeof (a));
 
@@ -2395,8 +2404,9 @@ ikev2_delete_tunnel_interface (vnet_main_t * vnm, ikev2_sa_t * sa,
   a.local_sa_id = child->local_sa_id;
   a.sw_if_index = (sa->is_tun_itf_set ? sa->tun_itf : ~0);
 
-  vl_api_rpc_call_main_thread (ikev2_del_tunnel_from_main, (u8 *) & a,
-			       sizeof (a));
+  vec_add2 (ikev2_get_per_thread_data ()->tunnel_ops, op, 1);
+  op->is_add = 0;
+  op->del = a;
   return 0;
 }
 
@@ -3012,11 +3022,71 @@ ikev2_update_stats (vlib_main_t *vm, u32 node_index, ikev2_stats_t *s)
 			       s->n_sa_auth_req);
 }
 
+static_always_inline u32
+ikev2_worker_pool_thread (vlib_buffer_t *b, u8 is_ip4, u8 natt)
+{
+  u8 *ip = natt ? vlib_buffer_get_current (b) :
+		  b->data + vnet_buffer (b)->l3_hdr_offset;
+  u64 key;
+
+  /* all the messages of a peer must be handled by the same thread as that
+   * is where its SAs live */
+  if (is_ip4)
+    key = ((ip4_header_t *) ip)->src_address.as_u32;
+  else
+    key = ((ip6_header_t *) ip)->src_address.as_u64[0] ^
+	  ((ip6_header_t *) ip)->src_address.as_u64[1];
+
+  return 1 + clib_xxhash (key) % (vlib_get_n_threads () - 1);
+}
+
+static_always_inline u32
+ikev2_worker_pool_handoff (vlib_main_t *vm, vlib_node_runtime_t *node,
+			   u32 *from, u32 n_left, u8 is_ip4, u8 natt,
+			   u32 *local)
+{
+  ikev2_main_t *km = &ikev2_main;
+  u32 remote[VLIB_FRAME_SIZE];
+  u16 threads[VLIB_FRAME_SIZE];
+  u32 n_local = 0, n_remote = 0, n_enq, fq_index, ti;
+
+  for (; n_left > 0; n_left--, from++)
+    {
+      ti = ikev2_worker_pool_thread (vlib_get_buffer (vm, from[0]), is_ip4,
+				     natt);
+      if (ti == vm->thread_index)
+	local[n_local++] = from[0];
+      else
+	{
+	  remote[n_remote] = from[0];
+	  threads[n_remote++] = ti;
+	}
+    }
+
+  if (n_remote)
+    {
+      fq_index = natt	? km->handoff_ip4_natt_fq_index :
+		 is_ip4 ? km->handoff_ip4_fq_index :
+			  km->handoff_ip6_fq_index;
+      n_enq = vlib_buffer_enqueue_to_thread (vm, node, fq_index, remote,
+					     threads, n_remote, 1);
+      vlib_node_increment_counter (vm, node->node_index, IKEV2_ERROR_HANDOFF,
+				   n_enq);
+      if (n_enq < n_remote)
+	vlib_node_increment_counter (vm, node->node_index,
+				     IKEV2_ERROR_HANDOFF_CONGESTION,
+				     n_remote - n_enq);
+    }
+
+  return n_local;
+}
+
 static uword
 ikev2_node_internal (vlib_main_t *vm, vlib_node_runtime_t *node,
 		     vlib_frame_t *frame, u8 is_ip4, u8 natt)
 {
-  u32 n_left = frame->n_vectors, *from;
+  u32 n_left = frame->n_vectors, *from, n_pkts;
+  u32 local[VLIB_FRAME_SIZE];
   ikev2_main_t *km = &ikev2_main;
   vlib_buffer_t *bufs[VLIB_FRAME_SIZE], **b;
   u16 nexts[VLIB_FRAME_SIZE], *next = nexts;
@@ -3029,6 +3099,17 @@ ikev2_node_internal (vlib_main_t *vm, vlib_node_runtime_t *node,
 
   clib_memset_u16 (stats, 0, sizeof (stats[0]) / sizeof (u16));
   from = vlib_frame_vector_args (frame);
+
+  if (PREDICT_FALSE (km->worker_pool_enabled))
+    {
+      n_left = ikev2_worker_pool_handoff (vm, node, from, n_left, is_ip4,
+					  natt, local);
+      if (n_left == 0)
+	return frame->n_vectors;
+      from = local;
+    }
+
+  n_pkts = n_left;
   vlib_get_buffers (vm, from, bufs, n_left);
   b = bufs;
 
@@ -3538,10 +3619,11 @@ ikev2_node_internal (vlib_main_t *vm, vlib_node_runtime_t *node,
       b += 1;
     }
 
+  ikev2_flush_tunnel_ops ();
   ikev2_update_stats (vm, node->node_index, stats);
   vlib_node_increment_counter (vm, node->node_index,
-			       IKEV2_ERROR_PROCESSED, frame->n_vectors);
-  vlib_buffer_enqueue_to_next (vm, node, from, nexts, frame->n_vectors);
+			       IKEV2_ERROR_PROCESSED, n_pkts);
+  vlib_buffer_enqueue_to_next (vm, node, from, nexts, n_pkts);
   return frame->n_vectors;
 }
 
@@ -3992,6 +4074,7 @@ ikev2_cleanup_profile_sessions (ikev2_main_t * km, ikev2_profile_t * p)
   }
 
   vec_free (del_sai);
+  ikev2_flush_tunnel_ops ();
 }
 
 static void
@@ -4632,6 +4715,7 @@ ikev2_initiate_sa_init (vlib_main_t * vm, u8 * name)
   vec_add (sa.childs[0].tsr, &p->rem_ts, 1);
 
   ikev2_initial_contact_cleanup (0, &sa);
+  ikev2_flush_tunnel_ops ();
 
   /* add SA to the pool */
   ikev2_sa_t *sa0 = 0;
@@ -4731,6 +4815,7 @@ ikev2_initiate_delete_child_sa (vlib_main_t * vm, u32 ispi)
   else
     {
       ikev2_delete_child_sa_internal (vm, fsa, fchild);
+      ikev2_flush_tunnel_ops ();
     }
 
   return 0;
@@ -4770,6 +4855,7 @@ ikev2_initiate_delete_ike_sa (vlib_main_t * vm, u64 ispi)
     }
 
   ikev2_initiate_delete_ike_sa_internal (vm, ftkm, fsa, 1);
+  ikev2_flush_tunnel_ops ();
   return 0;
 }
 
@@ -4891,6 +4977,7 @@ ikev2_sa_del (ikev2_profile_t * p, u32 sw_if_index)
     vec_reset_length (sa_vec);
   }
   vec_free (sa_vec);
+  ikev2_flush_tunnel_ops ();
 
   /* *INDENT-OFF* */
   pool_foreach (sa, km->sais)  {
@@ -4944,6 +5031,10 @@ ikev2_init (vlib_main_t * vm)
   km->liveness_period = IKEV2_LIVENESS_PERIOD_CHECK;
   km->liveness_max_retries = IKEV2_LIVENESS_RETRIES;
 
+  km->handoff_ip4_fq_index = ~0;
+  km->handoff_ip4_natt_fq_index = ~0;
+  km->handoff_ip6_fq_index = ~0;
+
   return 0;
 }
 
@@ -5081,6 +5172,41 @@ ikev2_set_liveness_params (u32 period, u32 max_retries)
   return 0;
 }
 
+clib_error_t *
+ikev2_set_worker_pool (u8 enable)
+{
+  ikev2_main_t *km = &ikev2_main;
+  ikev2_main_per_thread_data_t *tkm;
+
+  enable = !!enable;
+  if (enable == km->worker_pool_enabled)
+    return 0;
+
+  if (enable && vlib_get_n_threads () < 2)
+    return clib_error_return (0, "no worker threads");
+
+  /* an SA is only known to the thread that negotiated it, moving peers to
+   * other threads would orphan the existing ones */
+  if (pool_elts (km->sais))
+    return clib_error_return (0, "IKE SAs exist");
+  vec_foreach (tkm, km->per_thread_data)
+    if (pool_elts (tkm->sas))
+      return clib_error_return (0, "IKE SAs exist");
+
+  if (km->handoff_ip4_fq_index == ~0)
+    {
+      km->handoff_ip4_fq_index =
+	vlib_frame_queue_main_init (ikev2_node_ip4.index, 0);
+      km->handoff_ip4_natt_fq_index =
+	vlib_frame_queue_main_init (ikev2_node_ip4_natt.index, 0);
+      km->handoff_ip6_fq_index =
+	vlib_frame_queue_main_init (ikev2_node_ip6.index, 0);
+    }
+
+  km->worker_pool_enabled = enable;
+  return 0;
+}
+
 clib_error_t *
 ikev2_profile_natt_disable (u8 * name)
 {
@@ -5400,6 +5526,7 @@ ikev2_mngr_process_fn (vlib_main_t * vm, vlib_node_runtime_t * rt,
       /* *INDENT-ON* */
 
       ikev2_process_pending_sa_init (vm, km);
+      ikev2_flush_tunnel_ops ();
     }
   return 0;
 }
@@ -453,6 +453,7 @@ uword unformat_ikev2_transform_esn_type (unformat_input_t * input,
 					 va_list * args);
 
 clib_error_t *ikev2_set_liveness_params (u32 period, u32 max_retries);
+clib_error_t *ikev2_set_worker_pool (u8 enable);
 
 #endif /* __included_ikev2_h__ */
 
@@ -502,6 +502,23 @@ static void
   REPLY_MACRO (VL_API_IKEV2_PROFILE_SET_LIVENESS_REPLY);
 }
 
+static void
+vl_api_ikev2_set_worker_pool_t_handler (vl_api_ikev2_set_worker_pool_t *mp)
+{
+  vl_api_ikev2_set_worker_pool_reply_t *rmp;
+  int rv = 0;
+  clib_error_t *error;
+
+  error = ikev2_set_worker_pool (mp->enable);
+  if (error)
+    {
+      ikev2_log_error ("%U", format_clib_error, error);
+      clib_error_free (error);
+      rv = VNET_API_ERROR_UNSPECIFIED;
+    }
+  REPLY_MACRO (VL_API_IKEV2_SET_WORKER_POOL_REPLY);
+}
+
 static void
 vl_api_ikev2_profile_add_del_t_handler (vl_api_ikev2_profile_add_del_t * mp)
 {
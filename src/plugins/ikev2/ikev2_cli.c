@@ -714,6 +714,34 @@ VLIB_CLI_COMMAND (set_ikev2_liveness_command, static) = {
 };
 /* *INDENT-ON* */
 
+static clib_error_t *
+set_ikev2_worker_pool_fn (vlib_main_t *vm, unformat_input_t *input,
+			  vlib_cli_command_t *cmd)
+{
+  unformat_input_t _line_input, *line_input = &_line_input;
+  clib_error_t *r = 0;
+
+  if (!unformat_user (input, unformat_line_input, line_input))
+    return 0;
+
+  if (unformat (line_input, "enable"))
+    r = ikev2_set_worker_pool (1);
+  else if (unformat (line_input, "disable"))
+    r = ikev2_set_worker_pool (0);
+  else
+    r = clib_error_return (0, "parse error: '%U'", format_unformat_error,
+			   line_input);
+
+  unformat_free (line_input);
+  return r;
+}
+
+VLIB_CLI_COMMAND (set_ikev2_worker_pool_command, static) = {
+  .path = "ikev2 set worker-pool",
+  .short_help = "ikev2 set worker-pool <enable|disable>",
+  .function = set_ikev2_worker_pool_fn,
+};
+
 static clib_error_t *
 set_ikev2_local_key_command_fn (vlib_main_t * vm,
 				unformat_input_t * input,
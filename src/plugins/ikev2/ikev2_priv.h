@@ -18,6 +18,7 @@
 #include <vnet/vnet.h>
 #include <vnet/ip/ip.h>
 #include <vnet/ethernet/ethernet.h>
+#include <vnet/ipsec/ipsec_sa.h>
 
 #include <plugins/ikev2/ikev2.h>
 
@@ -472,6 +473,48 @@ typedef struct
 } ikev2_sa_t;
 
 
+typedef struct
+{
+  u32 sw_if_index;
+  u32 salt_local;
+  u32 salt_remote;
+  u32 local_sa_id;
+  u32 remote_sa_id;
+  ipsec_sa_flags_t flags;
+  u32 local_spi;
+  u32 remote_spi;
+  ipsec_crypto_alg_t encr_type;
+  ipsec_integ_alg_t integ_type;
+  ip_address_t local_ip;
+  ip_address_t remote_ip;
+  ipsec_key_t loc_ckey, rem_ckey, loc_ikey, rem_ikey;
+  u8 is_rekey;
+  u32 old_remote_sa_id;
+  u16 ipsec_over_udp_port;
+  u16 src_port;
+  u16 dst_port;
+} ikev2_add_ipsec_tunnel_args_t;
+
+typedef struct
+{
+  ip46_address_t local_ip;
+  ip46_address_t remote_ip;
+  u32 remote_sa_id;
+  u32 local_sa_id;
+  u32 sw_if_index;
+} ikev2_del_ipsec_tunnel_args_t;
+
+/* child SA tunnel change waiting to be installed by the main thread */
+typedef struct
+{
+  u8 is_add;
+  union
+  {
+    ikev2_add_ipsec_tunnel_args_t add;
+    ikev2_del_ipsec_tunnel_args_t del;
+  };
+} ikev2_tunnel_op_t;
+
 typedef struct
 {
   CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
@@ -482,6 +525,9 @@ typedef struct
   /* hash */
   uword *sa_by_rspi;
 
+  /* tunnel changes queued for the next batch install */
+  ikev2_tunnel_op_t *tunnel_ops;
+
   EVP_CIPHER_CTX *evp_ctx;
   HMAC_CTX *hmac_ctx;
 #if OPENSSL_VERSION_NUMBER < 0x10100000L
@@ -548,6 +594,12 @@ typedef struct
   /* punt handle for IPsec NATT IPSEC_PUNT_IP4_SPI_UDP_0 reason */
   vlib_punt_hdl_t punt_hdl;
 
+  /* spread IKE processing over the workers by peer address */
+  u8 worker_pool_enabled;
+  u32 handoff_ip4_fq_index;
+  u32 handoff_ip4_natt_fq_index;
+  u32 handoff_ip6_fq_index;
+
 } ikev2_main_t;
 
 extern ikev2_main_t ikev2_main;
@@ -145,6 +145,22 @@ lcp_get_del_dynamic_on_link_down (void)
   return lcpm->del_dynamic_on_link_down;
 }
 
+void
+lcp_set_tap_io_uring (u8 is_io_uring)
+{
+  lcp_main_t *lcpm = &lcp_main;
+
+  lcpm->tap_io_uring = (is_io_uring != 0);
+}
+
+u8
+lcp_get_tap_io_uring (void)
+{
+  lcp_main_t *lcpm = &lcp_main;
+
+  return lcpm->tap_io_uring;
+}
+
 void
 lcp_set_netlink_processing_active (u8 is_processing)
 {
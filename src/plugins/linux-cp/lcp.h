@@ -28,6 +28,7 @@ typedef struct lcp_main_s
   u8 lcp_sync;	      /* Automatically sync VPP changes to LCP */
   u8 del_static_on_link_down;  /* Delete static routes when link goes down */
   u8 del_dynamic_on_link_down; /* Delete dynamic routes when link goes down */
+  u8 tap_io_uring;	       /* Create host taps with the io_uring backend */
   u8 test_mode;	      /* Set when Unit testing */
   u8 netlink_processing_active; /* Set while a batch of Netlink messages are
 				   being processed */
@@ -54,6 +55,12 @@ u8 lcp_get_del_static_on_link_down (void);
 void lcp_set_del_dynamic_on_link_down (u8 is_del);
 u8 lcp_get_del_dynamic_on_link_down (void);
 
+/**
+ * Get/Set whether host taps use io_uring instead of vhost-net.
+ */
+void lcp_set_tap_io_uring (u8 is_io_uring);
+u8 lcp_get_tap_io_uring (void);
+
 /**
  * Get/Set when we're processing a batch of netlink messages.
  * This is used to avoid looping messages between lcp-sync and netlink.
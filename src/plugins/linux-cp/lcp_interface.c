@@ -138,6 +138,8 @@ lcp_itf_pair_show (u32 phy_sw_if_index)
 		   lcp_get_del_static_on_link_down () ? "on" : "off");
   vlib_cli_output (vm, "lcp del-dynamic-on-link-down %s\n",
 		   lcp_get_del_dynamic_on_link_down () ? "on" : "off");
+  vlib_cli_output (vm, "lcp tap-io-uring %s\n",
+		   lcp_get_tap_io_uring () ? "on" : "off");
 
   if (phy_sw_if_index == ~0)
     {
@@ -579,6 +581,8 @@ lcp_itf_pair_config (vlib_main_t *vm, unformat_input_t *input)
 	lcp_set_del_static_on_link_down (1 /* is_del */);
       else if (unformat (input, "del-dynamic-on-link-down"))
 	lcp_set_del_dynamic_on_link_down (1 /* is_del */);
+      else if (unformat (input, "tap-io-uring"))
+	lcp_set_tap_io_uring (1 /* is_io_uring */);
       else
 	return clib_error_return (0, "interfaces not found");
     }
@@ -1002,6 +1006,9 @@ lcp_itf_pair_create (u32 phy_sw_if_index, u8 *host_if_name,
       ethernet_interface_t *ei;
       u32 host_sw_mtu_size;
 
+      if (lcp_get_tap_io_uring ())
+	args.tap_flags |= TAP_FLAG_IO_URING;
+
       if (host_if_type == LCP_ITF_HOST_TUN)
 	args.tap_flags |= TAP_FLAG_TUN;
       else
@@ -320,6 +320,12 @@ format_memif_queue (u8 * s, va_list * args)
 		mq->ring->head, mq->ring->tail, mq->ring->flags,
 		mq->int_count);
 
+  if (mq->ring && mq->buffers && mq->type == MEMIF_RING_M2S)
+    s = format (s, "%Uzero-copy posted %u limit %u min %u\n",
+		format_white_space, indent + 4,
+		(u16) (mq->ring->head - mq->last_tail), mq->zc_posted_limit,
+		clib_min (1 << mq->log2_ring_size, MEMIF_ZC_MIN_POSTED));
+
   return s;
 }
 
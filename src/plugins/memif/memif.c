@@ -634,6 +634,8 @@ memif_init_regions_and_queues (memif_if_t * mif)
       mq->offset = (void *) mq->ring - (void *) mif->regions[mq->region].shm;
       mq->last_head = 0;
       mq->type = MEMIF_RING_M2S;
+      mq->zc_posted_limit =
+	clib_min (1 << mq->log2_ring_size, MEMIF_ZC_MIN_POSTED);
       if (mif->flags & MEMIF_IF_FLAG_ZERO_COPY)
 	vec_validate_aligned (mq->buffers, 1 << mq->log2_ring_size,
 			      CLIB_CACHE_LINE_BYTES);
@@ -765,7 +765,8 @@ memif_device_input_zc_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
   u32 thread_index = vm->thread_index;
   memif_per_thread_data_t *ptd = vec_elt_at_index (mm->per_thread_data,
 						   thread_index);
-  u16 cur_slot, last_slot, ring_size, n_slots, mask, head;
+  u16 cur_slot, last_slot, ring_size, n_slots, mask, head, limit;
+  u16 n_used = 0;
   i16 start_offset;
   u64 offset;
   u32 buffer_length;
@@ -838,6 +839,7 @@ memif_device_input_zc_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
     }
 
   /* release slots from the ring */
+  n_used = cur_slot - mq->last_tail;
   mq->last_tail = cur_slot;
 
   n_from = n_rx_packets;
@@ -987,7 +989,22 @@ refill:
   vec_reset_length (ptd->buffers);
 
   head = ring->head;
-  n_slots = ring_size - head + mq->last_tail;
+
+  /* Post only as many buffers as the master fills between two polls, so
+   * large rings do not keep thousands of cold buffers out of the pool.
+   * Double the limit when the master used up everything posted, back off
+   * slowly while it leaves most of them untouched. */
+  limit = mq->zc_posted_limit;
+  if (n_used && last_slot == head)
+    limit = clib_min (ring_size, 2 * limit);
+  else if (n_used * 8 < limit)
+    limit = clib_max (clib_min (ring_size, MEMIF_ZC_MIN_POSTED),
+		      limit - (limit >> 8));
+  mq->zc_posted_limit = limit;
+
+  n_slots = limit - (u16) (head - mq->last_tail);
+  if ((i16) n_slots <= 0)
+    goto done;
   slot = head & mask;
 
   n_slots &= ~7;
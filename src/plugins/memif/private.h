@@ -30,6 +30,9 @@
 #define MEMIF_MAX_REGION		256
 #define MEMIF_MAX_LOG2_RING_SIZE	14
 
+/* zero-copy rx never posts fewer buffers than this (or the ring size) */
+#define MEMIF_ZC_MIN_POSTED (2 * VLIB_FRAME_SIZE)
+
 
 #define memif_log_debug(dev, f, ...) do {                               \
   memif_if_t *_dev = (memif_if_t *) dev;                                \
@@ -140,6 +143,8 @@ typedef struct
   u16 last_tail;
   u32 *buffers;
   u8 buffer_pool_index;
+  /* zero-copy rx: buffers kept posted on the ring, adapts to the load */
+  u16 zc_posted_limit;
 
   /* dma data */
   u16 dma_head;
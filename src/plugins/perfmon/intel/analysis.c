@@ -0,0 +1,314 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2024 Cisco Systems, Inc.
+ */
+
+#include <vnet/vnet.h>
+#include <vppinfra/format_table.h>
+#include <perfmon/perfmon.h>
+#include <perfmon/intel/core.h>
+
+/*
+ * Per node bottleneck report. Not all of the events needed fit on the
+ * counters at once, so the node bundles below are run one after the
+ * other for the same duration and their per node totals combined.
+ */
+
+typedef enum
+{
+  PERFMON_ANALYSIS_TOPDOWN,
+  PERFMON_ANALYSIS_BACKEND,
+  PERFMON_ANALYSIS_INST_AND_CLOCK,
+  PERFMON_ANALYSIS_CACHE,
+  PERFMON_ANALYSIS_N_PHASES,
+} perfmon_analysis_phase_t;
+
+static char *perfmon_analysis_bundles[PERFMON_ANALYSIS_N_PHASES] = {
+  [PERFMON_ANALYSIS_TOPDOWN] = "td-level1",
+  [PERFMON_ANALYSIS_BACKEND] = "td-level2-backend",
+  [PERFMON_ANALYSIS_INST_AND_CLOCK] = "inst-and-clock",
+  [PERFMON_ANALYSIS_CACHE] = "cache-hierarchy",
+};
+
+typedef struct
+{
+  u32 node_index;
+  f64 lost_per_second;
+  f64 clocks_per_packet;
+  f64 ipc;
+  f64 retiring, bad_spec, fe_bound, mem_bound, core_bound;
+  f64 l1_miss, l2_miss, llc_miss;
+  char *bound;
+} perfmon_analysis_node_t;
+
+/* Node stats summed over threads, zero for nodes that did not run */
+static clib_error_t *
+perfmon_analysis_run (vlib_main_t *vm, perfmon_bundle_t *b, f64 duration,
+		      perfmon_node_stats_t **stats)
+{
+  perfmon_main_t *pm = &perfmon_main;
+  perfmon_thread_runtime_t *tr;
+  clib_error_t *err;
+
+  b->active_type = PERFMON_BUNDLE_TYPE_NODE;
+  if ((err = perfmon_start (vm, b)))
+    return err;
+
+  vlib_process_suspend (vm, duration);
+
+  if ((err = perfmon_stop (vm)))
+    return err;
+
+  vec_validate (stats[0], vec_len (vm->node_main.nodes) - 1);
+  vec_foreach (tr, pm->thread_runtimes)
+    for (int i = 0; i < tr->n_nodes && i < vec_len (stats[0]); i++)
+      {
+	perfmon_node_stats_t *ns = tr->node_stats + i, *s = stats[0] + i;
+	s->n_calls += ns->n_calls;
+	s->n_packets += ns->n_packets;
+	for (int j = 0; j < tr->n_events; j++)
+	  s->value[j] += ns->value[j];
+      }
+
+  perfmon_reset (vm);
+  return 0;
+}
+
+static_always_inline f64
+perfmon_analysis_ratio (f64 a, f64 b)
+{
+  return b > 0 ? a / b : -1;
+}
+
+static void
+perfmon_analysis_node (perfmon_analysis_node_t *r,
+		       perfmon_node_stats_t **stats, u32 node_index,
+		       f64 duration)
+{
+  perfmon_node_stats_t *ns;
+  f64 be = -1, worst = 0;
+
+  clib_memset (r, 0, sizeof (r[0]));
+  r->node_index = node_index;
+  r->clocks_per_packet = r->ipc = r->retiring = r->bad_spec = r->fe_bound =
+    r->mem_bound = r->core_bound = r->l1_miss = r->l2_miss = r->llc_miss = -1;
+  r->bound = "-";
+
+  ns = vec_elt_at_index (stats[PERFMON_ANALYSIS_TOPDOWN], node_index);
+  if (ns->n_calls)
+    {
+      r->retiring = intel_topdown_l1_ratio (ns, INTEL_TOPDOWN_RETIRING);
+      r->bad_spec = intel_topdown_l1_ratio (ns, INTEL_TOPDOWN_BAD_SPEC);
+      r->fe_bound = intel_topdown_l1_ratio (ns, INTEL_TOPDOWN_FE_BOUND);
+      be = intel_topdown_l1_ratio (ns, INTEL_TOPDOWN_BE_BOUND);
+      r->lost_per_second = ns->value[0] * (1 - r->retiring) / duration;
+    }
+
+  ns = vec_elt_at_index (stats[PERFMON_ANALYSIS_BACKEND], node_index);
+  if (ns->n_calls && be >= 0)
+    {
+      r->mem_bound = be * intel_topdown_mem_stall_ratio (ns);
+      r->core_bound = be - r->mem_bound;
+    }
+
+  ns = vec_elt_at_index (stats[PERFMON_ANALYSIS_INST_AND_CLOCK], node_index);
+  if (ns->n_calls)
+    {
+      /* inst-and-clock: instructions, clocks, reference clocks */
+      r->ipc = perfmon_analysis_ratio (ns->value[0], ns->value[1]);
+      r->clocks_per_packet =
+	perfmon_analysis_ratio (ns->value[1], ns->n_packets);
+    }
+
+  ns = vec_elt_at_index (stats[PERFMON_ANALYSIS_CACHE], node_index);
+  if (ns->n_calls)
+    {
+      /* cache-hierarchy: l1 hit, l1 miss, l2 miss, l3 miss loads */
+      r->l1_miss =
+	perfmon_analysis_ratio (ns->value[1], ns->value[0] + ns->value[1]);
+      r->l2_miss = perfmon_analysis_ratio (ns->value[2], ns->value[1]);
+      r->llc_miss = perfmon_analysis_ratio (ns->value[3], ns->value[2]);
+    }
+
+  /* the biggest share of non-retiring slots names the bottleneck */
+#define _(v, n)                                                               \
+  if (r->v > worst)                                                           \
+    {                                                                         \
+      worst = r->v;                                                           \
+      r->bound = n;                                                           \
+    }
+  _ (fe_bound, "frontend")
+  _ (bad_spec, "bad-speculation")
+  if (r->mem_bound >= 0)
+    {
+      _ (mem_bound, "memory")
+      _ (core_bound, "core")
+    }
+  else if (be > worst)
+    r->bound = "backend";
+#undef _
+}
+
+static int
+perfmon_analysis_sort (void *a1, void *a2)
+{
+  perfmon_analysis_node_t *r1 = a1, *r2 = a2;
+
+  return r1->lost_per_second < r2->lost_per_second ? 1 : -1;
+}
+
+static u8 *
+format_perfmon_analysis_value (u8 *s, va_list *args)
+{
+  f64 v = va_arg (*args, f64);
+  int percent = va_arg (*args, int);
+
+  if (v < 0)
+    return format (s, "-");
+  if (percent)
+    return format (s, "%.1f", v * 100);
+  return format (s, "%.2f", v);
+}
+
+static clib_error_t *
+perfmon_analyze_command_fn (vlib_main_t *vm, unformat_input_t *input,
+			    vlib_cli_command_t *cmd)
+{
+  perfmon_main_t *pm = &perfmon_main;
+  perfmon_node_stats_t *stats[PERFMON_ANALYSIS_N_PHASES] = {};
+  perfmon_analysis_node_t *nodes = 0, *r;
+  table_t table = {}, *t = &table;
+  clib_error_t *err = 0;
+  f64 duration = 1;
+  u32 n_top = 20;
+  int n_runs = 0;
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "duration %f", &duration))
+	;
+      else if (unformat (input, "top %u", &n_top))
+	;
+      else
+	return clib_error_return (0, "unknown input `%U'",
+				  format_unformat_error, input);
+    }
+
+  if (pm->is_running)
+    return clib_error_return (0, "please stop first");
+
+  if (duration <= 0)
+    return clib_error_return (0, "invalid duration");
+
+  for (int i = 0; i < PERFMON_ANALYSIS_N_PHASES; i++)
+    {
+      char *name = perfmon_analysis_bundles[i];
+      uword *p = hash_get_mem (pm->bundle_by_name, name);
+      perfmon_bundle_t *b = p ? (perfmon_bundle_t *) p[0] : 0;
+
+      if (b == 0 || (b->type_flags & 1 << PERFMON_BUNDLE_TYPE_NODE) == 0)
+	{
+	  vlib_cli_output (vm, "bundle '%s' not available, skipped", name);
+	  continue;
+	}
+
+      if ((err = perfmon_analysis_run (vm, b, duration, stats + i)))
+	{
+	  vlib_cli_output (vm, "bundle '%s': %U", name, format_clib_error,
+			   err);
+	  clib_error_free (err);
+	  continue;
+	}
+      n_runs++;
+    }
+
+  if (n_runs == 0)
+    {
+      err = clib_error_return (0, "no bundle could be run");
+      goto done;
+    }
+
+  /* nodes may have been added while the bundles ran */
+  for (int j = 0; j < PERFMON_ANALYSIS_N_PHASES; j++)
+    vec_validate (stats[j], vec_len (vm->node_main.nodes) - 1);
+
+  for (u32 i = 0; i < vec_len (vm->node_main.nodes); i++)
+    {
+      int ran = 0;
+      for (int j = 0; j < PERFMON_ANALYSIS_N_PHASES; j++)
+	ran |= stats[j][i].n_calls != 0;
+      if (!ran)
+	continue;
+      vec_add2 (nodes, r, 1);
+      perfmon_analysis_node (r, stats, i, duration);
+    }
+
+  vec_sort_with_function (nodes, perfmon_analysis_sort);
+
+  table_format_title (t, "Nodes by cycles lost to stalls and waste");
+  table_add_header_col (t, 13, "Node", "Lost Mclk/s", "Clk/Pkt", "IPC",
+			"% FE", "% BS", "% Mem", "% Core", "% RT", "% L1 Miss",
+			"% L2 Miss", "% LLC Miss", "Bound");
+
+  vec_foreach (r, nodes)
+    {
+      int row = r - nodes, c = 0;
+
+      if (row == n_top)
+	break;
+
+      table_format_cell (t, row, c++, "%U", format_vlib_node_name, vm,
+			 r->node_index);
+      table_format_cell (t, row, c++, "%.1f", r->lost_per_second * 1e-6);
+      table_format_cell (t, row, c++, "%U", format_perfmon_analysis_value,
+			 r->clocks_per_packet, 0);
+      table_format_cell (t, row, c++, "%U", format_perfmon_analysis_value,
+			 r->ipc, 0);
+#define _(v)                                                                  \
+  table_format_cell (t, row, c++, "%U", format_perfmon_analysis_value, r->v,  \
+		     1);
+      _ (fe_bound)
+      _ (bad_spec)
+      _ (mem_bound)
+      _ (core_bound)
+      _ (retiring)
+      _ (l1_miss)
+      _ (l2_miss)
+      _ (llc_miss)
+#undef _
+      table_format_cell (t, row, c++, "%s", r->bound);
+      for (int i = 1; i < c - 1; i++)
+	table_set_cell_align (t, row, i, TTAA_RIGHT);
+    }
+
+  vlib_cli_output (vm, "%U", format_table, t);
+  vlib_cli_output (vm,
+		   "FrontEnd (FE), Bad Speculation (BS), Memory (Mem) and "
+		   "Core bound and Retiring (RT)\n"
+		   "are shares of issue slots, miss rates are per load "
+		   "reaching that level");
+
+done:
+  table_free (t);
+  vec_free (nodes);
+  for (int i = 0; i < PERFMON_ANALYSIS_N_PHASES; i++)
+    vec_free (stats[i]);
+  return err;
+}
+
+/*?
+ * Run the td-level1, td-level2-backend, inst-and-clock and
+ * cache-hierarchy bundles one after the other, each for
+ * '<em>duration</em>' seconds (default 1), and report per node the
+ * top-down breakdown, IPC, clocks per packet and cache miss rates. Nodes
+ * are ranked by the cycles per second not spent retiring, with the
+ * largest top-down category named as the bottleneck.
+ *
+ * @cliexpar
+ * @cliexcmd{perfmon analyze duration 2 top 10}
+?*/
+VLIB_CLI_COMMAND (perfmon_analyze_command, static) = {
+  .path = "perfmon analyze",
+  .short_help = "perfmon analyze [duration <seconds>] [top <n>]",
+  .function = perfmon_analyze_command_fn,
+  .is_mp_safe = 1,
+};
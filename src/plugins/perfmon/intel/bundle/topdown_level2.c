@@ -0,0 +1,203 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2024 Cisco Systems, Inc.
+ */
+
+#include <vnet/vnet.h>
+#include <perfmon/perfmon.h>
+#include <perfmon/intel/core.h>
+
+/*
+ * Top-down level 1 and the level 2 memory / core split of backend bound,
+ * per node, from programmable events only. Unlike the perf metrics based
+ * topdown bundles these work on any core since Skylake, at the price of
+ * needing two runs; "perfmon analyze" runs them back to back. Cycles and
+ * instructions are scheduled on the fixed counters.
+ */
+
+enum
+{
+  TD_L1_THREAD = 0,
+  TD_L1_UOPS_ISSUED,
+  TD_L1_RETIRE_SLOTS,
+  TD_L1_NOT_DELIVERED,
+  TD_L1_RECOVERY_CYCLES,
+};
+
+enum
+{
+  TD_BE_THREAD = 0,
+  TD_BE_INST,
+  TD_BE_STALLS_TOTAL,
+  TD_BE_STALLS_MEM_ANY,
+  TD_BE_BOUND_ON_STORES,
+  TD_BE_STALLS_L3_MISS,
+};
+
+/* Issue slots per cycle, by core model: 6 from Golden Cove, 5 for Sunny
+ * and Willow Cove, 4 before. Hybrid parts report their P-core model. */
+static f64
+intel_topdown_width (void)
+{
+  static u8 width;
+  u32 eax, ebx, ecx, edx, model;
+
+  if (width)
+    return width;
+
+  width = 4;
+  if (clib_get_cpuid (1, &eax, &ebx, &ecx, &edx) == 0 ||
+      ((eax >> 8) & 0xf) != 6)
+    return width;
+
+  model = ((eax >> 4) & 0xf) | ((eax >> 12) & 0xf0);
+  switch (model)
+    {
+    case 0x6a: /* Ice Lake X */
+    case 0x6c: /* Ice Lake D */
+    case 0x7d: /* Ice Lake */
+    case 0x7e: /* Ice Lake L */
+    case 0x8c: /* Tiger Lake L */
+    case 0x8d: /* Tiger Lake */
+    case 0xa7: /* Rocket Lake */
+      width = 5;
+      break;
+    case 0x8f: /* Sapphire Rapids */
+    case 0x97: /* Alder Lake */
+    case 0x9a: /* Alder Lake L */
+    case 0xaa: /* Meteor Lake L */
+    case 0xac: /* Meteor Lake */
+    case 0xad: /* Granite Rapids */
+    case 0xae: /* Granite Rapids D */
+    case 0xb7: /* Raptor Lake */
+    case 0xba: /* Raptor Lake P */
+    case 0xbf: /* Raptor Lake S */
+    case 0xcf: /* Emerald Rapids */
+      width = 6;
+      break;
+    }
+
+  return width;
+}
+
+f64
+intel_topdown_l1_ratio (perfmon_node_stats_t *ns, intel_topdown_l1_t m)
+{
+  f64 w = intel_topdown_width ();
+  f64 slots = ns->value[TD_L1_THREAD] * w;
+  f64 fe, bs, rt;
+
+  if (slots == 0)
+    return 0;
+
+  fe = ns->value[TD_L1_NOT_DELIVERED] / slots;
+  rt = ns->value[TD_L1_RETIRE_SLOTS] / slots;
+  bs = ((f64) ns->value[TD_L1_UOPS_ISSUED] - ns->value[TD_L1_RETIRE_SLOTS] +
+	w * ns->value[TD_L1_RECOVERY_CYCLES]) /
+       slots;
+
+  /* counters are not read atomically, keep the ratios in range */
+  fe = clib_min (fe, 1.0);
+  rt = clib_min (rt, 1.0 - fe);
+  bs = clib_max (clib_min (bs, 1.0 - fe - rt), 0.0);
+
+  switch (m)
+    {
+    case INTEL_TOPDOWN_RETIRING:
+      return rt;
+    case INTEL_TOPDOWN_BAD_SPEC:
+      return bs;
+    case INTEL_TOPDOWN_FE_BOUND:
+      return fe;
+    case INTEL_TOPDOWN_BE_BOUND:
+      return 1.0 - fe - bs - rt;
+    }
+
+  return 0;
+}
+
+f64
+intel_topdown_mem_stall_ratio (perfmon_node_stats_t *ns)
+{
+  f64 stores = ns->value[TD_BE_BOUND_ON_STORES];
+  f64 stalls = ns->value[TD_BE_STALLS_TOTAL] + stores;
+
+  if (stalls == 0)
+    return 0;
+
+  return clib_min (1.0, (ns->value[TD_BE_STALLS_MEM_ANY] + stores) / stalls);
+}
+
+static u8 *
+format_topdown_level1 (u8 *s, va_list *args)
+{
+  perfmon_node_stats_t *ns = va_arg (*args, perfmon_node_stats_t *);
+  int row = va_arg (*args, int);
+
+  return format (s, "%.2f", intel_topdown_l1_ratio (ns, row) * 100);
+}
+
+PERFMON_REGISTER_BUNDLE (intel_core_topdown_level1) = {
+  .name = "td-level1",
+  .description = "Top-down level 1 per node, from programmable events",
+  .source = "intel-core",
+  .type = PERFMON_BUNDLE_TYPE_NODE,
+  .events[TD_L1_THREAD] = INTEL_CORE_E_CPU_CLK_UNHALTED_THREAD_P,
+  .events[TD_L1_UOPS_ISSUED] = INTEL_CORE_E_UOPS_ISSUED_ANY,
+  .events[TD_L1_RETIRE_SLOTS] = INTEL_CORE_E_UOPS_RETIRED_RETIRE_SLOTS,
+  .events[TD_L1_NOT_DELIVERED] = INTEL_CORE_E_IDQ_UOPS_NOT_DELIVERED_CORE,
+  .events[TD_L1_RECOVERY_CYCLES] = INTEL_CORE_E_INT_MISC_RECOVERY_CYCLES,
+  .n_events = 5,
+  .format_fn = format_topdown_level1,
+  .column_headers = PERFMON_STRINGS ("% RT", "% BS", "% FE", "% BE"),
+  .footer = "Retiring (RT), Bad Speculation (BS),\n"
+	    " FrontEnd bound (FE), BackEnd bound (BE)",
+};
+
+static u8 *
+format_topdown_level2_backend (u8 *s, va_list *args)
+{
+  perfmon_node_stats_t *ns = va_arg (*args, perfmon_node_stats_t *);
+  int row = va_arg (*args, int);
+  f64 clocks = ns->value[TD_BE_THREAD];
+
+  if (clocks == 0)
+    return s;
+
+  switch (row)
+    {
+    case 0:
+      s = format (s, "%.2f", ns->value[TD_BE_INST] / clocks);
+      break;
+    case 1:
+      s = format (s, "%.2f", ns->value[TD_BE_STALLS_TOTAL] / clocks * 100);
+      break;
+    case 2:
+      s = format (s, "%.2f", intel_topdown_mem_stall_ratio (ns) * 100);
+      break;
+    case 3:
+      s = format (s, "%.2f", (1 - intel_topdown_mem_stall_ratio (ns)) * 100);
+      break;
+    case 4:
+      s = format (s, "%.2f", ns->value[TD_BE_STALLS_L3_MISS] / clocks * 100);
+      break;
+    }
+
+  return s;
+}
+
+PERFMON_REGISTER_BUNDLE (intel_core_topdown_level2_backend) = {
+  .name = "td-level2-backend",
+  .description = "Backend stalls split into memory and core bound per node",
+  .source = "intel-core",
+  .type = PERFMON_BUNDLE_TYPE_NODE,
+  .events[TD_BE_THREAD] = INTEL_CORE_E_CPU_CLK_UNHALTED_THREAD_P,
+  .events[TD_BE_INST] = INTEL_CORE_E_INST_RETIRED_ANY_P,
+  .events[TD_BE_STALLS_TOTAL] = INTEL_CORE_E_CYCLE_ACTIVITY_STALLS_TOTAL,
+  .events[TD_BE_STALLS_MEM_ANY] = INTEL_CORE_E_CYCLE_ACTIVITY_STALLS_MEM_ANY,
+  .events[TD_BE_BOUND_ON_STORES] = INTEL_CORE_E_EXE_ACTIVITY_BOUND_ON_STORES,
+  .events[TD_BE_STALLS_L3_MISS] = INTEL_CORE_E_CYCLE_ACTIVITY_STALLS_L3_MISS,
+  .n_events = 6,
+  .format_fn = format_topdown_level2_backend,
+  .column_headers = PERFMON_STRINGS ("IPC", "% Stalled", "% Stalls Mem",
+				     "% Stalls Core", "% L3 Miss Stalled"),
+};
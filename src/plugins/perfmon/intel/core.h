@@ -287,4 +287,16 @@ typedef enum
       INTEL_CORE_N_EVENTS,
 } perf_intel_core_event_t;
 
+typedef enum
+{
+  INTEL_TOPDOWN_RETIRING,
+  INTEL_TOPDOWN_BAD_SPEC,
+  INTEL_TOPDOWN_FE_BOUND,
+  INTEL_TOPDOWN_BE_BOUND,
+} intel_topdown_l1_t;
+
+/* td-level1 and td-level2-backend node stats to ratios */
+f64 intel_topdown_l1_ratio (perfmon_node_stats_t *ns, intel_topdown_l1_t m);
+f64 intel_topdown_mem_stall_ratio (perfmon_node_stats_t *ns);
+
 #endif
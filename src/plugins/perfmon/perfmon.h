@@ -274,6 +274,8 @@ perfmon_cpu_update_bundle_type (perfmon_bundle_t *b)
 void perfmon_reset (vlib_main_t *vm);
 clib_error_t *perfmon_start (vlib_main_t *vm, perfmon_bundle_t *);
 clib_error_t *perfmon_stop (vlib_main_t *vm);
+clib_error_t *perfmon_profile_start (vlib_main_t *vm, u32 frequency);
+void perfmon_profile_stop (vlib_main_t *vm);
 
 #define PERFMON_STRINGS(...)                                                  \
   (char *[]) { __VA_ARGS__, 0 }
@@ -0,0 +1,820 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2024 Cisco Systems, Inc.
+ */
+
+#include <vnet/vnet.h>
+#include <vlib/stats/stats.h>
+#include <vppinfra/elf_clib.h>
+#include <vppinfra/mhash.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include <perfmon/perfmon.h>
+
+/*
+ * Continuous sampling profiler. Each vlib thread gets a sampling perf
+ * event with an mmap ring. The kernel writes one record per sample,
+ * carrying the interrupted user address and a user call chain, either from
+ * the LBR call stack or from frame pointers. A process node drains the
+ * rings, every drain interval or as soon as a ring is half full, attributes
+ * every sample to the innermost node function found on its stack and folds
+ * the stack, from that node function to the leaf, into a per-thread table.
+ */
+
+#define PERFMON_PROFILE_MAX_DEPTH	32
+#define PERFMON_PROFILE_MAX_LBR		32
+#define PERFMON_PROFILE_MAX_STACKS	(1 << 16)
+#define PERFMON_PROFILE_MIN_RING_PAGES	8
+#define PERFMON_PROFILE_MAX_RING_PAGES	512
+#define PERFMON_PROFILE_DRAIN_INTERVAL	0.1
+#define PERFMON_PROFILE_EXPORT_INTERVAL 1.0
+
+#define foreach_perfmon_profile_mode                                          \
+  _ (LBR, "precise cycles, lbr call stack")                                   \
+  _ (CYCLES, "cycles, frame pointer call chain")                              \
+  _ (CLOCK, "cpu-clock, frame pointer call chain")
+
+typedef enum
+{
+#define _(n, s) PERFMON_PROFILE_MODE_##n,
+  foreach_perfmon_profile_mode
+#undef _
+    PERFMON_PROFILE_N_MODES,
+} perfmon_profile_mode_t;
+
+typedef struct
+{
+  /* Leaf first, up to and including the node function frame */
+  u64 *frames;
+  u32 node_index;
+  u32 row;
+  u64 n_samples;
+  u64 n_exported;
+} perfmon_profile_stack_t;
+
+typedef struct
+{
+  int fd;
+  u32 clib_file_index;
+  struct perf_event_mmap_page *mmap_page;
+  perfmon_profile_stack_t *stacks;
+  mhash_t stack_index_by_key;
+  u8 *key;
+  u8 *record;
+  u64 n_samples;
+  u64 n_unknown;
+  u64 n_lost;
+  u64 n_dropped;
+} perfmon_profile_thread_t;
+
+typedef struct
+{
+  perfmon_profile_thread_t *threads;
+  perfmon_profile_mode_t mode;
+  u8 is_running;
+  u32 frequency;
+
+  /* Data pages of each ring, in bytes */
+  uword ring_size;
+
+  /* Node function address to node index */
+  uword *node_by_function;
+
+  /* Sampled address to node index, ~0 if not in a node function */
+  uword *node_by_address;
+
+  /* Sampled address to symbol name, a C string vector */
+  uword *name_by_address;
+
+  /* Stats segment: samples per thread and node, folded stacks */
+  vlib_simple_counter_main_t node_samples;
+  vlib_stats_string_vector_t stacks;
+  u32 n_rows;
+  f64 last_export;
+} perfmon_profile_main_t;
+
+static perfmon_profile_main_t perfmon_profile_main;
+
+static char *perfmon_profile_mode_names[] = {
+#define _(n, s) s,
+  foreach_perfmon_profile_mode
+#undef _
+};
+
+vlib_node_registration_t perfmon_profile_process_node;
+
+/*
+ * Size the ring for two drain intervals of samples at the given frequency,
+ * within bounds. Past the upper bound the half full wakeups keep up.
+ */
+static uword
+perfmon_profile_ring_size (perfmon_profile_mode_t mode, u32 frequency)
+{
+  uword page_size = clib_mem_get_page_size ();
+  /* header, ip, chain length, frames and some context markers */
+  uword sample_size = 8 * (3 + PERFMON_PROFILE_MAX_DEPTH + 4);
+  uword n_pages;
+
+  if (mode == PERFMON_PROFILE_MODE_LBR)
+    sample_size +=
+      8 + PERFMON_PROFILE_MAX_LBR * sizeof (struct perf_branch_entry);
+
+  n_pages = 2 * frequency * PERFMON_PROFILE_DRAIN_INTERVAL * sample_size /
+	    page_size;
+  n_pages = clib_clamp (n_pages, PERFMON_PROFILE_MIN_RING_PAGES,
+			PERFMON_PROFILE_MAX_RING_PAGES);
+
+  /* the kernel wants a power of 2 data pages */
+  return page_size << max_log2 (n_pages);
+}
+
+static int
+perfmon_profile_open (perfmon_profile_mode_t mode, u32 frequency, int pid,
+		      uword ring_size)
+{
+  struct perf_event_attr pe = {
+    .size = sizeof (struct perf_event_attr),
+    .type = PERF_TYPE_HARDWARE,
+    .config = PERF_COUNT_HW_CPU_CYCLES,
+    .sample_freq = frequency,
+    .freq = 1,
+    .sample_type = PERF_SAMPLE_IP | PERF_SAMPLE_CALLCHAIN,
+    .sample_max_stack = PERFMON_PROFILE_MAX_DEPTH,
+    .exclude_kernel = 1,
+    .exclude_hv = 1,
+    .exclude_callchain_kernel = 1,
+    .disabled = 1,
+    .watermark = 1,
+    .wakeup_watermark = ring_size / 2,
+  };
+
+  if (mode == PERFMON_PROFILE_MODE_LBR)
+    {
+      pe.precise_ip = 2;
+      pe.sample_type |= PERF_SAMPLE_BRANCH_STACK;
+      pe.branch_sample_type =
+	PERF_SAMPLE_BRANCH_USER | PERF_SAMPLE_BRANCH_CALL_STACK;
+    }
+  else if (mode == PERFMON_PROFILE_MODE_CLOCK)
+    {
+      pe.type = PERF_TYPE_SOFTWARE;
+      pe.config = PERF_COUNT_SW_CPU_CLOCK;
+    }
+
+  return syscall (__NR_perf_event_open, &pe, pid, /* cpu */ -1,
+		  /* group_fd */ -1, 0);
+}
+
+static void
+perfmon_profile_close (perfmon_profile_main_t *ppm)
+{
+  perfmon_profile_thread_t *pt;
+
+  vec_foreach (pt, ppm->threads)
+    {
+      if (pt->mmap_page)
+	munmap (pt->mmap_page, clib_mem_get_page_size () + ppm->ring_size);
+      if (pt->clib_file_index != ~0)
+	clib_file_del_by_index (&file_main, pt->clib_file_index);
+      else if (pt->fd >= 0)
+	close (pt->fd);
+      pt->mmap_page = 0;
+      pt->clib_file_index = ~0;
+      pt->fd = -1;
+    }
+}
+
+static void
+perfmon_profile_reset (perfmon_profile_main_t *ppm)
+{
+  perfmon_profile_thread_t *pt;
+  perfmon_profile_stack_t *st;
+  uword address;
+  u8 *name;
+
+  vec_foreach (pt, ppm->threads)
+    {
+      vec_foreach (st, pt->stacks)
+	vec_free (st->frames);
+      vec_free (pt->stacks);
+      mhash_free (&pt->stack_index_by_key);
+      vec_free (pt->key);
+      vec_free (pt->record);
+    }
+  vec_free (ppm->threads);
+
+  for (u32 i = 0; i < ppm->n_rows; i++)
+    vlib_stats_set_string_vector (&ppm->stacks, i, "");
+  ppm->n_rows = 0;
+
+  /* symbols may have moved with plugins loaded since */
+  hash_foreach (address, name, ppm->name_by_address, ({ vec_free (name); }));
+  hash_free (ppm->name_by_address);
+
+  vlib_clear_simple_counters (&ppm->node_samples);
+}
+
+static void
+perfmon_profile_add_node_functions (perfmon_profile_main_t *ppm,
+				    vlib_main_t *vm)
+{
+  vlib_node_main_t *nm = &vm->node_main;
+  vlib_node_fn_registration_t *r;
+
+  hash_free (ppm->node_by_function);
+  hash_free (ppm->node_by_address);
+
+  vec_foreach_pointer (n, nm->nodes)
+    {
+      if (n->function)
+	hash_set (ppm->node_by_function, pointer_to_uword (n->function),
+		  n->index);
+      for (r = n->node_fn_registrations; r; r = r->next_registration)
+	hash_set (ppm->node_by_function, pointer_to_uword (r->function),
+		  n->index);
+    }
+
+  vlib_validate_simple_counter (&ppm->node_samples, vec_len (nm->nodes) - 1);
+}
+
+/* Return addresses point past the call, look up the call itself */
+static_always_inline u64
+perfmon_profile_frame_address (u64 *frames, u32 i)
+{
+  return i ? frames[i] - 1 : frames[i];
+}
+
+static u32
+perfmon_profile_node_by_address (perfmon_profile_main_t *ppm, u64 address)
+{
+  clib_elf_symbol_t sym;
+  u32 node_index = ~0;
+  uword *p;
+
+  p = hash_get (ppm->node_by_address, address);
+  if (p)
+    return p[0];
+
+  if (clib_elf_symbol_by_address (address, &sym))
+    {
+      p = hash_get (ppm->node_by_function, sym.symbol.value);
+      if (p)
+	node_index = p[0];
+    }
+
+  hash_set (ppm->node_by_address, address, node_index);
+  return node_index;
+}
+
+static u8 *
+format_perfmon_profile_frame (u8 *s, va_list *args)
+{
+  perfmon_profile_main_t *ppm = va_arg (*args, perfmon_profile_main_t *);
+  u64 address = va_arg (*args, u64);
+  clib_elf_symbol_t sym;
+  uword *p;
+  u8 *name;
+
+  p = hash_get (ppm->name_by_address, address);
+  if (p)
+    return format (s, "%s", (char *) p[0]);
+
+  if (clib_elf_symbol_by_address (address, &sym))
+    name = format (0, "%s%c", clib_elf_symbol_name (&sym), 0);
+  else
+    name = format (0, "0x%lx%c", address, 0);
+
+  hash_set (ppm->name_by_address, address, pointer_to_uword (name));
+  return format (s, "%s", name);
+}
+
+static u8 *
+format_perfmon_profile_stack (u8 *s, va_list *args)
+{
+  perfmon_profile_main_t *ppm = va_arg (*args, perfmon_profile_main_t *);
+  vlib_main_t *vm = va_arg (*args, vlib_main_t *);
+  u32 thread_index = va_arg (*args, u32);
+  perfmon_profile_stack_t *st = va_arg (*args, perfmon_profile_stack_t *);
+
+  s = format (s, "%s;", vlib_worker_threads[thread_index].name);
+
+  if (st->node_index == ~0)
+    s = format (s, "[unknown]");
+  else
+    s = format (s, "[%U]", format_vlib_node_name, vm, st->node_index);
+
+  for (int i = vec_len (st->frames) - 1; i >= 0; i--)
+    s = format (s, ";%U", format_perfmon_profile_frame, ppm,
+		perfmon_profile_frame_address (st->frames, i));
+
+  return format (s, " %llu", st->n_samples);
+}
+
+static void
+perfmon_profile_sample (perfmon_profile_main_t *ppm, u32 thread_index,
+			u64 *p, u64 *end)
+{
+  perfmon_profile_thread_t *pt = vec_elt_at_index (ppm->threads, thread_index);
+  u64 frames[PERFMON_PROFILE_MAX_DEPTH];
+  u32 n_frames = 0, node_index = ~0, i;
+  perfmon_profile_stack_t *st;
+  u64 nr, ip;
+  uword *h;
+
+  if (end - p < 2)
+    return;
+
+  ip = *p++;
+  frames[n_frames++] = ip;
+
+  /* user call chain, context markers and the sampled address skipped */
+  nr = *p++;
+  nr = clib_min (nr, (u64) (end - p));
+  for (i = 0; i < nr && n_frames < PERFMON_PROFILE_MAX_DEPTH; i++)
+    if (p[i] < (u64) PERF_CONTEXT_MAX && (n_frames > 1 || p[i] != ip))
+      frames[n_frames++] = p[i];
+  p += nr;
+
+  /* lbr call stack, if present, replaces the frame pointer chain */
+  if (ppm->mode == PERFMON_PROFILE_MODE_LBR && p < end && p[0])
+    {
+      struct perf_branch_entry *be = (struct perf_branch_entry *) (p + 1);
+      nr = clib_min (p[0], (u64) (end - p - 1) / (sizeof (be[0]) / 8));
+      /* call sites, stored as return addresses like the chain above */
+      for (i = 0, n_frames = 1;
+	   i < nr && n_frames < PERFMON_PROFILE_MAX_DEPTH; i++)
+	frames[n_frames++] = be[i].from + 1;
+    }
+
+  for (i = 0; i < n_frames; i++)
+    {
+      u64 a = perfmon_profile_frame_address (frames, i);
+      node_index = perfmon_profile_node_by_address (ppm, a);
+      if (node_index != ~0)
+	{
+	  n_frames = i + 1;
+	  break;
+	}
+    }
+
+  pt->n_samples++;
+  if (node_index == ~0)
+    pt->n_unknown++;
+  else
+    vlib_increment_simple_counter (&ppm->node_samples, thread_index,
+				   node_index, 1);
+
+  vec_reset_length (pt->key);
+  vec_add (pt->key, (u8 *) &node_index, sizeof (node_index));
+  vec_add (pt->key, (u8 *) frames, n_frames * sizeof (frames[0]));
+
+  h = mhash_get (&pt->stack_index_by_key, pt->key);
+  if (h)
+    {
+      pt->stacks[h[0]].n_samples++;
+      return;
+    }
+
+  if (vec_len (pt->stacks) >= PERFMON_PROFILE_MAX_STACKS)
+    {
+      pt->n_dropped++;
+      return;
+    }
+
+  vec_add2 (pt->stacks, st, 1);
+  vec_add (st->frames, frames, n_frames);
+  st->node_index = node_index;
+  st->row = ~0;
+  st->n_samples = 1;
+  mhash_set_mem (&pt->stack_index_by_key, pt->key,
+		 &(uword){ st - pt->stacks }, 0);
+}
+
+static void
+perfmon_profile_drain (perfmon_profile_main_t *ppm, u32 thread_index)
+{
+  perfmon_profile_thread_t *pt = vec_elt_at_index (ppm->threads, thread_index);
+  struct perf_event_mmap_page *mp = pt->mmap_page;
+  u8 *data = (u8 *) mp + mp->data_offset;
+  u64 size = mp->data_size, head, tail;
+
+  head = __atomic_load_n (&mp->data_head, __ATOMIC_ACQUIRE);
+  tail = mp->data_tail;
+
+  while (tail < head)
+    {
+      struct perf_event_header *h;
+      u64 offset = tail & (size - 1);
+      u8 *r = data + offset;
+      u16 len;
+
+      /* records are 8 byte aligned, the header never wraps */
+      len = ((struct perf_event_header *) r)->size;
+      if (len < sizeof (h[0]) || tail + len > head)
+	break;
+
+      if (offset + len > size)
+	{
+	  vec_validate (pt->record, len - 1);
+	  clib_memcpy_fast (pt->record, r, size - offset);
+	  clib_memcpy_fast (pt->record + size - offset, data,
+			    len - (size - offset));
+	  r = pt->record;
+	}
+
+      h = (struct perf_event_header *) r;
+      if (h->type == PERF_RECORD_SAMPLE)
+	perfmon_profile_sample (ppm, thread_index, (u64 *) (h + 1),
+				(u64 *) (r + len));
+      else if (h->type == PERF_RECORD_LOST)
+	/* u64 id, u64 lost */
+	pt->n_lost += ((u64 *) (h + 1))[1];
+
+      tail += len;
+    }
+
+  __atomic_store_n (&mp->data_tail, head, __ATOMIC_RELEASE);
+}
+
+static clib_error_t *
+perfmon_profile_read_ready (clib_file_t *f)
+{
+  /* a ring is half full, drain now rather than at the next interval */
+  vlib_process_signal_event (vlib_get_main (),
+			     perfmon_profile_process_node.index, 0, 0);
+  return 0;
+}
+
+static void
+perfmon_profile_export (perfmon_profile_main_t *ppm, vlib_main_t *vm)
+{
+  perfmon_profile_thread_t *pt;
+  perfmon_profile_stack_t *st;
+  u8 *s = 0;
+
+  vec_foreach (pt, ppm->threads)
+    vec_foreach (st, pt->stacks)
+      {
+	if (st->n_samples == st->n_exported)
+	  continue;
+	if (st->row == ~0)
+	  st->row = ppm->n_rows++;
+	vec_reset_length (s);
+	s = format (s, "%U%c", format_perfmon_profile_stack, ppm, vm,
+		    pt - ppm->threads, st, 0);
+	vlib_stats_set_string_vector (&ppm->stacks, st->row, "%s", s);
+	st->n_exported = st->n_samples;
+      }
+
+  vec_free (s);
+  ppm->last_export = vlib_time_now (vm);
+}
+
+static void
+perfmon_profile_collect (perfmon_profile_main_t *ppm, vlib_main_t *vm)
+{
+  for (u32 i = 0; i < vec_len (ppm->threads); i++)
+    if (ppm->threads[i].mmap_page)
+      perfmon_profile_drain (ppm, i);
+
+  if (vlib_time_now (vm) - ppm->last_export >= PERFMON_PROFILE_EXPORT_INTERVAL)
+    perfmon_profile_export (ppm, vm);
+}
+
+clib_error_t *
+perfmon_profile_start (vlib_main_t *vm, u32 frequency)
+{
+  perfmon_profile_main_t *ppm = &perfmon_profile_main;
+  uword page_size = clib_mem_get_page_size ();
+  perfmon_profile_mode_t mode = PERFMON_PROFILE_MODE_LBR;
+  perfmon_profile_thread_t *pt;
+  clib_error_t *err = 0;
+
+  if (ppm->is_running)
+    return clib_error_return (0, "profiler already running");
+
+  if (frequency == 0)
+    return clib_error_return (0, "invalid frequency");
+
+  perfmon_profile_reset (ppm);
+  perfmon_profile_add_node_functions (ppm, vm);
+
+  vec_validate (ppm->threads, vlib_get_n_threads () - 1);
+  vec_foreach (pt, ppm->threads)
+    {
+      pt->fd = -1;
+      pt->clib_file_index = ~0;
+      mhash_init_vec_string (&pt->stack_index_by_key, sizeof (uword));
+    }
+
+  vec_foreach (pt, ppm->threads)
+    {
+      int pid = vlib_worker_threads[pt - ppm->threads].lwp;
+      clib_file_t template = {
+	.read_function = perfmon_profile_read_ready,
+	.private_data = pt - ppm->threads,
+      };
+
+      /* first thread picks the best mode this cpu and kernel support */
+      while (1)
+	{
+	  ppm->ring_size = perfmon_profile_ring_size (mode, frequency);
+	  pt->fd = perfmon_profile_open (mode, frequency, pid, ppm->ring_size);
+	  if (pt->fd >= 0 || pt != ppm->threads ||
+	      mode + 1 == PERFMON_PROFILE_N_MODES || errno == EACCES ||
+	      errno == EPERM)
+	    break;
+	  mode++;
+	}
+
+      if (pt->fd < 0)
+	{
+	  err = clib_error_return_unix (0, "perf_event_open");
+	  goto error;
+	}
+
+      pt->mmap_page = mmap (0, page_size + ppm->ring_size,
+			    PROT_READ | PROT_WRITE, MAP_SHARED, pt->fd, 0);
+      if (pt->mmap_page == MAP_FAILED)
+	{
+	  pt->mmap_page = 0;
+	  err = clib_error_return_unix (0, "mmap");
+	  goto error;
+	}
+
+      template.file_descriptor = pt->fd;
+      template.description =
+	format (0, "perfmon profile thread %u", pt - ppm->threads);
+      pt->clib_file_index = clib_file_add (&file_main, &template);
+    }
+
+  vec_foreach (pt, ppm->threads)
+    if (ioctl (pt->fd, PERF_EVENT_IOC_ENABLE, 0) < 0)
+      {
+	err = clib_error_return_unix (0, "ioctl(PERF_EVENT_IOC_ENABLE)");
+	goto error;
+      }
+
+  ppm->mode = mode;
+  ppm->frequency = frequency;
+  ppm->is_running = 1;
+  ppm->last_export = vlib_time_now (vm);
+  vlib_process_signal_event (vm, perfmon_profile_process_node.index, 0, 0);
+  return 0;
+
+error:
+  perfmon_profile_close (ppm);
+  return err;
+}
+
+void
+perfmon_profile_stop (vlib_main_t *vm)
+{
+  perfmon_profile_main_t *ppm = &perfmon_profile_main;
+  perfmon_profile_thread_t *pt;
+
+  if (!ppm->is_running)
+    return;
+
+  vec_foreach (pt, ppm->threads)
+    ioctl (pt->fd, PERF_EVENT_IOC_DISABLE, 0);
+
+  for (u32 i = 0; i < vec_len (ppm->threads); i++)
+    perfmon_profile_drain (ppm, i);
+  perfmon_profile_export (ppm, vm);
+
+  perfmon_profile_close (ppm);
+  ppm->is_running = 0;
+}
+
+static uword
+perfmon_profile_process (vlib_main_t *vm, vlib_node_runtime_t *rt,
+			 vlib_frame_t *f)
+{
+  perfmon_profile_main_t *ppm = &perfmon_profile_main;
+  uword *event_data = 0;
+
+  while (1)
+    {
+      if (ppm->is_running)
+	vlib_process_wait_for_event_or_clock (vm,
+					      PERFMON_PROFILE_DRAIN_INTERVAL);
+      else
+	vlib_process_wait_for_event (vm);
+
+      vlib_process_get_events (vm, &event_data);
+      vec_reset_length (event_data);
+
+      if (ppm->is_running)
+	perfmon_profile_collect (ppm, vm);
+    }
+
+  return 0;
+}
+
+VLIB_REGISTER_NODE (perfmon_profile_process_node) = {
+  .function = perfmon_profile_process,
+  .type = VLIB_NODE_TYPE_PROCESS,
+  .name = "perfmon-profile-process",
+  .process_log2_n_stack_bytes = 17,
+};
+
+typedef struct
+{
+  u32 node_index;
+  u64 n_samples;
+} perfmon_profile_node_total_t;
+
+static int
+perfmon_profile_node_total_sort (void *a1, void *a2)
+{
+  perfmon_profile_node_total_t *t1 = a1, *t2 = a2;
+
+  return t1->n_samples < t2->n_samples ? 1 : -1;
+}
+
+static clib_error_t *
+perfmon_profile_command_fn (vlib_main_t *vm, unformat_input_t *input,
+			    vlib_cli_command_t *cmd)
+{
+  u32 frequency = 1000;
+  int stop = 0;
+
+  if (unformat (input, "start"))
+    unformat (input, "frequency %u", &frequency);
+  else if (unformat (input, "stop"))
+    stop = 1;
+  else
+    return clib_error_return (0, "unknown input `%U'", format_unformat_error,
+			      input);
+
+  if (stop)
+    {
+      perfmon_profile_stop (vm);
+      return 0;
+    }
+
+  return perfmon_profile_start (vm, frequency);
+}
+
+/*?
+ * Start or stop the sampling profiler. Every vlib thread is sampled
+ * '<em>frequency</em>' times per second (default 1000), using precise
+ * cycles with the LBR call stack where available, and cycles or the
+ * cpu-clock timer with frame pointer call chains otherwise. Samples are
+ * attributed to the innermost graph node function on the stack.
+ *
+ * @cliexpar
+ * @cliexcmd{perfmon profile start frequency 499}
+ * @cliexcmd{perfmon profile stop}
+?*/
+VLIB_CLI_COMMAND (perfmon_profile_command, static) = {
+  .path = "perfmon profile",
+  .short_help = "perfmon profile start [frequency <hz>] | stop",
+  .function = perfmon_profile_command_fn,
+};
+
+static clib_error_t *
+show_perfmon_profile_command_fn (vlib_main_t *vm, unformat_input_t *input,
+				 vlib_cli_command_t *cmd)
+{
+  perfmon_profile_main_t *ppm = &perfmon_profile_main;
+  perfmon_profile_thread_t *pt;
+  perfmon_profile_stack_t *st;
+  perfmon_profile_node_total_t *totals = 0, *t;
+  u32 thread_index = ~0;
+  char *file = 0;
+  int folded = 0;
+  clib_error_t *err = 0;
+  FILE *fp = 0;
+  u8 *s = 0;
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "thread %u", &thread_index))
+	;
+      else if (unformat (input, "folded"))
+	folded = 1;
+      else if (unformat (input, "file %s", &file))
+	folded = 1;
+      else
+	return clib_error_return (0, "unknown input `%U'",
+				  format_unformat_error, input);
+    }
+
+  if (ppm->is_running)
+    perfmon_profile_collect (ppm, vm);
+
+  if (folded)
+    {
+      if (file && (fp = fopen (file, "w")) == 0)
+	{
+	  err = clib_error_return_unix (0, "fopen '%s'", file);
+	  goto done;
+	}
+
+      vec_foreach (pt, ppm->threads)
+	{
+	  if (thread_index != ~0 && pt - ppm->threads != thread_index)
+	    continue;
+	  vec_foreach (st, pt->stacks)
+	    {
+	      vec_reset_length (s);
+	      s = format (s, "%U", format_perfmon_profile_stack, ppm, vm,
+			  pt - ppm->threads, st);
+	      if (fp)
+		fprintf (fp, "%.*s\n", vec_len (s), s);
+	      else
+		vlib_cli_output (vm, "%v", s);
+	    }
+	}
+      goto done;
+    }
+
+  vlib_cli_output (vm, "profiler %s, %u Hz, %s",
+		   ppm->is_running ? "running" : "stopped", ppm->frequency,
+		   perfmon_profile_mode_names[ppm->mode]);
+
+  vec_foreach (pt, ppm->threads)
+    {
+      if (thread_index != ~0 && pt - ppm->threads != thread_index)
+	continue;
+
+      vlib_cli_output (vm,
+		       "thread %u (%s): samples %llu unknown %llu lost %llu "
+		       "dropped %llu stacks %u",
+		       pt - ppm->threads,
+		       vlib_worker_threads[pt - ppm->threads].name,
+		       pt->n_samples, pt->n_unknown, pt->n_lost, pt->n_dropped,
+		       vec_len (pt->stacks));
+
+      if (pt->n_samples == 0)
+	continue;
+
+      /* one slot per node, unknown last, then the busiest nodes first */
+      vec_reset_length (totals);
+      vec_validate (totals, vec_len (ppm->node_samples.counters[0]));
+      vec_foreach (t, totals)
+	t->node_index = t - totals;
+      vec_foreach (st, pt->stacks)
+	vec_elt (totals, clib_min (st->node_index, vec_len (totals) - 1))
+	  .n_samples += st->n_samples;
+      vec_sort_with_function (totals, perfmon_profile_node_total_sort);
+
+      vec_foreach (t, totals)
+	{
+	  if (t - totals == 20 || t->n_samples == 0)
+	    break;
+	  vec_reset_length (s);
+	  if (t->node_index == vec_len (totals) - 1)
+	    s = format (s, "[unknown]");
+	  else
+	    s = format (s, "%U", format_vlib_node_name, vm, t->node_index);
+	  vlib_cli_output (vm, "  %6.2f%% %10llu  %v",
+			   100.0 * t->n_samples / pt->n_samples, t->n_samples,
+			   s);
+	}
+    }
+
+done:
+  if (fp)
+    fclose (fp);
+  vec_free (file);
+  vec_free (totals);
+  vec_free (s);
+  return err;
+}
+
+/*?
+ * Show the sampling profiler summary: samples per thread and the nodes
+ * taking the most samples. With '<em>folded</em>' every distinct stack is
+ * printed in the folded format flamegraph tools take, as
+ * thread;[node];function;...;leaf count. '<em>file</em>' writes the
+ * folded stacks to the given path instead. The same lines are exported
+ * in the stats segment as /perfmon/profile/stacks and per node sample
+ * counts as /perfmon/profile/samples.
+ *
+ * @cliexpar
+ * @cliexcmd{show perfmon profile}
+ * @cliexcmd{show perfmon profile folded file /tmp/vpp.folded}
+?*/
+VLIB_CLI_COMMAND (show_perfmon_profile_command, static) = {
+  .path = "show perfmon profile",
+  .short_help = "show perfmon profile [thread <n>] [folded] [file <path>]",
+  .function = show_perfmon_profile_command_fn,
+};
+
+static clib_error_t *
+perfmon_profile_init (vlib_main_t *vm)
+{
+  perfmon_profile_main_t *ppm = &perfmon_profile_main;
+
+  ppm->node_samples.name = "perfmon profile samples";
+  ppm->node_samples.stat_segment_name = "/perfmon/profile/samples";
+  ppm->stacks = vlib_stats_add_string_vector ("/perfmon/profile/stacks");
+
+  return 0;
+}
+
+VLIB_INIT_FUNCTION (perfmon_profile_init);
@@ -97,6 +97,92 @@ dump_counter_vector_combined (stat_segment_data_t *res, u8 *s, u8 used_only)
   return s;
 }
 
+static u8 *
+dump_gauge_vector (stat_segment_data_t *res, u8 *s, u8 used_only)
+{
+  u8 need_header = 1;
+  int j, k;
+  u8 *name;
+
+  name = make_stat_name (res->name);
+
+  for (k = 0; k < vec_len (res->simple_counter_vec); k++)
+    for (j = 0; j < vec_len (res->simple_counter_vec[k]); j++)
+      {
+	if (used_only && !res->simple_counter_vec[k][j])
+	  continue;
+	if (need_header)
+	  {
+	    s = format (s, "# TYPE %v gauge\n", name);
+	    need_header = 0;
+	  }
+	s = format (s, "%v{thread=\"%d\",index=\"%d\"} %lld\n", name, k, j,
+		    res->simple_counter_vec[k][j]);
+      }
+
+  return s;
+}
+
+static u8 *
+dump_histogram (stat_segment_data_t *res, u8 *s, u8 used_only)
+{
+  vlib_stats_histogram_t *h = res->histogram;
+  u64 *bins = 0, count, sum;
+  u8 need_header = 1;
+  int i, j, k;
+  u32 n_bins;
+  u8 *name;
+
+  if (h == 0 || vec_len (h->counters) == 0 || h->n_bins == 0)
+    return s;
+
+  n_bins = h->n_bins;
+
+  name = make_stat_name (res->name);
+  vec_validate (bins, n_bins - 1);
+
+  /* Threads are summed here, the data path only touches its own bins */
+  for (j = 0; j < vec_len (h->counters[0]) / n_bins; j++)
+    {
+      vec_zero (bins);
+      sum = 0;
+      for (k = 0; k < vec_len (h->counters); k++)
+	{
+	  for (i = 0; i < n_bins; i++)
+	    bins[i] += h->counters[k][j * n_bins + i];
+	  sum += h->sums[k][j];
+	}
+
+      count = 0;
+      for (i = 0; i < n_bins; i++)
+	count += bins[i];
+
+      if (used_only && !count)
+	continue;
+      if (need_header)
+	{
+	  s = format (s, "# TYPE %v histogram\n", name);
+	  need_header = 0;
+	}
+
+      count = 0;
+      for (i = 0; i < n_bins - 1; i++)
+	{
+	  count += bins[i];
+	  s = format (s, "%v_bucket{index=\"%d\",le=\"%llu\"} %llu\n", name, j,
+		      vlib_stats_histogram_bin_bound (res->type, h, i), count);
+	}
+      count += bins[n_bins - 1];
+      s = format (s, "%v_bucket{index=\"%d\",le=\"+Inf\"} %llu\n", name, j,
+		  count);
+      s = format (s, "%v_sum{index=\"%d\"} %llu\n", name, j, sum);
+      s = format (s, "%v_count{index=\"%d\"} %llu\n", name, j, count);
+    }
+
+  vec_free (bins);
+  return s;
+}
+
 static u8 *
 dump_scalar_index (stat_segment_data_t *res, u8 *s, u8 used_only)
 {
@@ -129,6 +215,47 @@ dump_name_vector (stat_segment_data_t *res, u8 *s, u8 used_only)
   return s;
 }
 
+static u8 *
+dump_stat_entry (stat_segment_data_t *res, u8 *s, u8 used_only)
+{
+  switch (res->type)
+    {
+    case STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE:
+      s = dump_counter_vector_simple (res, s, used_only);
+      break;
+
+    case STAT_DIR_TYPE_COUNTER_VECTOR_COMBINED:
+      s = dump_counter_vector_combined (res, s, used_only);
+      break;
+
+    case STAT_DIR_TYPE_GAUGE_VECTOR:
+      s = dump_gauge_vector (res, s, used_only);
+      break;
+
+    case STAT_DIR_TYPE_HISTOGRAM_LOG2:
+    case STAT_DIR_TYPE_HISTOGRAM_LINEAR:
+      s = dump_histogram (res, s, used_only);
+      break;
+
+    case STAT_DIR_TYPE_SCALAR_INDEX:
+      s = dump_scalar_index (res, s, used_only);
+      break;
+
+    case STAT_DIR_TYPE_NAME_VECTOR:
+      s = dump_name_vector (res, s, used_only);
+      break;
+
+    case STAT_DIR_TYPE_EMPTY:
+      break;
+
+    default:
+      clib_warning ("Unknown value %d\n", res->type);
+      ;
+    }
+
+  return s;
+}
+
 static u8 *
 scrape_stats_segment (u8 *s, u8 **patterns, u8 used_only)
 {
@@ -149,39 +276,98 @@ retry:
     }
 
   for (i = 0; i < vec_len (res); i++)
+    s = dump_stat_entry (&res[i], s, used_only);
+
+  stat_segment_data_free (res);
+  vec_free (stats);
+
+  return s;
+}
+
+/*
+ * Delta scraping keeps a snapshot of the stats segment and the text
+ * rendered for each entry, and only re-renders the entries which changed
+ * since the previous scrape.
+ */
+static u8 *
+scrape_stats_segment_delta (u8 *s, u8 **patterns, u8 used_only)
+{
+  prom_main_t *pm = &prom_main;
+  stat_segment_delta_block_t *b;
+  stat_segment_delta_t *d;
+  uword *dirty;
+  u32 i;
+
+  if (pm->delta == 0)
     {
-      switch (res[i].type)
-	{
-	case STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE:
-	  s = dump_counter_vector_simple (&res[i], s, used_only);
-	  break;
+      pm->delta = stat_segment_delta_new (patterns);
+      if (pm->delta == 0)
+	return scrape_stats_segment (s, patterns, used_only);
+    }
+  d = pm->delta;
 
-	case STAT_DIR_TYPE_COUNTER_VECTOR_COMBINED:
-	  s = dump_counter_vector_combined (&res[i], s, used_only);
-	  break;
+  while (stat_segment_delta_update (d) < 0)
+    ;
 
-	case STAT_DIR_TYPE_SCALAR_INDEX:
-	  s = dump_scalar_index (&res[i], s, used_only);
-	  break;
+  if (d->resolved)
+    {
+      vec_foreach_index (i, pm->rendered)
+	vec_free (pm->rendered[i]);
+      vec_reset_length (pm->rendered);
+    }
 
-	case STAT_DIR_TYPE_NAME_VECTOR:
-	  s = dump_name_vector (&res[i], s, used_only);
-	  break;
+  clib_bitmap_zero (pm->rendered_last);
+  dirty = pm->rendered_last;
 
-	case STAT_DIR_TYPE_EMPTY:
-	  break;
+  if (vec_len (pm->rendered) < vec_len (d->data))
+    {
+      i = vec_len (pm->rendered);
+      vec_validate (pm->rendered, vec_len (d->data) - 1);
+      dirty = clib_bitmap_set_region (dirty, i, 1, vec_len (d->data) - i);
+    }
 
-	default:
-	  clib_warning ("Unknown value %d\n", res[i].type);
-	  ;
-	}
+  vec_foreach (b, d->changed)
+    dirty = clib_bitmap_set (dirty, b->entry, 1);
+
+  clib_bitmap_foreach (i, dirty)
+    {
+      vec_reset_length (pm->rendered[i]);
+      pm->rendered[i] =
+	dump_stat_entry (&d->data[i], pm->rendered[i], used_only);
     }
-  stat_segment_data_free (res);
-  vec_free (stats);
 
+  vec_foreach_index (i, pm->rendered)
+    vec_append (s, pm->rendered[i]);
+
+  pm->rendered_last = dirty;
   return s;
 }
 
+u8 *
+prom_scrape (u8 *s, u8 full)
+{
+  prom_main_t *pm = &prom_main;
+
+  if (pm->delta_scrape && !full)
+    return scrape_stats_segment_delta (s, pm->stats_patterns, pm->used_only);
+  return scrape_stats_segment (s, pm->stats_patterns, pm->used_only);
+}
+
+static void
+prom_scrape_reset (void)
+{
+  prom_main_t *pm = &prom_main;
+  u32 i;
+
+  if (pm->delta)
+    stat_segment_delta_free (pm->delta);
+  pm->delta = 0;
+  vec_foreach_index (i, pm->rendered)
+    vec_free (pm->rendered[i]);
+  vec_free (pm->rendered);
+  clib_bitmap_free (pm->rendered_last);
+}
+
 static void
 send_data_to_hss (hss_session_handle_t sh)
 {
@@ -224,8 +410,7 @@ prom_scraper_process (vlib_main_t *vm, vlib_node_runtime_t *rt,
 	case PROM_SCRAPER_EVT_RUN:
 	  sh.as_u64 = event_data[0];
 	  vec_reset_length (pm->stats);
-	  pm->stats = scrape_stats_segment (pm->stats, pm->stats_patterns,
-					    pm->used_only);
+	  pm->stats = prom_scrape (pm->stats, 0 /* full */);
 	  session_send_rpc_evt_to_thread_force (sh.thread_index,
 						send_data_to_hss_rpc, &sh);
 	  pm->last_scrape = vlib_time_now (vm);
@@ -302,6 +487,8 @@ prom_stat_patterns_add (u8 **patterns)
   u8 found;
   u32 len;
 
+  prom_scrape_reset ();
+
   vec_foreach (pattern, patterns)
     {
       found = 0;
@@ -329,6 +516,7 @@ prom_stat_patterns_free (void)
   prom_main_t *pm = &prom_main;
   u8 **pattern;
 
+  prom_scrape_reset ();
   vec_foreach (pattern, pm->stats_patterns)
     vec_free (*pattern);
   vec_free (pm->stats_patterns);
@@ -352,6 +540,7 @@ prom_stat_name_prefix_set (u8 *prefix)
 {
   prom_main_t *pm = &prom_main;
 
+  prom_scrape_reset ();
   vec_free (pm->stat_name_prefix);
   pm->stat_name_prefix = prefix;
 }
@@ -361,9 +550,19 @@ prom_report_used_only (u8 used_only)
 {
   prom_main_t *pm = &prom_main;
 
+  prom_scrape_reset ();
   pm->used_only = used_only;
 }
 
+void
+prom_delta_scrape (u8 enable)
+{
+  prom_main_t *pm = &prom_main;
+
+  prom_scrape_reset ();
+  pm->delta_scrape = enable;
+}
+
 static void
 prom_stat_segment_client_init (void)
 {
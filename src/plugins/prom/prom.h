@@ -18,6 +18,7 @@
 
 #include <vnet/session/session.h>
 #include <http_static/http_static.h>
+#include <vpp-api/client/stat_client.h>
 
 typedef struct prom_main_
 {
@@ -30,6 +31,11 @@ typedef struct prom_main_
   u8 *name_scratch_pad;
   vlib_main_t *vm;
 
+  /* Delta scraping state */
+  stat_segment_delta_t *delta;
+  u8 **rendered;
+  uword *rendered_last; /* entries re-rendered by the last scrape */
+
   /*
    * Configs
    */
@@ -37,6 +43,7 @@ typedef struct prom_main_
   u8 *stat_name_prefix;
   f64 min_scrape_interval;
   u8 used_only;
+  u8 delta_scrape;
 } prom_main_t;
 
 typedef enum prom_process_evt_codes_
@@ -54,6 +61,8 @@ void prom_stat_patterns_free (void);
 
 void prom_stat_name_prefix_set (u8 *prefix);
 void prom_report_used_only (u8 used_only);
+void prom_delta_scrape (u8 enable);
+u8 *prom_scrape (u8 *s, u8 full);
 
 #endif /* SRC_PLUGINS_PROM_PROM_H_ */
 
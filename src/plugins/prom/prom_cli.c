@@ -109,6 +109,10 @@ prom_command_fn (vlib_main_t *vm, unformat_input_t *input,
 	prom_report_used_only (1 /* used only */);
       else if (unformat (line_input, "all-stats"))
 	prom_report_used_only (0 /* used only */);
+      else if (unformat (line_input, "delta-scrape"))
+	prom_delta_scrape (1 /* enable */);
+      else if (unformat (line_input, "full-scrape"))
+	prom_delta_scrape (0 /* enable */);
       else if (unformat (line_input, "stat-name-prefix %_%v%_",
 			 &stat_name_prefix))
 	prom_stat_name_prefix_set (stat_name_prefix);
@@ -139,11 +143,69 @@ no_input:
 VLIB_CLI_COMMAND (prom_enable_command, static) = {
   .path = "prom",
   .short_help = "prom [enable] [min-scrape-interval <n>] [used-only] "
-		"[all-stats] [stat-name-prefix <prefix>] "
-		"[stat-patterns <patterns>...]",
+		"[all-stats] [delta-scrape|full-scrape] "
+		"[stat-name-prefix <prefix>] [stat-patterns <patterns>...]",
   .function = prom_command_fn,
 };
 
+static clib_error_t *
+show_prom_command_fn (vlib_main_t *vm, unformat_input_t *input,
+		      vlib_cli_command_t *cmd)
+{
+  prom_main_t *pm = prom_get_main ();
+  u8 is_scrape = 0, is_full = 0, **pattern, *s;
+  u32 i;
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "scrape"))
+	is_scrape = 1;
+      else if (unformat (input, "full"))
+	is_full = 1;
+      else
+	return clib_error_return (0, "unknown input `%U'",
+				  format_unformat_error, input);
+    }
+
+  if (!pm->is_enabled)
+    return clib_error_return (0, "prom not enabled");
+
+  /* scrape as the http handler would, without touching what it serves */
+  if (is_scrape)
+    {
+      s = prom_scrape (0, is_full);
+      vlib_cli_output (vm, "%v", s);
+      vec_free (s);
+      return 0;
+    }
+
+  vlib_cli_output (vm, "%s, %s, min-scrape-interval %.2f",
+		   pm->delta_scrape ? "delta-scrape" : "full-scrape",
+		   pm->used_only ? "used-only" : "all-stats",
+		   pm->min_scrape_interval);
+  vec_foreach (pattern, pm->stats_patterns)
+    vlib_cli_output (vm, "  stat-pattern %v", *pattern);
+
+  if (pm->delta == 0)
+    return 0;
+
+  vlib_cli_output (vm, "  delta: %u entries, last scrape re-rendered %u",
+		   vec_len (pm->delta->data),
+		   clib_bitmap_count_set_bits (pm->rendered_last));
+  /* entry names were turned into metric names when rendered */
+  clib_bitmap_foreach (i, pm->rendered_last)
+    vlib_cli_output (vm, "    %v%s", pm->stat_name_prefix,
+		     pm->delta->data[i].name);
+
+  return 0;
+}
+
+VLIB_CLI_COMMAND (show_prom_command, static) = {
+  .path = "show prom",
+  .short_help = "show prom [scrape [full]]",
+  .function = show_prom_command_fn,
+};
+
 /*
  * fd.io coding-style-patch-verification: ON
  *
@@ -25,11 +25,14 @@ enum
 {
   type_simple = 0,
   type_combined,
+  type_gauge,
+  type_histogram,
 };
 
 enum
 {
   test_expand = 0,
+  test_publish,
 };
 
 /*
@@ -145,6 +148,91 @@ test_combined_counter_expand (vlib_main_t *vm)
   return 0;
 }
 
+/*
+ * Publish a gauge vector with levels value, value + 1 and value + 2. The
+ * entry is left in place for the stats client to read back.
+ */
+static clib_error_t *
+test_gauge_publish (vlib_main_t *vm, u32 value)
+{
+  vlib_stats_segment_t *sm = vlib_stats_get_segment ();
+  static u32 entry_index = ~0;
+  counter_t **counters;
+  int i;
+
+  if (entry_index == ~0)
+    entry_index = vlib_stats_add_gauge_vector ("/vlib/test-gauge");
+  if (entry_index == ~0)
+    return clib_error_return (0, "failed to add gauge vector");
+
+  if (vlib_stats_get_entry (sm, entry_index)->type !=
+      STAT_DIR_TYPE_GAUGE_VECTOR)
+    return clib_error_return (0, "wrong entry type");
+
+  vlib_stats_validate (entry_index, 0, 2);
+  counters = vlib_stats_get_entry_data_pointer (entry_index);
+  for (i = 0; i < 3; i++)
+    counters[0][i] = value + i;
+
+  return 0;
+}
+
+/*
+ * Record known values in a linear histogram and check the bins and the
+ * sum. The entry is left in place for the stats client to read back.
+ */
+static clib_error_t *
+test_histogram_publish (vlib_main_t *vm)
+{
+  static vlib_histogram_main_t hm = {
+    .name = "test-histogram-linear",
+    .stat_segment_name = "/vlib/test-histogram-linear",
+    .n_bins = 5,
+    .base = 10,
+    .width = 10,
+  };
+  vlib_stats_segment_t *sm = vlib_stats_get_segment ();
+  u64 values[] = { 0, 9, 10, 25, 39, 40, 1000 };
+  counter_t expected[] = { 2, 1, 1, 1, 2 };
+  counter_t bins[5], sum = 0;
+  vlib_stats_histogram_t *h;
+  int i;
+
+  vlib_validate_histogram (&hm, 1);
+  vlib_zero_histogram (&hm, 0);
+  vlib_zero_histogram (&hm, 1);
+
+  if (vlib_stats_get_entry (sm, hm.stats_entry_index)->type !=
+      STAT_DIR_TYPE_HISTOGRAM_LINEAR)
+    return clib_error_return (0, "wrong entry type");
+  h = vlib_stats_get_entry_data_pointer (hm.stats_entry_index);
+  if (h->n_bins != 5 || h->base != 10 || h->width != 10)
+    return clib_error_return (0, "wrong histogram descriptor");
+
+  for (i = 0; i < ARRAY_LEN (values); i++)
+    {
+      vlib_increment_histogram (&hm, vm->thread_index, 1, values[i]);
+      sum += values[i];
+    }
+
+  vlib_get_histogram (&hm, 1, bins);
+  for (i = 0; i < ARRAY_LEN (bins); i++)
+    if (bins[i] != expected[i])
+      return clib_error_return (0, "bin %d is %llu, expected %llu", i,
+				bins[i], expected[i]);
+
+  if (vlib_get_histogram_sum (&hm, 1) != sum)
+    return clib_error_return (0, "sum is %llu, expected %llu",
+			      vlib_get_histogram_sum (&hm, 1), sum);
+
+  vlib_get_histogram (&hm, 0, bins);
+  for (i = 0; i < ARRAY_LEN (bins); i++)
+    if (bins[i])
+      return clib_error_return (0, "index 0 bin %d is not zero", i);
+
+  return 0;
+}
+
 static clib_error_t *
 test_simple_counter (vlib_main_t *vm, int test_case)
 {
@@ -188,6 +276,7 @@ test_counter_command_fn (vlib_main_t *vm, unformat_input_t *input,
   clib_error_t *error;
   int counter_type = -1;
   int test_case = -1;
+  u32 value = 0;
 
   while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
     {
@@ -195,8 +284,16 @@ test_counter_command_fn (vlib_main_t *vm, unformat_input_t *input,
 	counter_type = type_simple;
       else if (unformat (input, "combined"))
 	counter_type = type_combined;
+      else if (unformat (input, "gauge"))
+	counter_type = type_gauge;
+      else if (unformat (input, "histogram"))
+	counter_type = type_histogram;
       else if (unformat (input, "expand"))
 	test_case = test_expand;
+      else if (unformat (input, "publish"))
+	test_case = test_publish;
+      else if (unformat (input, "value %u", &value))
+	;
       else
 	return clib_error_return (0, "unknown input '%U'",
 				  format_unformat_error, input);
@@ -215,6 +312,18 @@ test_counter_command_fn (vlib_main_t *vm, unformat_input_t *input,
       error = test_combined_counter (vm, test_case);
       break;
 
+    case type_gauge:
+      if (test_case != test_publish)
+	return clib_error_return (0, "no such test");
+      error = test_gauge_publish (vm, value);
+      break;
+
+    case type_histogram:
+      if (test_case != test_publish)
+	return clib_error_return (0, "no such test");
+      error = test_histogram_publish (vm);
+      break;
+
     default:
       return clib_error_return (0, "no such test");
     }
@@ -224,7 +333,8 @@ test_counter_command_fn (vlib_main_t *vm, unformat_input_t *input,
 
 VLIB_CLI_COMMAND (test_counter_command, static) = {
   .path = "test counter",
-  .short_help = "test counter [simple | combined] expand",
+  .short_help = "test counter [simple | combined] expand | "
+		"gauge publish [value <n>] | histogram publish",
   .function = test_counter_command_fn,
 };
 
@@ -0,0 +1,222 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2024 Cisco Systems, Inc.
+ */
+
+#include <vlib/vlib.h>
+#include <vnet/vnet.h>
+#include <vnet/buffer.h>
+#include <vnet/dev/rx_funcs.h>
+
+/* mock descriptor ring exercising the vnet/dev rx burst helpers */
+
+#define DEV_RX_TEST_RING_SZ 256
+
+#define DEV_RX_TEST_ST_DD     (1 << 0)
+#define DEV_RX_TEST_ST_EOP    (1 << 1)
+#define DEV_RX_TEST_ST_L4_OK  (1 << 2)
+#define DEV_RX_TEST_ST_L4_ERR (1 << 3)
+
+typedef struct
+{
+  u64 addr;
+  u16 length;
+  u16 rsvd;
+  u32 status;
+} dev_rx_test_desc_t;
+
+static const vnet_dev_rx_flag_map_t dev_rx_test_flag_map[] = {
+  {
+    .mask = DEV_RX_TEST_ST_L4_OK | DEV_RX_TEST_ST_L4_ERR,
+    .match = DEV_RX_TEST_ST_L4_OK,
+    .flags = VNET_BUFFER_F_L4_CHECKSUM_COMPUTED |
+	     VNET_BUFFER_F_L4_CHECKSUM_CORRECT,
+  },
+};
+
+typedef struct
+{
+  dev_rx_test_desc_t descs[DEV_RX_TEST_RING_SZ];
+  u32 buffer_indices[DEV_RX_TEST_RING_SZ];
+  u64 dma_addr[DEV_RX_TEST_RING_SZ];
+  u16 lengths[DEV_RX_TEST_RING_SZ + VNET_DEV_RX_BURST_PAD];
+  u32 status[DEV_RX_TEST_RING_SZ + VNET_DEV_RX_BURST_PAD];
+  u32 flags[DEV_RX_TEST_RING_SZ + VNET_DEV_RX_BURST_PAD];
+  vlib_buffer_t *bufs[DEV_RX_TEST_RING_SZ];
+} dev_rx_test_ring_t;
+
+static u32
+dev_rx_test_refill (vlib_main_t *vm, dev_rx_test_ring_t *r)
+{
+  u32 n = DEV_RX_TEST_RING_SZ;
+
+  if (vlib_buffer_alloc (vm, r->buffer_indices, n) != n)
+    return 0;
+
+  vnet_dev_rx_buffers_dma_addr (vm, r->buffer_indices, r->dma_addr, n,
+				1 /* use_va */);
+  for (u32 i = 0; i < n; i++)
+    r->descs[i].addr = r->dma_addr[i];
+
+  return n;
+}
+
+/* what the device would do on receive */
+static void
+dev_rx_test_device_write (dev_rx_test_ring_t *r, u32 round)
+{
+  for (u32 i = 0; i < DEV_RX_TEST_RING_SZ; i++)
+    {
+      dev_rx_test_desc_t *d = r->descs + i;
+      d->length = 60 + ((i + round) * 7) % 1400;
+      d->status = DEV_RX_TEST_ST_DD | DEV_RX_TEST_ST_EOP;
+      if ((i + round) % 3 == 0)
+	d->status |= DEV_RX_TEST_ST_L4_OK;
+      else if ((i + round) % 3 == 1)
+	d->status |= DEV_RX_TEST_ST_L4_OK | DEV_RX_TEST_ST_L4_ERR;
+    }
+}
+
+static uword
+dev_rx_test_burst (vlib_main_t *vm, dev_rx_test_ring_t *r,
+		   vlib_buffer_template_t *bt)
+{
+  u32 n = DEV_RX_TEST_RING_SZ;
+
+  vnet_dev_rx_desc_get_u16 (r->descs, sizeof (dev_rx_test_desc_t),
+			    STRUCT_OFFSET_OF (dev_rx_test_desc_t, length),
+			    r->lengths, n);
+  vnet_dev_rx_desc_get_u32 (r->descs, sizeof (dev_rx_test_desc_t),
+			    STRUCT_OFFSET_OF (dev_rx_test_desc_t, status),
+			    r->status, n);
+  vnet_dev_rx_status_to_flags (r->status, r->flags, n, dev_rx_test_flag_map,
+			       ARRAY_LEN (dev_rx_test_flag_map));
+  vlib_get_buffers (vm, r->buffer_indices, r->bufs, n);
+  return vnet_dev_rx_buffers_init (r->bufs, bt, r->lengths, r->flags, n);
+}
+
+static clib_error_t *
+dev_rx_test_check (vlib_main_t *vm, dev_rx_test_ring_t *r,
+		   vlib_buffer_template_t *bt, uword n_bytes)
+{
+  u32 l4_ok = VNET_BUFFER_F_L4_CHECKSUM_COMPUTED |
+	      VNET_BUFFER_F_L4_CHECKSUM_CORRECT;
+  uword total = 0;
+
+  for (u32 i = 0; i < DEV_RX_TEST_RING_SZ; i++)
+    {
+      dev_rx_test_desc_t *d = r->descs + i;
+      vlib_buffer_t *b = r->bufs[i];
+      u32 want_flags = bt->flags;
+
+      if ((d->status & (DEV_RX_TEST_ST_L4_OK | DEV_RX_TEST_ST_L4_ERR)) ==
+	  DEV_RX_TEST_ST_L4_OK)
+	want_flags |= l4_ok;
+
+      if (b->current_length != d->length)
+	return clib_error_return (0, "failed: slot %u length %u expected %u",
+				  i, b->current_length, d->length);
+      if (b->flags != want_flags)
+	return clib_error_return (0, "failed: slot %u flags 0x%x expected "
+				  "0x%x", i, b->flags, want_flags);
+      if (b->current_data != bt->current_data ||
+	  b->buffer_pool_index != bt->buffer_pool_index ||
+	  vnet_buffer (b)->sw_if_index[VLIB_RX] !=
+	    vnet_buffer ((vlib_buffer_t *) bt)->sw_if_index[VLIB_RX])
+	return clib_error_return (0, "failed: slot %u template not applied",
+				  i);
+      if (d->addr != pointer_to_uword (b->data))
+	return clib_error_return (0, "failed: slot %u dma address mismatch",
+				  i);
+      total += d->length;
+    }
+
+  if (total != n_bytes)
+    return clib_error_return (0, "failed: %lu bytes reported, expected %lu",
+			      n_bytes, total);
+  return 0;
+}
+
+static clib_error_t *
+test_dev_rx_burst_fn (vlib_main_t *vm, unformat_input_t *input,
+		      vlib_cli_command_t *cmd)
+{
+  dev_rx_test_ring_t *r;
+  vlib_buffer_template_t bt;
+  clib_error_t *err = 0;
+  u32 n_rounds = 16, perf = 0;
+  u64 ticks = 0;
+  u8 bpi;
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "perf"))
+	perf = 1;
+      else if (unformat (input, "rounds %u", &n_rounds))
+	;
+      else
+	return clib_error_return (0, "unknown input `%U'",
+				  format_unformat_error, input);
+    }
+
+  if (perf && n_rounds == 16)
+    n_rounds = 100000;
+
+  bpi = vlib_buffer_pool_get_default_for_numa (vm, vm->numa_node);
+  bt = vlib_get_buffer_pool (vm, bpi)->buffer_template;
+  vnet_buffer ((vlib_buffer_t *) &bt)->sw_if_index[VLIB_RX] = 7;
+  vnet_buffer ((vlib_buffer_t *) &bt)->sw_if_index[VLIB_TX] = ~0;
+
+  r = clib_mem_alloc_aligned (sizeof (*r), CLIB_CACHE_LINE_BYTES);
+  clib_memset (r, 0, sizeof (*r));
+
+  for (u32 round = 0; round < n_rounds; round++)
+    {
+      uword n_bytes;
+      u64 t0;
+
+      if (dev_rx_test_refill (vm, r) == 0)
+	{
+	  err = clib_error_return (0, "failed: buffer allocation");
+	  break;
+	}
+
+      dev_rx_test_device_write (r, round);
+
+      t0 = clib_cpu_time_now ();
+      n_bytes = dev_rx_test_burst (vm, r, &bt);
+      ticks += clib_cpu_time_now () - t0;
+
+      if (!perf || round == 0)
+	err = dev_rx_test_check (vm, r, &bt, n_bytes);
+
+      vlib_buffer_free (vm, r->buffer_indices, DEV_RX_TEST_RING_SZ);
+
+      if (err)
+	break;
+    }
+
+  if (!err && perf)
+    vlib_cli_output (vm, "%u rounds of %u descriptors, %.02f ticks/packet",
+		     n_rounds, DEV_RX_TEST_RING_SZ,
+		     (f64) ticks / ((f64) n_rounds * DEV_RX_TEST_RING_SZ));
+  else if (!err)
+    vlib_cli_output (vm, "rx burst helpers passed %u rounds", n_rounds);
+
+  clib_mem_free (r);
+  return err;
+}
+
+/*?
+ * Run the vnet/dev rx burst helpers against a mock descriptor ring and
+ * verify the resulting buffer metadata. With '<em>perf</em>' only the
+ * first round is checked and the cost of descriptor decode and buffer
+ * init is reported in CPU ticks per packet.
+ *
+ * @cliexpar
+ * @cliexcmd{test dev rx-burst perf rounds 100000}
+?*/
+VLIB_CLI_COMMAND (test_dev_rx_burst_command, static) = {
+  .path = "test dev rx-burst",
+  .short_help = "test dev rx-burst [perf] [rounds <n>]",
+  .function = test_dev_rx_burst_fn,
+};
@@ -51,6 +51,45 @@ test_pool_command_fn (vlib_main_t *vm, unformat_input_t *input,
       ALWAYS_ASSERT (pool_free_elts (pool) == this_size);
     }
 
+  for (j = 0; j < ARRAY_LEN (sizes); j++)
+    {
+      pool_seg_t _sp, *sp = &_sp;
+      u64 **elts = 0, *p;
+      u32 index;
+
+      this_size = sizes[j];
+      pool_seg_init_type (sp, u64, 2);
+
+      for (i = 0; i < this_size; i++)
+	{
+	  p = pool_seg_get (sp, &index);
+	  ALWAYS_ASSERT (index == i);
+	  *p = i;
+	  vec_add1 (elts, p);
+	}
+
+      /* growth never moves an element */
+      for (i = 0; i < this_size; i++)
+	ALWAYS_ASSERT (pool_seg_elt_at_index (sp, i) == elts[i] &&
+		       *elts[i] == i);
+
+      vlib_cli_output (vm, "allocated %d elts in %d segments\n", i,
+		       sp->n_segments);
+
+      for (i = 0; i < this_size; i += 2)
+	pool_seg_put_index (sp, i);
+
+      ALWAYS_ASSERT (pool_seg_elts (sp) == this_size / 2);
+      pool_seg_foreach_index (index, sp)
+	ALWAYS_ASSERT (index & 1);
+
+      p = pool_seg_get (sp, &index);
+      ALWAYS_ASSERT (p == elts[index] && (index & 1) == 0);
+
+      pool_seg_free (sp);
+      vec_free (elts);
+    }
+
   vlib_cli_output (vm, "Test succeeded...\n");
   return 0;
 }
@@ -160,6 +160,18 @@ test_chain (vlib_main_t *vm, const chained_buffer_template_t *tmpl,
       goto err2;
     }
 
+  /* drivers that cut the chain links rely on owning every segment */
+  for (vlib_buffer_t *s = b;; s = vlib_get_buffer (vm, s->next_buffer))
+    {
+      if (s->ref_count != 1)
+	{
+	  ret = 0;
+	  goto err2;
+	}
+      if (!(s->flags & VLIB_BUFFER_NEXT_PRESENT))
+	break;
+    }
+
 err2:
   if (clone_off)
     vlib_buffer_free_one (vm, bi[1]);
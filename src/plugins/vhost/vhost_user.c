@@ -320,11 +320,176 @@ vhost_user_vring_init (vhost_user_intf_t * vui, u32 qid)
     vring->enabled = 1;
 }
 
+/*
+ * Forget the DMA batches in flight on rx queue qid. Their buffers are
+ * freed and their completions ignored.
+ */
+static void
+vhost_user_dma_queue_reset (vhost_user_intf_t *vui, u16 qid)
+{
+  vhost_user_dma_queue_t *dq = vec_elt_at_index (vui->dma_queues, qid);
+  vlib_main_t *vm = vlib_get_main ();
+
+  for (int i = 0; i < VHOST_USER_DMA_N_SLOTS; i++)
+    {
+      vhost_user_dma_slot_t *s = dq->slots + i;
+      if (vec_len (s->buffers))
+	vlib_buffer_free (vm, s->buffers, vec_len (s->buffers));
+      vec_reset_length (s->buffers);
+      s->done = 0;
+    }
+
+  dq->head = dq->tail = 0;
+  dq->gen++;
+}
+
+void
+vhost_user_dma_completion_cb (vlib_main_t *vm, vlib_dma_batch_t *b)
+{
+  vhost_user_main_t *vum = &vhost_user_main;
+  uword cookie = vlib_dma_batch_get_cookie (vm, b);
+  u32 if_index = cookie >> 32;
+  u16 qid = (cookie >> 8) & 0xff;
+  vhost_user_intf_t *vui;
+  vhost_user_dma_queue_t *dq;
+
+  if (pool_is_free_index (vum->vhost_user_interfaces, if_index))
+    return;
+
+  vui = pool_elt_at_index (vum->vhost_user_interfaces, if_index);
+  if (qid >= vec_len (vui->dma_queues))
+    return;
+
+  dq = vec_elt_at_index (vui->dma_queues, qid);
+  if (dq->gen != (u16) (cookie >> 16))
+    return;
+
+  dq->slots[cookie & 0xff].done = 1;
+  vhost_user_dma_complete (vm, vui, qid);
+}
+
+static int
+vhost_user_dma_config_add (vlib_main_t *vm)
+{
+  vlib_dma_config_t cfg = {
+    .max_transfers = VHOST_USER_DMA_MAX_TRANSFERS,
+    .max_transfer_size = 65536,
+    .sw_fallback = 1,
+    .callback_fn = vhost_user_dma_completion_cb,
+  };
+
+  return vlib_dma_config_add (vm, &cfg);
+}
+
+/*
+ * Wait for the copies still in flight to guest memory, before the memory
+ * is unmapped or the vrings are closed. Completions only run on the
+ * submitting threads, which are parked on the barrier, so the config is
+ * deleted instead: the backend waits for the copies it was handed to
+ * complete and drops their completions. The generation of every queue is
+ * bumped so a late completion cannot land on a reused slot, all slots are
+ * published and a new config is added for the following frames.
+ */
+static void
+vhost_user_dma_drain (vlib_main_t *vm, vhost_user_intf_t *vui)
+{
+  vhost_user_dma_queue_t *dq;
+  int with_barrier = 0;
+
+  if (vui->dma_config < 0)
+    return;
+
+  if (vlib_worker_thread_barrier_held () == 0)
+    {
+      with_barrier = 1;
+      vlib_worker_thread_barrier_sync (vm);
+    }
+
+  vec_foreach (dq, vui->dma_queues)
+    if (dq->head != dq->tail)
+      break;
+
+  if (dq == vec_end (vui->dma_queues))
+    goto done;
+
+  vlib_dma_config_del (vm, vui->dma_config);
+
+  vec_foreach (dq, vui->dma_queues)
+    {
+      u16 qid = dq - vui->dma_queues;
+
+      dq->gen++;
+      if (dq->head == dq->tail)
+	continue;
+
+      for (u16 i = dq->tail; i != dq->head; i++)
+	dq->slots[i % VHOST_USER_DMA_N_SLOTS].done = 1;
+
+      if (vui->vrings[VHOST_VRING_IDX_RX (qid)].used)
+	vhost_user_dma_complete (vm, vui, qid);
+      else
+	vhost_user_dma_queue_reset (vui, qid);
+    }
+
+  vui->dma_config = vhost_user_dma_config_add (vm);
+  if (vui->dma_config < 0)
+    vu_log_warn (vui, "no DMA backend available, using cpu copies");
+
+done:
+  if (with_barrier)
+    vlib_worker_thread_barrier_release (vm);
+}
+
+static void
+vhost_user_dma_init (vlib_main_t *vm, vhost_user_intf_t *vui, u8 use_dma)
+{
+  vui->use_dma = use_dma;
+  if (!use_dma || vui->dma_config >= 0)
+    return;
+
+  vec_validate_aligned (vui->dma_queues, VHOST_VRING_MAX_MQ_PAIR_SZ - 1,
+			CLIB_CACHE_LINE_BYTES);
+
+  /* the config pool may move under workers looking up batches */
+  vlib_worker_thread_barrier_sync (vm);
+  vui->dma_config = vhost_user_dma_config_add (vm);
+  vlib_worker_thread_barrier_release (vm);
+
+  if (vui->dma_config < 0)
+    vu_log_warn (vui, "no DMA backend available, using cpu copies");
+}
+
+static void
+vhost_user_dma_free (vlib_main_t *vm, vhost_user_intf_t *vui)
+{
+  vhost_user_dma_queue_t *dq;
+
+  if (vui->dma_config >= 0)
+    vlib_dma_config_del (vm, vui->dma_config);
+  vui->dma_config = -1;
+
+  vec_foreach (dq, vui->dma_queues)
+    for (int i = 0; i < VHOST_USER_DMA_N_SLOTS; i++)
+      {
+	vhost_user_dma_slot_t *s = dq->slots + i;
+	if (vec_len (s->buffers))
+	  vlib_buffer_free (vm, s->buffers, vec_len (s->buffers));
+	vec_free (s->buffers);
+      }
+  vec_free (vui->dma_queues);
+}
+
 static_always_inline void
 vhost_user_vring_close (vhost_user_intf_t * vui, u32 qid)
 {
   vhost_user_vring_t *vring = &vui->vrings[qid];
 
+  if (vui->dma_queues && (qid & 1) == 0)
+    {
+      vhost_user_dma_drain (vlib_get_main (), vui);
+      vhost_user_dma_queue_reset (vui, qid / 2);
+    }
+
   if (vring->kickfd_idx != ~0)
     {
       clib_file_t *uf = pool_elt_at_index (file_main.file_pool,
@@ -375,6 +540,10 @@ vhost_user_if_disconnect (vhost_user_intf_t * vui)
 
   vui->is_ready = 0;
 
+  /* guest memory must not be written once unmapped */
+  if (vui->dma_queues)
+    vhost_user_dma_drain (vlib_get_main (), vui);
+
   FOR_ALL_VHOST_RX_TXQ (q, vui) { vhost_user_vring_close (vui, q); }
 
   unmap_all_mem_regions (vui);
@@ -617,6 +786,8 @@ vhost_user_socket_read (clib_file_t * uf)
 	}
 
       vlib_worker_thread_barrier_sync (vm);
+      if (vui->dma_queues)
+	vhost_user_dma_drain (vm, vui);
       unmap_all_mem_regions (vui);
       for (i = 0; i < msg.memory.nregions; i++)
 	{
@@ -1175,6 +1346,7 @@ vhost_user_init (vlib_main_t * vm)
 
   vum->coalesce_frames = 32;
   vum->coalesce_time = 1e-3;
+  vum->dma_min_copy_size = 256;
 
   vec_validate (vum->cpus, tm->n_vlib_mains - 1);
 
@@ -1493,6 +1665,8 @@ vhost_user_delete_if (vnet_main_t * vnm, vlib_main_t * vm, u32 sw_if_index)
   // free vrings
   vec_free (vui->vrings);
 
+  vhost_user_dma_free (vm, vui);
+
   // Back to pool
   pool_put (vum->vhost_user_interfaces, vui);
 
@@ -1600,6 +1774,7 @@ vhost_user_vui_init (vnet_main_t * vnm, vhost_user_intf_t * vui,
   vnet_sw_interface_t *sw;
   int q;
   vhost_user_main_t *vum = &vhost_user_main;
+  vlib_main_t *vm = vlib_get_main ();
 
   sw = vnet_get_hw_sw_interface (vnm, vui->hw_if_index);
   if (server_sock_fd != -1)
@@ -1653,6 +1828,8 @@ vhost_user_vui_init (vnet_main_t * vnm, vhost_user_intf_t * vui,
   for (q = 0; q < vec_len (vui->vrings); q++)
     vhost_user_vring_init (vui, q);
 
+  vhost_user_dma_init (vm, vui, args->use_dma);
+
   vnet_hw_if_set_caps (vnm, vui->hw_if_index, VNET_HW_IF_CAP_INT_MODE);
   vnet_hw_interface_set_flags (vnm, vui->hw_if_index, 0);
 
@@ -1698,6 +1875,8 @@ vhost_user_create_if (vnet_main_t * vnm, vlib_main_t * vm,
   /* Protect the uninitialized vui from being dispatched by rx/tx */
   vlib_worker_thread_barrier_sync (vm);
   pool_get (vhost_user_main.vhost_user_interfaces, vui);
+  vui->dma_config = -1;
+  vui->dma_queues = 0;
   vhost_user_create_ethernet (vnm, vm, vui, args);
   vlib_worker_thread_barrier_release (vm);
 
@@ -1801,6 +1980,8 @@ vhost_user_connect_command_fn (vlib_main_t * vm,
 	args.enable_packed = 1;
       else if (unformat (line_input, "event-idx"))
 	args.enable_event_idx = 1;
+      else if (unformat (line_input, "use-dma"))
+	args.use_dma = 1;
       else if (unformat (line_input, "feature-mask 0x%llx",
 			 &args.feature_mask))
 	;
@@ -2215,6 +2396,14 @@ show_vhost_user_command_fn (vlib_main_t * vm,
 	vlib_cli_output (vm, "  Packed ring enable");
       if (vui->enable_event_idx)
 	vlib_cli_output (vm, "  Event index enable");
+      if (vui->use_dma)
+	{
+	  if (vui->dma_config >= 0)
+	    vlib_cli_output (vm, "  DMA copies enable, config %d",
+			     vui->dma_config);
+	  else
+	    vlib_cli_output (vm, "  DMA copies enable, no DMA backend");
+	}
 
       vlib_cli_output (vm, "virtio_net_hdr_sz %d\n"
 		       " features mask (0x%llx): \n"
@@ -2378,6 +2567,12 @@ done:
  * will be used anyway and multiple instances will have the same name. Use
  * with caution.
  *
+ * - <b>use-dma</b> - Optional flag to hand the copies into guest memory to
+ * the DMA engine, or the software DMA backend if there is none. Only split
+ * rings on queues used by a single thread are offloaded. Copies shorter than
+ * the vhost-user <em>dma-min-copy-size</em> startup parameter (default 256
+ * bytes) are still done by the cpu.
+ *
  * @cliexpar
  * Example of how to create a vhost interface with VPP as the client and all
  * features enabled:
@@ -2398,7 +2593,7 @@ VLIB_CLI_COMMAND (vhost_user_connect_command, static) = {
     .path = "create vhost-user",
     .short_help = "create vhost-user socket <socket-filename> [server] "
     "[feature-mask <hex>] [hwaddr <mac-addr>] [renumber <dev_instance>] [gso] "
-    "[packed] [event-idx]",
+    "[packed] [event-idx] [use-dma]",
     .function = vhost_user_connect_command_fn,
     .is_mp_safe = 1,
 };
@@ -2580,6 +2775,10 @@ vhost_user_config (vlib_main_t * vm, unformat_input_t * input)
 	;
       else if (unformat (input, "dont-dump-memory"))
 	vum->dont_dump_vhost_user_memory = 1;
+      else if (unformat (input, "dma-min-copy-size %u",
+			 &vum->dma_min_copy_size))
+	/* headers are copied from a per thread array, keep them on the cpu */
+	vum->dma_min_copy_size = clib_max (vum->dma_min_copy_size, 64);
       else
 	return clib_error_return (0, "unknown input `%U'",
 				  format_unformat_error, input);
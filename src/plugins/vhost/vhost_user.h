@@ -17,6 +17,7 @@
 
 #include <vhost/virtio_std.h>
 #include <vhost/vhost_std.h>
+#include <vlib/dma/dma.h>
 
 /* vhost-user data structures */
 
@@ -110,6 +111,7 @@ typedef struct
   u8 enable_packed;
   u8 enable_event_idx;
   u8 use_custom_mac;
+  u8 use_dma;
 
   /* return */
   u32 sw_if_index;
@@ -234,6 +236,33 @@ typedef struct
   u32 thread_index;
 } vhost_user_vring_t;
 
+/*
+ * Frames copied to the guest through the DMA API are only made visible in
+ * the used ring once their batch completed. Completions may come back in
+ * any order, so each rx queue keeps a ring of slots, one per submitted
+ * batch, and publishes the used index of the oldest slots that are done.
+ */
+#define VHOST_USER_DMA_N_SLOTS 32
+#define VHOST_USER_DMA_MAX_TRANSFERS VHOST_USER_COPY_ARRAY_N
+
+typedef struct
+{
+  u32 *buffers;	 /* vlib buffers to free once copied */
+  u16 used_idx;	 /* used ring index to publish once copied */
+  u16 n_packets; /* packets counted towards the guest interrupt */
+  u8 done;
+} vhost_user_dma_slot_t;
+
+typedef struct
+{
+  vhost_user_dma_slot_t slots[VHOST_USER_DMA_N_SLOTS];
+  u16 head;
+  u16 tail;
+  /* bumped when the vring is closed, completions of older batches are
+   * ignored */
+  u16 gen;
+} vhost_user_dma_queue_t;
+
 #define VHOST_USER_EVENT_START_TIMER 1
 #define VHOST_USER_EVENT_STOP_TIMER  2
 
@@ -285,6 +314,11 @@ typedef struct
   u8 enable_packed;
 
   u8 enable_event_idx;
+
+  /* Copies to the guest offloaded to the DMA API, split ring only */
+  u8 use_dma;
+  int dma_config;
+  vhost_user_dma_queue_t *dma_queues; /* per rx queue */
 } vhost_user_intf_t;
 
 #define FOR_ALL_VHOST_TXQ(qid, vui) for (qid = 1; qid < vui->num_qid; qid += 2)
@@ -353,6 +387,9 @@ typedef struct
 
   /* gso interface count */
   u32 gso_count;
+
+  /* copies shorter than this are done by the cpu, not the DMA engine */
+  u32 dma_min_copy_size;
 } vhost_user_main_t;
 
 typedef struct
@@ -371,6 +408,7 @@ int vhost_user_dump_ifs (vnet_main_t * vnm, vlib_main_t * vm,
 			 vhost_user_intf_details_t ** out_vuids);
 void vhost_user_set_operation_mode (vhost_user_intf_t *vui,
 				    vhost_user_vring_t *txvq);
+void vhost_user_dma_completion_cb (vlib_main_t *vm, vlib_dma_batch_t *b);
 
 extern vlib_node_registration_t vhost_user_send_interrupt_node;
 extern vnet_device_class_t vhost_user_device_class;
@@ -485,6 +485,54 @@ vhost_user_advance_last_used_idx (vhost_user_vring_t * vring)
     }
 }
 
+/*
+ * Release the oldest DMA slots of rx queue qid whose copies are done,
+ * publish the used index of the newest of them and notify the guest.
+ */
+static_always_inline void
+vhost_user_dma_complete (vlib_main_t *vm, vhost_user_intf_t *vui, u16 qid)
+{
+  vhost_user_main_t *vum = &vhost_user_main;
+  vhost_user_dma_queue_t *dq = vec_elt_at_index (vui->dma_queues, qid);
+  vhost_user_vring_t *rxvq = &vui->vrings[VHOST_VRING_IDX_RX (qid)];
+  u32 n_packets = 0, n_slots = 0;
+  u16 used_idx = 0;
+
+  while (dq->tail != dq->head)
+    {
+      vhost_user_dma_slot_t *s =
+	dq->slots + dq->tail % VHOST_USER_DMA_N_SLOTS;
+
+      if (!s->done)
+	break;
+
+      used_idx = s->used_idx;
+      n_packets += s->n_packets;
+      if (vec_len (s->buffers))
+	vlib_buffer_free (vm, s->buffers, vec_len (s->buffers));
+      vec_reset_length (s->buffers);
+      s->done = 0;
+      dq->tail++;
+      n_slots++;
+    }
+
+  if (n_slots == 0)
+    return;
+
+  CLIB_MEMORY_BARRIER ();
+  rxvq->used->idx = used_idx;
+  vhost_user_log_dirty_ring (vui, rxvq, idx);
+
+  if ((rxvq->callfd_idx != ~0) &&
+      !(rxvq->avail->flags & VRING_AVAIL_F_NO_INTERRUPT))
+    {
+      rxvq->n_since_last_int += n_packets;
+
+      if (rxvq->n_since_last_int > vum->coalesce_frames)
+	vhost_user_send_call (vm, vui, rxvq);
+    }
+}
+
 #endif
 
 /*
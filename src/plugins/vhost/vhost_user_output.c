@@ -201,6 +201,44 @@ vhost_user_tx_copy (vhost_user_intf_t * vui, vhost_copy_t * cpy,
   return 0;
 }
 
+/*
+ * Same as vhost_user_tx_copy but hands the copies to a DMA batch. Short
+ * copies, which include the virtio headers living in the per thread
+ * tx_headers array, are still done by the cpu.
+ */
+static_always_inline u32
+vhost_user_tx_copy_dma (vlib_main_t *vm, vhost_user_intf_t *vui,
+			vlib_dma_batch_t *b, vhost_copy_t *cpy, u16 copy_len,
+			u32 *map_hint)
+{
+  u32 min_size = vhost_user_main.dma_min_copy_size;
+  void *dst;
+
+  for (; copy_len; copy_len--, cpy++)
+    {
+      if (PREDICT_FALSE (!(dst = map_guest_mem (vui, cpy->dst, map_hint))))
+	return 1;
+
+      if (cpy->len < min_size || b->n_enq == VHOST_USER_DMA_MAX_TRANSFERS)
+	clib_memcpy_fast (dst, (void *) cpy->src, cpy->len);
+      else
+	vlib_dma_batch_add (vm, b, dst, (void *) cpy->src, cpy->len);
+
+      vhost_user_log_dirty_pages_2 (vui, cpy->dst, cpy->len, 1);
+    }
+  return 0;
+}
+
+static_always_inline u32
+vhost_user_tx_copy_any (vlib_main_t *vm, vhost_user_intf_t *vui,
+			vlib_dma_batch_t *b, vhost_copy_t *cpy, u16 copy_len,
+			u32 *map_hint)
+{
+  if (b)
+    return vhost_user_tx_copy_dma (vm, vui, b, cpy, copy_len, map_hint);
+  return vhost_user_tx_copy (vui, cpy, copy_len, map_hint);
+}
+
 static_always_inline void
 vhost_user_handle_tx_offload (vhost_user_intf_t *vui, vlib_buffer_t *b,
 			      vnet_virtio_net_hdr_t *hdr)
@@ -706,6 +744,9 @@ VNET_DEVICE_CLASS_TX_FN (vhost_user_device_class) (vlib_main_t * vm,
   u16 tx_headers_len;
   u32 or_flags;
   vnet_hw_if_tx_frame_t *tf = vlib_frame_scalar_args (frame);
+  vhost_user_dma_queue_t *dq = 0;
+  vlib_dma_batch_t *dma_batch = 0;
+  u32 n_dma_buffers = 0;
 
   if (PREDICT_FALSE (!vui->admin_up))
     {
@@ -734,6 +775,20 @@ VNET_DEVICE_CLASS_TX_FN (vhost_user_device_class) (vlib_main_t * vm,
   if (vhost_user_is_packed_ring_supported (vui))
     return (vhost_user_device_class_packed (vm, node, frame, vui, rxvq));
 
+  /*
+   * DMA completions run on this thread, so queues shared between threads
+   * stay on cpu copies. Once all completion slots are in use, frames are
+   * copied by the cpu and published with the newest pending batch.
+   */
+  if (vui->use_dma && vui->dma_config >= 0 && !tf->shared_queue)
+    {
+      dq = vec_elt_at_index (vui->dma_queues, tf->queue_id);
+      if ((u16) (dq->head - dq->tail) < VHOST_USER_DMA_N_SLOTS)
+	dma_batch = vlib_dma_batch_new (vm, vui->dma_config);
+      if (dma_batch == 0 && dq->head == dq->tail)
+	dq = 0;
+    }
+
 retry:
   error = VHOST_USER_TX_FUNC_ERROR_NONE;
   tx_headers_len = 0;
@@ -954,34 +1009,40 @@ retry:
        */
       if (PREDICT_FALSE (copy_len >= VHOST_USER_TX_COPY_THRESHOLD))
 	{
-	  if (PREDICT_FALSE (vhost_user_tx_copy (vui, cpu->copy, copy_len,
-						 &map_hint)))
+	  if (PREDICT_FALSE (vhost_user_tx_copy_any (
+		vm, vui, dma_batch, cpu->copy, copy_len, &map_hint)))
 	    {
 	      vlib_error_count (vm, node->node_index,
 				VHOST_USER_TX_FUNC_ERROR_MMAP_FAIL, 1);
 	    }
 	  copy_len = 0;
 
-	  /* give buffers back to driver */
-	  CLIB_MEMORY_BARRIER ();
-	  rxvq->used->idx = rxvq->last_used_idx;
-	  vhost_user_log_dirty_ring (vui, rxvq, idx);
+	  /* give buffers back to driver, after the DMA copies if any */
+	  if (dq == 0)
+	    {
+	      CLIB_MEMORY_BARRIER ();
+	      rxvq->used->idx = rxvq->last_used_idx;
+	      vhost_user_log_dirty_ring (vui, rxvq, idx);
+	    }
 	}
       buffers++;
     }
 
 done:
   //Do the memory copies
-  if (PREDICT_FALSE (vhost_user_tx_copy (vui, cpu->copy, copy_len,
-					 &map_hint)))
+  if (PREDICT_FALSE (vhost_user_tx_copy_any (vm, vui, dma_batch, cpu->copy,
+					     copy_len, &map_hint)))
     {
       vlib_error_count (vm, node->node_index,
 			VHOST_USER_TX_FUNC_ERROR_MMAP_FAIL, 1);
     }
 
-  CLIB_MEMORY_BARRIER ();
-  rxvq->used->idx = rxvq->last_used_idx;
-  vhost_user_log_dirty_ring (vui, rxvq, idx);
+  if (dq == 0)
+    {
+      CLIB_MEMORY_BARRIER ();
+      rxvq->used->idx = rxvq->last_used_idx;
+      vhost_user_log_dirty_ring (vui, rxvq, idx);
+    }
 
   /*
    * When n_left is set, error is always set to something too.
@@ -1001,9 +1062,47 @@ done:
       goto retry;
     }
 
-  /* interrupt (call) handling */
-  if ((rxvq->callfd_idx != ~0) &&
-      !(rxvq->avail->flags & VRING_AVAIL_F_NO_INTERRUPT))
+  if (dq)
+    {
+      u32 n_sent = frame->n_vectors - n_left;
+      vhost_user_dma_slot_t *s;
+
+      if (dma_batch)
+	{
+	  /* buffers are the copy sources, keep them until the batch is done */
+	  s = dq->slots + dq->head % VHOST_USER_DMA_N_SLOTS;
+	  s->used_idx = rxvq->last_used_idx;
+	  s->n_packets = n_sent;
+	  s->done = 0;
+	  vec_add (s->buffers, vlib_frame_vector_args (frame), n_sent);
+	  n_dma_buffers = n_sent;
+
+	  vlib_dma_batch_set_cookie (
+	    vm, dma_batch,
+	    (u64) vui->if_index << 32 | (u64) dq->gen << 16 |
+	      tf->queue_id << 8 | dq->head % VHOST_USER_DMA_N_SLOTS);
+	  dq->head++;
+
+	  if (dma_batch->n_enq)
+	    vlib_dma_batch_submit (vm, dma_batch);
+	  else
+	    {
+	      /* everything was copied by the cpu, give the batch back */
+	      vlib_dma_batch_submit (vm, dma_batch);
+	      s->done = 1;
+	      vhost_user_dma_complete (vm, vui, tf->queue_id);
+	    }
+	}
+      else
+	{
+	  s = dq->slots + (u16) (dq->head - 1) % VHOST_USER_DMA_N_SLOTS;
+	  s->used_idx = rxvq->last_used_idx;
+	  s->n_packets += n_sent;
+	}
+    }
+  /* interrupt (call) handling, done on DMA completion otherwise */
+  else if ((rxvq->callfd_idx != ~0) &&
+	   !(rxvq->avail->flags & VRING_AVAIL_F_NO_INTERRUPT))
     {
       rxvq->n_since_last_int += frame->n_vectors - n_left;
 
@@ -1023,7 +1122,8 @@ done3:
 	 thread_index, vui->sw_if_index, n_left);
     }
 
-  vlib_buffer_free (vm, vlib_frame_vector_args (frame), frame->n_vectors);
+  vlib_buffer_free (vm, vlib_frame_vector_args (frame) + n_dma_buffers,
+		    frame->n_vectors - n_dma_buffers);
   return frame->n_vectors;
 }
 
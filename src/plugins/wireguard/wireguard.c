@@ -36,6 +36,18 @@ wg_set_async_mode (u32 is_enabled)
     wg_op_mode_unset_ASYNC ();
 }
 
+void
+wg_set_parallel_mode (u32 is_enabled)
+{
+  /* workers must not be mid-frame while peers change ownership */
+  vlib_worker_thread_barrier_sync (vlib_get_main ());
+  if (is_enabled)
+    wg_op_mode_set_PARALLEL ();
+  else
+    wg_op_mode_unset_PARALLEL ();
+  vlib_worker_thread_barrier_release (vlib_get_main ());
+}
+
 static void
 wireguard_register_post_node (vlib_main_t *vm)
 
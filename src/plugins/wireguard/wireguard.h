@@ -18,6 +18,7 @@
 #include <wireguard/wireguard_index_table.h>
 #include <wireguard/wireguard_messages.h>
 #include <wireguard/wireguard_timer.h>
+#include <wireguard/wireguard_noise.h>
 #include <vnet/buffer.h>
 
 #define WG_DEFAULT_DATA_SIZE 2048
@@ -34,6 +35,8 @@ typedef struct wg_per_thread_data_t_
   vnet_crypto_op_t *chained_crypto_ops;
   vnet_crypto_op_chunk_t *chunks;
   vnet_crypto_async_frame_t **async_frames;
+  /* parallel mode: send counters reserved by this thread, per peer */
+  noise_counter_range_t *send_ranges;
   u8 data[WG_DEFAULT_DATA_SIZE];
 } wg_per_thread_data_t;
 
@@ -74,7 +77,9 @@ extern wg_main_t wg_main;
 /**
  * Wireguard operation mode
  **/
-#define foreach_wg_op_mode_flags _ (0, ASYNC, "async")
+#define foreach_wg_op_mode_flags                                              \
+  _ (0, ASYNC, "async")                                                       \
+  _ (1, PARALLEL, "parallel")
 
 /**
  * Helper function to set/unset and check op modes
@@ -119,6 +124,7 @@ STATIC_ASSERT (sizeof (wg_post_data_t) <=
 #define WG_START_EVENT	1
 void wg_feature_init (wg_main_t * wmp);
 void wg_set_async_mode (u32 is_enabled);
+void wg_set_parallel_mode (u32 is_enabled);
 
 void wg_secure_zero_memory (void *v, size_t n);
 
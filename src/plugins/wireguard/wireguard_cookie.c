@@ -176,6 +176,20 @@ cookie_checker_validate_macs (vlib_main_t *vm, cookie_checker_t *cc,
   return VALID_MAC_WITH_COOKIE;
 }
 
+/* Check mac1 only. This needs no per-checker state besides the mac1 key,
+ * so it is safe to call from any thread. */
+bool
+cookie_checker_validate_mac1 (cookie_checker_t *cc, message_macs_t *cm,
+			      void *buf, size_t len)
+{
+  message_macs_t our_cm;
+
+  len = len - sizeof (message_macs_t);
+  cookie_macs_mac1 (&our_cm, buf, len, cc->cc_mac1_key);
+
+  return (clib_memcmp (our_cm.mac1, cm->mac1, COOKIE_MAC_SIZE) == 0);
+}
+
 /* Private functions */
 static void
 cookie_precompute_key (uint8_t * key, const uint8_t input[COOKIE_INPUT_SIZE],
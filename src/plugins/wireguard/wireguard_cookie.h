@@ -112,6 +112,8 @@ enum cookie_mac_state
 cookie_checker_validate_macs (vlib_main_t *vm, cookie_checker_t *,
 			      message_macs_t *, void *, size_t, bool,
 			      ip46_address_t *ip, u16 udp_port);
+bool cookie_checker_validate_mac1 (cookie_checker_t *, message_macs_t *,
+				   void *, size_t);
 
 #endif /* __included_wg_cookie_h__ */
 
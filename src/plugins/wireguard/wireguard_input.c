@@ -131,6 +131,100 @@ is_ip4_header (u8 *data)
   return (data[0] >> 4) == 0x4;
 }
 
+typedef struct
+{
+  index_t peeri;
+  u32 r_idx;
+} wg_input_keypair_slide_args_t;
+
+static void
+wg_input_keypair_slide_thread_fn (void *arg)
+{
+  wg_input_keypair_slide_args_t *a = arg;
+  vlib_main_t *vm = vlib_get_main ();
+  noise_remote_t *r;
+  wg_peer_t *peer;
+  bool slid = false;
+
+  if (pool_is_free_index (wg_peer_pool, a->peeri))
+    return;
+
+  peer = wg_peer_get (a->peeri);
+  r = &peer->remote;
+
+  /* runs under the barrier, no worker can still be using r_previous */
+  clib_rwlock_writer_lock (&r->r_keypair_lock);
+  if (r->r_next != NULL && r->r_next->kp_local_index == a->r_idx)
+    {
+      noise_remote_keypair_free (vm, r, &r->r_previous);
+      r->r_previous = r->r_current;
+      r->r_current = r->r_next;
+      r->r_next = NULL;
+      slid = true;
+    }
+  clib_rwlock_writer_unlock (&r->r_keypair_lock);
+  clib_atomic_release (&r->r_slide_pending);
+
+  if (slid)
+    wg_timers_handshake_complete (peer);
+}
+
+/* In parallel mode other workers may still be decrypting with the previous
+ * keypair, so the slide is left to the main thread which does it under the
+ * barrier. */
+static_always_inline void
+wg_input_keypair_slide_from_mt (noise_remote_t *r, u32 r_idx)
+{
+  wg_input_keypair_slide_args_t a = {
+    .peeri = r->r_peer_idx,
+    .r_idx = r_idx,
+  };
+
+  if (clib_atomic_test_and_set (&r->r_slide_pending))
+    return;
+
+  vlib_rpc_call_main_thread (wg_input_keypair_slide_thread_fn, (u8 *) &a,
+			     sizeof (a));
+}
+
+/* Cheap mac1 check done by workers in parallel mode before a handshake is
+ * handed off, so that floods of bogus handshakes are dropped on the
+ * workers and do not queue up in front of the main thread. */
+static bool
+wg_handshake_mac1_is_valid (vlib_buffer_t *b)
+{
+  message_header_t *header = vlib_buffer_get_current (b);
+  udp_header_t *uhd = (void *) header - sizeof (udp_header_t);
+  message_macs_t *macs;
+  index_t *wg_ifs, *ii;
+  wg_if_t *wg_if;
+  u32 len;
+
+  if (header->type == MESSAGE_HANDSHAKE_INITIATION)
+    len = sizeof (message_handshake_initiation_t);
+  else if (header->type == MESSAGE_HANDSHAKE_RESPONSE)
+    len = sizeof (message_handshake_response_t);
+  else
+    return true;
+
+  if (b->current_length < len)
+    return false;
+
+  macs = (message_macs_t *) ((u8 *) header + len - sizeof (*macs));
+  wg_ifs = wg_if_indexes_get_by_port (clib_net_to_host_u16 (uhd->dst_port));
+
+  vec_foreach (ii, wg_ifs)
+    {
+      wg_if = wg_if_get (*ii);
+      if (wg_if &&
+	  cookie_checker_validate_mac1 (&wg_if->cookie_checker, macs, header,
+					len))
+	return true;
+    }
+
+  return false;
+}
+
 static wg_input_error_t
 wg_handshake_process (vlib_main_t *vm, wg_main_t *wmp, vlib_buffer_t *b,
 		      u32 node_idx, u8 is_ip4)
@@ -346,7 +440,12 @@ wg_input_post_process (vlib_main_t *vm, vlib_buffer_t *b, u16 *next,
       NULL)
     return -1;
 
-  if (!noise_counter_recv (&kp->kp_ctr, data->counter))
+  if (wg_op_mode_is_set_PARALLEL ())
+    {
+      if (!noise_counter_recv_locked (&kp->kp_ctr, data->counter))
+	return -1;
+    }
+  else if (!noise_counter_recv (&kp->kp_ctr, data->counter))
     {
       return -1;
     }
@@ -550,7 +649,7 @@ wg_input_add_to_frame (vlib_main_t *vm, vnet_crypto_async_frame_t *f,
   vnet_crypto_async_frame_elt_t *fe;
   u16 index;
 
-  ASSERT (f->n_elts < VNET_CRYPTO_FRAME_SIZE);
+  ASSERT (f->n_elts < f->max_elts);
 
   index = f->n_elts;
   fe = &f->elts[index];
@@ -631,7 +730,11 @@ wg_input_process (vlib_main_t *vm, wg_per_thread_data_t *ptd,
    * next keypair into current. If we do slide the next keypair in, then
    * we skip the REKEY_AFTER_TIME_RECV check. This is safe to do as a
    * data packet can't confirm a session that we are an INITIATOR of. */
-  if (kp == r->r_next)
+  if (kp == r->r_next && wg_op_mode_is_set_PARALLEL ())
+    {
+      wg_input_keypair_slide_from_mt (r, r_idx);
+    }
+  else if (kp == r->r_next)
     {
       clib_rwlock_writer_lock (&r->r_keypair_lock);
       if (kp == r->r_next && kp->kp_local_index == r_idx)
@@ -709,6 +812,7 @@ wg_input_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
   u16 data_nexts[VLIB_FRAME_SIZE], *data_next = data_nexts, n_data = 0;
   u16 n_async = 0;
   const u8 is_async = wg_op_mode_is_set_ASYNC ();
+  const u8 is_parallel = wg_op_mode_is_set_PARALLEL ();
   vnet_crypto_async_frame_t *async_frame = NULL;
 
   vlib_get_buffers (vm, from, bufs, n_left_from);
@@ -789,7 +893,8 @@ wg_input_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 					wg_peer_assign_thread (thread_index));
 	    }
 
-	  if (PREDICT_TRUE (thread_index != peer->input_thread_index))
+	  if (PREDICT_TRUE (!is_parallel &&
+			    thread_index != peer->input_thread_index))
 	    {
 	      other_next[n_other] = WG_INPUT_NEXT_HANDOFF_DATA;
 	      other_bi[n_other] = buf_idx;
@@ -893,6 +998,14 @@ wg_input_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	  /* Handshake packets should be processed in main thread */
 	  if (thread_index != 0)
 	    {
+	      if (is_parallel && !wg_handshake_mac1_is_valid (b[0]))
+		{
+		  other_next[n_other] = WG_INPUT_NEXT_ERROR;
+		  b[0]->error = node->errors[WG_INPUT_ERROR_HANDSHAKE_MAC];
+		  other_bi[n_other] = from[b - bufs];
+		  n_other += 1;
+		  goto out;
+		}
 	      other_next[n_other] = WG_INPUT_NEXT_HANDOFF_HANDSHAKE;
 	      other_bi[n_other] = from[b - bufs];
 	      n_other += 1;
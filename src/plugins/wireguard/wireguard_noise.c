@@ -515,8 +515,16 @@ noise_remote_encrypt (vlib_main_t * vm, noise_remote_t * r, uint32_t * r_idx,
    */
   if (!kp->kp_valid ||
       wg_birthdate_has_expired (kp->kp_birthdate, REJECT_AFTER_TIME) ||
-      kp->kp_ctr.c_recv >= REJECT_AFTER_MESSAGES ||
-      ((*nonce = noise_counter_send (&kp->kp_ctr)) > REJECT_AFTER_MESSAGES))
+      kp->kp_ctr.c_recv >= REJECT_AFTER_MESSAGES)
+    goto error;
+
+  /* in parallel mode workers reserve send counters concurrently */
+  if (wg_op_mode_is_set_PARALLEL ())
+    *nonce = clib_atomic_fetch_add (&kp->kp_ctr.c_send, 1);
+  else
+    *nonce = noise_counter_send (&kp->kp_ctr);
+
+  if (*nonce > REJECT_AFTER_MESSAGES)
     goto error;
 
   /* We encrypt into the same buffer, so the caller must ensure that buf
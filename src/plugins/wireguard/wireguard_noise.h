@@ -38,6 +38,10 @@
 #define COUNTER_BITS		(sizeof(unsigned long) * 8)
 #define COUNTER_NUM		(COUNTER_BITS_TOTAL / COUNTER_BITS)
 #define COUNTER_WINDOW_SIZE	(COUNTER_BITS_TOTAL - COUNTER_BITS)
+/* Send counters reserved at once by a thread in parallel mode. Each thread
+ * can be at most one batch ahead of the others, so the total skew seen by
+ * the receiver stays well within the replay window. */
+#define COUNTER_SEND_BATCH	64
 
 /* Constants for the keypair */
 #define REKEY_AFTER_MESSAGES	(1ull << 60)
@@ -81,8 +85,20 @@ typedef struct noise_counter
   uint64_t c_send;
   uint64_t c_recv;
   unsigned long c_backtrack[COUNTER_NUM];
+  /* serializes c_recv/c_backtrack updates when several threads
+   * receive on the same keypair */
+  volatile u32 c_recv_lock;
 } noise_counter_t;
 
+/* Per-thread range of send counters reserved from a keypair */
+typedef struct noise_counter_range
+{
+  uint32_t cr_local_index;
+  f64 cr_birthdate;
+  uint64_t cr_next;
+  uint64_t cr_end;
+} noise_counter_range_t;
+
 typedef struct noise_keypair
 {
   int kp_valid;
@@ -110,6 +126,8 @@ typedef struct noise_remote
 
   clib_rwlock_t r_keypair_lock;
   noise_keypair_t *r_next, *r_current, *r_previous;
+  /* parallel mode: next keypair confirmed, slide requested from main */
+  volatile u32 r_slide_pending;
 } noise_remote_t;
 
 typedef struct noise_local
@@ -144,6 +162,32 @@ noise_counter_send (noise_counter_t *ctr)
   return ret;
 }
 
+/* Take the next send counter from the thread's reserved range, reserving a
+ * new batch from the keypair once it is used up or belongs to an older
+ * keypair. Several threads may encrypt with the same keypair this way
+ * without ever reusing a nonce.
+ * A thread that sends rarely keeps its range while the others move the
+ * keypair counter on; the range is also dropped once it falls half a
+ * replay window behind, well before the peer would reject its counters
+ * as too old. */
+static_always_inline uint64_t
+noise_counter_send_range (noise_keypair_t *kp, noise_counter_range_t *cr)
+{
+  if (PREDICT_FALSE (cr->cr_next >= cr->cr_end ||
+		     cr->cr_local_index != kp->kp_local_index ||
+		     cr->cr_birthdate != kp->kp_birthdate ||
+		     cr->cr_next + COUNTER_WINDOW_SIZE / 2 <=
+		       clib_atomic_load_relax_n (&kp->kp_ctr.c_send)))
+    {
+      cr->cr_local_index = kp->kp_local_index;
+      cr->cr_birthdate = kp->kp_birthdate;
+      cr->cr_next =
+	clib_atomic_fetch_add (&kp->kp_ctr.c_send, COUNTER_SEND_BATCH);
+      cr->cr_end = cr->cr_next + COUNTER_SEND_BATCH;
+    }
+  return cr->cr_next++;
+}
+
 void noise_local_init (noise_local_t *, struct noise_upcall *);
 bool noise_local_set_private (noise_local_t *,
 			      const uint8_t[NOISE_PUBLIC_KEY_LEN]);
@@ -258,6 +302,19 @@ error:
   return ret;
 }
 
+static_always_inline bool
+noise_counter_recv_locked (noise_counter_t *ctr, uint64_t recv)
+{
+  bool ret;
+
+  while (clib_atomic_test_and_set (&ctr->c_recv_lock))
+    CLIB_PAUSE ();
+  ret = noise_counter_recv (ctr, recv);
+  clib_atomic_release (&ctr->c_recv_lock);
+
+  return ret;
+}
+
 static_always_inline void
 noise_remote_keypair_free (vlib_main_t *vm, noise_remote_t *r,
 			   noise_keypair_t **kp)
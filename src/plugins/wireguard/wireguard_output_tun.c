@@ -254,7 +254,7 @@ wg_output_tun_add_to_frame (vlib_main_t *vm, vnet_crypto_async_frame_t *f,
   vnet_crypto_async_frame_elt_t *fe;
   u16 index;
 
-  ASSERT (f->n_elts < VNET_CRYPTO_FRAME_SIZE);
+  ASSERT (f->n_elts < f->max_elts);
 
   index = f->n_elts;
   fe = &f->elts[index];
@@ -269,6 +269,22 @@ wg_output_tun_add_to_frame (vlib_main_t *vm, vnet_crypto_async_frame_t *f,
   f->next_node_index[index] = next_node;
 }
 
+static_always_inline uint64_t
+wg_output_tun_counter_send (wg_per_thread_data_t *ptd, noise_remote_t *r,
+			    noise_keypair_t *kp)
+{
+  /* In parallel mode several workers encrypt for the same peer, each one
+   * takes nonces from its own reserved range */
+  if (wg_op_mode_is_set_PARALLEL ())
+    {
+      vec_validate (ptd->send_ranges, r->r_peer_idx);
+      return noise_counter_send_range (
+	kp, vec_elt_at_index (ptd->send_ranges, r->r_peer_idx));
+    }
+
+  return noise_counter_send (&kp->kp_ctr);
+}
+
 static_always_inline enum noise_state_crypt
 wg_output_tun_process (vlib_main_t *vm, wg_per_thread_data_t *ptd,
 		       vlib_buffer_t *b, vlib_buffer_t *lb,
@@ -292,7 +308,8 @@ wg_output_tun_process (vlib_main_t *vm, wg_per_thread_data_t *ptd,
       wg_birthdate_has_expired_opt (kp->kp_birthdate, REJECT_AFTER_TIME,
 				    time) ||
       kp->kp_ctr.c_recv >= REJECT_AFTER_MESSAGES ||
-      ((*nonce = noise_counter_send (&kp->kp_ctr)) > REJECT_AFTER_MESSAGES))
+      ((*nonce = wg_output_tun_counter_send (ptd, r, kp)) >
+       REJECT_AFTER_MESSAGES))
     goto error;
 
   /* We encrypt into the same buffer, so the caller must ensure that buf
@@ -352,7 +369,8 @@ wg_add_to_async_frame (vlib_main_t *vm, wg_per_thread_data_t *ptd,
       wg_birthdate_has_expired_opt (kp->kp_birthdate, REJECT_AFTER_TIME,
 				    time) ||
       kp->kp_ctr.c_recv >= REJECT_AFTER_MESSAGES ||
-      ((*nonce = noise_counter_send (&kp->kp_ctr)) > REJECT_AFTER_MESSAGES))
+      ((*nonce = wg_output_tun_counter_send (ptd, r, kp)) >
+       REJECT_AFTER_MESSAGES))
     goto error;
 
   /* We encrypt into the same buffer, so the caller must ensure that buf
@@ -440,6 +458,7 @@ wg_output_tun_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
   u16 n_sync = 0;
   const u16 drop_next = WG_OUTPUT_NEXT_ERROR;
   const u8 is_async = wg_op_mode_is_set_ASYNC ();
+  const u8 is_parallel = wg_op_mode_is_set_PARALLEL ();
   vnet_crypto_async_frame_t *async_frame = NULL;
   u16 n_async = 0;
   u16 noop_nexts[VLIB_FRAME_SIZE], *noop_next = noop_nexts, n_noop = 0;
@@ -511,7 +530,8 @@ wg_output_tun_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 				    wg_peer_assign_thread (thread_index));
 	}
 
-      if (PREDICT_FALSE (thread_index != peer->output_thread_index))
+      if (PREDICT_FALSE (!is_parallel &&
+			 thread_index != peer->output_thread_index))
 	{
 	  noop_next[0] = WG_OUTPUT_NEXT_HANDOFF;
 	  err = WG_OUTPUT_NEXT_HANDOFF;
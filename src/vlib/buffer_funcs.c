@@ -22,7 +22,7 @@ enqueue_one (vlib_main_t *vm, vlib_node_runtime_t *node,
 
   maybe_aux = maybe_aux && f->aux_offset;
 
-  n_free = VLIB_FRAME_SIZE - f->n_vectors;
+  n_free = f->max_vectors - f->n_vectors;
 
   /* if frame contains enough space for worst case scenario, we can avoid
    * use of tmp */
@@ -63,28 +63,29 @@ enqueue_one (vlib_main_t *vm, vlib_node_runtime_t *node,
     }
   else
     {
-      /* full frame */
-      to = (u32 *) vlib_frame_vector_args (f) + f->n_vectors;
-      vlib_buffer_copy_indices (to, tmp, n_free);
-      if (maybe_aux)
-	{
-	  to_aux = (u32 *) vlib_frame_aux_args (f) + f->n_vectors;
-	  vlib_buffer_copy_indices (to_aux, tmp_aux, n_free);
-	}
-      vlib_put_next_frame (vm, node, next_index, 0);
+      /* full frame, spill into as many new frames as the next node's
+       * vector length needs */
+      u32 n_done = 0, n;
 
-      /* second frame */
-      u32 n_2nd_frame = n_extracted - n_free;
-      f = vlib_get_next_frame_internal (vm, node, next_index, 1);
-      to = vlib_frame_vector_args (f);
-      vlib_buffer_copy_indices (to, tmp + n_free, n_2nd_frame);
-      if (maybe_aux)
+      while (1)
 	{
-	  to_aux = vlib_frame_aux_args (f);
-	  vlib_buffer_copy_indices (to_aux, tmp_aux + n_free, n_2nd_frame);
+	  n = clib_min (n_free, n_extracted - n_done);
+	  to = (u32 *) vlib_frame_vector_args (f) + f->n_vectors;
+	  vlib_buffer_copy_indices (to, tmp + n_done, n);
+	  if (maybe_aux)
+	    {
+	      to_aux = (u32 *) vlib_frame_aux_args (f) + f->n_vectors;
+	      vlib_buffer_copy_indices (to_aux, tmp_aux + n_done, n);
+	    }
+	  vlib_put_next_frame (vm, node, next_index, n_free - n);
+	  n_done += n;
+
+	  if (n_done == n_extracted)
+	    break;
+
+	  f = vlib_get_next_frame_internal (vm, node, next_index, 1);
+	  n_free = f->max_vectors;
 	}
-      vlib_put_next_frame (vm, node, next_index,
-			   VLIB_FRAME_SIZE - n_2nd_frame);
     }
 
   return n_left - n_extracted;
@@ -319,6 +320,7 @@ more:
       hf->n_vectors = n_comp;
       __atomic_store_n (&hf->valid, 1, __ATOMIC_RELEASE);
       vlib_get_main_by_index (thread_index)->check_frame_queues = 1;
+      vlib_thread_wakeup (vlib_get_main_by_index (thread_index));
     }
   else
     n_drop += n_comp;
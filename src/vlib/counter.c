@@ -185,6 +185,86 @@ vlib_free_combined_counter (vlib_combined_counter_main_t * cm)
     }
 }
 
+void
+vlib_validate_histogram (vlib_histogram_main_t *hm, u32 index)
+{
+  vlib_thread_main_t *tm = vlib_get_thread_main ();
+  char *name = hm->stat_segment_name ? hm->stat_segment_name : hm->name;
+  vlib_stats_histogram_t *h;
+
+  ASSERT (hm->n_bins > 1);
+
+  if (name == 0)
+    {
+      if (hm->counters == 0)
+	hm->stats_entry_index = ~0;
+      vec_validate (hm->counters, tm->n_vlib_mains - 1);
+      vec_validate (hm->sums, tm->n_vlib_mains - 1);
+      for (int i = 0; i < tm->n_vlib_mains; i++)
+	{
+	  vec_validate_aligned (hm->counters[i], (index + 1) * hm->n_bins - 1,
+				CLIB_CACHE_LINE_BYTES);
+	  vec_validate_aligned (hm->sums[i], index, CLIB_CACHE_LINE_BYTES);
+	}
+      return;
+    }
+
+  if (hm->counters == 0)
+    {
+      if (hm->width)
+	hm->stats_entry_index = vlib_stats_add_histogram_linear (
+	  hm->n_bins, hm->base, hm->width, "%s", name);
+      else
+	hm->stats_entry_index =
+	  vlib_stats_add_histogram_log2 (hm->n_bins, hm->base, "%s", name);
+    }
+
+  vlib_stats_validate (hm->stats_entry_index, tm->n_vlib_mains - 1, index);
+  h = vlib_stats_get_entry_data_pointer (hm->stats_entry_index);
+  hm->counters = h->counters;
+  hm->sums = h->sums;
+}
+
+void
+vlib_clear_histograms (vlib_histogram_main_t *hm)
+{
+  uword i;
+
+  for (i = 0; i < vec_len (hm->counters); i++)
+    {
+      clib_memset_u64 (hm->counters[i], 0, vec_len (hm->counters[i]));
+      clib_memset_u64 (hm->sums[i], 0, vec_len (hm->sums[i]));
+    }
+}
+
+void
+vlib_free_histogram (vlib_histogram_main_t *hm)
+{
+  if (hm->stats_entry_index == ~0)
+    {
+      for (int i = 0; i < vec_len (hm->counters); i++)
+	{
+	  vec_free (hm->counters[i]);
+	  vec_free (hm->sums[i]);
+	}
+      vec_free (hm->counters);
+      vec_free (hm->sums);
+    }
+  else
+    {
+      vlib_stats_remove_entry (hm->stats_entry_index);
+      hm->counters = NULL;
+      hm->sums = NULL;
+    }
+}
+
+u32
+vlib_histogram_n_histograms (const vlib_histogram_main_t *hm)
+{
+  ASSERT (hm->counters);
+  return (vec_len (hm->counters[0]) / hm->n_bins);
+}
+
 u32
 vlib_combined_counter_n_counters (const vlib_combined_counter_main_t * cm)
 {
@@ -348,6 +348,164 @@ int vlib_validate_combined_counter_will_expand
 
 void vlib_free_combined_counter (vlib_combined_counter_main_t * cm);
 
+/** A collection of histograms
+
+    Each index owns n_bins consecutive per-thread counters. Bin 0 counts
+    values below the first bound, bin i values below bound i and the last
+    bin everything else. Bound i is 2^(base + i) for log2 histograms
+    (width == 0) and base + i * width for linear ones.
+*/
+
+typedef struct
+{
+  counter_t **counters;	 /**< Per-thread bins, n_bins per index */
+  counter_t **sums;	 /**< Per-thread sum of the recorded values */
+  char *name;		 /**< The histogram collection's name. */
+  char *stat_segment_name; /**< Name in stat segment directory */
+  u32 stats_entry_index;
+  u32 n_bins;		 /**< Bins per histogram, including the last */
+  u32 base;		 /**< First bin bound, or its log2 */
+  u32 width;		 /**< Linear bin width, 0 for log2 bins */
+} vlib_histogram_main_t;
+
+/** The number of histograms (not the number of bins) */
+u32 vlib_histogram_n_histograms (const vlib_histogram_main_t *hm);
+
+/** Find the bin a value falls in
+    @param hm - (vlib_histogram_main_t *) histogram main pointer
+    @param value - (u64) the value to bin
+    @returns - (u32) the bin index
+*/
+always_inline u32
+vlib_histogram_bin (const vlib_histogram_main_t *hm, u64 value)
+{
+  i64 bin;
+
+  if (hm->width)
+    bin = value < hm->base ? 0 : (value - hm->base) / hm->width + 1;
+  else
+    bin = value ? (i64) min_log2 (value) - hm->base + 1 : 0;
+
+  return clib_clamp (bin, 0, (i64) hm->n_bins - 1);
+}
+
+/** Exclusive upper bound of a bin, ~0 for the last one */
+always_inline u64
+vlib_histogram_bin_bound (const vlib_histogram_main_t *hm, u32 bin)
+{
+  if (bin + 1 >= hm->n_bins)
+    return ~0ULL;
+  if (hm->width)
+    return (u64) hm->base + (u64) bin * hm->width;
+  return 1ULL << (hm->base + bin);
+}
+
+/** Add to a histogram bin
+    @param hm - (vlib_histogram_main_t *) histogram main pointer
+    @param thread_index - (u32) the current cpu index
+    @param index - (u32) index of the histogram
+    @param bin - (u32) the bin, see vlib_histogram_bin
+    @param increment - (u64) quantity to add to the bin
+    @param sum - (u64) total of the values being added
+*/
+always_inline void
+vlib_increment_histogram_bin (vlib_histogram_main_t *hm, u32 thread_index,
+			      u32 index, u32 bin, u64 increment, u64 sum)
+{
+  counter_t *my_counters;
+
+  ASSERT (bin < hm->n_bins);
+
+  my_counters = hm->counters[thread_index];
+  my_counters[index * hm->n_bins + bin] += increment;
+  hm->sums[thread_index][index] += sum;
+}
+
+/** Record one value in a histogram
+    @param hm - (vlib_histogram_main_t *) histogram main pointer
+    @param thread_index - (u32) the current cpu index
+    @param index - (u32) index of the histogram
+    @param value - (u64) the value to record
+*/
+always_inline void
+vlib_increment_histogram (vlib_histogram_main_t *hm, u32 thread_index,
+			  u32 index, u64 value)
+{
+  vlib_increment_histogram_bin (hm, thread_index, index,
+				vlib_histogram_bin (hm, value), 1, value);
+}
+
+/** Get the bins of a histogram, summed over all threads
+    @param hm - (vlib_histogram_main_t *) histogram main pointer
+    @param index - (u32) index of the histogram to fetch
+    @param [out] bins - (counter_t *) n_bins counters
+*/
+always_inline void
+vlib_get_histogram (const vlib_histogram_main_t *hm, u32 index,
+		    counter_t *bins)
+{
+  counter_t *my_counters;
+  u32 i, j;
+
+  ASSERT (index < vlib_histogram_n_histograms (hm));
+
+  for (j = 0; j < hm->n_bins; j++)
+    bins[j] = 0;
+
+  for (i = 0; i < vec_len (hm->counters); i++)
+    {
+      my_counters = hm->counters[i] + index * hm->n_bins;
+      for (j = 0; j < hm->n_bins; j++)
+	bins[j] += my_counters[j];
+    }
+}
+
+/** Get the sum of the values recorded in a histogram, over all threads
+    @param hm - (vlib_histogram_main_t *) histogram main pointer
+    @param index - (u32) index of the histogram
+    @returns - (counter_t) the sum
+*/
+always_inline counter_t
+vlib_get_histogram_sum (const vlib_histogram_main_t *hm, u32 index)
+{
+  counter_t sum = 0;
+  u32 i;
+
+  ASSERT (index < vlib_histogram_n_histograms (hm));
+
+  for (i = 0; i < vec_len (hm->sums); i++)
+    sum += hm->sums[i][index];
+
+  return sum;
+}
+
+/** Clear a histogram
+    @param hm - (vlib_histogram_main_t *) histogram main pointer
+    @param index - (u32) index of the histogram to clear
+*/
+always_inline void
+vlib_zero_histogram (vlib_histogram_main_t *hm, u32 index)
+{
+  u32 i;
+
+  ASSERT (index < vlib_histogram_n_histograms (hm));
+
+  for (i = 0; i < vec_len (hm->counters); i++)
+    {
+      clib_memset_u64 (hm->counters[i] + index * hm->n_bins, 0, hm->n_bins);
+      hm->sums[i][index] = 0;
+    }
+}
+
+/** validate a histogram
+    @param hm - (vlib_histogram_main_t *) pointer to the histogram collection
+    @param index - (u32) index of the histogram to validate
+*/
+
+void vlib_validate_histogram (vlib_histogram_main_t *hm, u32 index);
+void vlib_clear_histograms (vlib_histogram_main_t *hm);
+void vlib_free_histogram (vlib_histogram_main_t *hm);
+
 /** Obtain the number of simple or combined counters allocated.
     A macro which reduces to to vec_len(cm->maxi), the answer in either
     case.
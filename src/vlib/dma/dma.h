@@ -59,6 +59,8 @@ typedef struct vlib_dma_batch
 typedef struct
 {
   char *name;
+  /* only tried after all other backends refused the config */
+  u8 fallback;
   vlib_dma_config_add_fn *config_add_fn;
   vlib_dma_config_del_fn *config_del_fn;
   format_function_t *info_fn;
@@ -0,0 +1,513 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2024 Cisco Systems, Inc.
+ */
+
+#include <vlib/vlib.h>
+#include <vlib/log.h>
+#include <vlib/unix/unix.h>
+#include <vlib/dma/dma.h>
+
+/*
+ * Software DMA backend. Batches are copied by "dma-sw" helper threads
+ * ("cpu { dma-sw <n> }" in startup.conf), each serving a fixed subset of
+ * the vlib threads through a single producer / single consumer ring per
+ * vlib thread. When the ring is full, the batch is copied by the
+ * submitting thread. Completion callbacks are always run on the
+ * submitting thread, in submission order, by the dma-sw input node.
+ * The backend is only tried after all hardware backends refused a config,
+ * and refuses it too without helpers: an inline copy completed on the next
+ * loop is slower than the direct copy DMA users fall back to.
+ *
+ * A helper with nothing to copy polls for a while and then goes to sleep,
+ * in umwait on its doorbell where available, otherwise in naps growing up
+ * to idle-wakeup-usec. Submitters ring the doorbell of a sleeping helper.
+ */
+
+#define VLIB_DMA_SW_RING_SIZE	   256
+#define VLIB_DMA_SW_IDLE_POLLS	   1024
+#define VLIB_DMA_SW_MAX_SLEEP_USEC 1000
+
+typedef enum
+{
+  VLIB_DMA_SW_STATUS_IDLE = 0,
+  VLIB_DMA_SW_STATUS_BUSY,
+  VLIB_DMA_SW_STATUS_DONE,
+} vlib_dma_sw_status_t;
+
+typedef struct
+{
+  void *dst;
+  void *src;
+  u32 size;
+} vlib_dma_sw_desc_t;
+
+struct vlib_dma_sw_config;
+
+typedef struct
+{
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
+  vlib_dma_batch_t batch;
+  struct vlib_dma_sw_config *config;
+  u16 thread_index;
+  volatile u8 status;
+  vlib_dma_sw_desc_t descs[0];
+} vlib_dma_sw_batch_t;
+
+STATIC_ASSERT_OFFSET_OF (vlib_dma_sw_batch_t, batch, 0);
+
+typedef struct vlib_dma_sw_config
+{
+  vlib_dma_sw_batch_t batch_template;
+  vlib_dma_sw_batch_t ***freelists;
+  u32 config_index;
+  u32 alloc_size;
+} vlib_dma_sw_config_t;
+
+typedef struct
+{
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
+  vlib_dma_sw_batch_t **pending;
+  u64 submitted;
+  u64 offloaded;
+  u64 copied_inline;
+  u64 completed;
+
+  /* written by the submitting thread */
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline1);
+  u32 head;
+
+  /* written by the helper thread */
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline2);
+  u32 tail;
+  u64 helper_bytes;
+
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline3);
+  vlib_dma_sw_batch_t *ring[VLIB_DMA_SW_RING_SIZE];
+} vlib_dma_sw_thread_t;
+
+typedef struct
+{
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
+  volatile u8 sleeping;
+  volatile u64 doorbell;
+  u64 n_sleeps;
+  u64 n_wakeups;
+} vlib_dma_sw_helper_t;
+
+typedef struct
+{
+  vlib_dma_sw_thread_t *threads;
+  vlib_dma_sw_helper_t *helpers;
+  u32 n_helpers;
+  u32 n_configs;
+  volatile u8 ready;
+} vlib_dma_sw_main_t;
+
+static vlib_dma_sw_main_t vlib_dma_sw_main;
+extern vlib_node_registration_t vlib_dma_sw_node;
+extern vlib_thread_registration_t vlib_dma_sw_thread_reg;
+
+VLIB_REGISTER_LOG_CLASS (dma_sw_log, static) = {
+  .class_name = "dma",
+  .subclass_name = "sw",
+};
+
+static_always_inline void
+vlib_dma_sw_copy (vlib_dma_sw_batch_t *b)
+{
+  for (u16 i = 0; i < b->batch.n_enq; i++)
+    clib_memcpy_fast (b->descs[i].dst, b->descs[i].src, b->descs[i].size);
+}
+
+/* wake the helper serving thread_index if it sleeps, after the ring head
+ * was published */
+static_always_inline void
+vlib_dma_sw_ring_doorbell (vlib_dma_sw_main_t *sm, u32 thread_index)
+{
+  vlib_dma_sw_helper_t *h = sm->helpers + thread_index % sm->n_helpers;
+
+  /* pairs with the fence in vlib_dma_sw_helper_sleep, either the helper
+   * sees the new head or we see it asleep */
+  CLIB_MEMORY_BARRIER ();
+  if (PREDICT_FALSE (h->sleeping) && h->doorbell == 0)
+    h->doorbell = 1;
+}
+
+static vlib_dma_batch_t *
+vlib_dma_sw_batch_new (vlib_main_t *vm, vlib_dma_config_data_t *cd)
+{
+  vlib_dma_sw_config_t *c = (vlib_dma_sw_config_t *) cd->private_data;
+  vlib_dma_sw_batch_t ***fl = c->freelists + vm->thread_index;
+  vlib_dma_sw_batch_t *b;
+
+  if (vec_len (fl[0]) > 0)
+    b = vec_pop (fl[0]);
+  else
+    {
+      b = clib_mem_alloc_aligned (c->alloc_size, CLIB_CACHE_LINE_BYTES);
+      *b = c->batch_template;
+      b->thread_index = vm->thread_index;
+    }
+
+  return &b->batch;
+}
+
+static_always_inline void
+vlib_dma_sw_batch_free (vlib_dma_sw_batch_t *b)
+{
+  vlib_dma_sw_batch_t ***fl = b->config->freelists + b->thread_index;
+
+  b->batch.n_enq = 0;
+  b->status = VLIB_DMA_SW_STATUS_IDLE;
+  vec_add1 (fl[0], b);
+}
+
+static int
+vlib_dma_sw_batch_submit (vlib_main_t *vm, vlib_dma_batch_t *vb)
+{
+  vlib_dma_sw_main_t *sm = &vlib_dma_sw_main;
+  vlib_dma_sw_batch_t *b = (vlib_dma_sw_batch_t *) vb;
+  vlib_dma_sw_thread_t *t = vec_elt_at_index (sm->threads, vm->thread_index);
+  u32 head = t->head;
+
+  if (PREDICT_FALSE (vb->n_enq == 0))
+    {
+      vlib_dma_sw_batch_free (b);
+      return 0;
+    }
+
+  if (head - __atomic_load_n (&t->tail, __ATOMIC_ACQUIRE) <
+      VLIB_DMA_SW_RING_SIZE)
+    {
+      b->status = VLIB_DMA_SW_STATUS_BUSY;
+      t->ring[head % VLIB_DMA_SW_RING_SIZE] = b;
+      __atomic_store_n (&t->head, head + 1, __ATOMIC_RELEASE);
+      vlib_dma_sw_ring_doorbell (sm, vm->thread_index);
+      t->offloaded++;
+    }
+  else
+    {
+      vlib_dma_sw_copy (b);
+      b->status = VLIB_DMA_SW_STATUS_DONE;
+      t->copied_inline++;
+    }
+
+  t->submitted++;
+  vec_add1 (t->pending, b);
+  vlib_node_set_interrupt_pending (vm, vlib_dma_sw_node.index);
+  return 1;
+}
+
+static int
+vlib_dma_sw_config_add_fn (vlib_main_t *vm, vlib_dma_config_data_t *cd)
+{
+  vlib_dma_sw_main_t *sm = &vlib_dma_sw_main;
+  vlib_dma_sw_config_t *c;
+  vlib_dma_sw_batch_t *b;
+
+  if (!sm->ready || sm->n_helpers == 0)
+    return 0;
+
+  c = clib_mem_alloc_aligned (sizeof (*c), CLIB_CACHE_LINE_BYTES);
+  clib_memset (c, 0, sizeof (*c));
+  c->config_index = cd->config_index;
+  c->alloc_size = sizeof (vlib_dma_sw_batch_t) +
+		  cd->cfg.max_transfers * sizeof (vlib_dma_sw_desc_t);
+  vec_validate (c->freelists, vlib_get_n_threads () - 1);
+
+  b = &c->batch_template;
+  b->config = c;
+  b->batch.submit_fn = vlib_dma_sw_batch_submit;
+  b->batch.callback_fn = cd->cfg.callback_fn;
+  b->batch.stride = sizeof (vlib_dma_sw_desc_t);
+  b->batch.src_ptr_off = STRUCT_OFFSET_OF (vlib_dma_sw_batch_t, descs[0].src);
+  b->batch.dst_ptr_off = STRUCT_OFFSET_OF (vlib_dma_sw_batch_t, descs[0].dst);
+  b->batch.size_off = STRUCT_OFFSET_OF (vlib_dma_sw_batch_t, descs[0].size);
+
+  cd->batch_new_fn = vlib_dma_sw_batch_new;
+  cd->private_data = pointer_to_uword (c);
+  __atomic_add_fetch (&sm->n_configs, 1, __ATOMIC_RELEASE);
+
+  vlib_log_debug (dma_sw_log.class, "config %u added, %u helper threads",
+		  cd->config_index, sm->n_helpers);
+  return 1;
+}
+
+static void
+vlib_dma_sw_config_del_fn (vlib_main_t *vm, vlib_dma_config_data_t *cd)
+{
+  vlib_dma_sw_main_t *sm = &vlib_dma_sw_main;
+  vlib_dma_sw_config_t *c = (vlib_dma_sw_config_t *) cd->private_data;
+  vlib_dma_sw_batch_t *b, **bp;
+  vlib_dma_sw_thread_t *t;
+  int with_barrier = 0;
+
+  if (vlib_worker_thread_barrier_held () == 0)
+    {
+      with_barrier = 1;
+      vlib_worker_thread_barrier_sync (vm);
+    }
+
+  vec_foreach (t, sm->threads)
+    {
+      u32 n = 0;
+
+      /* helpers may still be copying batches of this config, they were
+       * woken on submit so this is a short wait */
+      while (__atomic_load_n (&t->tail, __ATOMIC_ACQUIRE) != t->head)
+	unix_sleep (1e-5);
+
+      vec_foreach (bp, t->pending)
+	if (bp[0]->config == c)
+	  vlib_dma_sw_batch_free (bp[0]);
+	else
+	  t->pending[n++] = bp[0];
+      vec_set_len (t->pending, n);
+    }
+
+  __atomic_sub_fetch (&sm->n_configs, 1, __ATOMIC_RELEASE);
+
+  if (with_barrier)
+    vlib_worker_thread_barrier_release (vm);
+
+  for (u32 i = 0; i < vec_len (c->freelists); i++)
+    {
+      while (vec_len (c->freelists[i]))
+	{
+	  b = vec_pop (c->freelists[i]);
+	  clib_mem_free (b);
+	}
+      vec_free (c->freelists[i]);
+    }
+  vec_free (c->freelists);
+  clib_mem_free (c);
+
+  vlib_log_debug (dma_sw_log.class, "config %u removed", cd->config_index);
+}
+
+static uword
+vlib_dma_sw_node_fn (vlib_main_t *vm, vlib_node_runtime_t *node,
+		     vlib_frame_t *frame)
+{
+  vlib_dma_sw_main_t *sm = &vlib_dma_sw_main;
+  vlib_dma_sw_thread_t *t = vec_elt_at_index (sm->threads, vm->thread_index);
+  u32 n_pending = vec_len (t->pending), n_done = 0;
+
+  /* helpers complete batches in ring order, so stop at the first busy one */
+  while (n_done < n_pending)
+    {
+      vlib_dma_sw_batch_t *b = t->pending[n_done];
+
+      if (__atomic_load_n (&b->status, __ATOMIC_ACQUIRE) !=
+	  VLIB_DMA_SW_STATUS_DONE)
+	break;
+
+      if (b->batch.callback_fn)
+	b->batch.callback_fn (vm, &b->batch);
+
+      vlib_dma_sw_batch_free (b);
+      n_done++;
+    }
+
+  if (n_done)
+    {
+      vec_delete (t->pending, n_done, 0);
+      t->completed += n_done;
+    }
+
+  if (vec_len (t->pending))
+    vlib_node_set_interrupt_pending (vm, vlib_dma_sw_node.index);
+
+  return n_done;
+}
+
+VLIB_REGISTER_NODE (vlib_dma_sw_node) = {
+  .function = vlib_dma_sw_node_fn,
+  .name = "dma-sw",
+  .type = VLIB_NODE_TYPE_INPUT,
+  .state = VLIB_NODE_STATE_INTERRUPT,
+};
+
+static_always_inline int
+vlib_dma_sw_helper_has_work (vlib_dma_sw_main_t *sm, u32 helper)
+{
+  vlib_dma_sw_thread_t *t;
+
+  for (u32 i = helper; i < vec_len (sm->threads); i += sm->n_helpers)
+    {
+      t = vec_elt_at_index (sm->threads, i);
+      if (__atomic_load_n (&t->head, __ATOMIC_ACQUIRE) != t->tail)
+	return 1;
+    }
+  return 0;
+}
+
+#ifdef __x86_64__
+static __clib_noinline __attribute__ ((target ("waitpkg"))) void
+vlib_dma_sw_umwait (volatile u64 *addr, u64 deadline)
+{
+  _umonitor ((void *) addr);
+  if (*addr == 0)
+    _umwait (0 /* C0.2 */, deadline);
+}
+#endif
+
+/*
+ * Sleep until the doorbell rings. Naps start at 1us and double up to
+ * idle-wakeup-usec, so a helper woken soon after going idle does not pay
+ * the whole nap. Rings are checked after each wait as a safety net.
+ */
+static void
+vlib_dma_sw_helper_sleep (vlib_dma_sw_main_t *sm, u32 helper)
+{
+  vlib_dma_sw_helper_t *h = vec_elt_at_index (sm->helpers, helper);
+  u32 max_usec = clib_min (unix_main.idle_wakeup_usec,
+			   VLIB_DMA_SW_MAX_SLEEP_USEC);
+  u64 max_clocks = max_usec * 1e-6 * os_cpu_clock_frequency ();
+  u32 usec = 1;
+
+  h->doorbell = 0;
+  h->sleeping = 1;
+  /* store the flag before checking the rings, see
+   * vlib_dma_sw_ring_doorbell */
+  CLIB_MEMORY_BARRIER ();
+  h->n_sleeps++;
+
+  while (h->doorbell == 0 && !vlib_dma_sw_helper_has_work (sm, helper))
+    {
+#ifdef __x86_64__
+      if (clib_cpu_supports_waitpkg ())
+	{
+	  vlib_dma_sw_umwait (&h->doorbell, clib_cpu_time_now () + max_clocks);
+	  continue;
+	}
+#endif
+      {
+	struct timespec ts = { .tv_nsec = 1000 * usec }, tsrem;
+
+	while (nanosleep (&ts, &tsrem) < 0)
+	  ts = tsrem;
+	usec = clib_min (2 * usec, max_usec);
+      }
+    }
+
+  h->n_wakeups += h->doorbell;
+  h->sleeping = 0;
+}
+
+static void
+vlib_dma_sw_thread_fn (void *arg)
+{
+  vlib_worker_thread_t *w = arg;
+  vlib_dma_sw_main_t *sm = &vlib_dma_sw_main;
+  vlib_dma_sw_thread_t *t;
+  u32 n_idle = 0;
+
+  /* helpers are not vlib threads, they have no vlib_main_t and must not
+   * take part in the barrier, so only switch to the thread heap */
+  clib_mem_set_heap (w->thread_mheap);
+
+  while (!sm->ready)
+    unix_sleep (1e-3);
+
+  while (1)
+    {
+      u32 n_copied = 0;
+
+      if (__atomic_load_n (&sm->n_configs, __ATOMIC_ACQUIRE) == 0)
+	{
+	  unix_sleep (1e-3);
+	  continue;
+	}
+
+      for (u32 i = w->instance_id; i < vec_len (sm->threads);
+	   i += sm->n_helpers)
+	{
+	  u32 head, tail;
+
+	  t = vec_elt_at_index (sm->threads, i);
+	  head = __atomic_load_n (&t->head, __ATOMIC_ACQUIRE);
+	  tail = t->tail;
+
+	  while (tail != head)
+	    {
+	      vlib_dma_sw_batch_t *b = t->ring[tail % VLIB_DMA_SW_RING_SIZE];
+
+	      vlib_dma_sw_copy (b);
+	      for (u16 j = 0; j < b->batch.n_enq; j++)
+		t->helper_bytes += b->descs[j].size;
+	      __atomic_store_n (&b->status, VLIB_DMA_SW_STATUS_DONE,
+				__ATOMIC_RELEASE);
+	      tail++;
+	      n_copied++;
+	    }
+
+	  __atomic_store_n (&t->tail, tail, __ATOMIC_RELEASE);
+	}
+
+      if (n_copied)
+	n_idle = 0;
+      else if (++n_idle < VLIB_DMA_SW_IDLE_POLLS)
+	CLIB_PAUSE ();
+      else
+	{
+	  vlib_dma_sw_helper_sleep (sm, w->instance_id);
+	  n_idle = 0;
+	}
+    }
+}
+
+VLIB_REGISTER_THREAD (vlib_dma_sw_thread_reg) = {
+  .name = "dma-sw",
+  .short_name = "dma-sw",
+  .function = vlib_dma_sw_thread_fn,
+  .no_data_structure_clone = 1,
+};
+
+static u8 *
+format_vlib_dma_sw_info (u8 *s, va_list *args)
+{
+  vlib_dma_sw_main_t *sm = &vlib_dma_sw_main;
+  vlib_main_t *vm = va_arg (*args, vlib_main_t *);
+  vlib_dma_sw_thread_t *t = vec_elt_at_index (sm->threads, vm->thread_index);
+  vlib_dma_sw_helper_t *h;
+
+  s = format (s,
+	      "thread %u software, %u helpers, submitted %llu offloaded "
+	      "%llu inline %llu completed %llu helper bytes %llu",
+	      vm->thread_index, sm->n_helpers, t->submitted, t->offloaded,
+	      t->copied_inline, t->completed, t->helper_bytes);
+
+  if (sm->n_helpers == 0)
+    return s;
+
+  h = vec_elt_at_index (sm->helpers, vm->thread_index % sm->n_helpers);
+  return format (s, " helper sleeps %llu doorbell wakeups %llu", h->n_sleeps,
+		 h->n_wakeups);
+}
+
+static vlib_dma_backend_t vlib_dma_sw_backend = {
+  .name = "software",
+  .fallback = 1,
+  .config_add_fn = vlib_dma_sw_config_add_fn,
+  .config_del_fn = vlib_dma_sw_config_del_fn,
+  .info_fn = format_vlib_dma_sw_info,
+};
+
+static clib_error_t *
+vlib_dma_sw_main_loop_enter (vlib_main_t *vm)
+{
+  vlib_dma_sw_main_t *sm = &vlib_dma_sw_main;
+
+  vec_validate_aligned (sm->threads, vlib_get_n_threads () - 1,
+			CLIB_CACHE_LINE_BYTES);
+  sm->n_helpers = vlib_dma_sw_thread_reg.count;
+  if (sm->n_helpers)
+    vec_validate_aligned (sm->helpers, sm->n_helpers - 1,
+			  CLIB_CACHE_LINE_BYTES);
+  sm->ready = 1;
+
+  return vlib_dma_register_backend (vm, &vlib_dma_sw_backend);
+}
+
+VLIB_MAIN_LOOP_ENTER_FUNCTION (vlib_dma_sw_main_loop_enter);
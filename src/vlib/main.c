@@ -107,6 +107,7 @@ vlib_frame_alloc_to_node (vlib_main_t * vm, u32 to_node_index,
   f->aux_offset = to_node->aux_offset;
   f->flags = 0;
   f->frame_size_index = to_node->frame_size_index;
+  f->max_vectors = to_node->frame_vector_length;
 
   fs->n_alloc_frames += 1;
 
@@ -369,7 +370,7 @@ vlib_get_next_frame_internal (vlib_main_t * vm,
   /* Allocate new frame if current one is marked as no-append or
      it is already full. */
   n_used = f->n_vectors;
-  if (n_used >= VLIB_FRAME_SIZE || (allocate_new_next_frame && n_used > 0) ||
+  if (n_used >= f->max_vectors || (allocate_new_next_frame && n_used > 0) ||
       (f->frame_flags & VLIB_FRAME_NO_APPEND))
     {
       /* Old frame may need to be freed after dispatch, since we'll have
@@ -386,7 +387,7 @@ vlib_get_next_frame_internal (vlib_main_t * vm,
     }
 
   /* Should have free vectors in frame now. */
-  ASSERT (n_used < VLIB_FRAME_SIZE);
+  ASSERT (n_used < f->max_vectors);
 
   if (CLIB_DEBUG > 0)
     {
@@ -412,13 +413,12 @@ vlib_put_next_frame_validate (vlib_main_t * vm,
   nf = vlib_node_runtime_get_next_frame (vm, rt, next_index);
   f = vlib_get_frame (vm, nf->frame);
 
-  ASSERT (n_vectors_left <= VLIB_FRAME_SIZE);
-
   vlib_validate_frame_indices (f);
 
-  n_after = VLIB_FRAME_SIZE - n_vectors_left;
+  n_after = f->max_vectors - n_vectors_left;
   n_before = f->n_vectors;
 
+  ASSERT (n_after <= VLIB_FRAME_SIZE);
   ASSERT (n_after >= n_before);
 
   next_rt = vec_elt_at_index (nm->nodes_by_type[VLIB_NODE_TYPE_INTERNAL],
@@ -460,9 +460,10 @@ vlib_put_next_frame (vlib_main_t * vm,
       validate_frame_magic (vm, f, node, next_index);
     }
 
-  /* Convert # of vectors left -> number of vectors there. */
-  ASSERT (n_vectors_left <= VLIB_FRAME_SIZE);
-  n_vectors_in_frame = VLIB_FRAME_SIZE - n_vectors_left;
+  /* Convert # of vectors left -> number of vectors there. Senders filling
+     a frame past max_vectors (up to VLIB_FRAME_SIZE) wrap around here. */
+  n_vectors_in_frame = f->max_vectors - n_vectors_left;
+  ASSERT (n_vectors_in_frame <= VLIB_FRAME_SIZE);
 
   f->n_vectors = n_vectors_in_frame;
 
@@ -1064,6 +1065,85 @@ dispatch_node (vlib_main_t * vm,
   return t;
 }
 
+/*
+ * Pull frames pending for the same node further down the pending vector
+ * into this one, so the node runs once on a fuller vector. Frames with
+ * scalar or aux data, or differing user flags, are left alone. Merged
+ * entries are marked and skipped when their turn comes. Returns the trace
+ * flags of the merged frames.
+ */
+static u32
+dispatch_pending_coalesce (vlib_main_t *vm, uword pending_frame_index,
+			   vlib_node_runtime_t *n, vlib_frame_t *f)
+{
+  vlib_node_main_t *nm = &vm->node_main;
+  vlib_pending_frame_t *q;
+  vlib_next_frame_t *nf;
+  vlib_frame_t *g;
+  vlib_node_t *node;
+  u32 trace = 0, vector_size, runtime_index;
+  uword i;
+
+  if (f->scalar_offset || f->aux_offset || f->n_vectors >= f->max_vectors ||
+      (n->flags & VLIB_NODE_FLAG_FRAME_NO_FREE_AFTER_DISPATCH))
+    return 0;
+
+  node = vlib_get_node (vm, n->node_index);
+  vector_size = (node->magic_offset - node->vector_offset) /
+		(VLIB_FRAME_SIZE + VLIB_FRAME_SIZE_EXTRA);
+
+  runtime_index = nm->pending_frames[pending_frame_index].node_runtime_index;
+
+  for (i = pending_frame_index + 1; i < vec_len (nm->pending_frames); i++)
+    {
+      q = nm->pending_frames + i;
+
+      if (q->frame == 0 || q->node_runtime_index != runtime_index)
+	continue;
+
+      g = q->frame;
+      if (g->flags != f->flags ||
+	  f->n_vectors + g->n_vectors > f->max_vectors)
+	continue;
+
+      nf = 0;
+      if (q->next_frame_index != VLIB_PENDING_FRAME_NO_NEXT_FRAME)
+	nf = vec_elt_at_index (nm->next_frames, q->next_frame_index);
+
+      /* the frame must go back to its owner, or be freed */
+      if (!(g->frame_flags & VLIB_FRAME_FREE_AFTER_DISPATCH) &&
+	  (nf == 0 || nf->frame != g))
+	continue;
+
+      clib_memcpy_fast (vlib_frame_vector_args (f) +
+			  f->n_vectors * vector_size,
+			vlib_frame_vector_args (g), g->n_vectors * vector_size);
+      f->n_vectors += g->n_vectors;
+
+      nm->n_coalesced_frames++;
+      nm->n_coalesced_vectors += g->n_vectors;
+
+      if (nf)
+	{
+	  trace |= nf->flags & VLIB_FRAME_TRACE;
+	  nf->flags &= ~VLIB_FRAME_TRACE;
+	}
+      else
+	trace |= g->frame_flags & VLIB_FRAME_TRACE;
+
+      q->frame = 0;
+      g->n_vectors = 0;
+      g->frame_flags &= ~(VLIB_FRAME_PENDING | VLIB_FRAME_NO_APPEND);
+      if (g->frame_flags & VLIB_FRAME_FREE_AFTER_DISPATCH)
+	vlib_frame_free (vm, g);
+
+      if (f->n_vectors == f->max_vectors)
+	break;
+    }
+
+  return trace;
+}
+
 static u64
 dispatch_pending_node (vlib_main_t * vm, uword pending_frame_index,
 		       u64 last_time_stamp)
@@ -1074,14 +1154,26 @@ dispatch_pending_node (vlib_main_t * vm, uword pending_frame_index,
   vlib_node_runtime_t *n;
   vlib_frame_t *restore_frame;
   vlib_pending_frame_t *p;
+  u32 coalesced_trace = 0;
 
   /* See comment below about dangling references to nm->pending_frames */
   p = nm->pending_frames + pending_frame_index;
 
+  /* Merged into an earlier frame for the same node */
+  if (PREDICT_FALSE (p->frame == 0))
+    return last_time_stamp;
+
   n = vec_elt_at_index (nm->nodes_by_type[VLIB_NODE_TYPE_INTERNAL],
 			p->node_runtime_index);
 
   f = vlib_get_frame (vm, p->frame);
+
+  if (PREDICT_FALSE (nm->dispatch_coalesce))
+    {
+      coalesced_trace =
+	dispatch_pending_coalesce (vm, pending_frame_index, n, f);
+      p = nm->pending_frames + pending_frame_index;
+    }
   if (p->next_frame_index == VLIB_PENDING_FRAME_NO_NEXT_FRAME)
     {
       /* No next frame: so use placeholder on stack. */
@@ -1113,7 +1205,9 @@ dispatch_pending_node (vlib_main_t * vm, uword pending_frame_index,
      Trace flag indicates that at least one vector in the dispatched
      frame is traced. */
   n->flags &= ~VLIB_NODE_FLAG_TRACE;
-  n->flags |= (nf->flags & VLIB_FRAME_TRACE) ? VLIB_NODE_FLAG_TRACE : 0;
+  n->flags |= ((nf->flags | coalesced_trace) & VLIB_FRAME_TRACE) ?
+		VLIB_NODE_FLAG_TRACE :
+		0;
   nf->flags &= ~VLIB_FRAME_TRACE;
 
   last_time_stamp = dispatch_node (vm, n,
@@ -1620,6 +1714,11 @@ vlib_main_or_worker_loop (vlib_main_t * vm, int is_main)
 	    int nready_procs;
 	  } *ed;
 
+	  /* Release objects the workers are done with. */
+	  if (PREDICT_FALSE (vec_len (tm->deferred_pending) +
+			     vec_len (tm->deferred_waiting)))
+	    vlib_worker_thread_defer_run (vm);
+
 	  /* Check if process nodes have expired from timing wheel. */
 	  ASSERT (nm->data_from_advancing_timing_wheel != 0);
 
@@ -1776,6 +1875,7 @@ vlib_main_configure (vlib_main_t * vm, unformat_input_t * input)
 {
   vlib_global_main_t *vgm = vlib_get_global_main ();
   int turn_on_mem_trace = 0;
+  u32 frame_size;
 
   while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
     {
@@ -1786,6 +1886,15 @@ vlib_main_configure (vlib_main_t * vm, unformat_input_t * input)
 			 &vgm->configured_elog_ring_size))
 	vgm->configured_elog_ring_size =
 	  1 << max_log2 (vgm->configured_elog_ring_size);
+      else if (unformat (input, "dispatch-coalesce"))
+	vm->node_main.dispatch_coalesce = 1;
+      else if (unformat (input, "frame-size %u", &frame_size))
+	{
+	  if (frame_size == 0 || frame_size > VLIB_FRAME_SIZE)
+	    return clib_error_return (0, "frame-size must be between 1 and %u",
+				      VLIB_FRAME_SIZE);
+	  vm->node_main.frame_vector_length = frame_size;
+	}
       else if (unformat (input, "elog-post-mortem-dump"))
 	vlib_add_del_post_mortem_callback (elog_post_mortem_dump,
 					   /* is_add */ 1);
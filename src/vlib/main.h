@@ -223,6 +223,18 @@ typedef struct vlib_main_t
   /* debugging */
   volatile int parked_at_barrier;
 
+  /* Sleep on idle. Set while the thread is asleep, and the cpu time at
+   * which another thread first asked it to wake up. */
+  volatile u8 sleeping;
+  volatile u64 wakeup_requested;
+
+  /* Sleep on idle statistics, cpu clocks */
+  u64 n_idle_sleeps;
+  u64 n_idle_wakeups;
+  u64 cpu_time_asleep;
+  u64 wakeup_latency_total;
+  u64 wakeup_latency_max;
+
   /* Dispatch loop time accounting */
   u64 loops_this_reporting_interval;
   f64 loop_interval_end;
@@ -421,6 +433,22 @@ vlib_clear_internal_node_vector_rate (vlib_main_t * vm)
   vm->internal_node_vectors_last_clear = vm->internal_node_vectors;
 }
 
+/**
+ * Wake a thread sleeping on idle, after handing it work from another
+ * thread. A single load when the thread is awake.
+ */
+always_inline void
+vlib_thread_wakeup (vlib_main_t *vm)
+{
+  /* no fence here: the flag may be read before the work handed over is
+   * visible, and a thread just going to sleep may then be missed. It sees
+   * the work at the end of its current nap, see linux_epoll_worker_sleep.
+   * The compare and swap is a full barrier on the doorbell path. */
+  if (PREDICT_TRUE (vm->sleeping == 0) || vm->wakeup_requested)
+    return;
+  clib_atomic_cmp_and_swap (&vm->wakeup_requested, 0, clib_cpu_time_now ());
+}
+
 always_inline void
 vlib_increment_main_loop_counter (vlib_main_t * vm)
 {
@@ -267,6 +267,20 @@ vlib_node_add_named_next_with_slot (vlib_main_t * vm,
   return vlib_node_add_next_with_slot (vm, node, n_next->index, slot);
 }
 
+/* Number of vectors senders put in frames to node N: the node's preferred
+   length if it has one, else the startup frame-size, capped by
+   VLIB_FRAME_SIZE. */
+static u16
+node_frame_vector_length (vlib_node_main_t *nm, vlib_node_t *n)
+{
+  u16 len = nm->frame_vector_length ? nm->frame_vector_length : VLIB_FRAME_SIZE;
+
+  if (n->preferred_vector_length)
+    len = n->preferred_vector_length;
+
+  return clib_min (len, VLIB_FRAME_SIZE);
+}
+
 static void
 node_elog_init (vlib_main_t * vm, uword ni)
 {
@@ -439,6 +453,9 @@ vlib_register_node (vlib_main_t *vm, vlib_node_registration_t *r, char *fmt,
   _(unformat_buffer);
   _(format_trace);
   _(validate_frame);
+  _(preferred_vector_length);
+
+  n->frame_vector_length = node_frame_vector_length (nm, n);
 
   size = round_pow2 (sizeof (vlib_frame_t), VLIB_FRAME_DATA_ALIGN);
 
@@ -931,6 +948,44 @@ vlib_node_set_march_variant (vlib_main_t *vm, u32 node_index,
     }
   return -1;
 }
+int
+vlib_node_set_preferred_vector_length (vlib_main_t *vm, u32 node_index,
+				       u16 preferred_vector_length)
+{
+  vlib_node_t *n = vlib_get_node (vm, node_index);
+  u16 len;
+
+  if (n->type != VLIB_NODE_TYPE_INTERNAL ||
+      preferred_vector_length > VLIB_FRAME_SIZE)
+    return -1;
+
+  ASSERT (vlib_get_thread_index () == 0);
+  vlib_worker_thread_barrier_sync (vm);
+
+  n->preferred_vector_length = preferred_vector_length;
+  len = node_frame_vector_length (&vm->node_main, n);
+
+  for (int i = 0; i < vlib_get_n_threads (); i++)
+    {
+      vlib_main_t *this_vm = vlib_get_main_by_index (i);
+      vlib_node_t *tn = vlib_get_node (this_vm, node_index);
+      vlib_next_frame_t *nf;
+
+      tn->preferred_vector_length = preferred_vector_length;
+      tn->frame_vector_length = len;
+
+      /* frames already held by senders are empty while the barrier is
+       * held, refit them so the next enqueue sees the new length */
+      vec_foreach (nf, this_vm->node_main.next_frames)
+	if (nf->frame && nf->node_runtime_index == tn->runtime_index &&
+	    (nf->flags & VLIB_FRAME_IS_ALLOCATED))
+	  nf->frame->max_vectors = len;
+    }
+
+  vlib_worker_thread_barrier_release (vm);
+  return 0;
+}
+
 /*
  * fd.io coding-style-patch-verification: ON
  *
@@ -43,6 +43,7 @@
 #include <vppinfra/cpu.h>
 #include <vppinfra/longjmp.h>
 #include <vppinfra/lock.h>
+#include <vlib/config.h>
 #include <vlib/trace.h>		/* for vlib_trace_filter_t */
 
 /* Forward declaration. */
@@ -152,6 +153,12 @@ typedef struct _vlib_node_registration
   u8 vector_size, aux_size;
   u16 scalar_size;
 
+  /* Number of vectors this node would like to be handed, if different
+     from the startup frame-size, capped at VLIB_FRAME_SIZE. A hint only:
+     senders using vlib_get_next_frame and the enqueue helpers honour it,
+     others may still hand over up to VLIB_FRAME_SIZE vectors. */
+  u16 preferred_vector_length;
+
   /* Number of error codes used by this node. */
   u16 n_errors;
 
@@ -314,6 +321,11 @@ typedef struct vlib_node_t
   u16 frame_size, scalar_offset, vector_offset, magic_offset, aux_offset;
   u16 frame_size_index;
 
+  /* Preferred vector length (a hint, see the registration) and the
+     resulting number of vectors frames to this node are filled with. */
+  u16 preferred_vector_length;
+  u16 frame_vector_length;
+
   /* Handle/index in error heap for this node. */
   u32 error_heap_handle;
   u32 error_heap_index;
@@ -368,8 +380,10 @@ typedef struct vlib_node_t
 
 #define VLIB_INVALID_NODE_INDEX ((u32) ~0)
 
-/* Max number of vector elements to process at once per node. */
-#define VLIB_FRAME_SIZE 256
+/* Max number of vector elements to process at once per node. Set at build
+   time (VLIB_FRAME_SIZE in vlib/config.h); frames are always allocated at
+   this size, while the number of vectors actually put in them can be
+   lowered at startup or per node (see preferred_vector_length). */
 /* Number of extra elements allocated at the end of vecttor. */
 #define VLIB_FRAME_SIZE_EXTRA 4
 /* Frame data alignment */
@@ -393,6 +407,9 @@ typedef struct vlib_frame_t
   /* Index of frame size corresponding to allocated node. */
   u16 frame_size_index;
 
+  /* Number of vector elements senders should fill the frame up to. */
+  u16 max_vectors;
+
   /* Scalar and vector arguments to next node. */
   u8 arguments[0];
 } vlib_frame_t;
@@ -699,6 +716,14 @@ typedef struct
   u32 polling_threshold_vector_length;
   u32 interrupt_threshold_vector_length;
 
+  /* Merge frames pending for the same node before dispatching it */
+  u8 dispatch_coalesce;
+
+  /* Startup frame-size, vectors per frame unless a node asks otherwise */
+  u16 frame_vector_length;
+  u64 n_coalesced_frames;
+  u64 n_coalesced_vectors;
+
   /* Vector of next frames. */
   vlib_next_frame_t *next_frames;
 
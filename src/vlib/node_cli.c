@@ -601,6 +601,29 @@ show_node_runtime (vlib_main_t * vm,
 	    (f64) n_input / dt, (f64) n_output / dt, (f64) n_drop / dt,
 	    (f64) n_punt / dt);
 
+	  if (stat_vm->n_idle_sleeps)
+	    {
+	      f64 cps = stat_vm->clib_time.clocks_per_second;
+	      f64 asleep = (f64) stat_vm->cpu_time_asleep / cps;
+	      u64 n_wakeups = stat_vm->n_idle_wakeups;
+
+	      vlib_cli_output (
+		vm,
+		"  idle %.2f%% busy %.2f%% sleeps %llu wakeups %llu "
+		"wakeup latency avg %.2fus max %.2fus",
+		100.0 * asleep / dt, 100.0 * (dt - asleep) / dt,
+		stat_vm->n_idle_sleeps, n_wakeups,
+		n_wakeups ? 1e6 * stat_vm->wakeup_latency_total / n_wakeups /
+			      cps :
+			    0.0,
+		1e6 * stat_vm->wakeup_latency_max / cps);
+	    }
+
+	  if (stat_vm->node_main.dispatch_coalesce)
+	    vlib_cli_output (vm, "  coalesced frames %llu vectors %llu",
+			     stat_vm->node_main.n_coalesced_frames,
+			     stat_vm->node_main.n_coalesced_vectors);
+
 	  if (summary == 0)
 	    {
 	      vlib_cli_output (vm, "%U", format_vlib_node_stats, stat_vm,
@@ -674,6 +697,14 @@ clear_node_runtime (vlib_main_t * vm,
 	}
       /* Note: input/output rates computed using vlib_global_main */
       nm->time_last_runtime_stats_clear = vlib_time_now (vm);
+
+      stat_vm->n_idle_sleeps = 0;
+      stat_vm->n_idle_wakeups = 0;
+      stat_vm->cpu_time_asleep = 0;
+      stat_vm->wakeup_latency_total = 0;
+      stat_vm->wakeup_latency_max = 0;
+      nm->n_coalesced_frames = 0;
+      nm->n_coalesced_vectors = 0;
     }
 
   vlib_stats_set_timestamp (STAT_COUNTER_LAST_STATS_CLEAR,
@@ -767,6 +798,10 @@ show_node (vlib_main_t * vm, unformat_input_t * input,
 		   n->index, s);
   vec_reset_length (s);
 
+  if (n->type == VLIB_NODE_TYPE_INTERNAL)
+    vlib_cli_output (vm, "  vector length %u, preferred %u\n",
+		     n->frame_vector_length, n->preferred_vector_length);
+
   if (n->node_fn_registrations)
     {
       vlib_node_fn_registration_t *fnr = n->node_fn_registrations;
@@ -916,6 +951,100 @@ VLIB_CLI_COMMAND (set_node_fn_command, static) = {
 };
 /* *INDENT-ON* */
 
+static clib_error_t *
+set_node_dispatch_coalesce (vlib_main_t *vm, unformat_input_t *input,
+			    vlib_cli_command_t *cmd)
+{
+  u8 enable;
+  int i;
+
+  if (unformat (input, "enable") || unformat (input, "on"))
+    enable = 1;
+  else if (unformat (input, "disable") || unformat (input, "off"))
+    enable = 0;
+  else
+    return clib_error_return (0, "expected enable or disable, got `%U'",
+			      format_unformat_error, input);
+
+  vlib_worker_thread_barrier_sync (vm);
+  for (i = 0; i < vlib_get_n_threads (); i++)
+    {
+      vlib_main_t *this_vm = vlib_get_main_by_index (i);
+      if (this_vm)
+	this_vm->node_main.dispatch_coalesce = enable;
+    }
+  vlib_worker_thread_barrier_release (vm);
+
+  return 0;
+}
+
+/*?
+ * Merge frames pending for the same internal node into one before the node
+ * is dispatched, so that nodes fed from several places in the graph run
+ * fewer times on fuller vectors. Frame and vector counts of merged frames
+ * are shown by '<em>show runtime</em>'. Can also be enabled at startup
+ * with '<em>vlib { dispatch-coalesce }</em>'.
+ *
+ * @cliexpar
+ * @cliexcmd{set node dispatch-coalesce enable}
+?*/
+VLIB_CLI_COMMAND (set_node_dispatch_coalesce_command, static) = {
+  .path = "set node dispatch-coalesce",
+  .short_help = "set node dispatch-coalesce <enable|disable>",
+  .function = set_node_dispatch_coalesce,
+};
+
+static clib_error_t *
+set_node_vector_length (vlib_main_t *vm, unformat_input_t *input,
+			vlib_cli_command_t *cmd)
+{
+  unformat_input_t _line_input, *line_input = &_line_input;
+  u32 node_index, len = ~0;
+  clib_error_t *err = 0;
+
+  if (!unformat_user (input, unformat_line_input, line_input))
+    return 0;
+
+  if (!unformat (line_input, "%U", unformat_vlib_node, vm, &node_index))
+    {
+      err = clib_error_return (0, "please specify valid node name");
+      goto done;
+    }
+
+  if (unformat (line_input, "default"))
+    len = 0;
+  else if (!unformat (line_input, "%u", &len))
+    {
+      err = clib_error_return (0, "please specify vector length");
+      goto done;
+    }
+
+  if (len > VLIB_FRAME_SIZE ||
+      vlib_node_set_preferred_vector_length (vm, node_index, len))
+    err = clib_error_return (0, "vector length must be at most %u and the "
+			     "node an internal node", VLIB_FRAME_SIZE);
+
+done:
+  unformat_free (line_input);
+  return err;
+}
+
+/*?
+ * Set the number of vectors senders put in frames to the given internal
+ * node, overriding the startup '<em>vlib { frame-size }</em>' and the
+ * node's registered preference. Like those it is a hint: senders which
+ * fill frames directly may still hand the node up to VLIB_FRAME_SIZE
+ * vectors.
+ *
+ * @cliexpar
+ * @cliexcmd{set node vector-length ip4-lookup 64}
+?*/
+VLIB_CLI_COMMAND (set_node_vector_length_command, static) = {
+  .path = "set node vector-length",
+  .short_help = "set node vector-length <node-name> <n>|default",
+  .function = set_node_vector_length,
+};
+
 /* Dummy function to get us linked in. */
 void
 vlib_node_cli_reference (void)
@@ -265,7 +265,10 @@ vlib_node_set_interrupt_pending (vlib_main_t *vm, u32 node_index)
     }
 
   if (vm != vlib_get_main ())
-    clib_interrupt_set_atomic (interrupts, n->runtime_index);
+    {
+      clib_interrupt_set_atomic (interrupts, n->runtime_index);
+      vlib_thread_wakeup (vm);
+    }
   else
     clib_interrupt_set (interrupts, n->runtime_index);
 }
@@ -389,7 +392,7 @@ vlib_frame_t *vlib_get_next_frame_internal (vlib_main_t * vm,
 	(vm), (node), (next_index), (alloc_new_frame));                       \
       u32 _n = _f->n_vectors;                                                 \
       (vectors) = vlib_frame_vector_args (_f) + _n * sizeof ((vectors)[0]);   \
-      (n_vectors_left) = VLIB_FRAME_SIZE - _n;                                \
+      (n_vectors_left) = _f->max_vectors - _n;                                \
     }                                                                         \
   while (0)
 
@@ -406,7 +409,7 @@ vlib_frame_t *vlib_get_next_frame_internal (vlib_main_t * vm,
 	(aux_data) = NULL;                                                    \
       else                                                                    \
 	(aux_data) = vlib_frame_aux_args (_f) + _n * sizeof ((aux_data)[0]);  \
-      (n_vectors_left) = VLIB_FRAME_SIZE - _n;                                \
+      (n_vectors_left) = _f->max_vectors - _n;                                \
     }                                                                         \
   while (0)
 
@@ -1379,6 +1382,9 @@ vlib_node_set_dispatch_wrapper (vlib_main_t *vm, vlib_node_function_t *fn)
 int vlib_node_set_march_variant (vlib_main_t *vm, u32 node_index,
 				 clib_march_variant_type_t march_variant);
 
+int vlib_node_set_preferred_vector_length (vlib_main_t *vm, u32 node_index,
+					   u16 preferred_vector_length);
+
 vlib_node_function_t *
 vlib_node_get_preferred_node_fn_variant (vlib_main_t *vm,
 					 vlib_node_fn_registration_t *regs);
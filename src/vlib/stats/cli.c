@@ -34,6 +34,15 @@ format_stat_dir_entry (u8 *s, va_list *args)
       type_name = "CMainPtr";
       break;
 
+    case STAT_DIR_TYPE_GAUGE_VECTOR:
+      type_name = "GaugeVector";
+      break;
+
+    case STAT_DIR_TYPE_HISTOGRAM_LOG2:
+    case STAT_DIR_TYPE_HISTOGRAM_LINEAR:
+      type_name = "Histogram";
+      break;
+
     case STAT_DIR_TYPE_NAME_VECTOR:
       type_name = "NameVector";
       break;
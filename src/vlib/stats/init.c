@@ -104,6 +104,7 @@ vlib_stats_init (vlib_main_t *vm)
   /* Set up the name to counter-vector hash table */
   sm->directory_vector =
     vec_new_heap (typeof (sm->directory_vector[0]), STAT_COUNTERS, heap);
+  sm->entry_epochs = vec_new_heap (u64, STAT_COUNTERS, heap);
   sm->dir_vector_first_free_elt = CLIB_U32_MAX;
 
   shared_header->epoch = 1;
@@ -116,6 +117,7 @@ vlib_stats_init (vlib_main_t *vm)
 #undef _
     /* Save the vector in the shared segment, for clients */
     shared_header->directory_vector = sm->directory_vector;
+  shared_header->entry_epochs = sm->entry_epochs;
 
   vlib_stats_register_mem_heap (heap);
 
@@ -14,8 +14,42 @@ typedef enum
   STAT_DIR_TYPE_NAME_VECTOR,
   STAT_DIR_TYPE_EMPTY,
   STAT_DIR_TYPE_SYMLINK,
+  STAT_DIR_TYPE_GAUGE_VECTOR,
+  STAT_DIR_TYPE_HISTOGRAM_LOG2,
+  STAT_DIR_TYPE_HISTOGRAM_LINEAR,
 } stat_directory_type_t;
 
+/*
+ * Histogram entries point to this descriptor. Counters are per thread,
+ * n_bins consecutive bins per index, and are summed by the reader, as are
+ * the per-thread sums of the recorded values.
+ *
+ * Bin 0 counts values below the first bound, bin i values below bound i
+ * and the last bin everything else. For log2 histograms bound i is
+ * 2^(base + i), for linear ones base + i * width.
+ */
+typedef struct
+{
+  uint32_t n_bins;
+  uint32_t base;
+  uint32_t width;
+  uint32_t unused;
+  uint64_t **counters; /* [thread][index * n_bins + bin] */
+  uint64_t **sums;     /* [thread][index] */
+} vlib_stats_histogram_t;
+
+/* Exclusive upper bound of a histogram bin, UINT64_MAX for the last one */
+static inline uint64_t
+vlib_stats_histogram_bin_bound (stat_directory_type_t type,
+				vlib_stats_histogram_t *h, uint32_t bin)
+{
+  if (bin + 1 >= h->n_bins)
+    return UINT64_MAX;
+  if (type == STAT_DIR_TYPE_HISTOGRAM_LOG2)
+    return 1ULL << (h->base + bin);
+  return (uint64_t) h->base + (uint64_t) bin * h->width;
+}
+
 typedef struct
 {
   stat_directory_type_t type;
@@ -30,6 +64,7 @@ typedef struct
     uint64_t value;
     void *data;
     uint8_t **string_vector;
+    vlib_stats_histogram_t *histogram;
   };
 #define VLIB_STATS_MAX_NAME_SZ 128
   char name[VLIB_STATS_MAX_NAME_SZ];
@@ -45,6 +80,8 @@ typedef struct
   volatile uint64_t epoch;
   volatile uint64_t in_progress;
   volatile vlib_stats_entry_t *directory_vector;
+  /* epoch at which each directory entry last changed shape */
+  volatile uint64_t *entry_epochs;
 } vlib_stats_shared_header_t;
 
 #endif /* included_stat_segment_shared_h */
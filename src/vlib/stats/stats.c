@@ -101,6 +101,23 @@ hash_unset_str_key_free (uword **h, const char *key)
     }
 }
 
+/*
+ * Tag an entry with the epoch its change is published at, so that delta
+ * readers only re-resolve the entries which changed. Must be called with
+ * the segment locked.
+ */
+static void
+vlib_stats_entry_changed (vlib_stats_segment_t *sm, u32 entry_index)
+{
+  vlib_stats_shared_header_t *shared_header = sm->shared_header;
+
+  ASSERT (shared_header->in_progress);
+
+  vec_validate (sm->entry_epochs, entry_index);
+  sm->entry_epochs[entry_index] = shared_header->epoch + 1;
+  shared_header->entry_epochs = sm->entry_epochs;
+}
+
 u32
 vlib_stats_create_counter (vlib_stats_entry_t *e)
 {
@@ -119,6 +136,7 @@ vlib_stats_create_counter (vlib_stats_entry_t *e)
     }
 
   sm->directory_vector[index] = *e;
+  vlib_stats_entry_changed (sm, index);
 
   hash_set_str_key_alloc (&sm->directory_vector_by_name, e->name, index);
 
@@ -130,6 +148,7 @@ vlib_stats_remove_entry (u32 entry_index)
 {
   vlib_stats_segment_t *sm = vlib_stats_get_segment ();
   vlib_stats_entry_t *e = vlib_stats_get_entry (sm, entry_index);
+  vlib_stats_histogram_t *h;
   counter_t **c;
   vlib_counter_t **vc;
   void *oldheap;
@@ -149,6 +168,7 @@ vlib_stats_remove_entry (u32 entry_index)
       break;
 
     case STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE:
+    case STAT_DIR_TYPE_GAUGE_VECTOR:
       c = e->data;
       e->data = 0;
       oldheap = clib_mem_set_heap (sm->heap);
@@ -168,6 +188,22 @@ vlib_stats_remove_entry (u32 entry_index)
       clib_mem_set_heap (oldheap);
       break;
 
+    case STAT_DIR_TYPE_HISTOGRAM_LOG2:
+    case STAT_DIR_TYPE_HISTOGRAM_LINEAR:
+      h = e->histogram;
+      e->histogram = 0;
+      oldheap = clib_mem_set_heap (sm->heap);
+      for (i = 0; i < vec_len (h->counters); i++)
+	{
+	  vec_free (h->counters[i]);
+	  vec_free (h->sums[i]);
+	}
+      vec_free (h->counters);
+      vec_free (h->sums);
+      clib_mem_free (h);
+      clib_mem_set_heap (oldheap);
+      break;
+
     case STAT_DIR_TYPE_SCALAR_INDEX:
     case STAT_DIR_TYPE_SYMLINK:
       break;
@@ -175,6 +211,7 @@ vlib_stats_remove_entry (u32 entry_index)
       ASSERT (0);
     }
 
+  vlib_stats_entry_changed (sm, entry_index);
   vlib_stats_segment_unlock ();
 
   hash_unset_str_key_free (&sm->directory_vector_by_name, e->name);
@@ -306,7 +343,8 @@ vlib_stats_set_string_vector (vlib_stats_string_vector_t *svp,
 {
   vlib_stats_segment_t *sm = vlib_stats_get_segment ();
   vlib_stats_header_t *sh = vec_header (*svp);
-  vlib_stats_entry_t *e = vlib_stats_get_entry (sm, sh->entry_index);
+  u32 entry_index = sh->entry_index;
+  vlib_stats_entry_t *e = vlib_stats_get_entry (sm, entry_index);
   va_list va;
   u8 *s;
 
@@ -320,6 +358,7 @@ vlib_stats_set_string_vector (vlib_stats_string_vector_t *svp,
 
       vlib_stats_segment_lock ();
       vec_free (e->string_vector[vector_index]);
+      vlib_stats_entry_changed (sm, entry_index);
       vlib_stats_segment_unlock ();
       return;
     }
@@ -344,6 +383,8 @@ vlib_stats_set_string_vector (vlib_stats_string_vector_t *svp,
   vec_add1 (s, 0);
 
   e->string_vector[vector_index] = s;
+  /* vec_validate above may have moved the vector and its header */
+  vlib_stats_entry_changed (sm, entry_index);
 
   vlib_stats_segment_unlock ();
 }
@@ -381,6 +422,81 @@ vlib_stats_add_counter_pair_vector (char *fmt, ...)
 					name);
 }
 
+u32
+vlib_stats_add_gauge_vector (char *fmt, ...)
+{
+  va_list va;
+  u8 *name;
+
+  va_start (va, fmt);
+  name = va_format (0, fmt, &va);
+  va_end (va);
+  return vlib_stats_new_entry_internal (STAT_DIR_TYPE_GAUGE_VECTOR, name);
+}
+
+static u32
+vlib_stats_add_histogram_internal (stat_directory_type_t t, u32 n_bins,
+				   u32 base, u32 width, u8 *name)
+{
+  vlib_stats_segment_t *sm = vlib_stats_get_segment ();
+  vlib_stats_histogram_t *h;
+  void *oldheap;
+  u32 index;
+
+  ASSERT (n_bins > 1);
+  ASSERT (t != STAT_DIR_TYPE_HISTOGRAM_LOG2 || base + n_bins <= 64);
+
+  index = vlib_stats_new_entry_internal (t, name);
+  if (index == CLIB_U32_MAX)
+    return index;
+
+  oldheap = clib_mem_set_heap (sm->heap);
+  h = clib_mem_alloc (sizeof (*h));
+  clib_mem_set_heap (oldheap);
+
+  *h = (vlib_stats_histogram_t){
+    .n_bins = n_bins,
+    .base = base,
+    .width = width,
+  };
+
+  vlib_stats_segment_lock ();
+  sm->directory_vector[index].histogram = h;
+  vlib_stats_entry_changed (sm, index);
+  vlib_stats_segment_unlock ();
+
+  return index;
+}
+
+u32
+vlib_stats_add_histogram_log2 (u32 n_bins, u32 base, char *fmt, ...)
+{
+  va_list va;
+  u8 *name;
+
+  va_start (va, fmt);
+  name = va_format (0, fmt, &va);
+  va_end (va);
+  return vlib_stats_add_histogram_internal (STAT_DIR_TYPE_HISTOGRAM_LOG2,
+					    n_bins, base, 0, name);
+}
+
+u32
+vlib_stats_add_histogram_linear (u32 n_bins, u32 base, u32 width, char *fmt,
+				 ...)
+{
+  va_list va;
+  u8 *name;
+
+  ASSERT (width > 0);
+
+  va_start (va, fmt);
+  name = va_format (0, fmt, &va);
+  va_end (va);
+  return vlib_stats_add_histogram_internal (STAT_DIR_TYPE_HISTOGRAM_LINEAR,
+					    n_bins, base, width, name);
+}
+
 static int
 vlib_stats_validate_will_expand_internal (u32 entry_index, va_list *va)
 {
@@ -390,7 +506,8 @@ vlib_stats_validate_will_expand_internal (u32 entry_index, va_list *va)
   int rv = 1;
 
   oldheap = clib_mem_set_heap (sm->heap);
-  if (e->type == STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE)
+  if (e->type == STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE ||
+      e->type == STAT_DIR_TYPE_GAUGE_VECTOR)
     {
       u32 idx0 = va_arg (*va, u32);
       u32 idx1 = va_arg (*va, u32);
@@ -403,6 +520,22 @@ vlib_stats_validate_will_expand_internal (u32 entry_index, va_list *va)
 	if (idx1 >= vec_max_len (data[i]))
 	  goto done;
     }
+  else if (e->type == STAT_DIR_TYPE_HISTOGRAM_LOG2 ||
+	   e->type == STAT_DIR_TYPE_HISTOGRAM_LINEAR)
+    {
+      u32 idx0 = va_arg (*va, u32);
+      u32 idx1 = va_arg (*va, u32);
+      vlib_stats_histogram_t *h = e->histogram;
+      u32 last = (idx1 + 1) * h->n_bins - 1;
+
+      if (idx0 >= vec_len (h->counters))
+	goto done;
+
+      for (u32 i = 0; i <= idx0; i++)
+	if (last >= vec_max_len (h->counters[i]) ||
+	    idx1 >= vec_max_len (h->sums[i]))
+	  goto done;
+    }
   else if (e->type == STAT_DIR_TYPE_COUNTER_VECTOR_COMBINED)
     {
       u32 idx0 = va_arg (*va, u32);
@@ -459,7 +592,8 @@ vlib_stats_validate (u32 entry_index, ...)
 
   va_start (va, entry_index);
 
-  if (e->type == STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE)
+  if (e->type == STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE ||
+      e->type == STAT_DIR_TYPE_GAUGE_VECTOR)
     {
       u32 idx0 = va_arg (va, u32);
       u32 idx1 = va_arg (va, u32);
@@ -471,6 +605,27 @@ vlib_stats_validate (u32 entry_index, ...)
 	vec_validate_aligned (data[i], idx1, CLIB_CACHE_LINE_BYTES);
       e->data = data;
     }
+  else if (e->type == STAT_DIR_TYPE_HISTOGRAM_LOG2 ||
+	   e->type == STAT_DIR_TYPE_HISTOGRAM_LINEAR)
+    {
+      u32 idx0 = va_arg (va, u32);
+      u32 idx1 = va_arg (va, u32);
+      vlib_stats_histogram_t *h = e->histogram;
+      u64 **data = h->counters;
+      u64 **sums = h->sums;
+
+      vec_validate_aligned (data, idx0, CLIB_CACHE_LINE_BYTES);
+      vec_validate_aligned (sums, idx0, CLIB_CACHE_LINE_BYTES);
+
+      for (u32 i = 0; i <= idx0; i++)
+	{
+	  vec_validate_aligned (data[i], (idx1 + 1) * h->n_bins - 1,
+				CLIB_CACHE_LINE_BYTES);
+	  vec_validate_aligned (sums[i], idx1, CLIB_CACHE_LINE_BYTES);
+	}
+      h->counters = data;
+      h->sums = sums;
+    }
   else if (e->type == STAT_DIR_TYPE_COUNTER_VECTOR_COMBINED)
     {
       u32 idx0 = va_arg (va, u32);
@@ -491,7 +646,10 @@ vlib_stats_validate (u32 entry_index, ...)
   clib_mem_set_heap (oldheap);
 
   if (will_expand)
-    vlib_stats_segment_unlock ();
+    {
+      vlib_stats_entry_changed (sm, entry_index);
+      vlib_stats_segment_unlock ();
+    }
 }
 
 u32
@@ -517,10 +675,13 @@ vlib_stats_add_symlink (u32 entry_index, u32 vector_index, char *fmt, ...)
       e.type = STAT_DIR_TYPE_SYMLINK;
       e.index1 = entry_index;
       e.index2 = vector_index;
+
+      vlib_stats_segment_lock ();
       vector_index = vlib_stats_create_counter (&e);
 
       /* Warn clients to refresh any pointers they might be holding */
       shared_header->directory_vector = sm->directory_vector;
+      vlib_stats_segment_unlock ();
     }
   else
     vector_index = ~0;
@@ -544,7 +705,10 @@ vlib_stats_rename_symlink (u64 entry_index, char *fmt, ...)
   va_end (va);
 
   vec_add1 (new_name, 0);
+  vlib_stats_segment_lock ();
   vlib_stats_set_entry_name (e, (char *) new_name);
+  vlib_stats_entry_changed (sm, entry_index);
+  vlib_stats_segment_unlock ();
   hash_set_str_key_alloc (&sm->directory_vector_by_name, e->name, entry_index);
   vec_free (new_name);
 }
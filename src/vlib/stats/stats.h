@@ -64,6 +64,7 @@ typedef struct
   /* statistics segment */
   uword *directory_vector_by_name;
   vlib_stats_entry_t *directory_vector;
+  u64 *entry_epochs;
   u32 dir_vector_first_free_elt;
 
   /* Update interval */
@@ -141,6 +142,14 @@ u32 vlib_stats_add_counter_vector (char *fmt, ...);
 /* counter pair vector */
 u32 vlib_stats_add_counter_pair_vector (char *fmt, ...);
 
+/* gauge vector */
+u32 vlib_stats_add_gauge_vector (char *fmt, ...);
+
+/* histogram */
+u32 vlib_stats_add_histogram_log2 (u32 n_bins, u32 base, char *fmt, ...);
+u32 vlib_stats_add_histogram_linear (u32 n_bins, u32 base, u32 width,
+				     char *fmt, ...);
+
 /* string vector */
 typedef u8 **vlib_stats_string_vector_t;
 vlib_stats_string_vector_t vlib_stats_add_string_vector (char *fmt, ...);
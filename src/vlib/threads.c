@@ -1375,6 +1375,9 @@ vlib_worker_thread_barrier_sync_int (vlib_main_t * vm, const char *func_name)
   deadline = now + BARRIER_SYNC_TIMEOUT;
 
   *vlib_worker_threads->wait_at_barrier = 1;
+  for (i = 1; i < vlib_get_n_threads (); i++)
+    vlib_thread_wakeup (vlib_get_main_by_index (i));
+
   while (*vlib_worker_threads->workers_at_barrier != count)
     {
       if ((now = vlib_time_now (vm)) > deadline)
@@ -1386,6 +1389,9 @@ vlib_worker_thread_barrier_sync_int (vlib_main_t * vm, const char *func_name)
 
   t_closed = now - vm->barrier_epoch;
 
+  /* every worker is parked, whatever was waiting to be freed can go */
+  vlib_thread_main.deferred_quiesced = 1;
+
   barrier_trace_sync (t_entry, t_open, t_closed);
 
 }
@@ -1586,6 +1592,130 @@ vlib_worker_wait_one_loop (void)
   return;
 }
 
+void
+vlib_worker_thread_defer (vlib_thread_defer_fn_t *fn, uword opaque)
+{
+  vlib_thread_main_t *tm = vlib_get_thread_main ();
+  vlib_thread_deferred_t *d;
+
+  ASSERT (vlib_get_thread_index () == 0);
+
+  /* nobody to wait for */
+  if (vlib_get_n_threads () < 2 || vlib_worker_thread_barrier_held ())
+    {
+      fn (opaque);
+      return;
+    }
+
+  vec_add2 (tm->deferred_pending, d, 1);
+  d->fn = fn;
+  d->opaque = opaque;
+}
+
+/**
+ * Called from the main loop; retires the waiting batch once each worker
+ * has passed a quiescent point, then starts a grace period for whatever
+ * was queued since.
+ */
+void
+vlib_worker_thread_defer_run (vlib_main_t *vm)
+{
+  vlib_thread_main_t *tm = vlib_get_thread_main ();
+  vlib_thread_deferred_t *d, *tmp;
+  u32 ii;
+
+  if (vec_len (tm->deferred_waiting))
+    {
+      /*
+       * A worker asleep in the idle path finished its last loop before
+       * going to sleep, so it holds no references either. Pairs with the
+       * fences in the worker sleep start/end.
+       */
+      CLIB_MEMORY_BARRIER ();
+      if (!tm->deferred_quiesced)
+	for (ii = 1; ii < vec_len (tm->deferred_loop_counts); ii++)
+	  {
+	    vlib_main_t *wvm = vlib_get_main_by_index (ii);
+
+	    if (tm->deferred_loop_counts[ii] == wvm->main_loop_count &&
+		!wvm->sleeping)
+	      return;
+	  }
+
+      vec_foreach (d, tm->deferred_waiting)
+	d->fn (d->opaque);
+      vec_reset_length (tm->deferred_waiting);
+    }
+
+  if (0 == vec_len (tm->deferred_pending))
+    return;
+
+  tmp = tm->deferred_waiting;
+  tm->deferred_waiting = tm->deferred_pending;
+  tm->deferred_pending = tmp;
+
+  vec_validate (tm->deferred_loop_counts, vlib_get_n_threads () - 1);
+  for (ii = 1; ii < vec_len (tm->deferred_loop_counts); ii++)
+    tm->deferred_loop_counts[ii] =
+      vlib_get_main_by_index (ii)->main_loop_count;
+  tm->deferred_quiesced = 0;
+}
+
+/*
+ * Wait until each worker has either been round its loop or gone to sleep
+ * on idle, i.e. holds no pointer loaded before this call.
+ */
+static void
+vlib_worker_thread_wait_quiescent (void)
+{
+  vlib_global_main_t *vgm = vlib_get_global_main ();
+  u32 *counts = 0;
+  u32 ii;
+
+  vec_validate (counts, vlib_get_n_threads () - 1);
+  vec_foreach_index (ii, vgm->vlib_mains)
+    counts[ii] = vgm->vlib_mains[ii]->main_loop_count;
+
+  /* pairs with the fences in the worker sleep start/end */
+  CLIB_MEMORY_BARRIER ();
+  for (ii = 1; ii < vec_len (counts); ii++)
+    {
+      vlib_main_t *wvm = vgm->vlib_mains[ii];
+
+      while (counts[ii] == wvm->main_loop_count && !wvm->sleeping)
+	CLIB_PAUSE ();
+    }
+
+  vec_free (counts);
+}
+
+void
+_vlib_worker_thread_pool_grow (void **pp, uword align, uword elt_sz)
+{
+  void *old = pp[0], *new;
+  uword n_elts = clib_max (vec_len (old) / 2, 32);
+
+  ASSERT (vlib_get_thread_index () == 0);
+
+  if (!old || vlib_get_n_threads () < 2 || vlib_worker_thread_barrier_held ())
+    {
+      _pool_alloc (pp, n_elts, align, 0, elt_sz);
+      return;
+    }
+
+  new = _pool_dup (old, align, elt_sz);
+  _pool_alloc (&new, n_elts, align, 0, elt_sz);
+  clib_atomic_store_rel_n (pp, new);
+
+  /*
+   * A worker may still hold the old base. Once our caller hands out an
+   * index past its end and publishes it, such a worker would index out
+   * of the old copy, so wait for them all to reload before returning.
+   */
+  vlib_worker_thread_wait_quiescent ();
+  pool_free (old);
+}
+
 void
 vlib_worker_thread_fn (void *arg)
 {
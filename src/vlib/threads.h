@@ -175,6 +175,44 @@ void vlib_worker_thread_node_refork (void);
  */
 void vlib_worker_wait_one_loop (void);
 
+typedef void (vlib_thread_defer_fn_t) (uword opaque);
+
+typedef struct
+{
+  vlib_thread_defer_fn_t *fn;
+  uword opaque;
+} vlib_thread_deferred_t;
+
+/**
+ * Release an object once no worker can hold a reference to it.
+ *
+ * The main thread unlinks the object from the data-plane and hands it
+ * here instead of taking the barrier; @a fn is called on the main thread
+ * once every worker has been round its main loop at least once since.
+ */
+void vlib_worker_thread_defer (vlib_thread_defer_fn_t *fn, uword opaque);
+void vlib_worker_thread_defer_run (vlib_main_t *vm);
+
+/**
+ * Grow a pool so the next pool_get will not move it, without stopping
+ * the workers. A larger copy is published and the call returns once every
+ * worker has been round its loop, so none still reads the old copy when
+ * the new indices are handed out.
+ */
+void _vlib_worker_thread_pool_grow (void **pp, uword align, uword elt_sz);
+
+#define vlib_worker_thread_pool_grow_aligned(P, A)                            \
+  do                                                                          \
+    {                                                                         \
+      if (pool_get_will_expand (P))                                           \
+	_vlib_worker_thread_pool_grow ((void **) &(P), _vec_align (P, A),     \
+				       _vec_elt_sz (P));                      \
+    }                                                                         \
+  while (0)
+
+#define vlib_worker_thread_pool_grow(P)                                       \
+  vlib_worker_thread_pool_grow_aligned (P, 0)
+
 static_always_inline uword
 vlib_get_thread_index (void)
 {
@@ -281,6 +319,17 @@ typedef struct
   /* NUMA-bound heap size */
   uword numa_heap_size;
 
+  /* Deferred reclamation: objects queued since the current grace
+   * period started, and those waiting for it to end */
+  vlib_thread_deferred_t *deferred_pending;
+  vlib_thread_deferred_t *deferred_waiting;
+
+  /* Worker main loop counts sampled when the grace period started */
+  u32 *deferred_loop_counts;
+
+  /* A barrier was taken during the grace period */
+  u8 deferred_quiesced;
+
 } vlib_thread_main_t;
 
 extern vlib_thread_main_t vlib_thread_main;
@@ -42,6 +42,9 @@
 #include <signal.h>
 #include <unistd.h>
 #include <vppinfra/tw_timer_1t_3w_1024sl_ov.h>
+#ifdef __x86_64__
+#include <x86intrin.h>
+#endif
 
 /* FIXME autoconf */
 #define HAVE_LINUX_EPOLL
@@ -130,6 +133,102 @@ linux_epoll_file_update (clib_file_t * f, clib_file_update_type_t update_type)
     }
 }
 
+static u64
+linux_epoll_worker_sleep_start (vlib_main_t *vm)
+{
+  vm->wakeup_requested = 0;
+  vm->sleeping = 1;
+  /* store the flag before checking for work, so a waker reading it after
+   * the checks rings the doorbell */
+  CLIB_MEMORY_BARRIER ();
+  return clib_cpu_time_now ();
+}
+
+static void
+linux_epoll_worker_sleep_end (vlib_main_t *vm, u64 t0)
+{
+  u64 now = clib_cpu_time_now ();
+  u64 requested = vm->wakeup_requested;
+
+  vm->sleeping = 0;
+  /* see vlib_worker_thread_defer_run: no loads before the clear is seen */
+  CLIB_MEMORY_BARRIER ();
+  vm->n_idle_sleeps++;
+  vm->cpu_time_asleep += now - t0;
+
+  if (requested)
+    {
+      u64 latency = now > requested ? now - requested : 0;
+      vm->n_idle_wakeups++;
+      vm->wakeup_latency_total += latency;
+      vm->wakeup_latency_max = clib_max (vm->wakeup_latency_max, latency);
+    }
+}
+
+#ifdef __x86_64__
+static __clib_noinline __attribute__ ((target ("waitpkg"))) void
+linux_epoll_worker_umwait (volatile u64 *addr, u64 deadline)
+{
+  _umonitor ((void *) addr);
+  if (*addr == 0)
+    _umwait (0 /* C0.2 */, deadline);
+}
+#endif
+
+/*
+ * Worker thread with nothing to wait on in epoll: sleep until the timeout,
+ * a barrier request, a pending interrupt or a wakeup from another thread.
+ * With umwait the thread waits on its wakeup word and wakes as soon as it
+ * is written. Either way it rechecks for work every idle-wakeup-usec,
+ * which bounds the latency of work handed over by a waker that raced with
+ * the thread going to sleep and did not ring.
+ */
+static void
+linux_epoll_worker_sleep (vlib_main_t *vm, f64 timeout)
+{
+  unix_main_t *um = &unix_main;
+  vlib_node_main_t *nm = &vm->node_main;
+  f64 clocks_per_second = vm->clib_time.clocks_per_second;
+  u64 t0, now, limit, nap;
+
+  t0 = linux_epoll_worker_sleep_start (vm);
+  limit = t0 + (u64) (timeout * clocks_per_second);
+  nap = (u64) (um->idle_wakeup_usec * 1e-6 * clocks_per_second);
+
+  while (1)
+    {
+      if (vm->wakeup_requested || vm->check_frame_queues ||
+	  *vlib_worker_threads->wait_at_barrier ||
+	  clib_interrupt_is_any_pending (nm->input_node_interrupts) ||
+	  clib_interrupt_is_any_pending (nm->pre_input_node_interrupts))
+	break;
+
+      now = clib_cpu_time_now ();
+      if (now >= limit)
+	break;
+
+#ifdef __x86_64__
+      if (clib_cpu_supports_waitpkg ())
+	{
+	  /* the kernel caps each wait too, we come round again if need be */
+	  linux_epoll_worker_umwait (&vm->wakeup_requested,
+				     clib_min (limit, now + nap));
+	  continue;
+	}
+#endif
+      {
+	struct timespec ts, tsrem;
+	ts.tv_sec = 0;
+	ts.tv_nsec = 1000 * um->idle_wakeup_usec;
+
+	while (nanosleep (&ts, &tsrem) < 0)
+	  ts = tsrem;
+      }
+    }
+
+  linux_epoll_worker_sleep_end (vm, t0);
+}
+
 static_always_inline uword
 linux_epoll_input_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 			  vlib_frame_t * frame, u32 thread_index)
@@ -216,11 +315,19 @@ linux_epoll_input_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
     if (is_main || em->epoll_fd != -1)
       {
 	static sigset_t unblock_all_signals;
+	u64 t0 = 0;
+
+	if (is_main == 0 && timeout_ms)
+	  t0 = linux_epoll_worker_sleep_start (vm);
+
 	n_fds_ready = epoll_pwait (em->epoll_fd,
 				   em->epoll_events,
 				   vec_len (em->epoll_events),
 				   timeout_ms, &unblock_all_signals);
 
+	if (t0)
+	  linux_epoll_worker_sleep_end (vm, t0);
+
 	/* This kludge is necessary to run over absurdly old kernels */
 	if (n_fds_ready < 0 && errno == ENOSYS)
 	  {
@@ -233,30 +340,10 @@ linux_epoll_input_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
     else
       {
 	/*
-	 * Worker thread, no epoll fd's, sleep for 100us at a time
-	 * and check for a barrier sync request
+	 * Worker thread, no epoll fd's, sleep until there is work
 	 */
 	if (timeout_ms)
-	  {
-	    struct timespec ts, tsrem;
-	    f64 limit = now + (f64) timeout_ms * 1e-3;
-
-	    while (vlib_time_now (vm) < limit)
-	      {
-		/* Sleep for 100us at a time */
-		ts.tv_sec = 0;
-		ts.tv_nsec = 1000 * 100;
-
-		while (nanosleep (&ts, &tsrem) < 0)
-		  ts = tsrem;
-		if (*vlib_worker_threads->wait_at_barrier ||
-		    clib_interrupt_is_any_pending (
-		      nm->input_node_interrupts) ||
-		    clib_interrupt_is_any_pending (
-		      nm->pre_input_node_interrupts))
-		  goto done;
-	      }
-	  }
+	  linux_epoll_worker_sleep (vm, timeout);
 	goto done;
       }
   }
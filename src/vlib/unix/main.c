@@ -305,6 +305,7 @@ unix_config (vlib_main_t * vm, unformat_input_t * input)
   /* Defaults */
   um->cli_pager_buffer_limit = UNIX_CLI_DEFAULT_PAGER_LIMIT;
   um->cli_history_limit = UNIX_CLI_DEFAULT_HISTORY;
+  um->idle_wakeup_usec = 100;
 
   while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
     {
@@ -334,6 +335,8 @@ unix_config (vlib_main_t * vm, unformat_input_t * input)
 	um->cli_no_pager = 1;
       else if (unformat (input, "poll-sleep-usec %d", &um->poll_sleep_usec))
 	;
+      else if (unformat (input, "idle-wakeup-usec %u", &um->idle_wakeup_usec))
+	;
       else if (unformat (input, "cli-pager-buffer-limit %d",
 			 &um->cli_pager_buffer_limit))
 	;
@@ -557,6 +560,11 @@ unix_config (vlib_main_t * vm, unformat_input_t * input)
  *
  * @cfgcmd{poll-sleep-usec, &lt;nn&gt;}
  * Set a fixed poll sleep interval between main loop polls.
+ *
+ * @cfgcmd{idle-wakeup-usec, &lt;nn&gt;}
+ * Bound the latency with which an idle worker, asleep without an epoll
+ * fd to wait on, notices new work. Not used when the CPU has umwait.
+ * Default value: @c 100
 ?*/
 VLIB_EARLY_CONFIG_FUNCTION (unix_config, "unix");
 
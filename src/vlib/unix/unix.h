@@ -109,6 +109,9 @@ typedef struct
 
   u32 poll_sleep_usec;
 
+  /* Longest a sleeping worker naps before rechecking for work */
+  u32 idle_wakeup_usec;
+
 } unix_main_t;
 
 /** CLI session events. */
@@ -69,29 +69,24 @@ ip_adjacency_t *
 adj_alloc (fib_protocol_t proto)
 {
     ip_adjacency_t *adj;
-    u8 need_barrier_sync = pool_get_will_expand (adj_pool);
+    u8 need_barrier_sync;
     vlib_main_t *vm;
     vm = vlib_get_main();
 
     ASSERT (vm->thread_index == 0);
 
-    /* If the adj_pool will expand, stop the parade. */
-    if (need_barrier_sync)
-        vlib_worker_thread_barrier_sync (vm);
+    /* If the adj_pool will expand, grow it by copy; the parade goes on. */
+    vlib_worker_thread_pool_grow_aligned (adj_pool, CLIB_CACHE_LINE_BYTES);
 
     pool_get_aligned(adj_pool, adj, CLIB_CACHE_LINE_BYTES);
 
     adj_poison(adj);
 
-    /* Validate adjacency counters. */
-    if (need_barrier_sync == 0)
-    {
-        /* If the adj counter pool will expand, stop the parade */
-        need_barrier_sync = vlib_validate_combined_counter_will_expand
-            (&adjacency_counters, adj_get_index (adj));
-        if (need_barrier_sync)
-            vlib_worker_thread_barrier_sync (vm);
-    }
+    /* If the adj counter pool will expand, stop the parade */
+    need_barrier_sync = vlib_validate_combined_counter_will_expand
+        (&adjacency_counters, adj_get_index (adj));
+    if (need_barrier_sync)
+        vlib_worker_thread_barrier_sync (vm);
     vlib_validate_combined_counter(&adjacency_counters,
                                    adj_get_index(adj));
 
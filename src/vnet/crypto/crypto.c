@@ -119,6 +119,7 @@ vnet_crypto_register_engine (vlib_main_t * vm, char *name, int prio,
   p->name = name;
   p->desc = desc;
   p->priority = prio;
+  p->max_async_frame_size = VNET_CRYPTO_FRAME_SIZE;
 
   hash_set_mem (cm->engine_index_by_name, p->name, p - cm->engines);
 
@@ -277,6 +278,26 @@ vnet_crypto_register_ops_handlers (vlib_main_t * vm, u32 engine_index,
   vnet_crypto_register_ops_handler_inline (vm, engine_index, opt, fn, cfn);
 }
 
+static void
+vnet_crypto_update_async_frame_sizes (void)
+{
+  vnet_crypto_main_t *cm = &crypto_main;
+  vnet_crypto_async_op_data_t *otd;
+  vnet_crypto_engine_t *e;
+  u32 i;
+
+  for (i = 0; i < VNET_CRYPTO_ASYNC_OP_N_IDS; i++)
+    {
+      otd = cm->async_opt_data + i;
+      otd->frame_size = clib_min (cm->async_frame_size, VNET_CRYPTO_FRAME_SIZE);
+      if (otd->active_engine_index_async >= vec_len (cm->engines))
+	continue;
+      e = cm->engines + otd->active_engine_index_async;
+      otd->frame_size =
+	clib_min (cm->async_frame_size, e->max_async_frame_size);
+    }
+}
+
 void
 vnet_crypto_register_enqueue_handler (vlib_main_t *vm, u32 engine_index,
 				      vnet_crypto_async_op_id_t opt,
@@ -305,6 +326,8 @@ vnet_crypto_register_enqueue_handler (vlib_main_t *vm, u32 engine_index,
       cm->enqueue_handlers[opt] = enqueue_hdl;
     }
 
+  vnet_crypto_update_async_frame_sizes ();
+
   return;
 }
 
@@ -376,6 +399,19 @@ vnet_crypto_register_dequeue_handler (vlib_main_t *vm, u32 engine_index,
   return;
 }
 
+void
+vnet_crypto_register_async_frame_size (vlib_main_t *vm, u32 engine_index,
+				       u16 max_frame_size)
+{
+  vnet_crypto_main_t *cm = &crypto_main;
+  vnet_crypto_engine_t *e = vec_elt_at_index (cm->engines, engine_index);
+
+  e->max_async_frame_size =
+    clib_clamp (max_frame_size, 1, VNET_CRYPTO_FRAME_SIZE_MAX);
+
+  vnet_crypto_update_async_frame_sizes ();
+}
+
 void
 vnet_crypto_register_key_handler (vlib_main_t * vm, u32 engine_index,
 				  vnet_crypto_key_handler_t * key_handler)
@@ -574,6 +610,7 @@ vnet_crypto_set_async_handler2 (char *alg_name, char *engine)
     }
 
   vnet_crypto_update_cm_dequeue_handlers ();
+  vnet_crypto_update_async_frame_sizes ();
 
   return 0;
 }
@@ -719,14 +756,38 @@ vnet_crypto_init (vlib_main_t * vm)
   vnet_crypto_main_t *cm = &crypto_main;
   vlib_thread_main_t *tm = vlib_get_thread_main ();
   vnet_crypto_thread_t *ct = 0;
+  u32 n_elts, i;
 
   cm->engine_index_by_name = hash_create_string ( /* size */ 0,
 						 sizeof (uword));
   cm->alg_index_by_name = hash_create_string (0, sizeof (uword));
   cm->async_alg_index_by_name = hash_create_string (0, sizeof (uword));
   vec_validate_aligned (cm->threads, tm->n_vlib_mains, CLIB_CACHE_LINE_BYTES);
+
+  if (cm->async_frame_size == 0)
+    cm->async_frame_size = VNET_CRYPTO_FRAME_SIZE;
+  n_elts = VNET_CRYPTO_FRAME_POOL_SIZE * cm->async_frame_size;
+
   vec_foreach (ct, cm->threads)
-    pool_init_fixed (ct->frame_pool, VNET_CRYPTO_FRAME_POOL_SIZE);
+    {
+      pool_init_fixed (ct->frame_pool, VNET_CRYPTO_FRAME_POOL_SIZE);
+      vec_validate_aligned (ct->frame_elts, n_elts - 1,
+			    CLIB_CACHE_LINE_BYTES);
+      vec_validate_aligned (ct->frame_buffer_indices, n_elts - 1,
+			    CLIB_CACHE_LINE_BYTES);
+      vec_validate_aligned (ct->frame_nexts, n_elts - 1,
+			    CLIB_CACHE_LINE_BYTES);
+
+      /* frame pool is fixed, so each frame gets its storage once */
+      for (i = 0; i < VNET_CRYPTO_FRAME_POOL_SIZE; i++)
+	{
+	  vnet_crypto_async_frame_t *f = ct->frame_pool + i;
+	  f->elts = ct->frame_elts + i * cm->async_frame_size;
+	  f->buffer_indices =
+	    ct->frame_buffer_indices + i * cm->async_frame_size;
+	  f->next_node_index = ct->frame_nexts + i * cm->async_frame_size;
+	}
+    }
   vec_validate (cm->algs, VNET_CRYPTO_N_ALGS);
   vec_validate (cm->async_algs, VNET_CRYPTO_N_ASYNC_ALGS);
 
@@ -769,11 +830,40 @@ vnet_crypto_init (vlib_main_t * vm)
     cm->crypto_node_index =
     vlib_get_node_by_name (vm, (u8 *) "crypto-dispatch")->index;
 
+  vnet_crypto_update_async_frame_sizes ();
+
   return 0;
 }
 
 VLIB_INIT_FUNCTION (vnet_crypto_init);
 
+static clib_error_t *
+vnet_crypto_config (vlib_main_t *vm, unformat_input_t *input)
+{
+  vnet_crypto_main_t *cm = &crypto_main;
+  u32 frame_size;
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "async-frame-size %u", &frame_size))
+	{
+	  if (frame_size == 0 || frame_size > VNET_CRYPTO_FRAME_SIZE_MAX)
+	    return clib_error_return (0,
+				      "async-frame-size must be between 1 "
+				      "and %u",
+				      VNET_CRYPTO_FRAME_SIZE_MAX);
+	  cm->async_frame_size = frame_size;
+	}
+      else
+	return clib_error_return (0, "unknown input '%U'",
+				  format_unformat_error, input);
+    }
+
+  return 0;
+}
+
+VLIB_EARLY_CONFIG_FUNCTION (vnet_crypto_config, "crypto");
+
 /*
  * fd.io coding-style-patch-verification: ON
  *
@@ -19,6 +19,7 @@
 #include <vlib/vlib.h>
 
 #define VNET_CRYPTO_FRAME_SIZE 64
+#define VNET_CRYPTO_FRAME_SIZE_MAX 256
 #define VNET_CRYPTO_FRAME_POOL_SIZE 1024
 
 /* CRYPTO_ID, PRETTY_NAME, KEY_LENGTH_IN_BYTES */
@@ -324,6 +325,8 @@ typedef struct
   vnet_crypto_async_op_type_t type;
   vnet_crypto_async_alg_t alg;
   u32 active_engine_index_async;
+  /* elements per frame, bounded by what the active engine supports */
+  u16 frame_size;
 } vnet_crypto_async_op_data_t;
 
 typedef struct
@@ -370,18 +373,32 @@ typedef struct
   vnet_crypto_async_frame_state_t state;
   vnet_crypto_async_op_id_t op:8;
   u16 n_elts;
-  vnet_crypto_async_frame_elt_t elts[VNET_CRYPTO_FRAME_SIZE];
-  u32 buffer_indices[VNET_CRYPTO_FRAME_SIZE];
-  u16 next_node_index[VNET_CRYPTO_FRAME_SIZE];
+  u16 max_elts;
+  /* partial completion, written by the engine: elements [0, n_elts_ready)
+   * are processed and their status is set */
+  u16 n_elts_ready;
+  /* partial completion, owned by the enqueue thread: elements already sent
+   * to the next nodes and end of the range handed out by the last partial
+   * dequeue */
+  u16 n_elts_dequeued;
+  u16 partial_dequeue_end;
   u32 enqueue_thread_index;
+  /* per-frame storage, carved out of the thread frame arena */
+  vnet_crypto_async_frame_elt_t *elts;
+  u32 *buffer_indices;
+  u16 *next_node_index;
 } vnet_crypto_async_frame_t;
 
 typedef struct
 {
   CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
   vnet_crypto_async_frame_t *frame_pool;
+  vnet_crypto_async_frame_elt_t *frame_elts;
+  u32 *frame_buffer_indices;
+  u16 *frame_nexts;
   u32 *buffer_indices;
   u16 *nexts;
+  uword *enqueue_threads_to_signal;
 } vnet_crypto_thread_t;
 
 typedef u32 vnet_crypto_key_index_t;
@@ -441,6 +458,13 @@ void
 vnet_crypto_register_dequeue_handler (vlib_main_t *vm, u32 engine_index,
 				      vnet_crypto_frame_dequeue_t *deq_fn);
 
+/**
+ * Engines able to process frames larger than VNET_CRYPTO_FRAME_SIZE
+ * advertise their limit (at most VNET_CRYPTO_FRAME_SIZE_MAX) here.
+ **/
+void vnet_crypto_register_async_frame_size (vlib_main_t *vm, u32 engine_index,
+					    u16 max_frame_size);
+
 typedef struct
 {
   char *name;
@@ -452,6 +476,7 @@ typedef struct
     * chained_ops_handlers[VNET_CRYPTO_N_OP_IDS];
   vnet_crypto_frame_enqueue_t *enqueue_handlers[VNET_CRYPTO_ASYNC_OP_N_IDS];
   vnet_crypto_frame_dequeue_t *dequeue_handler;
+  u16 max_async_frame_size;
 } vnet_crypto_engine_t;
 
 typedef struct
@@ -478,6 +503,7 @@ typedef struct
   vnet_crypto_async_alg_data_t *async_algs;
   vnet_crypto_async_next_node_t *next_nodes;
   u32 crypto_node_index;
+  u16 async_frame_size;
 } vnet_crypto_main_t;
 
 extern vnet_crypto_main_t crypto_main;
@@ -569,11 +595,15 @@ vnet_crypto_async_get_frame (vlib_main_t * vm, vnet_crypto_async_op_id_t opt)
     {
       pool_get_aligned (ct->frame_pool, f, CLIB_CACHE_LINE_BYTES);
 #if CLIB_DEBUG > 0
-      clib_memset (f, 0xfe, sizeof (*f));
+      clib_memset (f->elts, 0xfe, cm->async_frame_size * sizeof (f->elts[0]));
 #endif
       f->state = VNET_CRYPTO_FRAME_STATE_NOT_PROCESSED;
       f->op = opt;
       f->n_elts = 0;
+      f->max_elts = cm->async_opt_data[opt].frame_size;
+      f->n_elts_ready = 0;
+      f->n_elts_dequeued = 0;
+      f->partial_dequeue_end = 0;
     }
 
   return f;
@@ -637,7 +667,7 @@ vnet_crypto_async_add_to_frame (vlib_main_t *vm, vnet_crypto_async_frame_t *f,
   vnet_crypto_async_frame_elt_t *fe;
   u16 index;
 
-  ASSERT (f->n_elts < VNET_CRYPTO_FRAME_SIZE);
+  ASSERT (f->n_elts < f->max_elts);
 
   index = f->n_elts;
   fe = &f->elts[index];
@@ -664,16 +694,36 @@ vnet_crypto_async_reset_frame (vnet_crypto_async_frame_t * f)
 	   || f->state == VNET_CRYPTO_FRAME_STATE_ELT_ERROR));
   opt = f->op;
   if (CLIB_DEBUG > 0)
-    clib_memset (f, 0xfe, sizeof (*f));
+    clib_memset (f->elts, 0xfe, f->n_elts * sizeof (f->elts[0]));
   f->state = VNET_CRYPTO_FRAME_STATE_NOT_PROCESSED;
   f->op = opt;
   f->n_elts = 0;
+  f->n_elts_ready = 0;
+  f->n_elts_dequeued = 0;
+  f->partial_dequeue_end = 0;
 }
 
 static_always_inline u8
 vnet_crypto_async_frame_is_full (const vnet_crypto_async_frame_t *f)
 {
-  return (f->n_elts == VNET_CRYPTO_FRAME_SIZE);
+  return (f->n_elts == f->max_elts);
+}
+
+/**
+ * Called by the dequeue handler of an engine on a frame which is still in
+ * flight to hand out the elements which are already processed. Returns the
+ * frame if some new elements are ready, the frame stays owned by the engine.
+ **/
+static_always_inline vnet_crypto_async_frame_t *
+vnet_crypto_async_frame_dequeue_partial (vnet_crypto_async_frame_t *f)
+{
+  u16 n_ready = clib_atomic_load_acq_n (&f->n_elts_ready);
+
+  if (n_ready <= f->n_elts_dequeued)
+    return 0;
+
+  f->partial_dequeue_end = n_ready;
+  return f;
 }
 
 #endif /* included_vnet_crypto_crypto_h */
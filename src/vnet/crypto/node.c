@@ -77,7 +77,6 @@ crypto_dequeue_frame (vlib_main_t * vm, vlib_node_runtime_t * node,
 		      vnet_crypto_frame_dequeue_t * hdl, u32 n_cache,
 		      u32 * n_total)
 {
-  vnet_crypto_main_t *cm = &crypto_main;
   u32 n_elts = 0;
   u32 enqueue_thread_idx = ~0;
   vnet_crypto_async_frame_t *cf = (hdl) (vm, &n_elts, &enqueue_thread_idx);
@@ -87,31 +86,39 @@ crypto_dequeue_frame (vlib_main_t * vm, vlib_node_runtime_t * node,
     {
       if (cf)
 	{
-	  vec_validate (ct->buffer_indices, n_cache + cf->n_elts);
-	  vec_validate (ct->nexts, n_cache + cf->n_elts);
-	  clib_memcpy_fast (ct->buffer_indices + n_cache, cf->buffer_indices,
-			    sizeof (u32) * cf->n_elts);
-	  if (cf->state == VNET_CRYPTO_FRAME_STATE_SUCCESS)
+	  u32 first = cf->n_elts_dequeued, last, n, i;
+	  u8 is_partial = cf->partial_dequeue_end != 0;
+
+	  /* a partially completed frame only hands out its processed
+	   * elements and stays with the engine until the rest is done */
+	  last = is_partial ? cf->partial_dequeue_end : cf->n_elts;
+	  n = last - first;
+
+	  vec_validate (ct->buffer_indices, n_cache + n);
+	  vec_validate (ct->nexts, n_cache + n);
+	  clib_memcpy_fast (ct->buffer_indices + n_cache,
+			    cf->buffer_indices + first, sizeof (u32) * n);
+	  if (!is_partial && cf->state == VNET_CRYPTO_FRAME_STATE_SUCCESS)
 	    {
-	      clib_memcpy_fast (ct->nexts + n_cache, cf->next_node_index,
-				sizeof (u16) * cf->n_elts);
+	      clib_memcpy_fast (ct->nexts + n_cache,
+				cf->next_node_index + first, sizeof (u16) * n);
 	    }
 	  else
 	    {
-	      u32 i;
-	      for (i = 0; i < cf->n_elts; i++)
+	      for (i = first; i < last; i++)
 		{
 		  if (cf->elts[i].status != VNET_CRYPTO_OP_STATUS_COMPLETED)
 		    {
-		      ct->nexts[i + n_cache] = CRYPTO_DISPATCH_NEXT_ERR_DROP;
+		      ct->nexts[i - first + n_cache] =
+			CRYPTO_DISPATCH_NEXT_ERR_DROP;
 		      vlib_node_increment_counter (vm, node->node_index,
 						   cf->elts[i].status, 1);
 		    }
 		  else
-		    ct->nexts[i + n_cache] = cf->next_node_index[i];
+		    ct->nexts[i - first + n_cache] = cf->next_node_index[i];
 		}
 	    }
-	  n_cache += cf->n_elts;
+	  n_cache += n;
 	  if (n_cache >= VLIB_FRAME_SIZE)
 	    {
 	      vlib_buffer_enqueue_to_next_vec (vm, node, &ct->buffer_indices,
@@ -121,9 +128,7 @@ crypto_dequeue_frame (vlib_main_t * vm, vlib_node_runtime_t * node,
 
 	  if (PREDICT_FALSE (node->flags & VLIB_NODE_FLAG_TRACE))
 	    {
-	      u32 i;
-
-	      for (i = 0; i < cf->n_elts; i++)
+	      for (i = first; i < last; i++)
 		{
 		  vlib_buffer_t *b = vlib_get_buffer (vm,
 						      cf->buffer_indices[i]);
@@ -132,19 +137,20 @@ crypto_dequeue_frame (vlib_main_t * vm, vlib_node_runtime_t * node,
 						 cf->elts[i].status);
 		}
 	    }
-	  vnet_crypto_async_free_frame (vm, cf);
-	}
-      /* signal enqueue-thread to dequeue the processed frame (n_elts>0) */
-      if (n_elts > 0 &&
-	  ((node->state == VLIB_NODE_STATE_POLLING &&
-	    (node->flags &
-	     VLIB_NODE_FLAG_SWITCH_FROM_POLLING_TO_INTERRUPT_MODE)) ||
-	   node->state == VLIB_NODE_STATE_INTERRUPT))
-	{
-	  vlib_node_set_interrupt_pending (
-	    vlib_get_main_by_index (enqueue_thread_idx),
-	    cm->crypto_node_index);
+
+	  if (is_partial)
+	    {
+	      cf->n_elts_dequeued = last;
+	      cf->partial_dequeue_end = 0;
+	    }
+	  else
+	    vnet_crypto_async_free_frame (vm, cf);
 	}
+      /* remember enqueue-thread to signal once all handlers ran, so it is
+       * woken up once per dispatch and not once per processed frame */
+      if (n_elts > 0)
+	ct->enqueue_threads_to_signal = clib_bitmap_set (
+	  ct->enqueue_threads_to_signal, enqueue_thread_idx, 1);
 
       n_elts = 0;
       enqueue_thread_idx = 0;
@@ -172,6 +178,21 @@ VLIB_NODE_FN (crypto_dispatch_node) (vlib_main_t * vm,
     vlib_buffer_enqueue_to_next_vec (vm, node, &ct->buffer_indices, &ct->nexts,
 				     n_cache);
 
+  /* signal enqueue-threads to dequeue the frames processed for them */
+  if (!clib_bitmap_is_zero (ct->enqueue_threads_to_signal))
+    {
+      if ((node->state == VLIB_NODE_STATE_POLLING &&
+	   (node->flags &
+	    VLIB_NODE_FLAG_SWITCH_FROM_POLLING_TO_INTERRUPT_MODE)) ||
+	  node->state == VLIB_NODE_STATE_INTERRUPT)
+	{
+	  clib_bitmap_foreach (index, ct->enqueue_threads_to_signal)
+	    vlib_node_set_interrupt_pending (vlib_get_main_by_index (index),
+					     cm->crypto_node_index);
+	}
+      clib_bitmap_zero (ct->enqueue_threads_to_signal);
+    }
+
   /* if there are still pending tasks and node in interrupt mode,
   sending current thread signal to dequeue next loop */
   if (pool_elts (ct->frame_pool) > 0 &&
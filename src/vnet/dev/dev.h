@@ -25,11 +25,13 @@ typedef enum
 #undef _
 } vnet_dev_port_type_t;
 
+/* ipsec_inline is experimental, no driver sets it yet */
 #define foreach_vnet_dev_port_caps                                            \
   _ (interrupt_mode)                                                          \
   _ (rss)                                                                     \
   _ (change_max_rx_frame_size)                                                \
-  _ (mac_filter)
+  _ (mac_filter)                                                              \
+  _ (ipsec_inline)
 
 #define foreach_vnet_dev_port_rx_offloads _ (ip4_cksum)
 
@@ -150,7 +152,9 @@ typedef struct
   _ (ADD_RX_FLOW)                                                             \
   _ (DEL_RX_FLOW)                                                             \
   _ (GET_RX_FLOW_COUNTER)                                                     \
-  _ (RESET_RX_FLOW_COUNTER)
+  _ (RESET_RX_FLOW_COUNTER)                                                    \
+  _ (ADD_IPSEC_SA)                                                            \
+  _ (DEL_IPSEC_SA)
 
 typedef enum
 {
@@ -177,6 +181,7 @@ typedef struct vnet_dev_port_cfg_change_req
       u32 flow_index;
       uword *private_data;
     };
+    u32 sa_index;
   };
 
 } vnet_dev_port_cfg_change_req_t;
@@ -328,6 +333,7 @@ typedef struct vnet_dev_port
   u32 max_rx_frame_size;
   vnet_dev_hw_addr_t primary_hw_addr;
   vnet_dev_hw_addr_t *secondary_hw_addr;
+  uword *ipsec_sas;
   u32 index;
   u32 speed;
   vnet_dev_rx_queue_t **rx_queues;
@@ -560,6 +566,7 @@ clib_error_t *vnet_dev_add_del_mac_address (vnet_hw_interface_t *, const u8 *,
 					    u8);
 int vnet_dev_flow_ops_fn (vnet_main_t *, vnet_flow_dev_op_t, u32, u32,
 			  uword *);
+int vnet_dev_ipsec_sa_ops_fn (vnet_main_t *, u32, u32, int);
 clib_error_t *vnet_dev_interface_set_rss_queues (vnet_main_t *,
 						 vnet_hw_interface_t *,
 						 clib_bitmap_t *);
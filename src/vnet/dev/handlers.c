@@ -189,6 +189,35 @@ vnet_dev_flow_ops_fn (vnet_main_t *vnm, vnet_flow_dev_op_t op,
   return 0;
 }
 
+int
+vnet_dev_ipsec_sa_ops_fn (vnet_main_t *vnm, u32 dev_instance, u32 sa_index,
+			  int is_add)
+{
+  vlib_main_t *vm = vlib_get_main ();
+  vnet_dev_port_t *p = vnet_dev_get_port_from_dev_instance (dev_instance);
+  vnet_dev_port_cfg_change_req_t req = {
+    .type = is_add ? VNET_DEV_PORT_CFG_ADD_IPSEC_SA :
+		     VNET_DEV_PORT_CFG_DEL_IPSEC_SA,
+    .sa_index = sa_index,
+  };
+  vnet_dev_rv_t rv;
+
+  rv = vnet_dev_port_cfg_change_req_validate (vm, p, &req);
+  if (rv != VNET_DEV_OK)
+    {
+      log_debug (p->dev, "validation failed for ipsec sa %u", sa_index);
+      return rv;
+    }
+
+  if ((rv = vnet_dev_process_port_cfg_change_req (vm, p, &req)) != VNET_DEV_OK)
+    {
+      log_err (p->dev, "request for ipsec sa %u failed", sa_index);
+      return rv;
+    }
+
+  return 0;
+}
+
 clib_error_t *
 vnet_dev_interface_set_rss_queues (vnet_main_t *vnm, vnet_hw_interface_t *hi,
 				   clib_bitmap_t *bitmap)
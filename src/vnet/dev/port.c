@@ -7,6 +7,7 @@
 #include <vnet/dev/dev.h>
 #include <vnet/dev/counters.h>
 #include <vnet/dev/log.h>
+#include <vnet/ipsec/ipsec_sa.h>
 
 VLIB_REGISTER_LOG_CLASS (dev_log, static) = {
   .class_name = "dev",
@@ -91,6 +92,7 @@ vnet_dev_port_free (vlib_main_t *vm, vnet_dev_port_t *port)
     port->port_ops.free (vm, port);
 
   pool_free (port->secondary_hw_addr);
+  clib_bitmap_free (port->ipsec_sas);
   pool_free (port->rx_queues);
   pool_free (port->tx_queues);
   vnet_dev_arg_free (&port->args);
@@ -337,6 +339,18 @@ vnet_dev_port_cfg_change_req_validate (vlib_main_t *vm, vnet_dev_port_t *port,
 	return VNET_DEV_ERR_NO_SUCH_ENTRY;
       break;
 
+    case VNET_DEV_PORT_CFG_ADD_IPSEC_SA:
+      if (!port->attr.caps.ipsec_inline)
+	return VNET_DEV_ERR_NOT_SUPPORTED;
+      if (clib_bitmap_get (port->ipsec_sas, req->sa_index))
+	return VNET_DEV_ERR_ALREADY_EXISTS;
+      break;
+
+    case VNET_DEV_PORT_CFG_DEL_IPSEC_SA:
+      if (!clib_bitmap_get (port->ipsec_sas, req->sa_index))
+	return VNET_DEV_ERR_NO_SUCH_ENTRY;
+      break;
+
     default:
       break;
     }
@@ -453,6 +467,14 @@ vnet_dev_port_cfg_change (vlib_main_t *vm, vnet_dev_port_t *port,
 	  }
       break;
 
+    case VNET_DEV_PORT_CFG_ADD_IPSEC_SA:
+      port->ipsec_sas = clib_bitmap_set (port->ipsec_sas, req->sa_index, 1);
+      break;
+
+    case VNET_DEV_PORT_CFG_DEL_IPSEC_SA:
+      port->ipsec_sas = clib_bitmap_set (port->ipsec_sas, req->sa_index, 0);
+      break;
+
     default:
       break;
     }
@@ -613,12 +635,17 @@ vnet_dev_port_if_create (vlib_main_t *vm, vnet_dev_port_t *port)
 
       caps |= port->attr.caps.interrupt_mode ? VNET_HW_IF_CAP_INT_MODE : 0;
       caps |= port->attr.caps.mac_filter ? VNET_HW_IF_CAP_MAC_FILTER : 0;
+      caps |= port->attr.caps.ipsec_inline ? VNET_HW_IF_CAP_IPSEC_INLINE : 0;
       caps |= port->attr.tx_offloads.tcp_gso ? VNET_HW_IF_CAP_TCP_GSO : 0;
       caps |= port->attr.tx_offloads.ip4_cksum ? VNET_HW_IF_CAP_TX_CKSUM : 0;
 
       if (caps)
 	vnet_hw_if_set_caps (vnm, port->intf.hw_if_index, caps);
 
+      /* hand over inbound SAs created before the port came up */
+      if (caps & VNET_HW_IF_CAP_IPSEC_INLINE)
+	ipsec_sa_inline_offload_interface_sync (port->intf.hw_if_index);
+
       /* create / reuse rx node */
       if (vec_len (dm->free_rx_node_indices))
 	{
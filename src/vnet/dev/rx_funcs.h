@@ -0,0 +1,175 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2024 Cisco Systems, Inc.
+ */
+
+#ifndef _VNET_DEV_RX_FUNCS_H_
+#define _VNET_DEV_RX_FUNCS_H_
+
+#include <vlib/vlib.h>
+#include <vnet/dev/dev.h>
+
+/*
+ * Building blocks for native driver rx nodes. The driver decodes its own
+ * descriptors into plain per packet arrays (lengths, status words) and
+ * these helpers turn them into buffer metadata and post fresh buffers
+ * back to the ring. Arrays passed to the vectorized helpers must have room
+ * for VNET_DEV_RX_BURST_PAD entries past the last packet.
+ */
+
+#define VNET_DEV_RX_BURST_PAD 16
+
+typedef struct
+{
+  u32 mask;
+  u32 match;
+  u32 flags;
+} vnet_dev_rx_flag_map_t;
+
+/* copy a u16 field found at byte offset 'off' of 'stride' sized
+ * descriptors */
+static_always_inline void
+vnet_dev_rx_desc_get_u16 (void *descs, u32 stride, u32 off, u16 *dst,
+			  u32 n_desc)
+{
+  u8 *p = (u8 *) descs + off;
+
+  for (; n_desc >= 4; n_desc -= 4, dst += 4, p += 4 * stride)
+    {
+      dst[0] = *(u16u *) (p + 0 * stride);
+      dst[1] = *(u16u *) (p + 1 * stride);
+      dst[2] = *(u16u *) (p + 2 * stride);
+      dst[3] = *(u16u *) (p + 3 * stride);
+    }
+
+  for (; n_desc; n_desc--, dst++, p += stride)
+    dst[0] = *(u16u *) p;
+}
+
+static_always_inline void
+vnet_dev_rx_desc_get_u32 (void *descs, u32 stride, u32 off, u32 *dst,
+			  u32 n_desc)
+{
+  u8 *p = (u8 *) descs + off;
+
+  for (; n_desc >= 4; n_desc -= 4, dst += 4, p += 4 * stride)
+    {
+#ifdef CLIB_HAVE_VEC128
+      u32x4_store_unaligned (
+	u32x4_gather (p, p + 1 * stride, p + 2 * stride, p + 3 * stride), dst);
+#else
+      dst[0] = *(u32u *) (p + 0 * stride);
+      dst[1] = *(u32u *) (p + 1 * stride);
+      dst[2] = *(u32u *) (p + 2 * stride);
+      dst[3] = *(u32u *) (p + 3 * stride);
+#endif
+    }
+
+  for (; n_desc; n_desc--, dst++, p += stride)
+    dst[0] = *(u32u *) p;
+}
+
+/* translate status words to buffer flags, each map entry whose masked
+ * status equals 'match' contributes its flags */
+static_always_inline void
+vnet_dev_rx_status_to_flags (u32 *status, u32 *flags, u32 n_desc,
+			     const vnet_dev_rx_flag_map_t *map, u32 n_map)
+{
+#if defined(CLIB_HAVE_VEC256)
+  for (u32 i = 0; i < n_desc; i += 8)
+    {
+      u32x8 s = u32x8_load_unaligned (status + i), f = {};
+      for (u32 j = 0; j < n_map; j++)
+	f |= ((s & u32x8_splat (map[j].mask)) == u32x8_splat (map[j].match)) &
+	     u32x8_splat (map[j].flags);
+      u32x8_store_unaligned (f, flags + i);
+    }
+#elif defined(CLIB_HAVE_VEC128)
+  for (u32 i = 0; i < n_desc; i += 4)
+    {
+      u32x4 s = u32x4_load_unaligned (status + i), f = {};
+      for (u32 j = 0; j < n_map; j++)
+	f |= ((s & u32x4_splat (map[j].mask)) == u32x4_splat (map[j].match)) &
+	     u32x4_splat (map[j].flags);
+      u32x4_store_unaligned (f, flags + i);
+    }
+#else
+  for (u32 i = 0; i < n_desc; i++)
+    {
+      u32 f = 0;
+      for (u32 j = 0; j < n_map; j++)
+	if ((status[i] & map[j].mask) == map[j].match)
+	  f |= map[j].flags;
+      flags[i] = f;
+    }
+#endif
+}
+
+/* initialize buffer metadata from the queue template in a single pass over
+ * the first cacheline, merging in length and flags */
+static_always_inline void
+vnet_dev_rx_buffer_init (vlib_buffer_t *b, vlib_buffer_template_t *bt,
+			 u16 len, u32 flags)
+{
+#if defined(CLIB_HAVE_VEC512)
+  u32x16 r = *(u32x16 *) bt;
+  r[0] = (r[0] & 0xffff) | (u32) len << 16;
+  r[1] |= flags;
+  b->as_u8x64[0] = (u8x64) r;
+#elif defined(CLIB_HAVE_VEC256)
+  u32x8 r = ((u32x8 *) bt)[0];
+  r[0] = (r[0] & 0xffff) | (u32) len << 16;
+  r[1] |= flags;
+  b->as_u8x32[0] = (u8x32) r;
+  b->as_u8x32[1] = ((u8x32 *) bt)[1];
+#else
+  b->template = *bt;
+  b->current_length = len;
+  b->flags |= flags;
+#endif
+}
+
+/* returns sum of lengths, 'flags' may be 0 */
+static_always_inline uword
+vnet_dev_rx_buffers_init (vlib_buffer_t **b, vlib_buffer_template_t *bt,
+			  u16 *lengths, u32 *flags, u32 n_bufs)
+{
+  uword n_bytes = 0;
+
+  for (; n_bufs >= 8; b += 4, lengths += 4, n_bufs -= 4)
+    {
+      clib_prefetch_store (b[4]);
+      clib_prefetch_store (b[5]);
+      clib_prefetch_store (b[6]);
+      clib_prefetch_store (b[7]);
+      vnet_dev_rx_buffer_init (b[0], bt, lengths[0], flags ? flags[0] : 0);
+      vnet_dev_rx_buffer_init (b[1], bt, lengths[1], flags ? flags[1] : 0);
+      vnet_dev_rx_buffer_init (b[2], bt, lengths[2], flags ? flags[2] : 0);
+      vnet_dev_rx_buffer_init (b[3], bt, lengths[3], flags ? flags[3] : 0);
+      n_bytes += lengths[0] + lengths[1] + lengths[2] + lengths[3];
+      flags = flags ? flags + 4 : 0;
+    }
+
+  for (; n_bufs; b++, lengths++, n_bufs--)
+    {
+      vnet_dev_rx_buffer_init (b[0], bt, lengths[0], flags ? flags[0] : 0);
+      n_bytes += lengths[0];
+      flags = flags ? flags + 1 : 0;
+    }
+
+  return n_bytes;
+}
+
+/* addresses of the buffer data areas as seen by the device */
+static_always_inline void
+vnet_dev_rx_buffers_dma_addr (vlib_main_t *vm, u32 *bi, u64 *addr,
+			      u32 n_bufs, int use_va)
+{
+  vlib_get_buffers_with_offset (vm, bi, (void **) addr, n_bufs,
+				STRUCT_OFFSET_OF (vlib_buffer_t, data));
+
+  if (!use_va)
+    for (u32 i = 0; i < n_bufs; i++)
+      addr[i] = vlib_physmem_get_pa (vm, (void *) addr[i]);
+}
+
+#endif /* _VNET_DEV_RX_FUNCS_H_ */
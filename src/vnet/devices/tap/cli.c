@@ -105,6 +105,8 @@ tap_create_command_fn (vlib_main_t * vm, unformat_input_t * input,
 	    args.tap_flags |= TAP_FLAG_PACKED;
 	  else if (unformat (line_input, "in-order"))
 	    args.tap_flags |= TAP_FLAG_IN_ORDER;
+	  else if (unformat (line_input, "io-uring"))
+	    args.tap_flags |= TAP_FLAG_IO_URING;
 	  else if (unformat (line_input, "hw-addr %U",
 			     unformat_ethernet_address, args.mac_addr.bytes))
 	    args.mac_addr_set = 1;
@@ -147,7 +149,7 @@ VLIB_CLI_COMMAND (tap_create_command, static) = {
     "[host-ip4-gw <ip4-addr>] [host-ip6-gw <ip6-addr>] "
     "[host-mac-addr <host-mac-address>] [host-if-name <name>] "
     "[host-mtu-size <size>] [no-gso|gso [gro-coalesce]|csum-offload] "
-    "[persist] [attach] [tun] [packed] [in-order]",
+    "[persist] [attach] [tun] [packed] [in-order] [io-uring]",
   .function = tap_create_command_fn,
 };
 /* *INDENT-ON* */
@@ -42,6 +42,7 @@
 #include <vnet/devices/netlink.h>
 #include <vnet/devices/virtio/virtio.h>
 #include <vnet/devices/tap/tap.h>
+#include <vnet/devices/tap/uring.h>
 
 tap_main_t tap_main;
 
@@ -105,6 +106,7 @@ tap_free (vlib_main_t * vm, virtio_if_t * vif)
   vec_foreach_index (i, vif->txq_vrings)
     virtio_vring_free_tx (vm, vif, TX_QUEUE (i));
   /* *INDENT-ON* */
+  tap_uring_free (vm, vif);
 
   if (vif->tap_fds)
     {
@@ -174,6 +176,18 @@ tap_create_if (vlib_main_t * vm, tap_create_if_args_t * args)
       return;
     }
 
+  /* io_uring moves plain frames, there is no virtio-net header to carry
+   * offload metadata */
+  if ((args->tap_flags & TAP_FLAG_IO_URING) &&
+      (args->tap_flags & (TAP_FLAG_GSO | TAP_FLAG_CSUM_OFFLOAD |
+			  TAP_FLAG_GRO_COALESCE | TAP_FLAG_PACKED)))
+    {
+      args->rv = VNET_API_ERROR_UNSUPPORTED;
+      args->error = clib_error_return (0, "io-uring doesn't support gso, "
+				       "checksum offload or packed ring");
+      return;
+    }
+
   pool_get_zero (vim->interfaces, vif);
 
   if (args->tap_flags & TAP_FLAG_TUN)
@@ -198,6 +212,12 @@ tap_create_if (vlib_main_t * vm, tap_create_if_args_t * args)
       sndbuf = INT_MAX;
     }
 
+  if (args->tap_flags & TAP_FLAG_IO_URING)
+    {
+      vif->is_io_uring = 1;
+      ifr.ifr_flags &= ~IFF_VNET_HDR;
+    }
+
   vif->dev_instance = vif - vim->interfaces;
   vif->id = args->id;
   vif->num_txqs = clib_max (args->num_tx_queues, thm->n_vlib_mains);
@@ -252,7 +272,7 @@ tap_create_if (vlib_main_t * vm, tap_create_if_args_t * args)
 
   _IOCTL (tfd, TUNGETFEATURES, &tap_features);
   tap_log_dbg (vif, "TUNGETFEATURES: features 0x%lx", tap_features);
-  if ((tap_features & IFF_VNET_HDR) == 0)
+  if (!vif->is_io_uring && (tap_features & IFF_VNET_HDR) == 0)
     {
       args->rv = VNET_API_ERROR_SYSCALL_ERROR_2;
       args->error = clib_error_return (0, "vhost-net backend not available");
@@ -342,14 +362,17 @@ tap_create_if (vlib_main_t * vm, tap_create_if_args_t * args)
 
   for (i = 0; i < vif->num_rxqs; i++)
     {
-      tap_log_dbg (vif, "TUNSETVNETHDRSZ: fd %d vnet_hdr_sz %u",
-		   vif->tap_fds[i], hdrsz);
-      _IOCTL (vif->tap_fds[i], TUNSETVNETHDRSZ, &hdrsz);
-
       tap_log_dbg (vif, "TUNSETSNDBUF: fd %d sndbuf %d", vif->tap_fds[i],
 		   sndbuf);
       _IOCTL (vif->tap_fds[i], TUNSETSNDBUF, &sndbuf);
 
+      if (vif->is_io_uring)
+	continue;
+
+      tap_log_dbg (vif, "TUNSETVNETHDRSZ: fd %d vnet_hdr_sz %u",
+		   vif->tap_fds[i], hdrsz);
+      _IOCTL (vif->tap_fds[i], TUNSETVNETHDRSZ, &hdrsz);
+
       tap_log_dbg (vif, "TUNSETOFFLOAD: fd %d offload 0x%lx", vif->tap_fds[i],
 		   offload);
       _IOCTL (vif->tap_fds[i], TUNSETOFFLOAD, offload);
@@ -362,8 +385,10 @@ tap_create_if (vlib_main_t * vm, tap_create_if_args_t * args)
 	}
     }
 
-  /* open as many vhost-net fds as required and set ownership */
-  num_vhost_queues = clib_max (vif->num_rxqs, vif->num_txqs);
+  /* open as many vhost-net fds as required and set ownership, io_uring
+   * reads and writes the tap fds itself */
+  num_vhost_queues =
+    vif->is_io_uring ? 0 : clib_max (vif->num_rxqs, vif->num_txqs);
   for (i = 0; i < num_vhost_queues; i++)
     {
       if ((vfd = open ("/dev/vhost-net", O_RDWR | O_NONBLOCK)) < 0)
@@ -378,40 +403,49 @@ tap_create_if (vlib_main_t * vm, tap_create_if_args_t * args)
       virtio_log_debug (vif, "VHOST_SET_OWNER: fd %u", vfd);
     }
 
-  _IOCTL (vif->vhost_fds[0], VHOST_GET_FEATURES, &vif->remote_features);
-  virtio_log_debug (vif, "VHOST_GET_FEATURES: features 0x%lx",
-		    vif->remote_features);
-
-  if ((vif->remote_features & VIRTIO_FEATURE (VIRTIO_NET_F_MRG_RXBUF)) == 0)
+  if (num_vhost_queues)
     {
-      args->rv = VNET_API_ERROR_UNSUPPORTED;
-      args->error = clib_error_return (0, "vhost-net backend doesn't support "
-				       "VIRTIO_NET_F_MRG_RXBUF feature");
-      goto error;
-    }
+      _IOCTL (vif->vhost_fds[0], VHOST_GET_FEATURES, &vif->remote_features);
+      virtio_log_debug (vif, "VHOST_GET_FEATURES: features 0x%lx",
+			vif->remote_features);
 
-  if ((vif->remote_features & VIRTIO_FEATURE (VIRTIO_RING_F_INDIRECT_DESC)) ==
-      0)
-    {
-      args->rv = VNET_API_ERROR_UNSUPPORTED;
-      args->error = clib_error_return (0, "vhost-net backend doesn't support "
-				       "VIRTIO_RING_F_INDIRECT_DESC feature");
-      goto error;
-    }
+      if ((vif->remote_features & VIRTIO_FEATURE (VIRTIO_NET_F_MRG_RXBUF)) ==
+	  0)
+	{
+	  args->rv = VNET_API_ERROR_UNSUPPORTED;
+	  args->error = clib_error_return (
+	    0, "vhost-net backend doesn't support "
+	       "VIRTIO_NET_F_MRG_RXBUF feature");
+	  goto error;
+	}
 
-  if ((vif->remote_features & VIRTIO_FEATURE (VIRTIO_F_VERSION_1)) == 0)
-    {
-      args->rv = VNET_API_ERROR_UNSUPPORTED;
-      args->error = clib_error_return (0, "vhost-net backend doesn't support "
-				       "VIRTIO_F_VERSION_1 features");
-      goto error;
-    }
+      if ((vif->remote_features &
+	   VIRTIO_FEATURE (VIRTIO_RING_F_INDIRECT_DESC)) == 0)
+	{
+	  args->rv = VNET_API_ERROR_UNSUPPORTED;
+	  args->error = clib_error_return (
+	    0, "vhost-net backend doesn't support "
+	       "VIRTIO_RING_F_INDIRECT_DESC feature");
+	  goto error;
+	}
+
+      if ((vif->remote_features & VIRTIO_FEATURE (VIRTIO_F_VERSION_1)) == 0)
+	{
+	  args->rv = VNET_API_ERROR_UNSUPPORTED;
+	  args->error = clib_error_return (
+	    0, "vhost-net backend doesn't support "
+	       "VIRTIO_F_VERSION_1 features");
+	  goto error;
+	}
 
-  vif->features |= VIRTIO_FEATURE (VIRTIO_NET_F_MRG_RXBUF);
-  vif->features |= VIRTIO_FEATURE (VIRTIO_F_VERSION_1);
-  vif->features |= VIRTIO_FEATURE (VIRTIO_RING_F_INDIRECT_DESC);
+      vif->features |= VIRTIO_FEATURE (VIRTIO_NET_F_MRG_RXBUF);
+      vif->features |= VIRTIO_FEATURE (VIRTIO_F_VERSION_1);
+      vif->features |= VIRTIO_FEATURE (VIRTIO_RING_F_INDIRECT_DESC);
+      if (vif->remote_features & VIRTIO_FEATURE (VIRTIO_RING_F_EVENT_IDX))
+	vif->features |= VIRTIO_FEATURE (VIRTIO_RING_F_EVENT_IDX);
 
-  virtio_set_net_hdr_size (vif);
+      virtio_set_net_hdr_size (vif);
+    }
 
   if (vif->type == VIRTIO_IF_TYPE_TAP)
     {
@@ -524,6 +558,32 @@ tap_create_if (vlib_main_t * vm, tap_create_if_args_t * args)
 	}
     }
 
+  if (vif->is_io_uring)
+    {
+      /* rx buffers come from the default buffer pool, one per packet. A
+       * frame must not fill its buffer, rx treats that as truncation */
+      u32 max_frame = args->host_mtu_set ? args->host_mtu_size : 1500;
+
+      if (vif->type == VIRTIO_IF_TYPE_TAP)
+	max_frame += sizeof (ethernet_header_t) +
+		     2 * sizeof (ethernet_vlan_header_t);
+      if (max_frame >= vlib_buffer_get_default_data_size (vm))
+	{
+	  args->rv = VNET_API_ERROR_INVALID_VALUE;
+	  args->error = clib_error_return (
+	    0, "host mtu doesn't fit in a buffer, io-uring needs %u bytes",
+	    max_frame + 1);
+	  goto error;
+	}
+
+      if ((args->error = tap_uring_init (vm, vif, args->rx_ring_sz,
+					 args->tx_ring_sz)))
+	{
+	  args->rv = VNET_API_ERROR_INIT_FAILED;
+	  goto error;
+	}
+    }
+
   for (i = 0; i < num_vhost_queues; i++)
     {
       if (i < vif->num_rxqs && (args->error =
@@ -544,21 +604,24 @@ tap_create_if (vlib_main_t * vm, tap_create_if_args_t * args)
     }
 
   /* setup features and memtable */
-  i = sizeof (vhost_memory_t) + sizeof (vhost_memory_region_t);
-  vhost_mem = clib_mem_alloc (i);
-  clib_memset (vhost_mem, 0, i);
-  vhost_mem->nregions = 1;
-  vhost_mem->regions[0].memory_size = vpm->max_size;
-  vhost_mem->regions[0].guest_phys_addr = vpm->base_addr;
-  vhost_mem->regions[0].userspace_addr =
-    vhost_mem->regions[0].guest_phys_addr;
-
-  for (i = 0; i < vhost_mem->nregions; i++)
-    virtio_log_debug (vif, "memtable region %u memory_size 0x%lx "
-		      "guest_phys_addr 0x%lx userspace_addr 0x%lx", i,
-		      vhost_mem->regions[0].memory_size,
-		      vhost_mem->regions[0].guest_phys_addr,
-		      vhost_mem->regions[0].userspace_addr);
+  if (num_vhost_queues)
+    {
+      i = sizeof (vhost_memory_t) + sizeof (vhost_memory_region_t);
+      vhost_mem = clib_mem_alloc (i);
+      clib_memset (vhost_mem, 0, i);
+      vhost_mem->nregions = 1;
+      vhost_mem->regions[0].memory_size = vpm->max_size;
+      vhost_mem->regions[0].guest_phys_addr = vpm->base_addr;
+      vhost_mem->regions[0].userspace_addr =
+	vhost_mem->regions[0].guest_phys_addr;
+
+      for (i = 0; i < vhost_mem->nregions; i++)
+	virtio_log_debug (vif, "memtable region %u memory_size 0x%lx "
+			  "guest_phys_addr 0x%lx userspace_addr 0x%lx", i,
+			  vhost_mem->regions[0].memory_size,
+			  vhost_mem->regions[0].guest_phys_addr,
+			  vhost_mem->regions[0].userspace_addr);
+    }
 
 
   for (i = 0; i < num_vhost_queues; i++)
@@ -699,9 +762,17 @@ tap_create_if (vlib_main_t * vm, tap_create_if_args_t * args)
     }
 
   vnet_hw_if_change_caps (vnm, vif->hw_if_index, &cc);
-  virtio_pre_input_node_enable (vm, vif);
-  virtio_vring_set_rx_queues (vm, vif);
-  virtio_vring_set_tx_queues (vm, vif);
+  if (vif->is_io_uring)
+    {
+      tap_uring_set_rx_queues (vm, vif);
+      tap_uring_set_tx_queues (vm, vif);
+    }
+  else
+    {
+      virtio_pre_input_node_enable (vm, vif);
+      virtio_vring_set_rx_queues (vm, vif);
+      virtio_vring_set_tx_queues (vm, vif);
+    }
 
   vif->per_interface_next_index = ~0;
   vnet_hw_interface_set_flags (vnm, vif->hw_if_index,
@@ -789,6 +860,9 @@ tap_csum_offload_enable_disable (vlib_main_t * vm, u32 sw_if_index,
 
   vif = pool_elt_at_index (mm->interfaces, hw->dev_instance);
 
+  if (vif->is_io_uring)
+    return VNET_API_ERROR_UNSUPPORTED;
+
   const unsigned int csum_offload_on = TUN_F_CSUM;
   const unsigned int csum_offload_off = 0;
   unsigned int offload = enable_disable ? csum_offload_on : csum_offload_off;
@@ -839,6 +913,9 @@ tap_gso_enable_disable (vlib_main_t * vm, u32 sw_if_index, int enable_disable,
 
   vif = pool_elt_at_index (mm->interfaces, hw->dev_instance);
 
+  if (vif->is_io_uring)
+    return VNET_API_ERROR_UNSUPPORTED;
+
   const unsigned int gso_on = TUN_F_CSUM | TUN_F_TSO4 | TUN_F_TSO6;
   const unsigned int gso_off = 0;
   unsigned int offload = enable_disable ? gso_on : gso_off;
@@ -897,10 +974,18 @@ tap_dump_ifs (tap_interface_details_t ** out_tapids)
     hi = vnet_get_hw_interface (vnm, vif->hw_if_index);
     clib_memcpy(tapid->dev_name, hi->name,
                 MIN (ARRAY_LEN (tapid->dev_name) - 1, vec_len (hi->name)));
-    vring = vec_elt_at_index (vif->rxq_vrings, RX_QUEUE_ACCESS(0));
-    tapid->rx_ring_sz = vring->queue_size;
-    vring = vec_elt_at_index (vif->txq_vrings, TX_QUEUE_ACCESS(0));
-    tapid->tx_ring_sz = vring->queue_size;
+    if (vif->is_io_uring)
+      {
+        tapid->rx_ring_sz = vif->rxq_urings[0].queue_size;
+        tapid->tx_ring_sz = vif->txq_urings[0].queue_size;
+      }
+    else
+      {
+        vring = vec_elt_at_index (vif->rxq_vrings, RX_QUEUE_ACCESS(0));
+        tapid->rx_ring_sz = vring->queue_size;
+        vring = vec_elt_at_index (vif->txq_vrings, TX_QUEUE_ACCESS(0));
+        tapid->tx_ring_sz = vring->queue_size;
+      }
     tapid->tap_flags = vif->tap_flags;
     clib_memcpy(&tapid->host_mac_addr, vif->host_mac_addr, 6);
     if (vif->host_if_name)
@@ -30,7 +30,8 @@
   _ (TUN, 4)                 \
   _ (GRO_COALESCE, 5)        \
   _ (PACKED, 6)              \
-  _ (IN_ORDER, 7)
+  _ (IN_ORDER, 7)            \
+  _ (IO_URING, 8)
 
 typedef enum
 {
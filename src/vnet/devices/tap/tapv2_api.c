@@ -222,6 +222,8 @@ vl_api_tap_create_v2_t_handler (vl_api_tap_create_v2_t * mp)
 		 "tap packed api flag mismatch");
   STATIC_ASSERT (((int) TAP_API_FLAG_IN_ORDER ==
 		  (int) TAP_FLAG_IN_ORDER), "tap in-order api flag mismatch");
+  STATIC_ASSERT (((int) TAP_API_FLAG_IO_URING == (int) TAP_FLAG_IO_URING),
+		 "tap io-uring api flag mismatch");
 
   ap->tap_flags = ntohl (mp->tap_flags);
 
@@ -0,0 +1,832 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2024 Cisco Systems, Inc.
+ */
+
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+
+#include <vlib/vlib.h>
+#include <vlib/unix/unix.h>
+#include <vnet/ethernet/ethernet.h>
+#include <vnet/feature/feature.h>
+#include <vnet/interface/rx_queue_funcs.h>
+#include <vnet/interface/tx_queue_funcs.h>
+#include <vnet/devices/virtio/virtio.h>
+#include <vnet/devices/virtio/virtio_inline.h>
+#include <vnet/devices/tap/uring.h>
+
+static char *tap_uring_input_error_strings[] = {
+#define _(n, s) s,
+  foreach_tap_uring_input_error
+#undef _
+};
+
+typedef struct
+{
+  u32 next_index;
+  u32 hw_if_index;
+  u16 queue_id;
+  u16 len;
+} tap_uring_input_trace_t;
+
+static u8 *
+format_tap_uring_input_trace (u8 *s, va_list *args)
+{
+  CLIB_UNUSED (vlib_main_t * vm) = va_arg (*args, vlib_main_t *);
+  CLIB_UNUSED (vlib_node_t * node) = va_arg (*args, vlib_node_t *);
+  tap_uring_input_trace_t *t = va_arg (*args, tap_uring_input_trace_t *);
+
+  s = format (s, "tap-uring: hw_if_index %d next-index %d queue %u len %u",
+	      t->hw_if_index, t->next_index, t->queue_id, t->len);
+  return s;
+}
+
+static_always_inline int
+tap_uring_enter (int fd, u32 to_submit, u32 min_complete, u32 flags)
+{
+  return syscall (__NR_io_uring_enter, fd, to_submit, min_complete, flags,
+		  NULL, 0);
+}
+
+static_always_inline int
+tap_uring_register (int fd, u32 opcode, void *arg, u32 nr_args)
+{
+  return syscall (__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+/* submit everything queued since the last call, entries the kernel didn't
+ * take stay queued for the next one */
+static_always_inline int
+tap_uring_submit (tap_uring_queue_t *q)
+{
+  u32 n = *q->sq_tail - clib_atomic_load_acq_n (q->sq_head);
+
+  if (n == 0)
+    return 0;
+
+  return tap_uring_enter (q->ring_fd, n, 0, 0);
+}
+
+static_always_inline void
+tap_uring_rx_refill (vlib_main_t *vm, vlib_node_runtime_t *node,
+		     tap_uring_queue_t *q)
+{
+  u32 data_size = vlib_buffer_get_default_data_size (vm);
+  u32 n_free = vec_len (q->free_bids);
+  u16 mask = q->queue_size - 1;
+  u16 tail = q->buf_ring_tail;
+  u32 bufs[64];
+
+  while (n_free)
+    {
+      u32 n = clib_min (n_free, ARRAY_LEN (bufs));
+      u32 n_alloc =
+	vlib_buffer_alloc_from_pool (vm, bufs, n, q->buffer_pool_index);
+
+      for (u32 i = 0; i < n_alloc; i++)
+	{
+	  /* fields one by one, the first entry shares memory with the ring
+	   * tail */
+	  struct io_uring_buf *e = q->buf_ring->bufs + (tail++ & mask);
+	  u16 bid = q->free_bids[--n_free];
+
+	  q->buffers[bid] = bufs[i];
+	  e->addr = pointer_to_uword (vlib_get_buffer (vm, bufs[i])->data);
+	  e->len = data_size;
+	  e->bid = bid;
+	}
+
+      if (PREDICT_FALSE (n_alloc != n))
+	{
+	  vlib_error_count (vm, node->node_index,
+			    TAP_URING_INPUT_ERROR_BUFFER_ALLOC, n - n_alloc);
+	  break;
+	}
+    }
+
+  vec_set_len (q->free_bids, n_free);
+
+  if (tail != q->buf_ring_tail)
+    {
+      q->buf_ring_tail = tail;
+      clib_atomic_store_rel_n (&q->buf_ring->tail, tail);
+    }
+}
+
+/* a multishot read keeps completing as long as there are buffers in the
+ * ring, single reads are re-armed as they complete */
+static_always_inline void
+tap_uring_rx_arm (vlib_main_t *vm, vlib_node_runtime_t *node,
+		  tap_uring_queue_t *q)
+{
+  u32 n_want = q->multishot ? 1 : clib_min (TAP_URING_RX_N_READS,
+					    q->queue_size);
+  u32 tail = *q->sq_tail;
+
+  /* a read armed on an empty ring fails right away */
+  if (vec_len (q->free_bids) == q->queue_size)
+    return;
+
+  while (q->n_inflight < n_want)
+    {
+      struct io_uring_sqe *sqe = q->sqes + (tail++ & q->sq_mask);
+
+      clib_memset (sqe, 0, sizeof (*sqe));
+      sqe->opcode =
+	q->multishot ? TAP_URING_OP_READ_MULTISHOT : IORING_OP_READ;
+      sqe->fd = q->tap_fd;
+      sqe->flags = IOSQE_BUFFER_SELECT;
+      sqe->buf_group = 0;
+      q->n_inflight++;
+    }
+
+  clib_atomic_store_rel_n (q->sq_tail, tail);
+
+  if (tap_uring_submit (q) < 0)
+    vlib_error_count (vm, node->node_index, TAP_URING_INPUT_ERROR_SUBMIT, 1);
+}
+
+static_always_inline uword
+tap_uring_device_input (vlib_main_t *vm, vlib_node_runtime_t *node,
+			virtio_if_t *vif, tap_uring_queue_t *q)
+{
+  vnet_main_t *vnm = vnet_get_main ();
+  u32 thread_index = vm->thread_index;
+  uword n_trace = vlib_get_trace_count (vm, node);
+  int is_tun = vif->type == VIRTIO_IF_TYPE_TUN;
+  u32 buffers[VLIB_FRAME_SIZE], to_free[VLIB_FRAME_SIZE];
+  u16 lens[VLIB_FRAME_SIZE], nexts[VLIB_FRAME_SIZE];
+  u32 n_rx = 0, n_free = 0, n_rx_bytes = 0;
+  u32 data_size = vlib_buffer_get_default_data_size (vm);
+  u32 head = *q->cq_head;
+  u32 n_cqe =
+    clib_min (clib_atomic_load_acq_n (q->cq_tail) - head, VLIB_FRAME_SIZE);
+  u32 next_index, i;
+  vlib_buffer_t bt = {};
+
+  for (i = 0; i < n_cqe; i++)
+    {
+      struct io_uring_cqe *cqe = q->cqes + ((head + i) & q->cq_mask);
+      u16 bid;
+      u32 bi;
+
+      if ((cqe->flags & IORING_CQE_F_MORE) == 0)
+	q->n_inflight--;
+
+      if ((cqe->flags & IORING_CQE_F_BUFFER) == 0)
+	{
+	  if (cqe->res == -ENOBUFS)
+	    vlib_error_count (vm, node->node_index,
+			      TAP_URING_INPUT_ERROR_NO_BUFFERS, 1);
+	  else if (cqe->res < 0 && cqe->res != -ECANCELED)
+	    vlib_error_count (vm, node->node_index, TAP_URING_INPUT_ERROR_READ,
+			      1);
+	  continue;
+	}
+
+      bid = cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+      bi = q->buffers[bid];
+      q->buffers[bid] = ~0;
+      vec_add1 (q->free_bids, bid);
+
+      if (PREDICT_FALSE (cqe->res <= 0))
+	{
+	  to_free[n_free++] = bi;
+	  continue;
+	}
+
+      /* the host mtu can be raised after create, and the kernel cuts
+       * frames to the buffer size. The mtu check at create leaves room,
+       * so a full buffer means the frame didn't fit */
+      if (PREDICT_FALSE (cqe->res >= data_size))
+	{
+	  vlib_error_count (vm, node->node_index,
+			    TAP_URING_INPUT_ERROR_TRUNCATED, 1);
+	  to_free[n_free++] = bi;
+	  continue;
+	}
+
+      buffers[n_rx] = bi;
+      lens[n_rx] = cqe->res;
+      n_rx++;
+    }
+
+  clib_atomic_store_rel_n (q->cq_head, head + n_cqe);
+
+  if (n_free)
+    vlib_buffer_free (vm, to_free, n_free);
+
+  if (n_rx)
+    {
+      if (is_tun)
+	next_index = VNET_DEVICE_INPUT_NEXT_IP4_INPUT;
+      else
+	{
+	  next_index = VNET_DEVICE_INPUT_NEXT_ETHERNET_INPUT;
+	  if (PREDICT_FALSE (vif->per_interface_next_index != ~0))
+	    next_index = vif->per_interface_next_index;
+
+	  /* only for l2, redirect if feature path enabled */
+	  vnet_feature_start_device_input (vif->sw_if_index, &next_index,
+					   &bt);
+	}
+
+      bt.flags = VLIB_BUFFER_TOTAL_LENGTH_VALID;
+      bt.ref_count = 1;
+      bt.buffer_pool_index = q->buffer_pool_index;
+      vnet_buffer (&bt)->sw_if_index[VLIB_RX] = vif->sw_if_index;
+      vnet_buffer (&bt)->sw_if_index[VLIB_TX] = (u32) ~0;
+
+      for (i = 0; i < n_rx; i++)
+	{
+	  vlib_buffer_t *b = vlib_get_buffer (vm, buffers[i]);
+
+	  vlib_buffer_copy_template (b, &bt);
+	  b->current_length = lens[i];
+	  n_rx_bytes += lens[i];
+
+	  if (is_tun)
+	    {
+	      switch (b->data[0] & 0xf0)
+		{
+		case 0x40:
+		  nexts[i] = VNET_DEVICE_INPUT_NEXT_IP4_INPUT;
+		  break;
+		case 0x60:
+		  nexts[i] = VNET_DEVICE_INPUT_NEXT_IP6_INPUT;
+		  break;
+		default:
+		  nexts[i] = VNET_DEVICE_INPUT_NEXT_DROP;
+		  break;
+		}
+
+	      if (PREDICT_FALSE (vif->per_interface_next_index != ~0))
+		nexts[i] = vif->per_interface_next_index;
+	    }
+	  else
+	    nexts[i] = next_index;
+	}
+
+      if (PREDICT_FALSE (n_trace > 0))
+	{
+	  for (i = 0; i < n_rx && n_trace > 0; i++)
+	    {
+	      vlib_buffer_t *b = vlib_get_buffer (vm, buffers[i]);
+	      tap_uring_input_trace_t *tr;
+
+	      if (!vlib_trace_buffer (vm, node, nexts[i], b,
+				      /* follow_chain */ 0))
+		continue;
+
+	      tr = vlib_add_trace (vm, node, b, sizeof (*tr));
+	      tr->next_index = nexts[i];
+	      tr->hw_if_index = vif->hw_if_index;
+	      tr->queue_id = q->queue_id;
+	      tr->len = lens[i];
+	      n_trace--;
+	    }
+	  vlib_set_trace_count (vm, node, n_trace);
+	}
+
+      if (is_tun)
+	vlib_buffer_enqueue_to_next (vm, node, buffers, nexts, n_rx);
+      else
+	{
+	  u32 n_left_to_next, *to_next;
+
+	  vlib_get_new_next_frame (vm, node, next_index, to_next,
+				   n_left_to_next);
+	  vlib_buffer_copy_indices (to_next, buffers, n_rx);
+	  virtio_device_input_ethernet (vm, node, next_index,
+					vif->sw_if_index, vif->hw_if_index);
+	  vlib_put_next_frame (vm, node, next_index, n_left_to_next - n_rx);
+	}
+
+      q->total_packets += n_rx;
+      vlib_increment_combined_counter (
+	vnm->interface_main.combined_sw_if_counters +
+	  VNET_INTERFACE_COUNTER_RX,
+	thread_index, vif->sw_if_index, n_rx, n_rx_bytes);
+    }
+
+  tap_uring_rx_refill (vm, node, q);
+  tap_uring_rx_arm (vm, node, q);
+
+  /* come back for completions left behind, or to retry arming */
+  if (q->mode != VNET_HW_IF_RX_MODE_POLLING &&
+      (clib_atomic_load_acq_n (q->cq_tail) != *q->cq_head ||
+       q->n_inflight == 0))
+    vnet_hw_if_rx_queue_set_int_pending (vnm, q->queue_index);
+
+  return n_rx;
+}
+
+static uword
+tap_uring_input_fn (vlib_main_t *vm, vlib_node_runtime_t *node,
+		    vlib_frame_t *frame)
+{
+  u32 n_rx = 0;
+  virtio_main_t *vim = &virtio_main;
+  vnet_hw_if_rxq_poll_vector_t *p,
+    *pv = vnet_hw_if_get_rxq_poll_vector (vm, node);
+
+  vec_foreach (p, pv)
+    {
+      virtio_if_t *vif = vec_elt_at_index (vim->interfaces, p->dev_instance);
+      if (vif->flags & VIRTIO_IF_FLAG_ADMIN_UP)
+	n_rx += tap_uring_device_input (
+	  vm, node, vif, vec_elt_at_index (vif->rxq_urings, p->queue_id));
+    }
+
+  return n_rx;
+}
+
+VLIB_REGISTER_NODE (tap_uring_input_node) = {
+  .function = tap_uring_input_fn,
+  .name = "tap-uring-input",
+  .sibling_of = "device-input",
+  .format_trace = format_tap_uring_input_trace,
+  .flags = VLIB_NODE_FLAG_TRACE_SUPPORTED,
+  .type = VLIB_NODE_TYPE_INPUT,
+  .state = VLIB_NODE_STATE_INTERRUPT,
+  .n_errors = TAP_URING_INPUT_N_ERROR,
+  .error_strings = tap_uring_input_error_strings,
+};
+
+/* hand back buffers of completed writes, returns number of failed ones */
+static_always_inline u32
+tap_uring_tx_reap (vlib_main_t *vm, tap_uring_queue_t *q)
+{
+  u32 head = *q->cq_head;
+  u32 n = clib_atomic_load_acq_n (q->cq_tail) - head;
+  u32 n_errors = 0, n_bufs = 0;
+  u32 bufs[64];
+
+  for (u32 i = 0; i < n; i++)
+    {
+      struct io_uring_cqe *cqe = q->cqes + ((head + i) & q->cq_mask);
+
+      if (cqe->res < 0)
+	n_errors++;
+
+      bufs[n_bufs++] = cqe->user_data;
+      if (n_bufs == ARRAY_LEN (bufs))
+	{
+	  vlib_buffer_free (vm, bufs, n_bufs);
+	  n_bufs = 0;
+	}
+    }
+
+  if (n_bufs)
+    vlib_buffer_free (vm, bufs, n_bufs);
+
+  clib_atomic_store_rel_n (q->cq_head, head + n);
+  q->n_inflight -= n;
+
+  return n_errors;
+}
+
+/* one submission per frame, writes to a tap complete inline so their
+ * buffers are usually back before we return */
+u16
+tap_uring_interface_tx (vlib_main_t *vm, vlib_node_runtime_t *node,
+			virtio_if_t *vif, vnet_hw_if_tx_frame_t *tf,
+			u32 *buffers, u16 n_packets)
+{
+  tap_uring_queue_t *q = vec_elt_at_index (vif->txq_urings, tf->queue_id);
+  vlib_simple_counter_main_t *drop_counter =
+    vnet_main.interface_main.sw_if_counters + VNET_INTERFACE_COUNTER_DROP;
+  u32 drop[VLIB_FRAME_SIZE];
+  u32 n_errors, n_drop = 0, tail, n, i;
+
+  if (tf->shared_queue)
+    clib_spinlock_lock (&q->lockp);
+
+  n_errors = tap_uring_tx_reap (vm, q);
+  n = clib_min (n_packets, q->queue_size - q->n_inflight);
+  tail = *q->sq_tail;
+
+  for (i = 0; i < n; i++)
+    {
+      u32 slot = tail & q->sq_mask;
+      struct io_uring_sqe *sqe = q->sqes + slot;
+      vlib_buffer_t *b = vlib_get_buffer (vm, buffers[i]);
+
+      clib_memset (sqe, 0, sizeof (*sqe));
+      sqe->fd = q->tap_fd;
+      sqe->user_data = buffers[i];
+
+      if (PREDICT_TRUE ((b->flags & VLIB_BUFFER_NEXT_PRESENT) == 0))
+	{
+	  sqe->opcode = IORING_OP_WRITE;
+	  sqe->addr = pointer_to_uword (vlib_buffer_get_current (b));
+	  sqe->len = b->current_length;
+	}
+      else
+	{
+	  /* the kernel copies the iovecs at submission */
+	  struct iovec *iov = q->iovecs + slot * TAP_URING_TX_MAX_SEGS;
+	  u32 n_segs = 0;
+
+	  while (n_segs < TAP_URING_TX_MAX_SEGS)
+	    {
+	      iov[n_segs].iov_base = vlib_buffer_get_current (b);
+	      iov[n_segs].iov_len = b->current_length;
+	      n_segs++;
+	      if ((b->flags & VLIB_BUFFER_NEXT_PRESENT) == 0)
+		{
+		  b = 0;
+		  break;
+		}
+	      b = vlib_get_buffer (vm, b->next_buffer);
+	    }
+
+	  if (PREDICT_FALSE (b != 0))
+	    {
+	      drop[n_drop++] = buffers[i];
+	      continue;
+	    }
+
+	  sqe->opcode = IORING_OP_WRITEV;
+	  sqe->addr = pointer_to_uword (iov);
+	  sqe->len = n_segs;
+	}
+
+      tail++;
+    }
+
+  clib_atomic_store_rel_n (q->sq_tail, tail);
+  q->n_inflight += n - n_drop;
+  q->total_packets += n - n_drop;
+
+  tap_uring_submit (q);
+  n_errors += tap_uring_tx_reap (vm, q);
+
+  if (PREDICT_FALSE (n_errors))
+    {
+      vlib_error_count (vm, node->node_index, VIRTIO_TX_ERROR_WRITE,
+			n_errors);
+      vlib_increment_simple_counter (drop_counter, vm->thread_index,
+				     vif->sw_if_index, n_errors);
+    }
+
+  if (PREDICT_FALSE (n_drop))
+    {
+      vlib_error_count (vm, node->node_index, VIRTIO_TX_ERROR_CHAIN_TOO_LONG,
+			n_drop);
+      vlib_increment_simple_counter (drop_counter, vm->thread_index,
+				     vif->sw_if_index, n_drop);
+      vlib_buffer_free (vm, drop, n_drop);
+    }
+
+  if (tf->shared_queue)
+    clib_spinlock_unlock (&q->lockp);
+
+  return n_packets - n;
+}
+
+static int
+tap_uring_op_supported (int ring_fd, u8 op)
+{
+  struct io_uring_probe *p;
+  u32 n_ops = 256;
+  int rv = 0;
+
+  p = clib_mem_alloc (sizeof (*p) + n_ops * sizeof (p->ops[0]));
+  clib_memset (p, 0, sizeof (*p) + n_ops * sizeof (p->ops[0]));
+
+  if (tap_uring_register (ring_fd, IORING_REGISTER_PROBE, p, n_ops) == 0 &&
+      op <= p->last_op)
+    rv = (p->ops[op].flags & IO_URING_OP_SUPPORTED) != 0;
+
+  clib_mem_free (p);
+  return rv;
+}
+
+static clib_error_t *
+tap_uring_queue_init (tap_uring_queue_t *q, u16 sz, int is_rx)
+{
+  struct io_uring_params p = {
+    .flags = IORING_SETUP_CQSIZE,
+    .cq_entries = 2 * sz,
+  };
+  u32 *sq_array;
+  u8 *ring;
+
+  clib_spinlock_init (&q->lockp);
+  q->ring_fd = q->event_fd = -1;
+  q->file_index = ~0;
+  q->queue_size = sz;
+
+  if ((q->ring_fd = syscall (__NR_io_uring_setup, sz, &p)) < 0)
+    return clib_error_return_unix (0, "io_uring_setup");
+
+  if ((p.features & IORING_FEAT_SINGLE_MMAP) == 0)
+    return clib_error_return (0, "io_uring single mmap not supported");
+
+  q->ring_mem_sz =
+    clib_max (p.sq_off.array + p.sq_entries * sizeof (u32),
+	      p.cq_off.cqes + p.cq_entries * sizeof (struct io_uring_cqe));
+  ring = mmap (0, q->ring_mem_sz, PROT_READ | PROT_WRITE,
+	       MAP_SHARED | MAP_POPULATE, q->ring_fd, IORING_OFF_SQ_RING);
+  if (ring == MAP_FAILED)
+    return clib_error_return_unix (0, "mmap io_uring rings");
+  q->ring_mem = ring;
+
+  q->sqes_sz = p.sq_entries * sizeof (struct io_uring_sqe);
+  q->sqes = mmap (0, q->sqes_sz, PROT_READ | PROT_WRITE,
+		  MAP_SHARED | MAP_POPULATE, q->ring_fd, IORING_OFF_SQES);
+  if (q->sqes == MAP_FAILED)
+    {
+      q->sqes = 0;
+      return clib_error_return_unix (0, "mmap io_uring sqes");
+    }
+
+  q->sq_head = (u32 *) (ring + p.sq_off.head);
+  q->sq_tail = (u32 *) (ring + p.sq_off.tail);
+  q->sq_mask = *(u32 *) (ring + p.sq_off.ring_mask);
+  q->cq_head = (u32 *) (ring + p.cq_off.head);
+  q->cq_tail = (u32 *) (ring + p.cq_off.tail);
+  q->cq_flags = (u32 *) (ring + p.cq_off.flags);
+  q->cq_mask = *(u32 *) (ring + p.cq_off.ring_mask);
+  q->cqes = (struct io_uring_cqe *) (ring + p.cq_off.cqes);
+
+  /* submission entries are always consumed in ring order */
+  sq_array = (u32 *) (ring + p.sq_off.array);
+  for (u32 i = 0; i <= q->sq_mask; i++)
+    sq_array[i] = i;
+
+  if (is_rx)
+    {
+      struct io_uring_buf_reg reg = {};
+
+      if ((q->event_fd = eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0)
+	return clib_error_return_unix (0, "eventfd");
+
+      if (tap_uring_register (q->ring_fd, IORING_REGISTER_EVENTFD,
+			      &q->event_fd, 1) < 0)
+	return clib_error_return_unix (0, "IORING_REGISTER_EVENTFD");
+
+      q->buf_ring_sz = round_pow2 (sz * sizeof (struct io_uring_buf),
+				   clib_mem_get_page_size ());
+      q->buf_ring = mmap (0, q->buf_ring_sz, PROT_READ | PROT_WRITE,
+			  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (q->buf_ring == MAP_FAILED)
+	{
+	  q->buf_ring = 0;
+	  return clib_error_return_unix (0, "mmap buffer ring");
+	}
+
+      reg.ring_addr = pointer_to_uword (q->buf_ring);
+      reg.ring_entries = sz;
+      reg.bgid = 0;
+      if (tap_uring_register (q->ring_fd, IORING_REGISTER_PBUF_RING, &reg,
+			      1) < 0)
+	{
+	  munmap (q->buf_ring, q->buf_ring_sz);
+	  q->buf_ring = 0;
+	  return clib_error_return_unix (0, "IORING_REGISTER_PBUF_RING");
+	}
+
+      q->multishot =
+	tap_uring_op_supported (q->ring_fd, TAP_URING_OP_READ_MULTISHOT);
+
+      vec_validate_aligned (q->buffers, sz - 1, CLIB_CACHE_LINE_BYTES);
+      clib_memset_u32 (q->buffers, ~0, sz);
+      vec_validate (q->free_bids, sz - 1);
+      for (u32 i = 0; i < sz; i++)
+	q->free_bids[i] = sz - 1 - i;
+    }
+  else
+    vec_validate_aligned (q->iovecs, sz * TAP_URING_TX_MAX_SEGS - 1,
+			  CLIB_CACHE_LINE_BYTES);
+
+  return 0;
+}
+
+static void
+tap_uring_queue_free (vlib_main_t *vm, tap_uring_queue_t *q)
+{
+  u32 *bi;
+
+  if (q->file_index != ~0)
+    clib_file_del_by_index (&file_main, q->file_index);
+
+  /* take the buffer ring away from the kernel before freeing buffers */
+  if (q->buf_ring)
+    {
+      struct io_uring_buf_reg reg = { .bgid = 0 };
+      tap_uring_register (q->ring_fd, IORING_UNREGISTER_PBUF_RING, &reg, 1);
+      munmap (q->buf_ring, q->buf_ring_sz);
+    }
+
+  /* wait for writes still holding buffers */
+  while (q->iovecs && q->cqes && q->n_inflight)
+    {
+      if (tap_uring_enter (q->ring_fd, 0, 1, IORING_ENTER_GETEVENTS) < 0)
+	break;
+      tap_uring_tx_reap (vm, q);
+    }
+
+  if (q->sqes)
+    munmap (q->sqes, q->sqes_sz);
+  if (q->ring_mem)
+    munmap (q->ring_mem, q->ring_mem_sz);
+  if (q->ring_fd != -1)
+    close (q->ring_fd);
+  if (q->event_fd != -1)
+    close (q->event_fd);
+
+  vec_foreach (bi, q->buffers)
+    if (bi[0] != ~0)
+      vlib_buffer_free_one (vm, bi[0]);
+
+  vec_free (q->buffers);
+  vec_free (q->free_bids);
+  vec_free (q->iovecs);
+  clib_spinlock_free (&q->lockp);
+}
+
+clib_error_t *
+tap_uring_init (vlib_main_t *vm, virtio_if_t *vif, u16 rx_ring_sz,
+		u16 tx_ring_sz)
+{
+  tap_uring_queue_t *q;
+  clib_error_t *err;
+  u16 i;
+
+  rx_ring_sz = rx_ring_sz ? rx_ring_sz : VIRTIO_NUM_RX_DESC;
+  tx_ring_sz = tx_ring_sz ? tx_ring_sz : VIRTIO_NUM_TX_DESC;
+
+  if (!is_pow2 (rx_ring_sz) || !is_pow2 (tx_ring_sz))
+    return clib_error_return (0, "ring size must be power of 2");
+
+  if (rx_ring_sz > 32768 || tx_ring_sz > 32768)
+    return clib_error_return (0, "ring size must be 32768 or lower");
+
+  for (i = 0; i < vif->num_rxqs; i++)
+    {
+      vec_add2_aligned (vif->rxq_urings, q, 1, CLIB_CACHE_LINE_BYTES);
+      clib_memset (q, 0, sizeof (*q));
+      q->queue_id = i;
+      q->tap_fd = vif->tap_fds[i];
+      if ((err = tap_uring_queue_init (q, rx_ring_sz, 1)))
+	return err;
+      virtio_log_debug (vif,
+			"io_uring rx queue %u size %u ring-fd %d "
+			"event-fd %d multishot %u",
+			i, q->queue_size, q->ring_fd, q->event_fd,
+			q->multishot);
+    }
+
+  for (i = 0; i < vif->num_txqs; i++)
+    {
+      vec_add2_aligned (vif->txq_urings, q, 1, CLIB_CACHE_LINE_BYTES);
+      clib_memset (q, 0, sizeof (*q));
+      q->queue_id = i;
+      q->tap_fd = vif->tap_fds[i % vif->num_rxqs];
+      if ((err = tap_uring_queue_init (q, tx_ring_sz, 0)))
+	return err;
+      virtio_log_debug (vif, "io_uring tx queue %u size %u ring-fd %d", i,
+			q->queue_size, q->ring_fd);
+    }
+
+  return 0;
+}
+
+void
+tap_uring_free (vlib_main_t *vm, virtio_if_t *vif)
+{
+  tap_uring_queue_t *q;
+
+  vec_foreach (q, vif->rxq_urings)
+    tap_uring_queue_free (vm, q);
+  vec_foreach (q, vif->txq_urings)
+    tap_uring_queue_free (vm, q);
+
+  vec_free (vif->rxq_urings);
+  vec_free (vif->txq_urings);
+}
+
+static clib_error_t *
+tap_uring_event_read_ready (clib_file_t *uf)
+{
+  vnet_main_t *vnm = vnet_get_main ();
+  u64 b;
+
+  CLIB_UNUSED (ssize_t size) = read (uf->file_descriptor, &b, sizeof (b));
+  vnet_hw_if_rx_queue_set_int_pending (vnm, uf->private_data);
+
+  return 0;
+}
+
+void
+tap_uring_set_rx_queues (vlib_main_t *vm, virtio_if_t *vif)
+{
+  vnet_main_t *vnm = vnet_get_main ();
+  tap_uring_queue_t *q;
+
+  vnet_hw_if_set_input_node (vnm, vif->hw_if_index,
+			     tap_uring_input_node.index);
+
+  vec_foreach (q, vif->rxq_urings)
+    {
+      clib_file_t f = {
+	.read_function = tap_uring_event_read_ready,
+	.flags = UNIX_FILE_EVENT_EDGE_TRIGGERED,
+	.file_descriptor = q->event_fd,
+	.description = format (0, "%U io_uring rx queue %u",
+			       format_virtio_device_name, vif->dev_instance,
+			       q->queue_id),
+      };
+
+      q->queue_index = vnet_hw_if_register_rx_queue (
+	vnm, vif->hw_if_index, q->queue_id, VNET_HW_IF_RXQ_THREAD_ANY);
+      q->buffer_pool_index = vlib_buffer_pool_get_default_for_numa (
+	vm, vnet_hw_if_get_rx_queue_numa_node (vnm, q->queue_index));
+
+      f.private_data = q->queue_index;
+      q->file_index = clib_file_add (&file_main, &f);
+      vnet_hw_if_set_rx_queue_file_index (vnm, q->queue_index,
+					  q->file_index);
+
+      /* buffers are posted and reads armed by the thread polling the
+       * queue, the first time it runs */
+      *q->cq_flags |= IORING_CQ_EVENTFD_DISABLED;
+      vnet_hw_if_set_rx_queue_mode (vnm, q->queue_index,
+				    VNET_HW_IF_RX_MODE_POLLING);
+      q->mode = VNET_HW_IF_RX_MODE_POLLING;
+    }
+
+  vnet_hw_if_update_runtime_data (vnm, vif->hw_if_index);
+}
+
+void
+tap_uring_set_tx_queues (vlib_main_t *vm, virtio_if_t *vif)
+{
+  vnet_main_t *vnm = vnet_get_main ();
+  tap_uring_queue_t *q;
+
+  vec_foreach (q, vif->txq_urings)
+    q->queue_index =
+      vnet_hw_if_register_tx_queue (vnm, vif->hw_if_index, q->queue_id);
+
+  for (u32 j = 0; j < vlib_get_n_threads (); j++)
+    {
+      u32 qi = vif->txq_urings[j % vif->num_txqs].queue_index;
+      vnet_hw_if_tx_queue_assign_thread (vnm, qi, j);
+    }
+
+  vnet_hw_if_update_runtime_data (vnm, vif->hw_if_index);
+}
+
+void
+tap_uring_rx_mode_change (virtio_if_t *vif, u16 qid, vnet_hw_if_rx_mode mode)
+{
+  tap_uring_queue_t *q = vec_elt_at_index (vif->rxq_urings, qid);
+
+  if (mode == VNET_HW_IF_RX_MODE_POLLING)
+    *q->cq_flags |= IORING_CQ_EVENTFD_DISABLED;
+  else
+    {
+      u64 b = 1;
+      *q->cq_flags &= ~IORING_CQ_EVENTFD_DISABLED;
+      /* completions posted while polling raised no event, and reads may not
+       * be armed yet, kick the queue once the new mode is in place */
+      CLIB_UNUSED (ssize_t size) = write (q->event_fd, &b, sizeof (b));
+    }
+
+  q->mode = mode;
+}
+
+u8 *
+format_tap_uring_queues (u8 *s, va_list *args)
+{
+  virtio_if_t *vif = va_arg (*args, virtio_if_t *);
+  u32 indent = format_get_indent (s);
+  tap_uring_queue_t *q;
+
+  vec_foreach (q, vif->rxq_urings)
+    {
+      if (q != vif->rxq_urings)
+	s = format (s, "\n%U", format_white_space, indent);
+      s = format (s,
+		  "rx queue %u: size %u ring-fd %d tap-fd %d %s, "
+		  "buffers posted %u reads armed %u packets %llu",
+		  q->queue_id, q->queue_size, q->ring_fd, q->tap_fd,
+		  q->multishot ? "multishot" : "single-shot",
+		  q->queue_size - vec_len (q->free_bids), q->n_inflight,
+		  q->total_packets);
+    }
+
+  vec_foreach (q, vif->txq_urings)
+    s = format (s,
+		"\n%Utx queue %u: size %u ring-fd %d tap-fd %d, "
+		"writes in flight %u packets %llu",
+		format_white_space, indent, q->queue_id, q->queue_size,
+		q->ring_fd, q->tap_fd, q->n_inflight, q->total_packets);
+
+  return s;
+}
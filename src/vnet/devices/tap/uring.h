@@ -0,0 +1,135 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2024 Cisco Systems, Inc.
+ */
+
+#ifndef _VNET_DEVICES_TAP_URING_H_
+#define _VNET_DEVICES_TAP_URING_H_
+
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+#include <vnet/devices/virtio/virtio.h>
+
+/* linux 6.7, newer than some distribution uapi headers */
+#define TAP_URING_OP_READ_MULTISHOT 49
+
+#ifndef HAVE_IO_URING_PBUF_RING
+/* linux 5.19 provided buffer rings, missing from older uapi headers */
+#define IORING_REGISTER_PBUF_RING   22
+#define IORING_UNREGISTER_PBUF_RING 23
+
+struct io_uring_buf
+{
+  __u64 addr;
+  __u32 len;
+  __u16 bid;
+  __u16 resv;
+};
+
+struct io_uring_buf_ring
+{
+  union
+  {
+    struct
+    {
+      __u64 resv1;
+      __u32 resv2;
+      __u16 resv3;
+      __u16 tail;
+    };
+    struct io_uring_buf bufs[0];
+  };
+};
+
+struct io_uring_buf_reg
+{
+  __u64 ring_addr;
+  __u32 ring_entries;
+  __u16 bgid;
+  __u16 pad;
+  __u64 resv[3];
+};
+#endif
+
+/* without multishot support, number of single reads kept armed */
+#define TAP_URING_RX_N_READS 32
+
+/* iovecs available to a chained tx buffer */
+#define TAP_URING_TX_MAX_SEGS 32
+
+#define foreach_tap_uring_input_error                                         \
+  _ (BUFFER_ALLOC, "buffer alloc error")                                      \
+  _ (NO_BUFFERS, "rx buffer ring empty")                                      \
+  _ (READ, "read error")                                                      \
+  _ (TRUNCATED, "frame truncated, host mtu too large")                        \
+  _ (SUBMIT, "io_uring submit error")
+
+typedef enum
+{
+#define _(f, s) TAP_URING_INPUT_ERROR_##f,
+  foreach_tap_uring_input_error
+#undef _
+    TAP_URING_INPUT_N_ERROR,
+} tap_uring_input_error_t;
+
+/* one io_uring instance per queue, each queue is only ever used by the
+ * thread it is placed on (or under lock for shared tx queues) */
+struct _tap_uring_queue
+{
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
+  clib_spinlock_t lockp;
+
+  /* rings shared with the kernel */
+  u32 *sq_head;
+  u32 *sq_tail;
+  u32 *cq_head;
+  u32 *cq_tail;
+  u32 *cq_flags;
+  struct io_uring_sqe *sqes;
+  struct io_uring_cqe *cqes;
+  struct io_uring_buf_ring *buf_ring;
+  u32 sq_mask;
+  u32 cq_mask;
+
+  int ring_fd;
+  int tap_fd;
+  int event_fd;
+  u32 file_index;
+
+  /* rx: vlib buffer posted under each buffer id, ~0 if not posted */
+  u32 *buffers;
+  u16 *free_bids;
+  /* tx: iovecs of a chained buffer, per submission queue entry */
+  struct iovec *iovecs;
+
+  u16 queue_size;
+  u16 queue_id;
+  u32 queue_index;
+  u16 n_inflight;
+  u16 buf_ring_tail;
+  u8 buffer_pool_index;
+  u8 multishot;
+  vnet_hw_if_rx_mode mode;
+  u64 total_packets;
+
+  void *ring_mem;
+  uword ring_mem_sz;
+  uword sqes_sz;
+  uword buf_ring_sz;
+};
+
+extern vlib_node_registration_t tap_uring_input_node;
+
+clib_error_t *tap_uring_init (vlib_main_t *vm, virtio_if_t *vif,
+			      u16 rx_ring_sz, u16 tx_ring_sz);
+void tap_uring_free (vlib_main_t *vm, virtio_if_t *vif);
+void tap_uring_set_rx_queues (vlib_main_t *vm, virtio_if_t *vif);
+void tap_uring_set_tx_queues (vlib_main_t *vm, virtio_if_t *vif);
+void tap_uring_rx_mode_change (virtio_if_t *vif, u16 qid,
+			       vnet_hw_if_rx_mode mode);
+u16 tap_uring_interface_tx (vlib_main_t *vm, vlib_node_runtime_t *node,
+			    virtio_if_t *vif, vnet_hw_if_tx_frame_t *tf,
+			    u32 *buffers, u16 n_packets);
+
+format_function_t format_tap_uring_queues;
+
+#endif /* _VNET_DEVICES_TAP_URING_H_ */
@@ -25,32 +25,17 @@
 #include <vnet/ethernet/ethernet.h>
 #include <vnet/gso/gro_func.h>
 #include <vnet/gso/hdr_offset_parser.h>
+#include <vnet/interface/rx_queue_funcs.h>
 #include <vnet/ip/ip4_packet.h>
 #include <vnet/ip/ip6_packet.h>
 #include <vnet/ip/ip_psh_cksum.h>
 #include <vnet/tcp/tcp_packet.h>
 #include <vnet/udp/udp_packet.h>
 #include <vnet/devices/virtio/virtio.h>
+#include <vnet/devices/tap/uring.h>
 
 #define VIRTIO_TX_MAX_CHAIN_LEN 127
 
-#define foreach_virtio_tx_func_error	       \
-_(NO_FREE_SLOTS, "no free tx slots")           \
-_(TRUNC_PACKET, "packet > buffer size -- truncated in tx ring") \
-_(PENDING_MSGS, "pending msgs in tx ring") \
-_(INDIRECT_DESC_ALLOC_FAILED, "indirect descriptor allocation failed - packet drop") \
-_(OUT_OF_ORDER, "out-of-order buffers in used ring") \
-_(GSO_PACKET_DROP, "gso disabled on itf  -- gso packet drop") \
-_(CSUM_OFFLOAD_PACKET_DROP, "checksum offload disabled on itf -- csum offload packet drop")
-
-typedef enum
-{
-#define _(f,s) VIRTIO_TX_ERROR_##f,
-  foreach_virtio_tx_func_error
-#undef _
-    VIRTIO_TX_N_ERROR,
-} virtio_tx_func_error_t;
-
 static char *virtio_tx_func_error_strings[] = {
 #define _(n,s) s,
   foreach_virtio_tx_func_error
@@ -72,6 +57,9 @@ format_virtio_device (u8 * s, va_list * args)
     {
       s = format (s, "\n%U instance %u", format_white_space, indent + 2,
 		  dev_instance);
+      if (vif->is_io_uring)
+	return format (s, "\n%U %U", format_white_space, indent + 4,
+		       format_tap_uring_queues, vif);
       s = format (s, "\n%U RX QUEUE : Total Packets", format_white_space,
 		  indent + 4);
       vec_foreach (vring, vif->rxq_vrings)
@@ -892,7 +880,7 @@ virtio_interface_tx_split_gso_inline (vlib_main_t *vm,
 				      vnet_virtio_vring_t *vring, u32 *buffers,
 				      u16 n_left, int do_gso, int csum_offload)
 {
-  u16 used, next, avail, n_buffers = 0, n_buffers_left = 0;
+  u16 used, next, avail, old_avail, n_buffers = 0, n_buffers_left = 0;
   int is_pci = (type == VIRTIO_IF_TYPE_PCI);
   int is_tun = (type == VIRTIO_IF_TYPE_TUN);
   int is_indirect =
@@ -906,7 +894,7 @@ virtio_interface_tx_split_gso_inline (vlib_main_t *vm,
 
   used = vring->desc_in_use;
   next = vring->desc_next;
-  avail = vring->avail->idx;
+  avail = old_avail = vring->avail->idx;
 
   u16 free_desc_count = 0;
 
@@ -987,9 +975,7 @@ virtio_interface_tx_split_gso_inline (vlib_main_t *vm,
       clib_atomic_store_seq_cst (&vring->avail->idx, avail);
       vring->desc_next = next;
       vring->desc_in_use = used;
-      if ((clib_atomic_load_seq_cst (&vring->used->flags) &
-	   VRING_USED_F_NO_NOTIFY) == 0)
-	virtio_kick (vm, vring, vif);
+      virtio_kick_split (vm, vring, vif, old_avail, avail);
     }
 
   return n_left;
@@ -1047,13 +1033,34 @@ VNET_DEVICE_CLASS_TX_FN (virtio_device_class) (vlib_main_t * vm,
   virtio_if_t *vif = pool_elt_at_index (nm->interfaces, rund->dev_instance);
   vnet_hw_if_tx_frame_t *tf = vlib_frame_scalar_args (frame);
   u16 qid = tf->queue_id;
-  vnet_virtio_vring_t *vring = vec_elt_at_index (vif->txq_vrings, qid);
+  vnet_virtio_vring_t *vring;
   u16 n_left = frame->n_vectors;
   u32 *buffers = vlib_frame_vector_args (frame);
   u32 to[GRO_TO_VECTOR_SIZE (n_left)];
   int packed = vif->is_packed;
   u16 n_vectors = frame->n_vectors;
 
+  if (vif->is_io_uring)
+    {
+      for (u16 i = 0; i < n_vectors; i++)
+	{
+	  vlib_buffer_t *b = vlib_get_buffer (vm, buffers[i]);
+	  if (b->flags & VLIB_BUFFER_IS_TRACED)
+	    virtio_tx_trace (vm, node, b, buffers[i],
+			     vif->type == VIRTIO_IF_TYPE_TUN);
+	}
+
+      n_left =
+	tap_uring_interface_tx (vm, node, vif, tf, buffers, n_vectors);
+      if (n_left)
+	virtio_interface_drop_inline (vm, vif, node->node_index,
+				      &buffers[n_vectors - n_left], n_left,
+				      VIRTIO_TX_ERROR_NO_FREE_SLOTS);
+      return n_vectors - n_left;
+    }
+
+  vring = vec_elt_at_index (vif->txq_vrings, qid);
+
   if (tf->shared_queue)
     clib_spinlock_lock (&vring->lockp);
 
@@ -1127,9 +1134,10 @@ virtio_set_interface_next_node (vnet_main_t * vnm, u32 hw_if_index,
       return;
     }
 
-  vif->per_interface_next_index =
-    vlib_node_add_next (vlib_get_main (), virtio_input_node.index,
-			node_index);
+  vif->per_interface_next_index = vlib_node_add_next (
+    vlib_get_main (),
+    vif->is_io_uring ? tap_uring_input_node.index : virtio_input_node.index,
+    node_index);
 }
 
 static void
@@ -1143,6 +1151,14 @@ virtio_set_rx_interrupt (virtio_if_t *vif, vnet_virtio_vring_t *vring)
 {
   if (vif->is_packed)
     vring->driver_event->flags &= ~VRING_EVENT_F_DISABLE;
+  else if (vif->features & VIRTIO_FEATURE (VIRTIO_RING_F_EVENT_IDX))
+    {
+      u16 last = vring->last_used_idx;
+      clib_atomic_store_seq_cst (virtio_vring_used_event (vring), last);
+      if (clib_atomic_load_seq_cst (&vring->used->idx) != last)
+	vnet_hw_if_rx_queue_set_int_pending (vnet_get_main (),
+					     vring->queue_index);
+    }
   else
     vring->avail->flags &= ~VRING_AVAIL_F_NO_INTERRUPT;
 }
@@ -1152,6 +1168,9 @@ virtio_set_rx_polling (virtio_if_t *vif, vnet_virtio_vring_t *vring)
 {
   if (vif->is_packed)
     vring->driver_event->flags |= VRING_EVENT_F_DISABLE;
+  else if (vif->features & VIRTIO_FEATURE (VIRTIO_RING_F_EVENT_IDX))
+    /* the device ignores the flags, park the event index behind us */
+    *virtio_vring_used_event (vring) = vring->last_used_idx - 1;
   else
     vring->avail->flags |= VRING_AVAIL_F_NO_INTERRUPT;
 }
@@ -1163,7 +1182,15 @@ virtio_interface_rx_mode_change (vnet_main_t * vnm, u32 hw_if_index, u32 qid,
   virtio_main_t *mm = &virtio_main;
   vnet_hw_interface_t *hw = vnet_get_hw_interface (vnm, hw_if_index);
   virtio_if_t *vif = pool_elt_at_index (mm->interfaces, hw->dev_instance);
-  vnet_virtio_vring_t *rx_vring = vec_elt_at_index (vif->rxq_vrings, qid);
+  vnet_virtio_vring_t *rx_vring;
+
+  if (vif->is_io_uring)
+    {
+      tap_uring_rx_mode_change (vif, qid, mode);
+      return 0;
+    }
+
+  rx_vring = vec_elt_at_index (vif->rxq_vrings, qid);
 
   if (vif->type == VIRTIO_IF_TYPE_PCI && !(vif->support_int_mode))
     {
@@ -214,29 +214,6 @@ virtio_get_len (vnet_virtio_vring_t *vring, const int packed, const int hdr_sz,
     }                                                                         \
   while (0)
 
-static_always_inline void
-virtio_device_input_ethernet (vlib_main_t *vm, vlib_node_runtime_t *node,
-			      const u32 next_index, const u32 sw_if_index,
-			      const u32 hw_if_index)
-{
-  vlib_next_frame_t *nf;
-  vlib_frame_t *f;
-  ethernet_input_frame_t *ef;
-
-  if (PREDICT_FALSE (VNET_DEVICE_INPUT_NEXT_ETHERNET_INPUT != next_index))
-    return;
-
-  nf = vlib_node_runtime_get_next_frame (
-    vm, node, VNET_DEVICE_INPUT_NEXT_ETHERNET_INPUT);
-  f = vlib_get_frame (vm, nf->frame);
-  f->flags = ETH_INPUT_FRAME_F_SINGLE_SW_IF_IDX;
-
-  ef = vlib_frame_scalar_args (f);
-  ef->sw_if_index = sw_if_index;
-  ef->hw_if_index = hw_if_index;
-  vlib_frame_no_append (f);
-}
-
 static_always_inline uword
 virtio_device_input_gso_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 				vlib_frame_t *frame, virtio_if_t *vif,
@@ -415,6 +392,21 @@ virtio_device_input_gso_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
     }
   vring->last_used_idx = last;
 
+  /* ask for an interrupt on the next used entry only, or keep the event
+   * index just behind us while polling */
+  if (!packed && (vif->features & VIRTIO_FEATURE (VIRTIO_RING_F_EVENT_IDX)))
+    {
+      if (vring->mode == VNET_HW_IF_RX_MODE_POLLING)
+	*virtio_vring_used_event (vring) = last - 1;
+      else
+	{
+	  clib_atomic_store_seq_cst (virtio_vring_used_event (vring), last);
+	  /* entries used past the old event index raised no interrupt */
+	  if (clib_atomic_load_seq_cst (&vring->used->idx) != last)
+	    vnet_hw_if_rx_queue_set_int_pending (vnm, vring->queue_index);
+	}
+    }
+
   vring->total_packets += n_rx_packets;
   vlib_increment_combined_counter (vnm->interface_main.combined_sw_if_counters
 				   + VNET_INTERFACE_COUNTER_RX, thread_index,
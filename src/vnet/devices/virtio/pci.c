@@ -117,6 +117,7 @@ virtio_pci_irq_queue_handler (vlib_main_t * vm, vlib_pci_dev_handle_t h,
   u16 qid = line;
 
   vnet_virtio_vring_t *vring = vec_elt_at_index (vif->rxq_vrings, qid);
+  vring->n_interrupts++;
   vnet_hw_if_rx_queue_set_int_pending (vnm, vring->queue_index);
 }
 
@@ -643,6 +644,8 @@ virtio_pci_control_vring_packed_init (vlib_main_t * vm, virtio_if_t * vif,
   vring->device_event->flags = 0;
 
   vring->total_packets = 0;
+  vring->n_kicks = 0;
+  vring->n_interrupts = 0;
   vring->queue_id = queue_num;
   vring->queue_size = queue_size;
   vring->avail_wrap_counter = 1;
@@ -696,6 +699,8 @@ virtio_pci_control_vring_split_init (vlib_main_t * vm, virtio_if_t * vif,
   vnet_virtio_vring_init (vring, queue_size, ptr, VNET_VIRTIO_PCI_VRING_ALIGN);
   vring->queue_id = queue_num;
   vring->total_packets = 0;
+  vring->n_kicks = 0;
+  vring->n_interrupts = 0;
 
   ASSERT (vring->buffers == 0);
   virtio_log_debug (vif, "control-queue: number %u, size %u", queue_num,
@@ -778,6 +783,8 @@ virtio_pci_vring_split_init (vlib_main_t *vm, virtio_if_t *vif, u16 queue_num,
   vring->avail->flags = VIRTIO_RING_FLAG_MASK_INT;
   vring->flow_table = 0;
   vring->total_packets = 0;
+  vring->n_kicks = 0;
+  vring->n_interrupts = 0;
 
   ASSERT (vring->buffers == 0);
   vec_validate_aligned (vring->buffers, queue_size, CLIB_CACHE_LINE_BYTES);
@@ -868,6 +875,8 @@ virtio_pci_vring_packed_init (vlib_main_t * vm, virtio_if_t * vif,
   vring->avail_wrap_counter = 1;
   vring->used_wrap_counter = 1;
   vring->total_packets = 0;
+  vring->n_kicks = 0;
+  vring->n_interrupts = 0;
 
   ASSERT (vring->buffers == 0);
   vec_validate_aligned (vring->buffers, queue_size, CLIB_CACHE_LINE_BYTES);
@@ -942,6 +951,8 @@ virtio_negotiate_features (vlib_main_t * vm, virtio_if_t * vif,
 	(VIRTIO_FEATURE (VIRTIO_F_RING_PACKED) |
 	 VIRTIO_FEATURE (VIRTIO_F_IN_ORDER));
     }
+  else
+    supported_features |= VIRTIO_FEATURE (VIRTIO_RING_F_EVENT_IDX);
 
   if (req_features == 0)
     {
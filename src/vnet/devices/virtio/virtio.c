@@ -32,6 +32,7 @@
 #include <vnet/devices/virtio/virtio.h>
 #include <vnet/devices/virtio/virtio_inline.h>
 #include <vnet/devices/virtio/pci.h>
+#include <vnet/devices/tap/uring.h>
 #include <vnet/interface/rx_queue_funcs.h>
 #include <vnet/interface/tx_queue_funcs.h>
 
@@ -48,9 +49,20 @@ static clib_error_t *
 call_read_ready (clib_file_t * uf)
 {
   vnet_main_t *vnm = vnet_get_main ();
+  vnet_hw_if_rx_queue_t *rxq;
+  vnet_hw_interface_t *hw;
+  vnet_virtio_vring_t *vring;
+  virtio_if_t *vif;
   u64 b;
 
-  CLIB_UNUSED (ssize_t size) = read (uf->file_descriptor, &b, sizeof (b));
+  rxq = vnet_hw_if_get_rx_queue (vnm, uf->private_data);
+  hw = vnet_get_hw_interface (vnm, rxq->hw_if_index);
+  vif = pool_elt_at_index (virtio_main.interfaces, hw->dev_instance);
+  vring = vec_elt_at_index (vif->rxq_vrings, rxq->queue_id);
+
+  /* the eventfd counts the interrupts raised since the last read */
+  if (read (uf->file_descriptor, &b, sizeof (b)) == sizeof (b))
+    vring->n_interrupts += b;
   vnet_hw_if_rx_queue_set_int_pending (vnm, uf->private_data);
 
   return 0;
@@ -90,15 +102,18 @@ virtio_vring_init (vlib_main_t * vm, virtio_if_t * vif, u16 idx, u16 sz)
   vring->desc = clib_mem_alloc_aligned (i, CLIB_CACHE_LINE_BYTES);
   clib_memset (vring->desc, 0, i);
 
-  i = sizeof (vnet_virtio_vring_avail_t) + sz * sizeof (vring->avail->ring[0]);
+  /* trailing u16 is used_event, see VIRTIO_RING_F_EVENT_IDX */
+  i = sizeof (vnet_virtio_vring_avail_t) +
+      sz * sizeof (vring->avail->ring[0]) + sizeof (u16);
   i = round_pow2 (i, CLIB_CACHE_LINE_BYTES);
   vring->avail = clib_mem_alloc_aligned (i, CLIB_CACHE_LINE_BYTES);
   clib_memset (vring->avail, 0, i);
   // tell kernel that we don't need interrupt
   vring->avail->flags = VRING_AVAIL_F_NO_INTERRUPT;
 
+  /* trailing u16 is avail_event */
   i = sizeof (vnet_virtio_vring_used_t) +
-      sz * sizeof (vnet_virtio_vring_used_elem_t);
+      sz * sizeof (vnet_virtio_vring_used_elem_t) + sizeof (u16);
   i = round_pow2 (i, CLIB_CACHE_LINE_BYTES);
   vring->used = clib_mem_alloc_aligned (i, CLIB_CACHE_LINE_BYTES);
   clib_memset (vring->used, 0, i);
@@ -117,6 +132,8 @@ virtio_vring_init (vlib_main_t * vm, virtio_if_t * vif, u16 idx, u16 sz)
     vring->call_fd = eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC);
 
   vring->total_packets = 0;
+  vring->n_kicks = 0;
+  vring->n_interrupts = 0;
   vring->queue_size = sz;
   vring->kick_fd = eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC);
   virtio_log_debug (vif, "vring %u size %u call_fd %d kick_fd %d", idx,
@@ -395,6 +412,9 @@ virtio_show (vlib_main_t *vm, u32 *hw_if_indices, u8 show_descr,
 	    str = format (str, " %d", vif->tap_fds[i]);
 	  vlib_cli_output (vm, "  tap-fds%v", str);
 	  vec_free (str);
+	  if (vif->is_io_uring)
+	    vlib_cli_output (vm, "  io-uring\n    %U", format_tap_uring_queues,
+			     vif);
 	}
       vlib_cli_output (vm, "  gso-enabled %d", vif->gso_enabled);
       vlib_cli_output (vm, "  csum-enabled %d", vif->csum_offload_enabled);
@@ -466,6 +486,8 @@ virtio_show (vlib_main_t *vm, u32 *hw_if_indices, u8 show_descr,
 			   "    avail.flags 0x%x avail.idx %d used.flags 0x%x used.idx %d",
 			   vring->avail->flags, vring->avail->idx,
 			   vring->used->flags, vring->used->idx);
+	vlib_cli_output (vm, "    kicks %llu, interrupts %llu", vring->n_kicks,
+			 vring->n_interrupts);
 	if (type & (VIRTIO_IF_TYPE_TAP | VIRTIO_IF_TYPE_TUN))
 	  {
 	    vlib_cli_output (vm, "    kickfd %d, callfd %d", vring->kick_fd,
@@ -528,6 +550,8 @@ virtio_show (vlib_main_t *vm, u32 *hw_if_indices, u8 show_descr,
 			   "    avail.flags 0x%x avail.idx %d used.flags 0x%x used.idx %d",
 			   vring->avail->flags, vring->avail->idx,
 			   vring->used->flags, vring->used->idx);
+	vlib_cli_output (vm, "    kicks %llu, interrupts %llu", vring->n_kicks,
+			 vring->n_interrupts);
 	if (type & (VIRTIO_IF_TYPE_TAP | VIRTIO_IF_TYPE_TUN))
 	  {
 	    vlib_cli_output (vm, "    kickfd %d, callfd %d", vring->kick_fd,
@@ -56,6 +56,25 @@ typedef enum
     VIRTIO_IF_N_TYPES = (1 << 3),
 } virtio_if_type_t;
 
+#define foreach_virtio_tx_func_error	       \
+_(NO_FREE_SLOTS, "no free tx slots")           \
+_(TRUNC_PACKET, "packet > buffer size -- truncated in tx ring") \
+_(PENDING_MSGS, "pending msgs in tx ring") \
+_(INDIRECT_DESC_ALLOC_FAILED, "indirect descriptor allocation failed - packet drop") \
+_(OUT_OF_ORDER, "out-of-order buffers in used ring") \
+_(GSO_PACKET_DROP, "gso disabled on itf  -- gso packet drop") \
+_(CSUM_OFFLOAD_PACKET_DROP, "checksum offload disabled on itf -- csum offload packet drop") \
+_(CHAIN_TOO_LONG, "buffer chain too long -- packet drop") \
+_(WRITE, "write error")
+
+typedef enum
+{
+#define _(f,s) VIRTIO_TX_ERROR_##f,
+  foreach_virtio_tx_func_error
+#undef _
+    VIRTIO_TX_N_ERROR,
+} virtio_tx_func_error_t;
+
 #define VIRTIO_RING_FLAG_MASK_INT 1
 
 #define VIRTIO_EVENT_START_TIMER 1
@@ -111,6 +130,8 @@ typedef struct
   virtio_vring_buffering_t *buffering;
   gro_flow_table_t *flow_table;
   u64 total_packets;
+  u64 n_kicks;
+  u64 n_interrupts;
 } vnet_virtio_vring_t;
 
 typedef union
@@ -127,6 +148,7 @@ typedef union
 
 /* forward declaration */
 typedef struct _virtio_pci_func virtio_pci_func_t;
+typedef struct _tap_uring_queue tap_uring_queue_t;
 
 typedef struct
 {
@@ -179,6 +201,8 @@ typedef struct
     {
       ip6_address_t host_ip6_addr;
       int *vhost_fds;
+      tap_uring_queue_t *rxq_urings;
+      tap_uring_queue_t *txq_urings;
       u8 *host_if_name;
       u8 *net_ns;
       u8 *host_bridge;
@@ -212,6 +236,7 @@ typedef struct
   };
   const virtio_pci_func_t *virtio_pci_func;
   int is_packed;
+  int is_io_uring;
 } virtio_if_t;
 
 typedef struct
@@ -257,6 +282,7 @@ format_function_t format_virtio_log_name;
 static_always_inline void
 virtio_kick (vlib_main_t *vm, vnet_virtio_vring_t *vring, virtio_if_t *vif)
 {
+  vring->n_kicks++;
   if (vif->type == VIRTIO_IF_TYPE_PCI)
     {
       if (vif->is_modern)
@@ -276,6 +302,42 @@ virtio_kick (vlib_main_t *vm, vnet_virtio_vring_t *vring, virtio_if_t *vif)
     }
 }
 
+/* with VIRTIO_RING_F_EVENT_IDX the used_event and avail_event words sit
+ * right after the avail and used rings */
+static_always_inline u16 *
+virtio_vring_used_event (vnet_virtio_vring_t *vring)
+{
+  return &vring->avail->ring[vring->queue_size];
+}
+
+static_always_inline u16 *
+virtio_vring_avail_event (vnet_virtio_vring_t *vring)
+{
+  return (u16 *) &vring->used->ring[vring->queue_size];
+}
+
+static_always_inline int
+virtio_vring_need_event (u16 event_idx, u16 new_idx, u16 old_idx)
+{
+  return (u16) (new_idx - event_idx - 1) < (u16) (new_idx - old_idx);
+}
+
+/* split ring: entries [old_idx, new_idx) were just made available */
+static_always_inline void
+virtio_kick_split (vlib_main_t *vm, vnet_virtio_vring_t *vring,
+		   virtio_if_t *vif, u16 old_idx, u16 new_idx)
+{
+  if (vif->features & VIRTIO_FEATURE (VIRTIO_RING_F_EVENT_IDX))
+    {
+      u16 event = clib_atomic_load_seq_cst (virtio_vring_avail_event (vring));
+      if (virtio_vring_need_event (event, new_idx, old_idx))
+	virtio_kick (vm, vring, vif);
+    }
+  else if ((clib_atomic_load_seq_cst (&vring->used->flags) &
+	    VRING_USED_F_NO_NOTIFY) == 0)
+    virtio_kick (vm, vring, vif);
+}
+
 static_always_inline u8
 virtio_txq_is_scheduled (vnet_virtio_vring_t *vring)
 {
@@ -27,12 +27,35 @@ typedef enum
     VIRTIO_INPUT_N_ERROR,
 } virtio_input_error_t;
 
+static_always_inline void
+virtio_device_input_ethernet (vlib_main_t *vm, vlib_node_runtime_t *node,
+			      const u32 next_index, const u32 sw_if_index,
+			      const u32 hw_if_index)
+{
+  vlib_next_frame_t *nf;
+  vlib_frame_t *f;
+  ethernet_input_frame_t *ef;
+
+  if (PREDICT_FALSE (VNET_DEVICE_INPUT_NEXT_ETHERNET_INPUT != next_index))
+    return;
+
+  nf = vlib_node_runtime_get_next_frame (
+    vm, node, VNET_DEVICE_INPUT_NEXT_ETHERNET_INPUT);
+  f = vlib_get_frame (vm, nf->frame);
+  f->flags = ETH_INPUT_FRAME_F_SINGLE_SW_IF_IDX;
+
+  ef = vlib_frame_scalar_args (f);
+  ef->sw_if_index = sw_if_index;
+  ef->hw_if_index = hw_if_index;
+  vlib_frame_no_append (f);
+}
+
 static_always_inline void
 virtio_refill_vring_split (vlib_main_t *vm, virtio_if_t *vif,
 			   virtio_if_type_t type, vnet_virtio_vring_t *vring,
 			   const int hdr_sz, u32 node_index)
 {
-  u16 used, next, avail, n_slots, n_refill;
+  u16 used, next, avail, old_avail, n_slots, n_refill;
   u16 sz = vring->queue_size;
   u16 mask = sz - 1;
 
@@ -46,7 +69,7 @@ more:
   n_refill = clib_min (sz - used, 64);
 
   next = vring->desc_next;
-  avail = vring->avail->idx;
+  avail = old_avail = vring->avail->idx;
   n_slots = vlib_buffer_alloc_to_ring_from_pool (vm, vring->buffers, next,
 						 vring->queue_size, n_refill,
 						 vring->buffer_pool_index);
@@ -85,11 +108,7 @@ more:
   clib_atomic_store_seq_cst (&vring->avail->idx, avail);
   vring->desc_next = next;
   vring->desc_in_use = used;
-  if ((clib_atomic_load_seq_cst (&vring->used->flags) &
-       VRING_USED_F_NO_NOTIFY) == 0)
-    {
-      virtio_kick (vm, vring, vif);
-    }
+  virtio_kick_split (vm, vring, vif, old_avail, avail);
   goto more;
 }
 
@@ -526,7 +526,12 @@ dpo_get_next_node_by_type_and_proto (dpo_type_t   child_type,
 
 
 /**
- * @brief Barrier sync if a dpo pool is about to expand
+ * @brief Make room in a dpo pool ahead of a pool_get
+ *
+ * If the pool is about to expand it is grown by copy and we wait for the
+ * workers to move to the new copy at their next quiescent point, so no
+ * barrier is needed. dpo pools are cache-line aligned. The macro pair is
+ * kept for the callers.
  *
  * @param VM (output)
  *  vlib_main_t *, invariably &vlib_global_main
@@ -535,22 +540,17 @@ dpo_get_next_node_by_type_and_proto (dpo_type_t   child_type,
  *  pool pointer
  *
  * @param YESNO (output)
- *  typically a u8, 1 => expand will occur, worker barrier held
- *                  0 => no expand, barrier not held
+ *  typically a u8, always 0 => barrier not held
  *
  * @return YESNO set
  */
 
 #define dpo_pool_barrier_sync(VM,P,YESNO)                               \
 do {                                                                    \
-    YESNO = pool_get_will_expand (P);                                   \
-                                                                        \
-    if (YESNO)                                                          \
-    {                                                                   \
-        VM = vlib_get_main();                                           \
-        ASSERT ((VM)->thread_index == 0);                               \
-        vlib_worker_thread_barrier_sync((VM));                          \
-    }                                                                   \
+    VM = vlib_get_main();                                               \
+    ASSERT ((VM)->thread_index == 0);                                   \
+    vlib_worker_thread_pool_grow_aligned (P, CLIB_CACHE_LINE_BYTES);    \
+    YESNO = 0;                                                          \
 } while(0);
 
 /**
@@ -92,6 +92,48 @@ load_balance_get_buckets (load_balance_t *lb)
     }
 }
 
+/**
+ * Release a bucket array that is no longer reachable from its load-balance,
+ * once the workers are no longer switching through it.
+ */
+static void
+load_balance_buckets_free (uword opaque)
+{
+    dpo_id_t *buckets, *tmp_dpo;
+
+    buckets = uword_to_pointer(opaque, dpo_id_t*);
+
+    vec_foreach(tmp_dpo, buckets)
+    {
+        dpo_reset(tmp_dpo);
+    }
+    vec_free(buckets);
+}
+
+static void
+load_balance_buckets_defer_free (dpo_id_t *buckets)
+{
+    vlib_worker_thread_defer(load_balance_buckets_free,
+                             pointer_to_uword(buckets));
+}
+
+static void
+load_balance_free (uword lbi)
+{
+    load_balance_t *lb;
+
+    /*
+     * the bucket array goes with the LB, once no worker can still be
+     * switching through either.
+     */
+    lb = load_balance_get(lbi);
+    if (!LB_HAS_INLINE_BUCKETS(lb))
+    {
+        vec_free(lb->lb_buckets);
+    }
+    pool_put_index(load_balance_pool, lbi);
+}
+
 static load_balance_t *
 load_balance_alloc_i (void)
 {
@@ -100,10 +142,13 @@ load_balance_alloc_i (void)
     vlib_main_t *vm = vlib_get_main();
     ASSERT (vm->thread_index == 0);
 
-    need_barrier_sync = pool_get_will_expand (load_balance_pool);
-
-    if (need_barrier_sync)
-        vlib_worker_thread_barrier_sync (vm);
+    /*
+     * the pool is grown by copy, the workers move over to the new one
+     * without being stopped. The counters below still need the barrier
+     * when they grow.
+     */
+    vlib_worker_thread_pool_grow_aligned(load_balance_pool,
+                                         CLIB_CACHE_LINE_BYTES);
 
     pool_get_aligned(load_balance_pool, lb, CLIB_CACHE_LINE_BYTES);
     clib_memset(lb, 0, sizeof(*lb));
@@ -111,17 +156,18 @@ load_balance_alloc_i (void)
     lb->lb_map = INDEX_INVALID;
     lb->lb_urpf = INDEX_INVALID;
 
-    if (need_barrier_sync == 0)
-    {
-        need_barrier_sync += vlib_validate_combined_counter_will_expand
-            (&(load_balance_main.lbm_to_counters),
-             load_balance_get_index(lb));
-        need_barrier_sync += vlib_validate_combined_counter_will_expand
-            (&(load_balance_main.lbm_via_counters),
-             load_balance_get_index(lb));
-        if (need_barrier_sync)
-            vlib_worker_thread_barrier_sync (vm);
-    }
+    /*
+     * the workers write the counters, so those cannot be copied under
+     * their feet.
+     */
+    need_barrier_sync += vlib_validate_combined_counter_will_expand
+        (&(load_balance_main.lbm_to_counters),
+         load_balance_get_index(lb));
+    need_barrier_sync += vlib_validate_combined_counter_will_expand
+        (&(load_balance_main.lbm_via_counters),
+         load_balance_get_index(lb));
+    if (need_barrier_sync)
+        vlib_worker_thread_barrier_sync (vm);
 
     vlib_validate_combined_counter(&(load_balance_main.lbm_to_counters),
                                    load_balance_get_index(lb));
@@ -655,7 +701,6 @@ load_balance_multipath_update (const dpo_id_t *dpo,
     u32 sum_of_weights, n_buckets, ii;
     index_t lbmi, old_lbmi;
     load_balance_t *lb;
-    dpo_id_t *tmp_dpo;
 
     nhs = NULL;
 
@@ -776,7 +821,7 @@ load_balance_multipath_update (const dpo_id_t *dpo,
                      * we are not crossing the threshold. We need a new bucket array to
                      * hold the increased number of choices.
                      */
-                    dpo_id_t *new_buckets, *old_buckets, *tmp_dpo;
+                    dpo_id_t *new_buckets, *old_buckets;
 
                     new_buckets = NULL;
                     old_buckets = load_balance_get_buckets(lb);
@@ -792,11 +837,7 @@ load_balance_multipath_update (const dpo_id_t *dpo,
                     CLIB_MEMORY_BARRIER();
                     load_balance_set_n_buckets(lb, n_buckets);
 
-                    vec_foreach(tmp_dpo, old_buckets)
-                    {
-                        dpo_reset(tmp_dpo);
-                    }
-                    vec_free(old_buckets);
+                    load_balance_buckets_defer_free(old_buckets);
                 }
             }
 
@@ -835,11 +876,8 @@ load_balance_multipath_update (const dpo_id_t *dpo,
                 load_balance_set_n_buckets(lb, n_buckets);
                 CLIB_MEMORY_BARRIER();
 
-                vec_foreach(tmp_dpo, lb->lb_buckets)
-                {
-                    dpo_reset(tmp_dpo);
-                }
-                vec_free(lb->lb_buckets);
+                load_balance_buckets_defer_free(lb->lb_buckets);
+                lb->lb_buckets = NULL;
             }
             else
             {
@@ -903,15 +941,16 @@ load_balance_destroy (load_balance_t *lb)
     }
 
     LB_DBG(lb, "destroy");
-    if (!LB_HAS_INLINE_BUCKETS(lb))
-    {
-        vec_free(lb->lb_buckets);
-    }
 
     fib_urpf_list_unlock(lb->lb_urpf);
     load_balance_map_unlock(lb->lb_map);
 
-    pool_put(load_balance_pool, lb);
+    /*
+     * packets in flight may still be switching through this LB; hold the
+     * index back until they are done, lest it be reused under them.
+     */
+    vlib_worker_thread_defer(load_balance_free,
+                             load_balance_get_index(lb));
 }
 
 static void
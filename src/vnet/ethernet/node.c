@@ -45,6 +45,7 @@
 #include <vppinfra/sparse_vec.h>
 #include <vnet/l2/l2_bvi.h>
 #include <vnet/classify/pcap_classify.h>
+#include <vnet/interface/latency.h>
 
 #define foreach_ethernet_input_next		\
   _ (PUNT, "error-punt")			\
@@ -1699,6 +1700,9 @@ VLIB_NODE_FN (ethernet_input_node) (vlib_main_t * vm,
 
   ethernet_input_trace (vm, node, frame);
 
+  if (PREDICT_FALSE (vnet_latency_main.enabled))
+    vnet_latency_stamp (vm, from, n_packets);
+
   if (frame->flags & ETH_INPUT_FRAME_F_SINGLE_SW_IF_IDX)
     {
       ethernet_input_frame_t *ef = vlib_frame_scalar_args (frame);
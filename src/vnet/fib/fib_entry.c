@@ -537,18 +537,13 @@ fib_entry_alloc (u32 fib_index,
 {
     fib_entry_t *fib_entry;
     fib_prefix_t *fep;
-    u8 need_barrier_sync = pool_get_will_expand (fib_entry_pool);
     vlib_main_t *vm = vlib_get_main();
     ASSERT (vm->thread_index == 0);
 
-    if (need_barrier_sync)
-        vlib_worker_thread_barrier_sync (vm);
+    vlib_worker_thread_pool_grow (fib_entry_pool);
 
     pool_get(fib_entry_pool, fib_entry);
 
-    if (need_barrier_sync)
-        vlib_worker_thread_barrier_release (vm);
-
     clib_memset(fib_entry, 0, sizeof(*fib_entry));
 
     fib_node_init(&fib_entry->fe_node,
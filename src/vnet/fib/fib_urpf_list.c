@@ -55,18 +55,13 @@ index_t
 fib_urpf_list_alloc_and_lock (void)
 {
     fib_urpf_list_t *urpf;
-    u8 need_barrier_sync = pool_get_will_expand (fib_urpf_list_pool);
     vlib_main_t *vm = vlib_get_main();
     ASSERT (vm->thread_index == 0);
 
-    if (need_barrier_sync)
-        vlib_worker_thread_barrier_sync (vm);
+    vlib_worker_thread_pool_grow (fib_urpf_list_pool);
 
     pool_get(fib_urpf_list_pool, urpf);
 
-    if (need_barrier_sync)
-        vlib_worker_thread_barrier_release (vm);
-
     clib_memset(urpf, 0, sizeof(*urpf));
 
     urpf->furpf_locks++;
@@ -74,6 +69,17 @@ fib_urpf_list_alloc_and_lock (void)
     return (urpf - fib_urpf_list_pool);
 }
 
+static void
+fib_urpf_list_free (uword ui)
+{
+    fib_urpf_list_t *urpf;
+
+    urpf = fib_urpf_list_get(ui);
+
+    vec_free(urpf->furpf_itfs);
+    pool_put(fib_urpf_list_pool, urpf);
+}
+
 void
 fib_urpf_list_unlock (index_t ui)
 {
@@ -88,8 +94,11 @@ fib_urpf_list_unlock (index_t ui)
 
     if (0 == urpf->furpf_locks)
     {
-	vec_free(urpf->furpf_itfs);
-	pool_put(fib_urpf_list_pool, urpf);
+        /*
+         * the load-balance has already moved on to its new list, but
+         * packets in flight may still be checking against this one.
+         */
+        vlib_worker_thread_defer(fib_urpf_list_free, ui);
     }
 }
 
@@ -16,6 +16,7 @@
 
 #include <vnet/vnet.h>
 #include <vnet/hash/hash.h>
+#include <vnet/hash/toeplitz.h>
 #include <vlib/threads.h>
 #include <vnet/feature/feature.h>
 
@@ -24,6 +25,11 @@ typedef struct
   vnet_hash_fn_t hash_fn;
   uword *workers_bitmap;
   u32 *workers;
+
+  /* software RSS: the toeplitz hash indexes the redirection table, which
+   * holds thread indices */
+  clib_toeplitz_hash_key_t *rss_key;
+  u16 *reta;
 } per_inteface_handoff_data_t;
 
 typedef struct
@@ -51,6 +57,7 @@ typedef struct
   u32 sw_if_index;
   u32 next_worker_index;
   u32 buffer_index;
+  u32 hash;
 } worker_handoff_trace_t;
 
 #define foreach_worker_handoff_error			\
@@ -78,14 +85,17 @@ format_worker_handoff_trace (u8 * s, va_list * args)
   CLIB_UNUSED (vlib_node_t * node) = va_arg (*args, vlib_node_t *);
   worker_handoff_trace_t *t = va_arg (*args, worker_handoff_trace_t *);
 
-  s = format (s, "worker-handoff: sw_if_index %d, next_worker %d, buffer 0x%x",
-	      t->sw_if_index, t->next_worker_index, t->buffer_index);
+  s = format (s,
+	      "worker-handoff: sw_if_index %d, next_worker %d, buffer 0x%x, "
+	      "hash 0x%08x",
+	      t->sw_if_index, t->next_worker_index, t->buffer_index, t->hash);
   return s;
 }
 
 static void
 worker_handoff_trace_frame (vlib_main_t *vm, vlib_node_runtime_t *node,
-			    vlib_buffer_t **bufs, u16 *threads, u32 n_vectors)
+			    vlib_buffer_t **bufs, u16 *threads, u32 *hashes,
+			    u32 n_vectors)
 {
   worker_handoff_trace_t *t;
   vlib_buffer_t **b;
@@ -100,9 +110,11 @@ worker_handoff_trace_frame (vlib_main_t *vm, vlib_node_runtime_t *node,
       t->sw_if_index = vnet_buffer (b[0])->sw_if_index[VLIB_RX];
       t->next_worker_index = ti[0];
       t->buffer_index = vlib_get_buffer_index (vm, b[0]);
+      t->hash = hashes[0];
 
       b += 1;
       ti += 1;
+      hashes += 1;
       n_vectors -= 1;
     }
 }
@@ -112,58 +124,74 @@ VLIB_NODE_FN (worker_handoff_node) (vlib_main_t * vm,
 				    vlib_frame_t * frame)
 {
   handoff_main_t *hm = &handoff_main;
-  vlib_buffer_t *bufs[VLIB_FRAME_SIZE], **b;
-  u32 n_enq, n_left_from, *from;
-  u16 thread_indices[VLIB_FRAME_SIZE], *ti;
+  vlib_buffer_t *bufs[VLIB_FRAME_SIZE];
+  void *data[VLIB_FRAME_SIZE];
+  u32 hashes[VLIB_FRAME_SIZE];
+  u16 thread_indices[VLIB_FRAME_SIZE];
+  u32 n_enq, n_vectors, *from;
+  u32 i, j, k;
 
   from = vlib_frame_vector_args (frame);
-  n_left_from = frame->n_vectors;
-  vlib_get_buffers (vm, from, bufs, n_left_from);
+  n_vectors = frame->n_vectors;
+  vlib_get_buffers (vm, from, bufs, n_vectors);
 
-  b = bufs;
-  ti = thread_indices;
+  for (i = 0; i < n_vectors; i++)
+    data[i] = vlib_buffer_get_current (bufs[i]);
 
-  while (n_left_from > 0)
+  /* input nodes hand over frames from a single interface, so hash each
+   * run of packets received on the same interface in one call */
+  for (i = 0; i < n_vectors; i = j)
     {
       per_inteface_handoff_data_t *ihd0;
-      u32 sw_if_index0, hash, index0;
-      void *data;
+      u32 sw_if_index0, n_workers;
+
+      sw_if_index0 = vnet_buffer (bufs[i])->sw_if_index[VLIB_RX];
+      for (j = i + 1; j < n_vectors; j++)
+	if (vnet_buffer (bufs[j])->sw_if_index[VLIB_RX] != sw_if_index0)
+	  break;
 
-      sw_if_index0 = vnet_buffer (b[0])->sw_if_index[VLIB_RX];
       ihd0 = vec_elt_at_index (hm->if_data, sw_if_index0);
 
-      /* Compute ingress LB hash */
-      data = vlib_buffer_get_current (b[0]);
-      ihd0->hash_fn (&data, &hash, 1);
+      if (ihd0->reta)
+	{
+	  u32 mask = vec_len (ihd0->reta) - 1;
 
-      /* if input node did not specify next index, then packet
-         should go to ethernet-input */
+	  vnet_toeplitz_5tuple_hash (ihd0->rss_key, data + i, hashes + i,
+				     j - i, /* is_ip */ 0);
+	  for (k = i; k < j; k++)
+	    thread_indices[k] = ihd0->reta[hashes[k] & mask];
+	  continue;
+	}
 
-      if (PREDICT_TRUE (is_pow2 (vec_len (ihd0->workers))))
-	index0 = hash & (vec_len (ihd0->workers) - 1);
-      else
-	index0 = hash % vec_len (ihd0->workers);
+      /* Compute ingress LB hash */
+      ihd0->hash_fn (data + i, hashes + i, j - i);
+      n_workers = vec_len (ihd0->workers);
 
-      ti[0] = hm->first_worker_index + ihd0->workers[index0];
+      for (k = i; k < j; k++)
+	{
+	  u32 index0;
 
-      /* next */
-      n_left_from -= 1;
-      ti += 1;
-      b += 1;
+	  if (PREDICT_TRUE (is_pow2 (n_workers)))
+	    index0 = hashes[k] & (n_workers - 1);
+	  else
+	    index0 = hashes[k] % n_workers;
+
+	  thread_indices[k] = hm->first_worker_index + ihd0->workers[index0];
+	}
     }
 
   if (PREDICT_FALSE (node->flags & VLIB_NODE_FLAG_TRACE))
-    worker_handoff_trace_frame (vm, node, bufs, thread_indices,
-				frame->n_vectors);
+    worker_handoff_trace_frame (vm, node, bufs, thread_indices, hashes,
+				n_vectors);
 
   n_enq = vlib_buffer_enqueue_to_thread (vm, node, hm->frame_queue_index, from,
-					 thread_indices, frame->n_vectors, 1);
+					 thread_indices, n_vectors, 1);
 
-  if (n_enq < frame->n_vectors)
+  if (n_enq < n_vectors)
     vlib_node_increment_counter (vm, node->node_index,
 				 WORKER_HANDOFF_ERROR_CONGESTION_DROP,
-				 frame->n_vectors - n_enq);
-  return frame->n_vectors;
+				 n_vectors - n_enq);
+  return n_vectors;
 }
 
 VLIB_REGISTER_NODE (worker_handoff_node) = {
@@ -214,6 +242,10 @@ interface_handoff_enable_disable (vlib_main_t *vm, u32 sw_if_index,
 
   vec_free (d->workers);
   vec_free (d->workers_bitmap);
+  vec_free (d->reta);
+  if (d->rss_key)
+    clib_toeplitz_hash_key_free (d->rss_key);
+  d->rss_key = 0;
 
   if (enable_disable)
     {
@@ -249,15 +281,114 @@ interface_handoff_enable_disable (vlib_main_t *vm, u32 sw_if_index,
   return rv;
 }
 
+int
+interface_handoff_set_rss (vlib_main_t *vm, u32 sw_if_index, u8 *key,
+			   u32 reta_size)
+{
+  handoff_main_t *hm = &handoff_main;
+  per_inteface_handoff_data_t *d;
+  u32 i;
+
+  if (sw_if_index >= vec_len (hm->if_data))
+    return VNET_API_ERROR_FEATURE_DISABLED;
+
+  d = vec_elt_at_index (hm->if_data, sw_if_index);
+  if (vec_len (d->workers) == 0)
+    return VNET_API_ERROR_FEATURE_DISABLED;
+
+  if (key && vec_len (key) < VNET_TOEPLITZ_TUPLE_MAX_SZ + 4)
+    return VNET_API_ERROR_INVALID_VALUE;
+
+  if (reta_size == 0 || !is_pow2 (reta_size) || reta_size > (1 << 16))
+    return VNET_API_ERROR_INVALID_VALUE_2;
+
+  if (d->rss_key)
+    clib_toeplitz_hash_key_free (d->rss_key);
+  d->rss_key = clib_toeplitz_hash_key_init (key, vec_len (key));
+
+  /* spread entries evenly, like NICs do by default */
+  vec_validate (d->reta, reta_size - 1);
+  vec_set_len (d->reta, reta_size);
+  for (i = 0; i < reta_size; i++)
+    d->reta[i] =
+      hm->first_worker_index + d->workers[i % vec_len (d->workers)];
+
+  return 0;
+}
+
+int
+interface_handoff_set_reta_entries (vlib_main_t *vm, u32 sw_if_index,
+				    u32 first, u32 last, u32 worker)
+{
+  handoff_main_t *hm = &handoff_main;
+  per_inteface_handoff_data_t *d;
+
+  if (sw_if_index >= vec_len (hm->if_data))
+    return VNET_API_ERROR_FEATURE_DISABLED;
+
+  d = vec_elt_at_index (hm->if_data, sw_if_index);
+  if (d->reta == 0)
+    return VNET_API_ERROR_FEATURE_DISABLED;
+
+  if (worker >= hm->num_workers)
+    return VNET_API_ERROR_INVALID_WORKER;
+
+  if (first > last || last >= vec_len (d->reta))
+    return VNET_API_ERROR_INVALID_VALUE;
+
+  for (u32 i = first; i <= last; i++)
+    d->reta[i] = hm->first_worker_index + worker;
+
+  return 0;
+}
+
+static clib_error_t *
+handoff_rv_to_error (int rv)
+{
+  switch (rv)
+    {
+    case 0:
+      return 0;
+
+    case VNET_API_ERROR_INVALID_SW_IF_INDEX:
+      return clib_error_return (0, "Invalid interface");
+
+    case VNET_API_ERROR_INVALID_WORKER:
+      return clib_error_return (0, "Invalid worker(s)");
+
+    case VNET_API_ERROR_UNIMPLEMENTED:
+      return clib_error_return (0,
+				"Device driver doesn't support redirection");
+
+    case VNET_API_ERROR_FEATURE_DISABLED:
+      return clib_error_return (0, "Handoff not enabled on interface");
+
+    case VNET_API_ERROR_INVALID_VALUE:
+      return clib_error_return (0, "RSS key shorter than %u bytes or "
+				"redirection table entry out of range",
+				VNET_TOEPLITZ_TUPLE_MAX_SZ + 4);
+
+    case VNET_API_ERROR_INVALID_VALUE_2:
+      return clib_error_return (0, "Redirection table size must be a "
+				"power of two");
+
+    default:
+      return clib_error_return (0, "unknown return value %d", rv);
+    }
+}
+
 static clib_error_t *
 set_interface_handoff_command_fn (vlib_main_t * vm,
 				  unformat_input_t * input,
 				  vlib_cli_command_t * cmd)
 {
-  u32 sw_if_index = ~0, is_sym = 0, is_l4 = 0;
+  u32 sw_if_index = ~0, is_sym = 0, is_l4 = 0, is_rss = 0;
+  u32 reta_size = 128;
   int enable_disable = 1;
   uword *bitmap = 0;
+  u8 *key = 0;
   int rv = 0;
+  clib_error_t *error;
 
   while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
     {
@@ -274,6 +405,12 @@ set_interface_handoff_command_fn (vlib_main_t * vm,
 	is_sym = 0;
       else if (unformat (input, "l4"))
 	is_l4 = 1;
+      else if (unformat (input, "rss"))
+	is_rss = 1;
+      else if (unformat (input, "key %U", unformat_hex_string, &key))
+	;
+      else if (unformat (input, "reta-size %u", &reta_size))
+	;
       else
 	break;
     }
@@ -287,39 +424,112 @@ set_interface_handoff_command_fn (vlib_main_t * vm,
   rv = interface_handoff_enable_disable (vm, sw_if_index, bitmap, is_sym,
 					 is_l4, enable_disable);
 
-  switch (rv)
+  if (rv == 0 && enable_disable && is_rss)
+    rv = interface_handoff_set_rss (vm, sw_if_index, key, reta_size);
+
+  error = handoff_rv_to_error (rv);
+  vec_free (key);
+  return error;
+}
+
+/* *INDENT-OFF* */
+VLIB_CLI_COMMAND (set_interface_handoff_command, static) = {
+  .path = "set interface handoff",
+  .short_help = "set interface handoff <interface-name> workers <workers-list>"
+		" [symmetrical|asymmetrical] [rss [key <hex>] "
+		"[reta-size <n>]]",
+  .function = set_interface_handoff_command_fn,
+};
+/* *INDENT-ON* */
+
+static clib_error_t *
+set_interface_handoff_reta_command_fn (vlib_main_t *vm,
+				       unformat_input_t *input,
+				       vlib_cli_command_t *cmd)
+{
+  u32 sw_if_index = ~0, first = ~0, last = ~0, worker = ~0;
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
     {
-    case 0:
-      break;
+      if (unformat (input, "entry %u-%u", &first, &last))
+	;
+      else if (unformat (input, "entry %u", &first))
+	last = first;
+      else if (unformat (input, "worker %u", &worker))
+	;
+      else if (unformat (input, "%U", unformat_vnet_sw_interface,
+			 vnet_get_main (), &sw_if_index))
+	;
+      else
+	return clib_error_return (0, "unknown input '%U'",
+				  format_unformat_error, input);
+    }
 
-    case VNET_API_ERROR_INVALID_SW_IF_INDEX:
-      return clib_error_return (0, "Invalid interface");
-      break;
+  if (sw_if_index == ~0)
+    return clib_error_return (0, "Please specify an interface...");
 
-    case VNET_API_ERROR_INVALID_WORKER:
-      return clib_error_return (0, "Invalid worker(s)");
-      break;
+  if (first == ~0 || worker == ~0)
+    return clib_error_return (0, "Please specify entry and worker...");
 
-    case VNET_API_ERROR_UNIMPLEMENTED:
-      return clib_error_return (0,
-				"Device driver doesn't support redirection");
-      break;
+  return handoff_rv_to_error (interface_handoff_set_reta_entries (
+    vm, sw_if_index, first, last, worker));
+}
 
-    default:
-      return clib_error_return (0, "unknown return value %d", rv);
+VLIB_CLI_COMMAND (set_interface_handoff_reta_command, static) = {
+  .path = "set interface handoff reta",
+  .short_help = "set interface handoff reta <interface-name> "
+		"entry <n>[-<m>] worker <n>",
+  .function = set_interface_handoff_reta_command_fn,
+};
+
+static clib_error_t *
+show_interface_handoff_command_fn (vlib_main_t *vm, unformat_input_t *input,
+				   vlib_cli_command_t *cmd)
+{
+  handoff_main_t *hm = &handoff_main;
+  vnet_main_t *vnm = vnet_get_main ();
+  per_inteface_handoff_data_t *d;
+  vnet_hash_function_registration_t *hash;
+  u32 sw_if_index;
+
+  vec_foreach (d, hm->if_data)
+    {
+      if (vec_len (d->workers) == 0)
+	continue;
+
+      sw_if_index = d - hm->if_data;
+      vlib_cli_output (vm, "%U: workers %U", format_vnet_sw_if_index_name,
+		       vnm, sw_if_index, format_bitmap_list,
+		       d->workers_bitmap);
+
+      if (d->reta == 0)
+	{
+	  hash =
+	    vnet_hash_function_from_func (d->hash_fn, VNET_HASH_FN_TYPE_ETHERNET);
+	  vlib_cli_output (vm, "  hash %s", hash ? hash->name : "unknown");
+	  continue;
+	}
+
+      vlib_cli_output (vm, "  rss key %U", format_hex_bytes_no_wrap,
+		       d->rss_key->data, d->rss_key->key_length);
+      for (u32 i = 0; i < vec_len (d->reta); i += 16)
+	{
+	  u8 *s = format (0, "  reta %4u:", i);
+	  for (u32 j = i; j < i + 16 && j < vec_len (d->reta); j++)
+	    s = format (s, " %2u", d->reta[j] - hm->first_worker_index);
+	  vlib_cli_output (vm, "%v", s);
+	  vec_free (s);
+	}
     }
 
   return 0;
 }
 
-/* *INDENT-OFF* */
-VLIB_CLI_COMMAND (set_interface_handoff_command, static) = {
-  .path = "set interface handoff",
-  .short_help = "set interface handoff <interface-name> workers <workers-list>"
-		" [symmetrical|asymmetrical]",
-  .function = set_interface_handoff_command_fn,
+VLIB_CLI_COMMAND (show_interface_handoff_command, static) = {
+  .path = "show interface handoff",
+  .short_help = "show interface handoff",
+  .function = show_interface_handoff_command_fn,
 };
-/* *INDENT-ON* */
 
 clib_error_t *
 handoff_init (vlib_main_t * vm)
@@ -0,0 +1,136 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2024 Cisco Systems, Inc.
+ */
+
+#ifndef __VNET_HASH_TOEPLITZ_H__
+#define __VNET_HASH_TOEPLITZ_H__
+
+#include <vnet/ethernet/ethernet.h>
+#include <vnet/ip/ip4_packet.h>
+#include <vnet/ip/ip6_packet.h>
+#include <vppinfra/vector/toeplitz.h>
+
+/* RSS hash input as NICs build it: source and destination address followed
+ * by source and destination port for TCP and UDP. Shorter tuples are zero
+ * padded, zero bits don't change a toeplitz hash so the result is the same
+ * as hashing the tuple alone. Keys must be at least 4 bytes longer. */
+#define VNET_TOEPLITZ_TUPLE_MAX_SZ 36
+
+static_always_inline u8
+vnet_toeplitz_tuple_ip4 (ip4_header_t *ip, u8 *t)
+{
+  clib_memcpy_fast (t, &ip->src_address, 8);
+
+  if ((ip->protocol == IP_PROTOCOL_TCP || ip->protocol == IP_PROTOCOL_UDP) &&
+      !ip4_is_fragment (ip))
+    {
+      clib_memcpy_fast (t + 8, ip4_next_header (ip), 4);
+      return 12;
+    }
+  return 8;
+}
+
+static_always_inline u8
+vnet_toeplitz_tuple_ip6 (ip6_header_t *ip, u8 *t)
+{
+  clib_memcpy_fast (t, &ip->src_address, 32);
+
+  if (ip->protocol == IP_PROTOCOL_TCP || ip->protocol == IP_PROTOCOL_UDP)
+    {
+      clib_memcpy_fast (t + 32, ip6_next_header (ip), 4);
+      return 36;
+    }
+  return 32;
+}
+
+static_always_inline u8
+vnet_toeplitz_tuple (void *p, u8 *t, int is_ip)
+{
+  u16 ethertype;
+
+  if (is_ip)
+    {
+      if ((((u8 *) p)[0] & 0xf0) == 0x40)
+	return vnet_toeplitz_tuple_ip4 (p, t);
+      if ((((u8 *) p)[0] & 0xf0) == 0x60)
+	return vnet_toeplitz_tuple_ip6 (p, t);
+      return 0;
+    }
+
+  ethertype = clib_net_to_host_u16 (((ethernet_header_t *) p)->type);
+  p += sizeof (ethernet_header_t);
+
+  while (ethernet_frame_is_tagged (ethertype))
+    {
+      ethertype = clib_net_to_host_u16 (((ethernet_vlan_header_t *) p)->type);
+      p += sizeof (ethernet_vlan_header_t);
+    }
+
+  if (ethertype == ETHERNET_TYPE_IP4)
+    return vnet_toeplitz_tuple_ip4 (p, t);
+  if (ethertype == ETHERNET_TYPE_IP6)
+    return vnet_toeplitz_tuple_ip6 (p, t);
+  return 0;
+}
+
+/* pad tuple to n bytes */
+static_always_inline void
+vnet_toeplitz_tuple_pad (u8 *t, u8 len, u8 n)
+{
+  if (len < n)
+    clib_memset_u8 (t + len, 0, n - len);
+}
+
+/* hash packets with the given key, non-IP packets hash to zero */
+static_always_inline void
+vnet_toeplitz_5tuple_hash (clib_toeplitz_hash_key_t *k, void **p, u32 *hash,
+			   u32 n_packets, int is_ip)
+{
+  u8 t[4][VNET_TOEPLITZ_TUPLE_MAX_SZ];
+  u8 l0, l1, l2, l3, n;
+
+  while (n_packets >= 4)
+    {
+      if (n_packets >= 8)
+	{
+	  clib_prefetch_load (p[4]);
+	  clib_prefetch_load (p[5]);
+	  clib_prefetch_load (p[6]);
+	  clib_prefetch_load (p[7]);
+	}
+
+      l0 = vnet_toeplitz_tuple (p[0], t[0], is_ip);
+      l1 = vnet_toeplitz_tuple (p[1], t[1], is_ip);
+      l2 = vnet_toeplitz_tuple (p[2], t[2], is_ip);
+      l3 = vnet_toeplitz_tuple (p[3], t[3], is_ip);
+
+      /* all four are hashed over the longest tuple */
+      n = clib_max (clib_max (l0, l1), clib_max (l2, l3));
+      vnet_toeplitz_tuple_pad (t[0], l0, n);
+      vnet_toeplitz_tuple_pad (t[1], l1, n);
+      vnet_toeplitz_tuple_pad (t[2], l2, n);
+      vnet_toeplitz_tuple_pad (t[3], l3, n);
+
+      if (n)
+	clib_toeplitz_hash_x4 (k, t[0], t[1], t[2], t[3], hash, hash + 1,
+			       hash + 2, hash + 3, n);
+      else
+	hash[0] = hash[1] = hash[2] = hash[3] = 0;
+
+      hash += 4;
+      p += 4;
+      n_packets -= 4;
+    }
+
+  while (n_packets > 0)
+    {
+      l0 = vnet_toeplitz_tuple (p[0], t[0], is_ip);
+      hash[0] = l0 ? clib_toeplitz_hash (k, t[0], l0) : 0;
+
+      hash += 1;
+      p += 1;
+      n_packets -= 1;
+    }
+}
+
+#endif
@@ -0,0 +1,39 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2024 Cisco Systems, Inc.
+ */
+
+#include <vnet/vnet.h>
+#include <vnet/hash/hash.h>
+#include <vnet/hash/toeplitz.h>
+
+static clib_toeplitz_hash_key_t *toeplitz_5tuple_key;
+
+static void
+vnet_toeplitz_5tuple_ethernet_func (void **p, u32 *hash, u32 n_packets)
+{
+  vnet_toeplitz_5tuple_hash (toeplitz_5tuple_key, p, hash, n_packets, 0);
+}
+
+static void
+vnet_toeplitz_5tuple_ip_func (void **p, u32 *hash, u32 n_packets)
+{
+  vnet_toeplitz_5tuple_hash (toeplitz_5tuple_key, p, hash, n_packets, 1);
+}
+
+VNET_REGISTER_HASH_FUNCTION (toeplitz_5tuple, static) = {
+  .name = "toeplitz-5tuple",
+  .description = "RSS toeplitz hash of IPv4/IPv6 addresses and TCP/UDP "
+		 "ports with the default key",
+  .priority = 40,
+  .function[VNET_HASH_FN_TYPE_ETHERNET] = vnet_toeplitz_5tuple_ethernet_func,
+  .function[VNET_HASH_FN_TYPE_IP] = vnet_toeplitz_5tuple_ip_func,
+};
+
+static clib_error_t *
+toeplitz_5tuple_init (vlib_main_t *vm)
+{
+  toeplitz_5tuple_key = clib_toeplitz_hash_key_init (0, 0);
+  return 0;
+}
+
+VLIB_INIT_FUNCTION (toeplitz_5tuple_init);
@@ -113,6 +113,12 @@ typedef int (vnet_flow_dev_ops_function_t) (struct vnet_main_t * vnm,
 					    u32 hw_if_index, u32 index,
 					    uword * private_data);
 
+/* Interface inline IPsec SA offload callback. Experimental, only the
+ * packet-generator implements it so far. */
+typedef int (vnet_ipsec_sa_dev_ops_function_t) (struct vnet_main_t *vnm,
+						u32 dev_instance, u32 sa_index,
+						int is_add);
+
 typedef enum vnet_interface_function_priority_t_
 {
   VNET_ITF_FUNC_PRIORITY_LOW,
@@ -247,6 +253,9 @@ typedef struct _vnet_device_class
   /* Interface flow offload operations */
   vnet_flow_dev_ops_function_t *flow_ops_function;
 
+  /* Interface inline IPsec SA offload operations (experimental) */
+  vnet_ipsec_sa_dev_ops_function_t *ipsec_sa_dev_ops_function;
+
   /* Format device instance as name. */
   format_function_t *format_device_name;
 
@@ -551,6 +560,7 @@ typedef enum vnet_hw_interface_flags_t_
   _ (16, UDP_TNL_GSO, "udp-tnl-gso")                                          \
   _ (17, IP_TNL_GSO, "ip-tnl-gso")                                            \
   _ (18, TCP_LRO, "tcp-lro")                                                  \
+  _ (19, IPSEC_INLINE, "ipsec-inline")                                        \
   _ (30, INT_MODE, "int-mode")                                                \
   _ (31, MAC_FILTER, "mac-filter")
 
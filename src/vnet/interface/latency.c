@@ -0,0 +1,346 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2024 Cisco Systems, Inc.
+ */
+
+#include <vlib/vlib.h>
+#include <vnet/vnet.h>
+#include <vnet/interface/latency.h>
+
+vnet_latency_main_t vnet_latency_main;
+
+static void
+vnet_latency_validate_interfaces (vnet_latency_main_t *lm)
+{
+  vnet_main_t *vnm = vnet_get_main ();
+  u32 n = pool_len (vnm->interface_main.sw_interfaces);
+
+  if (n == 0)
+    return;
+
+  vlib_validate_histogram (&lm->tx_latency, n - 1);
+}
+
+static void
+vnet_latency_node_callback (vlib_node_runtime_perf_callback_data_t *data,
+			    vlib_node_runtime_perf_callback_args_t *args)
+{
+  vnet_latency_main_t *lm = &vnet_latency_main;
+  vlib_buffer_t *bufs[VLIB_FRAME_SIZE];
+  vlib_main_t *vm = args->vm;
+  vlib_frame_t *f = args->frame;
+
+  if (args->call_type != VLIB_NODE_RUNTIME_PERF_BEFORE || f == 0 ||
+      f->n_vectors == 0 ||
+      !clib_bitmap_get (lm->node_bitmap, args->node->node_index))
+    return;
+
+  vlib_get_buffers (vm, vlib_frame_vector_args (f), bufs, f->n_vectors);
+  vnet_latency_record (vm, &lm->node_latency, args->node->node_index, bufs,
+		       f->n_vectors, 0 /* is_final */);
+}
+
+static void
+vnet_latency_update_callbacks (vnet_latency_main_t *lm)
+{
+  vlib_node_runtime_perf_callback_data_t *d;
+  u8 want = lm->enabled && clib_bitmap_count_set_bits (lm->node_bitmap);
+
+  for (int i = 0; i < vlib_get_n_threads (); i++)
+    {
+      vlib_main_t *ovm = vlib_get_main_by_index (i);
+      u8 have = 0;
+
+      if (ovm == 0)
+	continue;
+
+      vec_foreach (d, ovm->vlib_node_runtime_perf_callbacks.curr)
+	if (d->fp == vnet_latency_node_callback)
+	  have = 1;
+
+      if (want != have)
+	clib_callback_data_enable_disable (
+	  &ovm->vlib_node_runtime_perf_callbacks, vnet_latency_node_callback,
+	  want);
+    }
+}
+
+int
+vnet_latency_enable_disable (u8 enable, u32 sample_interval)
+{
+  vnet_latency_main_t *lm = &vnet_latency_main;
+  vlib_main_t *vm = vlib_get_main ();
+  vnet_latency_per_thread_t *ptd;
+
+  if (enable && sample_interval == 0)
+    return VNET_API_ERROR_INVALID_VALUE;
+
+  vlib_worker_thread_barrier_sync (vm);
+
+  if (enable)
+    {
+      lm->ns_per_clock = 1e9 / vm->clib_time.clocks_per_second;
+      lm->sample_interval = sample_interval;
+      vec_validate_aligned (lm->per_thread, vlib_get_n_threads () - 1,
+			    CLIB_CACHE_LINE_BYTES);
+      vec_foreach (ptd, lm->per_thread)
+	ptd->countdown = 1;
+      vnet_latency_validate_interfaces (lm);
+    }
+
+  lm->enabled = enable;
+  vnet_latency_update_callbacks (lm);
+
+  vlib_worker_thread_barrier_release (vm);
+
+  return 0;
+}
+
+int
+vnet_latency_node_enable_disable (u32 node_index, u8 enable)
+{
+  vnet_latency_main_t *lm = &vnet_latency_main;
+  vlib_main_t *vm = vlib_get_main ();
+  vlib_node_t *n = vlib_get_node (vm, node_index);
+
+  if (n->type != VLIB_NODE_TYPE_INTERNAL)
+    return VNET_API_ERROR_INVALID_VALUE;
+
+  vlib_worker_thread_barrier_sync (vm);
+
+  if (enable)
+    vlib_validate_histogram (&lm->node_latency, node_index);
+
+  lm->node_bitmap = clib_bitmap_set (lm->node_bitmap, node_index, enable);
+  vnet_latency_update_callbacks (lm);
+
+  vlib_worker_thread_barrier_release (vm);
+
+  return 0;
+}
+
+static clib_error_t *
+vnet_latency_sw_interface_add_del (vnet_main_t *vnm, u32 sw_if_index,
+				   u32 is_add)
+{
+  vnet_latency_main_t *lm = &vnet_latency_main;
+
+  if (!lm->enabled)
+    return 0;
+
+  vlib_validate_histogram (&lm->tx_latency, sw_if_index);
+  vlib_zero_histogram (&lm->tx_latency, sw_if_index);
+
+  return 0;
+}
+
+VNET_SW_INTERFACE_ADD_DEL_FUNCTION (vnet_latency_sw_interface_add_del);
+
+static u8 *
+format_vnet_latency_bin (u8 *s, va_list *args)
+{
+  vlib_histogram_main_t *hm = va_arg (*args, vlib_histogram_main_t *);
+  u32 bin = va_arg (*args, u32);
+  u64 ns = vlib_histogram_bin_bound (hm, bin);
+
+  if (ns == ~0ULL)
+    return format (s, "inf");
+  if (ns < 1000)
+    return format (s, "%lluns", ns);
+  if (ns < 1000000)
+    return format (s, "%.1fus", ns * 1e-3);
+  return format (s, "%.1fms", ns * 1e-6);
+}
+
+static u8 *
+format_vnet_latency_histogram (u8 *s, va_list *args)
+{
+  vlib_histogram_main_t *hm = va_arg (*args, vlib_histogram_main_t *);
+  u32 index = va_arg (*args, u32);
+  int verbose = va_arg (*args, int);
+  u32 indent = format_get_indent (s);
+  u64 counts[VNET_LATENCY_N_BINS], total = 0, sum = 0;
+  u32 p50 = ~0, p99 = ~0, max = 0;
+
+  vlib_get_histogram (hm, index, counts);
+
+  for (int i = 0; i < VNET_LATENCY_N_BINS; i++)
+    {
+      total += counts[i];
+      if (counts[i])
+	max = i;
+    }
+
+  if (total == 0)
+    return format (s, "no samples");
+
+  for (int i = 0; i < VNET_LATENCY_N_BINS; i++)
+    {
+      sum += counts[i];
+      if (p50 == ~0 && sum * 2 >= total)
+	p50 = i;
+      if (p99 == ~0 && sum * 100 >= total * 99)
+	p99 = i;
+    }
+
+  s = format (s, "samples %llu p50 <%U p99 <%U max <%U", total,
+	      format_vnet_latency_bin, hm, p50, format_vnet_latency_bin, hm,
+	      p99, format_vnet_latency_bin, hm, max);
+
+  if (!verbose)
+    return s;
+
+  for (int i = 0; i <= max; i++)
+    if (counts[i])
+      s = format (s, "\n%U<%-12U %llu", format_white_space, indent + 2,
+		  format_vnet_latency_bin, hm, i, counts[i]);
+
+  return s;
+}
+
+static clib_error_t *
+set_latency_sampling_command_fn (vlib_main_t *vm, unformat_input_t *input,
+				 vlib_cli_command_t *cmd)
+{
+  vnet_latency_main_t *lm = &vnet_latency_main;
+  unformat_input_t _line_input, *line_input = &_line_input;
+  u32 interval = lm->sample_interval ? lm->sample_interval : 100;
+  u32 node_index = ~0;
+  int enable = -1, rv;
+  clib_error_t *error = 0;
+
+  if (!unformat_user (input, unformat_line_input, line_input))
+    return 0;
+
+  while (unformat_check_input (line_input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (line_input, "enable"))
+	enable = 1;
+      else if (unformat (line_input, "disable"))
+	enable = 0;
+      else if (unformat (line_input, "interval %u", &interval))
+	;
+      else if (unformat (line_input, "node %U", unformat_vlib_node, vm,
+			 &node_index))
+	;
+      else
+	{
+	  error = clib_error_return (0, "unknown input `%U'",
+				     format_unformat_error, line_input);
+	  goto done;
+	}
+    }
+
+  if (node_index != ~0)
+    rv = vnet_latency_node_enable_disable (node_index, enable != 0);
+  else if (enable == -1)
+    {
+      error = clib_error_return (0, "specify enable or disable");
+      goto done;
+    }
+  else
+    rv = vnet_latency_enable_disable (enable, interval);
+
+  if (rv)
+    error = clib_error_return (0, "failed: %U", format_vnet_api_errno, rv);
+
+done:
+  unformat_free (line_input);
+  return error;
+}
+
+/*?
+ * Stamp one packet in every '<em>interval</em>' (default 100) on ethernet
+ * input and record how long it took to reach interface-output, per tx
+ * interface. With '<em>node</em>' the time to reach the given node is
+ * recorded as well, on every frame the node is dispatched with. The
+ * histograms are in the stats segment as /if/tx-latency and
+ * /sys/node/latency, indexed by sw_if_index and node index.
+ *
+ * @cliexpar
+ * @cliexcmd{set latency-sampling enable interval 1000}
+ * @cliexcmd{set latency-sampling node ip4-lookup}
+?*/
+VLIB_CLI_COMMAND (set_latency_sampling_command, static) = {
+  .path = "set latency-sampling",
+  .short_help = "set latency-sampling [enable|disable] [interval <n>] "
+		"[node <node-name>]",
+  .function = set_latency_sampling_command_fn,
+};
+
+static clib_error_t *
+show_latency_sampling_command_fn (vlib_main_t *vm, unformat_input_t *input,
+				  vlib_cli_command_t *cmd)
+{
+  vnet_latency_main_t *lm = &vnet_latency_main;
+  vnet_main_t *vnm = vnet_get_main ();
+  vnet_sw_interface_t *si;
+  int verbose = 0;
+  u32 i;
+
+  if (unformat (input, "verbose"))
+    verbose = 1;
+
+  vlib_cli_output (vm, "latency sampling %s, 1 in %u packets",
+		   lm->enabled ? "enabled" : "disabled", lm->sample_interval);
+
+  if (lm->tx_latency.counters)
+    pool_foreach (si, vnm->interface_main.sw_interfaces)
+      {
+	if (si->sw_if_index >= vlib_histogram_n_histograms (&lm->tx_latency))
+	  continue;
+	vlib_cli_output (vm, "  %U: %U", format_vnet_sw_if_index_name, vnm,
+			 si->sw_if_index, format_vnet_latency_histogram,
+			 &lm->tx_latency, si->sw_if_index, verbose);
+      }
+
+  clib_bitmap_foreach (i, lm->node_bitmap)
+    vlib_cli_output (vm, "  node %U: %U", format_vlib_node_name, vm, i,
+		     format_vnet_latency_histogram, &lm->node_latency, i,
+		     verbose);
+
+  return 0;
+}
+
+VLIB_CLI_COMMAND (show_latency_sampling_command, static) = {
+  .path = "show latency-sampling",
+  .short_help = "show latency-sampling [verbose]",
+  .function = show_latency_sampling_command_fn,
+};
+
+static clib_error_t *
+clear_latency_sampling_command_fn (vlib_main_t *vm, unformat_input_t *input,
+				   vlib_cli_command_t *cmd)
+{
+  vnet_latency_main_t *lm = &vnet_latency_main;
+
+  vlib_clear_histograms (&lm->tx_latency);
+  vlib_clear_histograms (&lm->node_latency);
+
+  return 0;
+}
+
+VLIB_CLI_COMMAND (clear_latency_sampling_command, static) = {
+  .path = "clear latency-sampling",
+  .short_help = "clear latency-sampling",
+  .function = clear_latency_sampling_command_fn,
+};
+
+static clib_error_t *
+vnet_latency_init (vlib_main_t *vm)
+{
+  vnet_latency_main_t *lm = &vnet_latency_main;
+
+  lm->tx_latency.name = "tx latency";
+  lm->tx_latency.stat_segment_name = "/if/tx-latency";
+  lm->tx_latency.n_bins = VNET_LATENCY_N_BINS;
+  lm->tx_latency.base = VNET_LATENCY_MIN_LOG2_NS;
+
+  lm->node_latency.name = "node latency";
+  lm->node_latency.stat_segment_name = "/sys/node/latency";
+  lm->node_latency.n_bins = VNET_LATENCY_N_BINS;
+  lm->node_latency.base = VNET_LATENCY_MIN_LOG2_NS;
+
+  return 0;
+}
+
+VLIB_INIT_FUNCTION (vnet_latency_init);
@@ -0,0 +1,103 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2024 Cisco Systems, Inc.
+ */
+
+#ifndef __included_vnet_interface_latency_h__
+#define __included_vnet_interface_latency_h__
+
+#include <vnet/vnet.h>
+#include <vnet/buffer.h>
+
+/*
+ * Packet latency sampling. One packet in sample_interval is stamped with
+ * the CPU time of the input node dispatch; interface-output, and any node
+ * selected for it, record the nanoseconds since then in a log2 histogram.
+ *
+ * Bin 0 counts samples below 2^VNET_LATENCY_MIN_LOG2_NS nanoseconds, bin i
+ * samples in [2^(i + MIN_LOG2_NS - 1), 2^(i + MIN_LOG2_NS)) and the last
+ * bin everything above.
+ */
+#define VNET_LATENCY_N_BINS	 24
+#define VNET_LATENCY_MIN_LOG2_NS 7
+
+typedef struct
+{
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
+
+  /* Packets to let through before stamping the next one */
+  u32 countdown;
+} vnet_latency_per_thread_t;
+
+typedef struct
+{
+  u8 enabled;
+
+  /* Stamp one packet in this many */
+  u32 sample_interval;
+
+  f64 ns_per_clock;
+
+  vnet_latency_per_thread_t *per_thread;
+
+  /* Histograms by tx sw_if_index and by node index */
+  vlib_histogram_main_t tx_latency;
+  vlib_histogram_main_t node_latency;
+
+  /* Nodes recording on frame arrival */
+  uword *node_bitmap;
+} vnet_latency_main_t;
+
+extern vnet_latency_main_t vnet_latency_main;
+
+int vnet_latency_enable_disable (u8 enable, u32 sample_interval);
+int vnet_latency_node_enable_disable (u32 node_index, u8 enable);
+
+static_always_inline u64
+vnet_latency_ns (vnet_latency_main_t *lm, u64 t0, u64 t1)
+{
+  return t1 > t0 ? (t1 - t0) * lm->ns_per_clock : 0;
+}
+
+/* Stamp every sample_interval-th packet of an input frame */
+static_always_inline void
+vnet_latency_stamp (vlib_main_t *vm, u32 *from, u32 n_left)
+{
+  vnet_latency_main_t *lm = &vnet_latency_main;
+  vnet_latency_per_thread_t *ptd;
+  u64 now = vm->cpu_time_last_node_dispatch;
+  u32 i;
+
+  ptd = vec_elt_at_index (lm->per_thread, vm->thread_index);
+
+  for (i = ptd->countdown - 1; i < n_left; i += lm->sample_interval)
+    {
+      vlib_buffer_t *b = vlib_get_buffer (vm, from[i]);
+      b->flags |= VNET_BUFFER_F_LATENCY_SAMPLE;
+      vnet_buffer2 (b)->rx_time = now;
+    }
+
+  ptd->countdown = i - n_left + 1;
+}
+
+static_always_inline void
+vnet_latency_record (vlib_main_t *vm, vlib_histogram_main_t *hm, u32 index,
+		     vlib_buffer_t **b, u32 n_left, int is_final)
+{
+  vnet_latency_main_t *lm = &vnet_latency_main;
+  u64 now = vm->cpu_time_last_node_dispatch;
+  u64 ns;
+
+  for (; n_left; n_left--, b++)
+    {
+      if (PREDICT_TRUE (!(b[0]->flags & VNET_BUFFER_F_LATENCY_SAMPLE)))
+	continue;
+
+      ns = vnet_latency_ns (lm, vnet_buffer2 (b[0])->rx_time, now);
+      vlib_increment_histogram (hm, vm->thread_index, index, ns);
+
+      if (is_final)
+	b[0]->flags &= ~VNET_BUFFER_F_LATENCY_SAMPLE;
+    }
+}
+
+#endif /* __included_vnet_interface_latency_h__ */
@@ -48,6 +48,7 @@
 #include <vnet/classify/pcap_classify.h>
 #include <vnet/hash/hash.h>
 #include <vnet/interface_output.h>
+#include <vnet/interface/latency.h>
 #include <vppinfra/vector/mask_compare.h>
 #include <vppinfra/vector/compress.h>
 #include <vppinfra/vector/count_equal.h>
@@ -419,7 +420,7 @@ enqueue_one_to_tx_node (vlib_main_t *vm, vlib_node_runtime_t *node, u32 *ppqi,
       (!copy_frame || (tf->queue_id == copy_frame->queue_id)))
     {
       /* append current next frame */
-      n_free = VLIB_FRAME_SIZE - f->n_vectors;
+      n_free = f->max_vectors - f->n_vectors;
       /*
        * if frame contains enough space for worst case scenario,
        * we can avoid use of tmp
@@ -441,7 +442,7 @@ enqueue_one_to_tx_node (vlib_main_t *vm, vlib_node_runtime_t *node, u32 *ppqi,
       /* empty frame - store scalar data */
       store_tx_frame_scalar_data (copy_frame, tf);
       to = vlib_frame_vector_args (f);
-      n_free = VLIB_FRAME_SIZE;
+      n_free = f->max_vectors;
     }
 
   /*
@@ -480,21 +481,27 @@ enqueue_one_to_tx_node (vlib_main_t *vm, vlib_node_runtime_t *node, u32 *ppqi,
     }
   else
     {
-      /* full frame */
-      to = (u32 *) vlib_frame_vector_args (f) + f->n_vectors;
-      vlib_buffer_copy_indices (to, tmp, n_free);
-      vlib_put_next_frame (vm, node, next_index, 0);
+      /* full frame, spill into as many new frames as the tx node's
+       * vector length needs */
+      u32 n_done = 0, n;
 
-      /* second frame */
-      u32 n_2nd_frame = n_copy - n_free;
-      f = vlib_get_next_frame_internal (vm, node, next_index, 1);
-      tf = vlib_frame_scalar_args (f);
-      /* empty frame - store scalar data */
-      store_tx_frame_scalar_data (copy_frame, tf);
-      to = vlib_frame_vector_args (f);
-      vlib_buffer_copy_indices (to, tmp + n_free, n_2nd_frame);
-      vlib_put_next_frame (vm, node, next_index,
-			   VLIB_FRAME_SIZE - n_2nd_frame);
+      while (1)
+	{
+	  n = clib_min (n_free, n_copy - n_done);
+	  to = (u32 *) vlib_frame_vector_args (f) + f->n_vectors;
+	  vlib_buffer_copy_indices (to, tmp + n_done, n);
+	  vlib_put_next_frame (vm, node, next_index, n_free - n);
+	  n_done += n;
+
+	  if (n_done == n_copy)
+	    break;
+
+	  f = vlib_get_next_frame_internal (vm, node, next_index, 1);
+	  tf = vlib_frame_scalar_args (f);
+	  /* empty frame - store scalar data */
+	  store_tx_frame_scalar_data (copy_frame, tf);
+	  n_free = f->max_vectors;
+	}
     }
 
   return n_left - n_copy;
@@ -604,6 +611,10 @@ VLIB_NODE_FN (vnet_interface_output_node)
 	node->node_index, VNET_INTERFACE_OUTPUT_ERROR_INTERFACE_DOWN);
     }
 
+  if (PREDICT_FALSE (vnet_latency_main.enabled))
+    vnet_latency_record (vm, &vnet_latency_main.tx_latency, sw_if_index,
+			 bufs, n_buffers, 1 /* is_final */);
+
   if (hi->output_node_thread_runtimes)
     r = vec_elt_at_index (hi->output_node_thread_runtimes, vm->thread_index);
 
@@ -45,7 +45,8 @@
 /**
  * Global pool of IPv4 8bit PLYs
  */
-ip4_mtrie_8_ply_t *ip4_ply_pool;
+pool_seg_t ip4_ply_pool =
+  POOL_SEG_INIT_ALIGNED (ip4_mtrie_8_ply_t, CLIB_CACHE_LINE_BYTES, 4);
 
 always_inline u32
 ip4_mtrie_leaf_is_non_empty (ip4_mtrie_8_ply_t *p, u8 dst_byte)
@@ -115,24 +116,15 @@ static ip4_mtrie_leaf_t
 ply_create (ip4_mtrie_leaf_t init_leaf, u32 leaf_prefix_len, u32 ply_base_len)
 {
   ip4_mtrie_8_ply_t *p;
-  ip4_mtrie_leaf_t l;
-  u8 need_barrier_sync = pool_get_will_expand (ip4_ply_pool);
-  vlib_main_t *vm = vlib_get_main ();
-  ASSERT (vm->thread_index == 0);
-
-  if (need_barrier_sync)
-    vlib_worker_thread_barrier_sync (vm);
+  u32 pi;
+  ASSERT (vlib_get_thread_index () == 0);
 
-  /* Get cache aligned ply. */
-  pool_get_aligned (ip4_ply_pool, p, CLIB_CACHE_LINE_BYTES);
+  /* plies never move, the workers carry on looking up while it grows */
+  p = pool_seg_get (&ip4_ply_pool, &pi);
 
   ply_8_init (p, init_leaf, leaf_prefix_len, ply_base_len);
-  l = ip4_mtrie_leaf_set_next_ply_index (p - ip4_ply_pool);
-
-  if (need_barrier_sync)
-    vlib_worker_thread_barrier_release (vm);
 
-  return l;
+  return ip4_mtrie_leaf_set_next_ply_index (pi);
 }
 
 always_inline ip4_mtrie_8_ply_t *
@@ -140,7 +132,7 @@ get_next_ply_for_leaf (ip4_mtrie_leaf_t l)
 {
   uword n = ip4_mtrie_leaf_get_next_ply_index (l);
 
-  return pool_elt_at_index (ip4_ply_pool, n);
+  return pool_seg_elt_at_index (&ip4_ply_pool, n);
 }
 
 void
@@ -172,7 +164,8 @@ ip4_mtrie_8_free (ip4_mtrie_8_t *m)
    * the assumption being that the IP4 FIB table has emptied the trie
    * before deletion.
    */
-  ip4_mtrie_8_ply_t *root = pool_elt_at_index (ip4_ply_pool, m->root_ply);
+  ip4_mtrie_8_ply_t *root =
+    pool_seg_elt_at_index (&ip4_ply_pool, m->root_ply);
 
 #if CLIB_DEBUG > 0
   int i;
@@ -182,7 +175,7 @@ ip4_mtrie_8_free (ip4_mtrie_8_t *m)
     }
 #endif
 
-  pool_put (ip4_ply_pool, root);
+  pool_seg_put_index (&ip4_ply_pool, m->root_ply);
 }
 
 void
@@ -190,8 +183,7 @@ ip4_mtrie_8_init (ip4_mtrie_8_t *m)
 {
   ip4_mtrie_8_ply_t *root;
 
-  pool_get (ip4_ply_pool, root);
-  m->root_ply = root - ip4_ply_pool;
+  root = pool_seg_get (&ip4_ply_pool, &m->root_ply);
 
   ply_8_init (root, IP4_MTRIE_LEAF_EMPTY, 0, 0);
 }
@@ -247,7 +239,7 @@ set_leaf (const ip4_mtrie_set_unset_leaf_args_t *a, u32 old_ply_index,
   u8 dst_byte;
   ip4_mtrie_8_ply_t *old_ply;
 
-  old_ply = pool_elt_at_index (ip4_ply_pool, old_ply_index);
+  old_ply = pool_seg_elt_at_index (&ip4_ply_pool, old_ply_index);
 
   ASSERT (a->dst_address_length <= 32);
   ASSERT (dst_address_byte_index < ARRAY_LEN (a->dst_address.as_u8));
@@ -314,8 +306,8 @@ set_leaf (const ip4_mtrie_set_unset_leaf_args_t *a, u32 old_ply_index,
 	    {
 	      /* The current leaf is less specific and not termial (i.e. a ply),
 	       * recurse on down the trie */
-	      new_ply = get_next_ply_for_leaf (old_leaf);
-	      set_leaf (a, new_ply - ip4_ply_pool, dst_address_byte_index + 1);
+	      set_leaf (a, ip4_mtrie_leaf_get_next_ply_index (old_leaf),
+			dst_address_byte_index + 1);
 	    }
 	  /*
 	   * else
@@ -328,7 +320,6 @@ set_leaf (const ip4_mtrie_set_unset_leaf_args_t *a, u32 old_ply_index,
     {
       /* The address to insert requires us to move down at a lower level of
        * the trie - recurse on down */
-      ip4_mtrie_8_ply_t *new_ply;
       u8 ply_base_len;
 
       ply_base_len = 8 * (dst_address_byte_index + 1);
@@ -344,10 +335,6 @@ set_leaf (const ip4_mtrie_set_unset_leaf_args_t *a, u32 old_ply_index,
 	  new_leaf = ply_create (old_leaf,
 				 old_ply->dst_address_bits_of_leaves[dst_byte],
 				 ply_base_len);
-	  new_ply = get_next_ply_for_leaf (new_leaf);
-
-	  /* Refetch since ply_create may move pool. */
-	  old_ply = pool_elt_at_index (ip4_ply_pool, old_ply_index);
 
 	  clib_atomic_store_rel_n (&old_ply->leaves[dst_byte], new_leaf);
 	  old_ply->dst_address_bits_of_leaves[dst_byte] = ply_base_len;
@@ -357,9 +344,10 @@ set_leaf (const ip4_mtrie_set_unset_leaf_args_t *a, u32 old_ply_index,
 	  ASSERT (old_ply->n_non_empty_leafs >= 0);
 	}
       else
-	new_ply = get_next_ply_for_leaf (old_leaf);
+	new_leaf = old_leaf;
 
-      set_leaf (a, new_ply - ip4_ply_pool, dst_address_byte_index + 1);
+      set_leaf (a, ip4_mtrie_leaf_get_next_ply_index (new_leaf),
+		dst_address_byte_index + 1);
     }
 }
 
@@ -434,8 +422,7 @@ set_root_leaf (ip4_mtrie_16_t *m, const ip4_mtrie_set_unset_leaf_args_t *a)
 	    {
 	      /* The current leaf is less specific and not termial (i.e. a ply),
 	       * recurse on down the trie */
-	      new_ply = get_next_ply_for_leaf (old_leaf);
-	      set_leaf (a, new_ply - ip4_ply_pool, 2);
+	      set_leaf (a, ip4_mtrie_leaf_get_next_ply_index (old_leaf), 2);
 	    }
 	  /*
 	   * else
@@ -448,7 +435,6 @@ set_root_leaf (ip4_mtrie_16_t *m, const ip4_mtrie_set_unset_leaf_args_t *a)
     {
       /* The address to insert requires us to move down at a lower level of
        * the trie - recurse on down */
-      ip4_mtrie_8_ply_t *new_ply;
       u8 ply_base_len;
 
       ply_base_len = 16;
@@ -461,27 +447,29 @@ set_root_leaf (ip4_mtrie_16_t *m, const ip4_mtrie_set_unset_leaf_args_t *a)
 	  new_leaf = ply_create (old_leaf,
 				 old_ply->dst_address_bits_of_leaves[dst_byte],
 				 ply_base_len);
-	  new_ply = get_next_ply_for_leaf (new_leaf);
 
 	  clib_atomic_store_rel_n (&old_ply->leaves[dst_byte], new_leaf);
 	  old_ply->dst_address_bits_of_leaves[dst_byte] = ply_base_len;
 	}
       else
-	new_ply = get_next_ply_for_leaf (old_leaf);
+	new_leaf = old_leaf;
 
-      set_leaf (a, new_ply - ip4_ply_pool, 2);
+      set_leaf (a, ip4_mtrie_leaf_get_next_ply_index (new_leaf), 2);
     }
 }
 
 static uword
-unset_leaf (const ip4_mtrie_set_unset_leaf_args_t *a,
-	    ip4_mtrie_8_ply_t *old_ply, u32 dst_address_byte_index)
+unset_leaf (const ip4_mtrie_set_unset_leaf_args_t *a, u32 old_ply_index,
+	    u32 dst_address_byte_index)
 {
   ip4_mtrie_leaf_t old_leaf, del_leaf;
   i32 n_dst_bits_next_plies;
   i32 i, n_dst_bits_this_ply, old_leaf_is_terminal;
+  ip4_mtrie_8_ply_t *old_ply;
   u8 dst_byte;
 
+  old_ply = pool_seg_elt_at_index (&ip4_ply_pool, old_ply_index);
+
   ASSERT (a->dst_address_length <= 32);
   ASSERT (dst_address_byte_index < ARRAY_LEN (a->dst_address.as_u8));
 
@@ -505,7 +493,7 @@ unset_leaf (const ip4_mtrie_set_unset_leaf_args_t *a,
 
       if (old_leaf == del_leaf ||
 	  (!old_leaf_is_terminal &&
-	   unset_leaf (a, get_next_ply_for_leaf (old_leaf),
+	   unset_leaf (a, ip4_mtrie_leaf_get_next_ply_index (old_leaf),
 		       dst_address_byte_index + 1)))
 	{
 	  old_ply->n_non_empty_leafs -=
@@ -522,7 +510,7 @@ unset_leaf (const ip4_mtrie_set_unset_leaf_args_t *a,
 	  ASSERT (old_ply->n_non_empty_leafs >= 0);
 	  if (old_ply->n_non_empty_leafs == 0 && dst_address_byte_index > 0)
 	    {
-	      pool_put (ip4_ply_pool, old_ply);
+	      pool_seg_put_index (&ip4_ply_pool, old_ply_index);
 	      /* Old ply was deleted. */
 	      return 1;
 	    }
@@ -580,7 +568,7 @@ unset_root_leaf (ip4_mtrie_16_t *m, const ip4_mtrie_set_unset_leaf_args_t *a)
 
       if (old_leaf == del_leaf ||
 	  (!old_leaf_is_terminal &&
-	   unset_leaf (a, get_next_ply_for_leaf (old_leaf), 2)))
+	   unset_leaf (a, ip4_mtrie_leaf_get_next_ply_index (old_leaf), 2)))
 	{
 	  clib_atomic_store_rel_n (
 	    &old_ply->leaves[slot],
@@ -619,9 +607,7 @@ ip4_mtrie_8_route_add (ip4_mtrie_8_t *m, const ip4_address_t *dst_address,
   a.dst_address_length = dst_address_length;
   a.adj_index = adj_index;
 
-  ip4_mtrie_8_ply_t *root = pool_elt_at_index (ip4_ply_pool, m->root_ply);
-
-  set_leaf (&a, root - ip4_ply_pool, 0);
+  set_leaf (&a, m->root_ply, 0);
 }
 
 void
@@ -662,9 +648,7 @@ ip4_mtrie_8_route_del (ip4_mtrie_8_t *m, const ip4_address_t *dst_address,
   };
 
   /* the top level ply is never removed */
-  ip4_mtrie_8_ply_t *root = pool_elt_at_index (ip4_ply_pool, m->root_ply);
-
-  unset_leaf (&a, root, 0);
+  unset_leaf (&a, m->root_ply, 0);
 }
 
 /* Returns number of bytes of memory used by mtrie. */
@@ -703,7 +687,8 @@ ip4_mtrie_16_memory_usage (ip4_mtrie_16_t *m)
 uword
 ip4_mtrie_8_memory_usage (ip4_mtrie_8_t *m)
 {
-  ip4_mtrie_8_ply_t *root = pool_elt_at_index (ip4_ply_pool, m->root_ply);
+  ip4_mtrie_8_ply_t *root =
+    pool_seg_elt_at_index (&ip4_ply_pool, m->root_ply);
   uword bytes, i;
 
   bytes = sizeof (*m);
@@ -758,7 +743,7 @@ format_ip4_mtrie_ply (u8 *s, va_list *va)
   ip4_mtrie_8_ply_t *p;
   int i;
 
-  p = pool_elt_at_index (ip4_ply_pool, ply_index);
+  p = pool_seg_elt_at_index (&ip4_ply_pool, ply_index);
   s = format (s, "%Uply index %d, %d non-empty leaves",
 	      format_white_space, indent, ply_index, p->n_non_empty_leafs);
 
@@ -784,7 +769,8 @@ format_ip4_mtrie_16 (u8 *s, va_list *va)
   int i;
 
   s =
-    format (s, "16-8-8: %d plies, memory usage %U\n", pool_elts (ip4_ply_pool),
+    format (s, "16-8-8: %d plies, memory usage %U\n",
+	    pool_seg_elts (&ip4_ply_pool),
 	    format_memory_size, ip4_mtrie_16_memory_usage (m));
   p = &m->root_ply;
 
@@ -818,10 +804,10 @@ format_ip4_mtrie_8 (u8 *s, va_list *va)
   u32 base_address = 0;
   u16 slot;
 
-  root = pool_elt_at_index (ip4_ply_pool, m->root_ply);
+  root = pool_seg_elt_at_index (&ip4_ply_pool, m->root_ply);
 
   s = format (s, "8-8-8-8; %d plies, memory usage %U\n",
-	      pool_elts (ip4_ply_pool), format_memory_size,
+	      pool_seg_elts (&ip4_ply_pool), format_memory_size,
 	      ip4_mtrie_8_memory_usage (m));
 
   if (verbose)
@@ -849,11 +835,11 @@ format_ip4_mtrie_8 (u8 *s, va_list *va)
 static clib_error_t *
 ip4_mtrie_module_init (vlib_main_t * vm)
 {
-  CLIB_UNUSED (ip4_mtrie_8_ply_t * p);
   clib_error_t *error = NULL;
+  u32 pi;
 
   /* Burn one ply so index 0 is taken */
-  pool_get (ip4_ply_pool, p);
+  pool_seg_get (&ip4_ply_pool, &pi);
 
   return (error);
 }
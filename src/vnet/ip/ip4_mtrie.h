@@ -174,9 +174,10 @@ format_function_t format_ip4_mtrie_16;
 format_function_t format_ip4_mtrie_8;
 
 /**
- * @brief A global pool of 8bit stride plys
+ * @brief A global pool of 8bit stride plys. Plies never move, so it grows
+ * without stopping the workers.
  */
-extern ip4_mtrie_8_ply_t *ip4_ply_pool;
+extern pool_seg_t ip4_ply_pool;
 
 /**
  * Is the leaf terminal (i.e. an LB index) or non-terminal (i.e. a PLY index)
@@ -211,7 +212,7 @@ ip4_mtrie_16_lookup_step (ip4_mtrie_leaf_t current_leaf,
 
   if (!current_is_terminal)
     {
-      ply = ip4_ply_pool + (current_leaf >> 1);
+      ply = pool_seg_elt_at_index (&ip4_ply_pool, current_leaf >> 1);
       return (ply->leaves[dst_address->as_u8[dst_address_byte_index]]);
     }
 
@@ -243,7 +244,7 @@ ip4_mtrie_8_lookup_step (ip4_mtrie_leaf_t current_leaf,
 
   if (!current_is_terminal)
     {
-      ply = ip4_ply_pool + (current_leaf >> 1);
+      ply = pool_seg_elt_at_index (&ip4_ply_pool, current_leaf >> 1);
       return (ply->leaves[dst_address->as_u8[dst_address_byte_index]]);
     }
 
@@ -257,7 +258,7 @@ ip4_mtrie_8_lookup_step_one (const ip4_mtrie_8_t *m,
   ip4_mtrie_leaf_t next_leaf;
   ip4_mtrie_8_ply_t *ply;
 
-  ply = pool_elt_at_index (ip4_ply_pool, m->root_ply);
+  ply = pool_seg_elt_at_index (&ip4_ply_pool, m->root_ply);
   next_leaf = ply->leaves[dst_address->as_u8[0]];
 
   return next_leaf;
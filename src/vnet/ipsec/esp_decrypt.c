@@ -1108,15 +1108,15 @@ esp_decrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
   vnet_crypto_async_op_id_t async_op = ~0;
   vnet_crypto_async_frame_t *async_frames[VNET_CRYPTO_ASYNC_OP_N_IDS];
   esp_decrypt_error_t err;
+  u32 n_inline = 0;
+  u8 is_inline;
 
   vlib_get_buffers (vm, from, b, n_left);
-  if (!is_async)
-    {
-      vec_reset_length (ptd->crypto_ops);
-      vec_reset_length (ptd->integ_ops);
-      vec_reset_length (ptd->chained_crypto_ops);
-      vec_reset_length (ptd->chained_integ_ops);
-    }
+  /* inline decrypted packets take the sync path even in async mode */
+  vec_reset_length (ptd->crypto_ops);
+  vec_reset_length (ptd->integ_ops);
+  vec_reset_length (ptd->chained_crypto_ops);
+  vec_reset_length (ptd->chained_integ_ops);
   vec_reset_length (ptd->async_frames);
   vec_reset_length (ptd->chunks);
   clib_memset (sync_nexts, -1, sizeof (sync_nexts));
@@ -1127,6 +1127,7 @@ esp_decrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
       u8 *payload;
 
       err = ESP_DECRYPT_ERROR_RX_PKTS;
+      is_inline = 0;
       if (n_left > 2)
 	{
 	  u8 *p;
@@ -1251,7 +1252,24 @@ esp_decrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
       current_sa_pkts += 1;
       current_sa_bytes += vlib_buffer_length_in_chain (vm, b[0]);
 
-      if (is_async)
+      if (PREDICT_FALSE (b[0]->flags & VNET_BUFFER_F_IPSEC_INLINE))
+	{
+	  /* the device has already authenticated and decrypted the payload
+	   * in place, only the ESP header and trailer are left to strip */
+	  b[0]->flags &= ~VNET_BUFFER_F_IPSEC_INLINE;
+	  if (PREDICT_FALSE (pd->is_chain))
+	    {
+	      err = ESP_DECRYPT_ERROR_DECRYPTION_FAILED;
+	      esp_decrypt_set_next_index (b[0], node, thread_index, err,
+					  n_noop, noop_nexts,
+					  ESP_DECRYPT_NEXT_DROP,
+					  current_sa_index);
+	      goto next;
+	    }
+	  is_inline = 1;
+	  n_inline++;
+	}
+      else if (is_async)
 	{
 	  async_op = sa0->crypto_async_dec_op_id;
 
@@ -1297,7 +1315,7 @@ esp_decrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	  noop_bi[n_noop] = from[b - bufs];
 	  n_noop++;
 	}
-      else if (!is_async)
+      else if (!is_async || is_inline)
 	{
 	  sync_bi[n_sync] = from[b - bufs];
 	  sync_bufs[n_sync] = b[0];
@@ -1414,6 +1432,9 @@ esp_decrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 
   vlib_node_increment_counter (vm, node->node_index, ESP_DECRYPT_ERROR_RX_PKTS,
 			       from_frame->n_vectors);
+  if (n_inline)
+    vlib_node_increment_counter (vm, node->node_index,
+				 ESP_DECRYPT_ERROR_RX_INLINE, n_inline);
 
   if (n_sync)
     vlib_buffer_enqueue_to_next (vm, node, sync_bi, sync_nexts, n_sync);
@@ -57,6 +57,52 @@ ipsec_call_add_del_callbacks (ipsec_main_t * im, ipsec_sa_t * sa,
   return 0;
 }
 
+/*
+ * Offer an ESP SA to interfaces that can decrypt inline. SAs used by SPD
+ * policies carry no direction, so every ESP SA is offered and the device
+ * only acts on the SPIs it receives. An interface failing to install an SA
+ * is not an error, its packets are then decrypted in software as usual.
+ * Experimental: the packet-generator is the only such interface so far.
+ */
+static void
+ipsec_sa_inline_offload_one (vnet_main_t *vnm, vnet_hw_interface_t *hi,
+			     ipsec_sa_t *sa, int is_add)
+{
+  vnet_device_class_t *dc;
+
+  if (sa->protocol != IPSEC_PROTOCOL_ESP)
+    return;
+
+  if (!(hi->caps & VNET_HW_IF_CAP_IPSEC_INLINE))
+    return;
+
+  dc = vnet_get_device_class (vnm, hi->dev_class_index);
+  if (dc->ipsec_sa_dev_ops_function)
+    dc->ipsec_sa_dev_ops_function (vnm, hi->dev_instance, sa - ipsec_sa_pool,
+				   is_add);
+}
+
+static void
+ipsec_sa_inline_offload_add_del (ipsec_sa_t *sa, int is_add)
+{
+  vnet_main_t *vnm = vnet_get_main ();
+  vnet_hw_interface_t *hi;
+
+  pool_foreach (hi, vnm->interface_main.hw_interfaces)
+    ipsec_sa_inline_offload_one (vnm, hi, sa, is_add);
+}
+
+void
+ipsec_sa_inline_offload_interface_sync (u32 hw_if_index)
+{
+  vnet_main_t *vnm = vnet_get_main ();
+  vnet_hw_interface_t *hi = vnet_get_hw_interface (vnm, hw_if_index);
+  ipsec_sa_t *sa;
+
+  pool_foreach (sa, ipsec_sa_pool)
+    ipsec_sa_inline_offload_one (vnm, hi, sa, 1);
+}
+
 void
 ipsec_mk_key (ipsec_key_t * key, const u8 * data, u8 len)
 {
@@ -506,6 +552,8 @@ ipsec_sa_add_and_lock (u32 id, u32 spi, ipsec_protocol_t proto,
 
   hash_set (im->sa_index_by_sa_id, sa->id, sa_index);
 
+  ipsec_sa_inline_offload_add_del (sa, 1);
+
   if (sa_out_index)
     *sa_out_index = sa_index;
 
@@ -523,6 +571,8 @@ ipsec_sa_del (ipsec_sa_t * sa)
   hash_unset (im->sa_index_by_sa_id, sa->id);
   tunnel_unresolve (&sa->tunnel);
 
+  ipsec_sa_inline_offload_add_del (sa, 0);
+
   /* no recovery possible when deleting an SA */
   (void) ipsec_call_add_del_callbacks (im, sa, sa_index, 0);
 
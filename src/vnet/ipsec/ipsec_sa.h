@@ -307,6 +307,7 @@ extern void ipsec_sa_set_crypto_alg (ipsec_sa_t *sa,
 extern void ipsec_sa_set_integ_alg (ipsec_sa_t *sa,
 				    ipsec_integ_alg_t integ_alg);
 extern void ipsec_sa_set_async_mode (ipsec_sa_t *sa, int is_enabled);
+extern void ipsec_sa_inline_offload_interface_sync (u32 hw_if_index);
 
 typedef walk_rc_t (*ipsec_sa_walk_cb_t) (ipsec_sa_t *sa, void *ctx);
 extern void ipsec_sa_walk (ipsec_sa_walk_cb_t cd, void *ctx);
@@ -679,6 +679,65 @@ VLIB_CLI_COMMAND (pg_capture_cmd, static) = {
 };
 /* *INDENT-ON* */
 
+static clib_error_t *
+pg_ipsec_inline_cmd_fn (vlib_main_t *vm, unformat_input_t *input,
+			vlib_cli_command_t *cmd)
+{
+  pg_main_t *pg = &pg_main;
+  clib_error_t *error = 0;
+  vnet_main_t *vnm = vnet_get_main ();
+  unformat_input_t _line_input, *line_input = &_line_input;
+  vnet_hw_interface_t *hi = 0;
+  u32 hw_if_index;
+  u8 is_disable = 0;
+
+  if (!unformat_user (input, unformat_line_input, line_input))
+    return 0;
+
+  while (unformat_check_input (line_input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (line_input, "%U", unformat_vnet_hw_interface, vnm,
+		    &hw_if_index))
+	hi = vnet_get_hw_interface (vnm, hw_if_index);
+      else if (unformat (line_input, "disable"))
+	is_disable = 1;
+      else
+	{
+	  error = clib_error_create ("unknown input `%U'",
+				     format_unformat_error, line_input);
+	  goto done;
+	}
+    }
+
+  if (!hi)
+    {
+      error = clib_error_return (0, "Please specify interface name");
+      goto done;
+    }
+
+  if (hi->dev_class_index != pg_dev_class.index)
+    {
+      error =
+	clib_error_return (0, "Please specify packet-generator interface");
+      goto done;
+    }
+
+  pg_interface_enable_disable_ipsec_inline (
+    pool_elt_at_index (pg->interfaces, hi->dev_instance), !is_disable);
+
+done:
+  unformat_free (line_input);
+
+  return error;
+}
+
+VLIB_CLI_COMMAND (pg_ipsec_inline_cmd, static) = {
+  .path = "packet-generator ipsec-inline",
+  .short_help = "packet-generator ipsec-inline <interface name> [disable] "
+		"(experimental)",
+  .function = pg_ipsec_inline_cmd_fn,
+};
+
 static clib_error_t *
 create_pg_if_cmd_fn (vlib_main_t * vm,
 		     unformat_input_t * input, vlib_cli_command_t * cmd)
@@ -1721,6 +1721,9 @@ pg_generate_packets (vlib_node_runtime_t * node,
 	    vnet_buffer (b)->feature_arc_index = feature_arc_index;
 	  }
 
+      if (PREDICT_FALSE (pi->ipsec_inline_enabled))
+	pg_ipsec_inline_decrypt (vm, pi, to_next, n_this_frame);
+
       if (pi->gso_enabled || (s->buffer_flags & VNET_BUFFER_F_OFFLOAD))
 	{
 	  fill_buffer_offload_flags (vm, to_next, n_this_frame,
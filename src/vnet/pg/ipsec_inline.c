@@ -0,0 +1,263 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright (c) 2024 Cisco Systems, Inc.
+ */
+
+/*
+ * Software model of a NIC doing inline IPsec decryption. Inbound ESP SAs
+ * are handed to the interface through the device class SA ops; packets
+ * generated on the interface which match one of them are authenticated
+ * and decrypted in place before they enter the graph, the same way a
+ * device would deliver them.
+ *
+ * Experimental: this is the only implementation of the ipsec-inline
+ * capability, it exists to exercise the esp-decrypt side.
+ */
+
+#include <vlib/vlib.h>
+#include <vnet/vnet.h>
+#include <vnet/pg/pg.h>
+#include <vnet/ethernet/ethernet.h>
+#include <vnet/ip/ip4_packet.h>
+#include <vnet/ip/ip6_packet.h>
+#include <vnet/ipsec/ipsec_sa.h>
+#include <vnet/ipsec/esp.h>
+
+/* SAs are matched the way a device matches them, on SPI and outer
+ * destination address. Transport mode SAs carry no address and match on
+ * SPI alone, with an all zero destination. */
+typedef struct
+{
+  ip46_address_t dst;
+  u32 spi;
+} pg_ipsec_sa_key_t;
+
+static void
+pg_ipsec_sa_key_init (pg_ipsec_sa_key_t *key, ipsec_sa_t *sa)
+{
+  clib_memset (key, 0, sizeof (*key));
+  key->spi = sa->spi;
+
+  if (ipsec_sa_is_set_IS_TUNNEL_V6 (sa))
+    key->dst.ip6 = ip_addr_v6 (&sa->tunnel.t_dst);
+  else if (ipsec_sa_is_set_IS_TUNNEL (sa))
+    ip46_address_set_ip4 (&key->dst, &ip_addr_v4 (&sa->tunnel.t_dst));
+}
+
+int
+pg_ipsec_sa_add_del (vnet_main_t *vnm, u32 dev_instance, u32 sa_index,
+		     int is_add)
+{
+  pg_main_t *pg = &pg_main;
+  pg_interface_t *pi = pool_elt_at_index (pg->interfaces, dev_instance);
+  ipsec_sa_t *sa = ipsec_sa_get (sa_index);
+  pg_ipsec_sa_key_t key;
+  uword *p;
+
+  pg_ipsec_sa_key_init (&key, sa);
+
+  if (!pi->ipsec_sa_by_key)
+    pi->ipsec_sa_by_key = hash_create_mem (0, sizeof (key), sizeof (uword));
+
+  if (!is_add)
+    {
+      p = hash_get_mem (pi->ipsec_sa_by_key, &key);
+      if (!p || p[0] != sa_index)
+	return VNET_API_ERROR_NO_SUCH_ENTRY;
+      hash_unset_mem_free (&pi->ipsec_sa_by_key, &key);
+      return 0;
+    }
+
+  /* only the plain cipher + hmac combinations are modelled */
+  if (ipsec_sa_is_set_IS_AEAD (sa) || ipsec_sa_is_set_IS_CTR (sa) ||
+      ipsec_sa_is_set_USE_ESN (sa) || ipsec_sa_is_set_UDP_ENCAP (sa))
+    return VNET_API_ERROR_UNSUPPORTED;
+
+  if (hash_get_mem (pi->ipsec_sa_by_key, &key))
+    return VNET_API_ERROR_VALUE_EXIST;
+
+  hash_set_mem_alloc (&pi->ipsec_sa_by_key, &key, sa_index);
+  return 0;
+}
+
+static void
+pg_ipsec_sa_table_free (pg_interface_t *pi)
+{
+  hash_pair_t *hp;
+  void **keys = 0;
+
+  if (!pi->ipsec_sa_by_key)
+    return;
+
+  hash_foreach_pair (hp, pi->ipsec_sa_by_key, ({
+		       vec_add1 (keys, uword_to_pointer (hp->key, void *));
+		     }));
+  for (int i = 0; i < vec_len (keys); i++)
+    hash_unset_mem_free (&pi->ipsec_sa_by_key, keys[i]);
+  vec_free (keys);
+  hash_free (pi->ipsec_sa_by_key);
+}
+
+void
+pg_interface_enable_disable_ipsec_inline (pg_interface_t *pi, u8 enable)
+{
+  vnet_main_t *vnm = vnet_get_main ();
+
+  if (enable == pi->ipsec_inline_enabled)
+    return;
+
+  if (enable)
+    {
+      vnet_hw_if_set_caps (vnm, pi->hw_if_index, VNET_HW_IF_CAP_IPSEC_INLINE);
+      ipsec_sa_inline_offload_interface_sync (pi->hw_if_index);
+      pi->ipsec_inline_enabled = 1;
+    }
+  else
+    {
+      pi->ipsec_inline_enabled = 0;
+      vnet_hw_if_unset_caps (vnm, pi->hw_if_index,
+			     VNET_HW_IF_CAP_IPSEC_INLINE);
+      pg_ipsec_sa_table_free (pi);
+    }
+}
+
+static esp_header_t *
+pg_ipsec_inline_get_esp (vlib_buffer_t *b, pg_interface_mode_t mode,
+			 u16 *esp_len, ip46_address_t *dst)
+{
+  u8 *data = vlib_buffer_get_current (b);
+  u16 n_left = b->current_length;
+  u16 type;
+
+  if (b->flags & VLIB_BUFFER_NEXT_PRESENT)
+    return 0;
+
+  if (mode == PG_MODE_ETHERNET)
+    {
+      ethernet_header_t *e = (ethernet_header_t *) data;
+
+      if (n_left < sizeof (*e))
+	return 0;
+      type = clib_net_to_host_u16 (e->type);
+      data += sizeof (*e);
+      n_left -= sizeof (*e);
+    }
+  else
+    type = mode == PG_MODE_IP4 ? ETHERNET_TYPE_IP4 : ETHERNET_TYPE_IP6;
+
+  if (type == ETHERNET_TYPE_IP4)
+    {
+      ip4_header_t *ip4 = (ip4_header_t *) data;
+      u16 hdr_len;
+
+      if (n_left < sizeof (*ip4) || ip4->protocol != IP_PROTOCOL_IPSEC_ESP ||
+	  ip4_is_fragment (ip4))
+	return 0;
+      hdr_len = ip4_header_bytes (ip4);
+      if (clib_net_to_host_u16 (ip4->length) > n_left ||
+	  clib_net_to_host_u16 (ip4->length) < hdr_len)
+	return 0;
+      *esp_len = clib_net_to_host_u16 (ip4->length) - hdr_len;
+      ip46_address_set_ip4 (dst, &ip4->dst_address);
+      return (esp_header_t *) (data + hdr_len);
+    }
+
+  if (type == ETHERNET_TYPE_IP6)
+    {
+      ip6_header_t *ip6 = (ip6_header_t *) data;
+
+      if (n_left < sizeof (*ip6) || ip6->protocol != IP_PROTOCOL_IPSEC_ESP)
+	return 0;
+      *esp_len = clib_net_to_host_u16 (ip6->payload_length);
+      if (*esp_len > n_left - sizeof (*ip6))
+	return 0;
+      dst->ip6 = ip6->dst_address;
+      return (esp_header_t *) (ip6 + 1);
+    }
+
+  return 0;
+}
+
+static_always_inline int
+pg_ipsec_inline_decrypt_one (vlib_main_t *vm, pg_interface_t *pi,
+			     vlib_buffer_t *b)
+{
+  vnet_crypto_op_t _op, *op = &_op;
+  pg_ipsec_sa_key_t key = {};
+  esp_header_t *esp;
+  ipsec_sa_t *sa;
+  u16 len, icv_sz, iv_sz;
+  uword *p;
+
+  esp = pg_ipsec_inline_get_esp (b, pi->mode, &len, &key.dst);
+  if (!esp)
+    return 0;
+
+  /* tunnel SA for this destination first, then a transport one */
+  key.spi = clib_net_to_host_u32 (esp->spi);
+  p = hash_get_mem (pi->ipsec_sa_by_key, &key);
+  if (!p)
+    {
+      ip46_address_reset (&key.dst);
+      p = hash_get_mem (pi->ipsec_sa_by_key, &key);
+    }
+  if (!p)
+    return 0;
+
+  sa = ipsec_sa_get (p[0]);
+  icv_sz = sa->integ_icv_size;
+  iv_sz = sa->crypto_iv_size;
+
+  if (len < sizeof (*esp) + iv_sz + sizeof (esp_footer_t) + icv_sz)
+    return 0;
+  len -= icv_sz;
+
+  /* authenticate first, a failed check leaves the packet untouched for
+   * the software path to account for */
+  if (sa->integ_op_id != VNET_CRYPTO_OP_NONE)
+    {
+      vnet_crypto_op_init (op, sa->integ_op_id);
+      op->key_index = sa->integ_key_index;
+      op->flags = VNET_CRYPTO_OP_FLAG_HMAC_CHECK;
+      op->src = (u8 *) esp;
+      op->len = len;
+      op->digest = (u8 *) esp + len;
+      op->digest_len = icv_sz;
+      if (vnet_crypto_process_ops (vm, op, 1) != 1 ||
+	  op->status != VNET_CRYPTO_OP_STATUS_COMPLETED)
+	return 0;
+    }
+
+  if (sa->crypto_dec_op_id != VNET_CRYPTO_OP_NONE)
+    {
+      vnet_crypto_op_init (op, sa->crypto_dec_op_id);
+      op->key_index = sa->crypto_key_index;
+      op->iv = (u8 *) (esp + 1);
+      op->src = op->dst = op->iv + iv_sz;
+      op->len = len - sizeof (*esp) - iv_sz;
+      if (vnet_crypto_process_ops (vm, op, 1) != 1 ||
+	  op->status != VNET_CRYPTO_OP_STATUS_COMPLETED)
+	return 0;
+    }
+
+  b->flags |= VNET_BUFFER_F_IPSEC_INLINE;
+  return 1;
+}
+
+void
+pg_ipsec_inline_decrypt (vlib_main_t *vm, pg_interface_t *pi, u32 *buffers,
+			 u32 n_buffers)
+{
+  vlib_buffer_t *bufs[VLIB_FRAME_SIZE], **b = bufs;
+
+  if (hash_elts (pi->ipsec_sa_by_key) == 0)
+    return;
+
+  vlib_get_buffers (vm, buffers, bufs, n_buffers);
+
+  while (n_buffers)
+    {
+      pg_ipsec_inline_decrypt_one (vm, pi, b[0]);
+      b += 1;
+      n_buffers -= 1;
+    }
+}
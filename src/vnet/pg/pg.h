@@ -326,6 +326,11 @@ typedef struct
   pg_interface_mode_t mode;
 
   mac_address_t *allowed_mcast_macs;
+
+  /* Inline IPsec decryption (experimental): SPI and outer destination ->
+   * inbound SA index, see pg_ipsec_sa_key_t. */
+  u8 ipsec_inline_enabled;
+  uword *ipsec_sa_by_key;
 } pg_interface_t;
 
 /* Per VLIB node data. */
@@ -382,6 +387,13 @@ void pg_stream_enable_disable (pg_main_t * pg, pg_stream_t * s,
 void pg_interface_enable_disable_coalesce (pg_interface_t * pi, u8 enable,
 					   u32 tx_node_index);
 
+/* Enable/disable inline IPsec decryption on given interface */
+void pg_interface_enable_disable_ipsec_inline (pg_interface_t *pi, u8 enable);
+int pg_ipsec_sa_add_del (struct vnet_main_t *vnm, u32 dev_instance,
+			 u32 sa_index, int is_add);
+void pg_ipsec_inline_decrypt (vlib_main_t *vm, pg_interface_t *pi,
+			      u32 *buffers, u32 n_buffers);
+
 /* Find/create free packet-generator interface index. */
 u32 pg_interface_add_or_get (pg_main_t *pg, uword stream_index, u8 gso_enabled,
 			     u32 gso_size, u8 coalesce_enabled,
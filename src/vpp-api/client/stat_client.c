@@ -245,6 +245,7 @@ copy_data (vlib_stats_entry_t *ep, u32 index2, char *name,
       break;
 
     case STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE:
+    case STAT_DIR_TYPE_GAUGE_VECTOR:
       simple_c = stat_segment_adjust (sm, ep->data);
       result.simple_counter_vec = stat_vec_dup (sm, simple_c);
       for (i = 0; i < vec_len (simple_c); i++)
@@ -271,6 +272,46 @@ copy_data (vlib_stats_entry_t *ep, u32 index2, char *name,
 	}
       break;
 
+    case STAT_DIR_TYPE_HISTOGRAM_LOG2:
+    case STAT_DIR_TYPE_HISTOGRAM_LINEAR:
+      {
+	vlib_stats_histogram_t *h = stat_segment_adjust (sm, ep->data);
+	if (h == 0)
+	  break;
+	result.histogram = clib_mem_alloc (sizeof (*h));
+	*result.histogram = *h;
+	simple_c = stat_segment_adjust (sm, h->counters);
+	result.histogram->counters = stat_vec_dup (sm, simple_c);
+	for (i = 0; i < vec_len (simple_c); i++)
+	  {
+	    counter_t *cb = stat_segment_adjust (sm, simple_c[i]);
+	    if (index2 != ~0)
+	      {
+		/* Only the bins of the indexed histogram */
+		counter_t *v = 0;
+		vec_add (v, cb + index2 * h->n_bins, h->n_bins);
+		result.histogram->counters[i] = v;
+	      }
+	    else
+	      result.histogram->counters[i] = stat_vec_dup (sm, cb);
+	  }
+	simple_c = stat_segment_adjust (sm, h->sums);
+	result.histogram->sums = stat_vec_dup (sm, simple_c);
+	for (i = 0; i < vec_len (simple_c); i++)
+	  {
+	    counter_t *cb = stat_segment_adjust (sm, simple_c[i]);
+	    if (index2 != ~0)
+	      {
+		counter_t *v = 0;
+		vec_add1 (v, cb[index2]);
+		result.histogram->sums[i] = v;
+	      }
+	    else
+	      result.histogram->sums[i] = stat_vec_dup (sm, cb);
+	  }
+      }
+      break;
+
     case STAT_DIR_TYPE_NAME_VECTOR:
       {
 	uint8_t **name_vector = stat_segment_adjust (sm, ep->data);
@@ -302,37 +343,58 @@ copy_data (vlib_stats_entry_t *ep, u32 index2, char *name,
   return result;
 }
 
+static void
+stat_segment_data_free_one (stat_segment_data_t *res)
+{
+  int j;
+
+  switch (res->type)
+    {
+    case STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE:
+    case STAT_DIR_TYPE_GAUGE_VECTOR:
+      for (j = 0; j < vec_len (res->simple_counter_vec); j++)
+	vec_free (res->simple_counter_vec[j]);
+      vec_free (res->simple_counter_vec);
+      break;
+    case STAT_DIR_TYPE_COUNTER_VECTOR_COMBINED:
+      for (j = 0; j < vec_len (res->combined_counter_vec); j++)
+	vec_free (res->combined_counter_vec[j]);
+      vec_free (res->combined_counter_vec);
+      break;
+    case STAT_DIR_TYPE_HISTOGRAM_LOG2:
+    case STAT_DIR_TYPE_HISTOGRAM_LINEAR:
+      if (res->histogram == 0)
+	break;
+      for (j = 0; j < vec_len (res->histogram->counters); j++)
+	vec_free (res->histogram->counters[j]);
+      vec_free (res->histogram->counters);
+      for (j = 0; j < vec_len (res->histogram->sums); j++)
+	vec_free (res->histogram->sums[j]);
+      vec_free (res->histogram->sums);
+      clib_mem_free (res->histogram);
+      res->histogram = 0;
+      break;
+    case STAT_DIR_TYPE_NAME_VECTOR:
+      for (j = 0; j < vec_len (res->name_vector); j++)
+	vec_free (res->name_vector[j]);
+      vec_free (res->name_vector);
+      break;
+    case STAT_DIR_TYPE_ILLEGAL:
+    case STAT_DIR_TYPE_SCALAR_INDEX:
+    case STAT_DIR_TYPE_EMPTY:
+      break;
+    default:
+      assert (0);
+    }
+  free (res->name);
+}
+
 void
 stat_segment_data_free (stat_segment_data_t * res)
 {
-  int i, j;
+  int i;
   for (i = 0; i < vec_len (res); i++)
-    {
-      switch (res[i].type)
-	{
-	case STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE:
-	  for (j = 0; j < vec_len (res[i].simple_counter_vec); j++)
-	    vec_free (res[i].simple_counter_vec[j]);
-	  vec_free (res[i].simple_counter_vec);
-	  break;
-	case STAT_DIR_TYPE_COUNTER_VECTOR_COMBINED:
-	  for (j = 0; j < vec_len (res[i].combined_counter_vec); j++)
-	    vec_free (res[i].combined_counter_vec[j]);
-	  vec_free (res[i].combined_counter_vec);
-	  break;
-	case STAT_DIR_TYPE_NAME_VECTOR:
-	  for (j = 0; j < vec_len (res[i].name_vector); j++)
-	    vec_free (res[i].name_vector[j]);
-	  vec_free (res[i].name_vector);
-	  break;
-	case STAT_DIR_TYPE_SCALAR_INDEX:
-	case STAT_DIR_TYPE_EMPTY:
-	  break;
-	default:
-	  assert (0);
-	}
-      free (res[i].name);
-    }
+    stat_segment_data_free_one (res + i);
   vec_free (res);
 }
 
@@ -445,6 +507,351 @@ stat_segment_dump (uint32_t * stats)
   return stat_segment_dump_r (stats, sm);
 }
 
+stat_segment_delta_t *
+stat_segment_delta_new (uint8_t **patterns)
+{
+  stat_segment_delta_t *d = calloc (1, sizeof (*d));
+  regex_t *regex = 0;
+  int i;
+
+  vec_validate (regex, vec_len (patterns));
+  for (i = 0; i < vec_len (patterns); i++)
+    if (regcomp (&regex[i], (const char *) patterns[i], 0))
+      {
+	fprintf (stderr, "Could not compile regex %s\n", patterns[i]);
+	while (--i >= 0)
+	  regfree (&regex[i]);
+	vec_free (regex);
+	free (d);
+	return 0;
+      }
+
+  d->patterns = patterns;
+  d->regex = regex;
+  return d;
+}
+
+void
+stat_segment_delta_free (stat_segment_delta_t *d)
+{
+  regex_t *regex = d->regex;
+  int i;
+
+  for (i = 0; i < vec_len (d->patterns); i++)
+    regfree (&regex[i]);
+  vec_free (regex);
+  stat_segment_data_free (d->data);
+  vec_free (d->stats);
+  vec_free (d->entry_epochs);
+  vec_free (d->changed);
+  free (d);
+}
+
+static bool
+stat_segment_delta_match (stat_segment_delta_t *d, vlib_stats_entry_t *ep)
+{
+  regex_t *regex = d->regex;
+  int i;
+
+  if (vec_len (d->patterns) == 0)
+    return true;
+  for (i = 0; i < vec_len (d->patterns); i++)
+    if (regexec (&regex[i], ep->name, 0, NULL, 0) == 0)
+      return true;
+  return false;
+}
+
+/*
+ * Re-match the directory after its epoch moved. Entries which are still
+ * matched and whose own epoch did not move keep their snapshot, the rest
+ * get copied in full by the caller.
+ */
+static void
+stat_segment_delta_resolve (stat_segment_delta_t *d, stat_client_main_t *sm,
+			    uint64_t epoch)
+{
+  uint64_t *entry_epochs = stat_segment_adjust (
+    sm, (void *) sm->shared_header->entry_epochs);
+  stat_segment_data_t *data = 0;
+  uint64_t *copied = 0;
+  uint32_t *stats = 0;
+  uint32_t i, j = 0;
+
+  for (i = 0; i < vec_len (sm->directory_vector); i++)
+    {
+      stat_segment_data_t r = { 0 };
+      uint64_t e = 0;
+
+      if (!stat_segment_delta_match (d, sm->directory_vector + i))
+	continue;
+
+      while (j < vec_len (d->stats) && d->stats[j] < i)
+	stat_segment_data_free_one (d->data + j++);
+
+      if (j < vec_len (d->stats) && d->stats[j] == i)
+	{
+	  if (entry_epochs && i < vec_len (entry_epochs) &&
+	      entry_epochs[i] <= d->epoch)
+	    {
+	      r = d->data[j];
+	      e = d->entry_epochs[j];
+	    }
+	  else
+	    stat_segment_data_free_one (d->data + j);
+	  j++;
+	}
+
+      vec_add1 (stats, i);
+      vec_add1 (data, r);
+      vec_add1 (copied, e);
+    }
+
+  while (j < vec_len (d->stats))
+    stat_segment_data_free_one (d->data + j++);
+
+  vec_free (d->stats);
+  vec_free (d->data);
+  vec_free (d->entry_epochs);
+  d->stats = stats;
+  d->data = data;
+  d->entry_epochs = copied;
+  d->epoch = epoch;
+  d->resolved = 1;
+}
+
+static void
+stat_segment_delta_compare (stat_segment_delta_t *d, uint32_t entry,
+			    uint32_t thread, void *cached, void *src,
+			    uint32_t n_elts, uint32_t elt_size)
+{
+  stat_segment_delta_block_t *b;
+  uint32_t first, n;
+
+  for (first = 0; first < n_elts; first += STAT_SEGMENT_DELTA_BLOCK_SIZE)
+    {
+      n = n_elts - first;
+      if (n > STAT_SEGMENT_DELTA_BLOCK_SIZE)
+	n = STAT_SEGMENT_DELTA_BLOCK_SIZE;
+      if (memcmp (cached + first * elt_size, src + first * elt_size,
+		  n * elt_size) == 0)
+	continue;
+      memcpy (cached + first * elt_size, src + first * elt_size,
+	      n * elt_size);
+      vec_add2 (d->changed, b, 1);
+      b->entry = entry;
+      b->thread = thread;
+      b->first = first;
+      b->n_elts = n;
+    }
+}
+
+/*
+ * Compare per-thread vectors against the snapshot. With index2 set only
+ * the stride elements at index2 are looked at, as copy_data does for
+ * symlinks. Returns -1 if the shape changed and the entry needs a copy.
+ */
+static int
+stat_segment_delta_compare_threads (stat_segment_delta_t *d, uint32_t entry,
+				    stat_client_main_t *sm, void *data,
+				    void **cached, uint32_t elt_size,
+				    uint32_t index2, uint32_t stride)
+{
+  void **src = stat_segment_adjust (sm, data);
+  uint32_t i, n;
+
+  if (src == 0 || vec_len (src) != vec_len (cached))
+    return -1;
+
+  for (i = 0; i < vec_len (src); i++)
+    {
+      void *cb = stat_segment_adjust (sm, src[i]);
+
+      if (cb == 0)
+	return -1;
+      if (index2 == ~0)
+	{
+	  n = vec_len (cb);
+	  if (n != vec_len (cached[i]))
+	    return -1;
+	  stat_segment_delta_compare (d, entry, i, cached[i], cb, n, elt_size);
+	}
+      else
+	{
+	  if ((index2 + 1) * stride > vec_len (cb))
+	    return -1;
+	  stat_segment_delta_compare (d, entry, i, cached[i],
+				      cb + index2 * stride * elt_size, stride,
+				      elt_size);
+	}
+    }
+
+  return 0;
+}
+
+/*
+ * Histogram sums only move along with the bins, which are what is
+ * reported as changed, so they are refreshed without blocks of their own.
+ */
+static int
+stat_segment_delta_copy_sums (stat_client_main_t *sm,
+			      vlib_stats_histogram_t *h,
+			      stat_segment_data_t *r, uint32_t index2)
+{
+  counter_t **src = stat_segment_adjust (sm, h->sums);
+  counter_t **cached = r->histogram->sums;
+  uint32_t i;
+
+  if (src == 0 || vec_len (src) != vec_len (cached))
+    return -1;
+
+  for (i = 0; i < vec_len (src); i++)
+    {
+      counter_t *cb = stat_segment_adjust (sm, src[i]);
+
+      if (cb == 0)
+	return -1;
+      if (index2 == ~0)
+	{
+	  if (vec_len (cb) != vec_len (cached[i]))
+	    return -1;
+	  memcpy (cached[i], cb, vec_len (cb) * sizeof (counter_t));
+	}
+      else
+	{
+	  if (index2 >= vec_len (cb))
+	    return -1;
+	  cached[i][0] = cb[index2];
+	}
+    }
+
+  return 0;
+}
+
+static int
+stat_segment_delta_entry (stat_segment_delta_t *d, uint32_t entry,
+			  vlib_stats_entry_t *ep, stat_client_main_t *sm)
+{
+  stat_segment_data_t *r = d->data + entry;
+  stat_segment_delta_block_t *b;
+  vlib_stats_histogram_t *h;
+  uint32_t index2 = ~0;
+
+  if (ep->type == STAT_DIR_TYPE_SYMLINK)
+    {
+      index2 = ep->index2;
+      ep = vec_elt_at_index (sm->directory_vector, ep->index1);
+    }
+
+  if (ep->type != r->type)
+    return -1;
+
+  switch (ep->type)
+    {
+    case STAT_DIR_TYPE_SCALAR_INDEX:
+      if (r->scalar_value != ep->value)
+	{
+	  r->scalar_value = ep->value;
+	  vec_add2 (d->changed, b, 1);
+	  b->entry = entry;
+	  b->thread = 0;
+	  b->first = 0;
+	  b->n_elts = 1;
+	}
+      return 0;
+
+    case STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE:
+    case STAT_DIR_TYPE_GAUGE_VECTOR:
+      return stat_segment_delta_compare_threads (
+	d, entry, sm, ep->data, (void **) r->simple_counter_vec,
+	sizeof (counter_t), index2, 1);
+
+    case STAT_DIR_TYPE_COUNTER_VECTOR_COMBINED:
+      return stat_segment_delta_compare_threads (
+	d, entry, sm, ep->data, (void **) r->combined_counter_vec,
+	sizeof (vlib_counter_t), index2, 1);
+
+    case STAT_DIR_TYPE_HISTOGRAM_LOG2:
+    case STAT_DIR_TYPE_HISTOGRAM_LINEAR:
+      h = stat_segment_adjust (sm, ep->data);
+      if (h == 0 || r->histogram == 0)
+	return -1;
+      if (stat_segment_delta_compare_threads (
+	    d, entry, sm, h->counters, (void **) r->histogram->counters,
+	    sizeof (counter_t), index2, h->n_bins) < 0)
+	return -1;
+      return stat_segment_delta_copy_sums (sm, h, r, index2);
+
+    case STAT_DIR_TYPE_NAME_VECTOR:
+    case STAT_DIR_TYPE_EMPTY:
+      /* only change under the lock, and so with the entry epoch */
+      return 0;
+
+    default:
+      return -1;
+    }
+}
+
+/*
+ * Bring the snapshot up to date. Returns the number of changed blocks
+ * (now in d->changed), or -1 if the segment changed while reading; the
+ * caller should retry, and the retry reports the changes of both.
+ */
+int
+stat_segment_delta_update_r (stat_segment_delta_t *d, stat_client_main_t *sm)
+{
+  stat_segment_delta_block_t *b;
+  stat_segment_access_t sa;
+  vlib_stats_entry_t *ep;
+  uint32_t i;
+
+  /* Changes seen by failed updates are kept until one succeeds */
+  if (d->complete)
+    {
+      vec_reset_length (d->changed);
+      d->resolved = 0;
+      d->complete = 0;
+    }
+
+  if (stat_segment_access_start (&sa, sm))
+    return -1;
+
+  if (sa.epoch != d->epoch)
+    stat_segment_delta_resolve (d, sm, sa.epoch);
+
+  for (i = 0; i < vec_len (d->stats); i++)
+    {
+      ep = vec_elt_at_index (sm->directory_vector, d->stats[i]);
+
+      if (d->entry_epochs[i] &&
+	  stat_segment_delta_entry (d, i, ep, sm) == 0)
+	continue;
+
+      stat_segment_data_free_one (d->data + i);
+      d->data[i] = copy_data (ep, ~0, 0, sm, false);
+      d->entry_epochs[i] = sa.epoch;
+      vec_add2 (d->changed, b, 1);
+      b->entry = i;
+      b->thread = ~0;
+      b->first = 0;
+      b->n_elts = 0;
+    }
+
+  /* A torn read is fixed up by the next update, which re-resolves the
+     entries whose epoch moved and compares everything else again */
+  if (!stat_segment_access_end (&sa, sm))
+    return -1;
+
+  d->complete = 1;
+  return vec_len (d->changed);
+}
+
+int
+stat_segment_delta_update (stat_segment_delta_t *d)
+{
+  stat_client_main_t *sm = &stat_client_main;
+  return stat_segment_delta_update_r (d, sm);
+}
+
 /* Wrapper for accessing vectors from other languages */
 int
 stat_segment_vec_len (void *vec)
@@ -18,7 +18,7 @@
 #define included_stat_client_h
 
 #define STAT_VERSION_MAJOR     1
-#define STAT_VERSION_MINOR     2
+#define STAT_VERSION_MINOR     3
 
 #include <stdint.h>
 #include <unistd.h>
@@ -41,12 +41,42 @@ typedef struct
   {
     double scalar_value;
     counter_t *error_vector;
-    counter_t **simple_counter_vec;
+    counter_t **simple_counter_vec; /* also gauge vectors */
     vlib_counter_t **combined_counter_vec;
     uint8_t **name_vector;
+    vlib_stats_histogram_t *histogram; /* copy of the segment's, or 0 */
   };
 } stat_segment_data_t;
 
+/* Delta reads compare per-thread counters in blocks of this many */
+#define STAT_SEGMENT_DELTA_BLOCK_SIZE 64
+
+typedef struct
+{
+  uint32_t entry;  /* index into stat_segment_delta_t data */
+  uint32_t thread; /* ~0 if the whole entry was (re)copied */
+  uint32_t first;  /* first element of the block */
+  uint32_t n_elts;
+} stat_segment_delta_block_t;
+
+/*
+ * Snapshot of the entries matching a set of patterns, kept up to date by
+ * stat_segment_delta_update, which only re-resolves directory entries
+ * whose epoch moved and only copies counter blocks that changed.
+ */
+typedef struct
+{
+  uint8_t **patterns;
+  void *regex;
+  uint64_t epoch;	     /* directory epoch of the snapshot */
+  uint8_t resolved;	     /* last update re-resolved the directory */
+  uint8_t complete;	     /* last update succeeded */
+  uint32_t *stats;	     /* directory index of each entry */
+  uint64_t *entry_epochs;    /* epoch each entry was copied at */
+  stat_segment_data_t *data; /* the snapshot, parallel to stats */
+  stat_segment_delta_block_t *changed; /* changed by the last update */
+} stat_segment_delta_t;
+
 typedef struct
 {
   uint64_t current_epoch;
@@ -78,6 +108,12 @@ stat_segment_data_t *stat_segment_dump_entry_r (uint32_t index,
 stat_segment_data_t *stat_segment_dump_entry (uint32_t index);
 
 void stat_segment_data_free (stat_segment_data_t * res);
+
+stat_segment_delta_t *stat_segment_delta_new (uint8_t **patterns);
+int stat_segment_delta_update_r (stat_segment_delta_t *d,
+				 stat_client_main_t *sm);
+int stat_segment_delta_update (stat_segment_delta_t *d);
+void stat_segment_delta_free (stat_segment_delta_t *d);
 double stat_segment_heartbeat_r (stat_client_main_t * sm);
 double stat_segment_heartbeat (void);
 
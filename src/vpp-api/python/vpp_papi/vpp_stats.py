@@ -387,6 +387,42 @@ class SimpleList(list):
         return sum(self)
 
 
+class StatsHistogramList(list):
+    """Histograms 3-dimensional by thread by index by bin"""
+
+    def __init__(self, bounds):
+        self.bounds = bounds
+        self.sums = []
+        super().__init__()
+
+    def __getitem__(self, item):
+        """Supports partial numpy style 2d support. Slice by column [:,1]"""
+        if isinstance(item, int):
+            return list.__getitem__(self, item)
+        return HistogramList(
+            [row[item[1]] for row in self],
+            self.bounds,
+            [row[item[1]] for row in self.sums],
+        )
+
+
+class HistogramList(list):
+    """Bins of one histogram for all threads"""
+
+    def __init__(self, rows, bounds, sums):
+        self.bounds = bounds
+        self.sums = sums
+        super().__init__(rows)
+
+    def sum(self):
+        """Sum the bins over all threads"""
+        return [sum(b) for b in zip(*self)]
+
+    def sum_values(self):
+        """Sum of the recorded values over all threads"""
+        return sum(self.sums)
+
+
 class StatsEntry:
     """An individual stats entry"""
 
@@ -406,6 +442,10 @@ class StatsEntry:
             self.function = self.name
         elif stattype == 6:
             self.function = self.symlink
+        elif stattype == 7:
+            self.function = self.simple
+        elif stattype in (8, 9):
+            self.function = self.histogram
         else:
             self.function = self.illegal
 
@@ -441,6 +481,28 @@ class StatsEntry:
                 counter.append(get_string(stats, name[0]))
         return counter
 
+    HISTOGRAM_FMT = Struct("IIIIQQ")
+
+    def histogram(self, stats):
+        """Log2 or linear histogram"""
+        n_bins, base, width, _, counters, sums = self.HISTOGRAM_FMT.unpack_from(
+            stats.statseg, self.value - stats.base
+        )
+        if self.type == 8:
+            bounds = [1 << (base + i) for i in range(n_bins - 1)]
+        else:
+            bounds = [base + i * width for i in range(n_bins - 1)]
+        bounds.append(float("inf"))
+        counter = StatsHistogramList(bounds)
+        if counters == 0:
+            return counter
+        for threads in StatsVector(stats, counters, "P"):
+            bins = [v[0] for v in StatsVector(stats, threads[0], "Q")]
+            counter.append([bins[i : i + n_bins] for i in range(0, len(bins), n_bins)])
+        for threads in StatsVector(stats, sums, "P"):
+            counter.sums.append([v[0] for v in StatsVector(stats, threads[0], "Q")])
+        return counter
+
     SYMLINK_FMT1 = Struct("II")
     SYMLINK_FMT2 = Struct("Q")
 
@@ -70,6 +70,13 @@ stat_poll_loop (u8 ** patterns)
 			   j, res[i].simple_counter_vec[k][j], res[i].name);
 	      break;
 
+	    case STAT_DIR_TYPE_GAUGE_VECTOR:
+	      for (k = 0; k < vec_len (res[i].simple_counter_vec); k++)
+		for (j = 0; j < vec_len (res[i].simple_counter_vec[k]); j++)
+		  fformat (stdout, "[%d]: %llu %s\n", j,
+			   res[i].simple_counter_vec[k][j], res[i].name);
+	      break;
+
 	    case STAT_DIR_TYPE_COUNTER_VECTOR_COMBINED:
 	      for (k = 0; k < vec_len (res[i].simple_counter_vec); k++)
 		for (j = 0; j < vec_len (res[i].combined_counter_vec[k]); j++)
@@ -213,6 +220,30 @@ reconnect:
 			   res[i].name);
 	      break;
 
+	    case STAT_DIR_TYPE_GAUGE_VECTOR:
+	      if (res[i].simple_counter_vec == 0)
+		continue;
+	      for (k = 0; k < vec_len (res[i].simple_counter_vec); k++)
+		for (j = 0; j < vec_len (res[i].simple_counter_vec[k]); j++)
+		  fformat (stdout, "[%d @ %d]: %llu %s\n", j, k,
+			   res[i].simple_counter_vec[k][j], res[i].name);
+	      break;
+
+	    case STAT_DIR_TYPE_HISTOGRAM_LOG2:
+	    case STAT_DIR_TYPE_HISTOGRAM_LINEAR:
+	      {
+		vlib_stats_histogram_t *h = res[i].histogram;
+		for (k = 0; h && k < vec_len (h->counters); k++)
+		  for (j = 0; j < vec_len (h->counters[k]); j++)
+		    if (h->counters[k][j])
+		      fformat (stdout, "[%d @ %d]: %llu below %llu %s\n",
+			       j / h->n_bins, k, h->counters[k][j],
+			       vlib_stats_histogram_bin_bound (
+				 res[i].type, h, j % h->n_bins),
+			       res[i].name);
+	      }
+	      break;
+
 	    case STAT_DIR_TYPE_SCALAR_INDEX:
 	      fformat (stdout, "%.2f %s\n", res[i].scalar_value, res[i].name);
 	      break;
@@ -50,6 +50,50 @@ prom_string (char *s)
   return s;
 }
 
+static void
+print_histogram (FILE *stream, stat_segment_data_t *res)
+{
+  vlib_stats_histogram_t *h = res->histogram;
+  u64 *bins = 0, count, sum;
+  int i, j, k;
+
+  if (h == 0 || vec_len (h->counters) == 0 || h->n_bins == 0)
+    return;
+
+  vec_validate (bins, h->n_bins - 1);
+  fformat (stream, "# TYPE %s histogram\n", prom_string (res->name));
+
+  for (j = 0; j < vec_len (h->counters[0]) / h->n_bins; j++)
+    {
+      vec_zero (bins);
+      sum = 0;
+      for (k = 0; k < vec_len (h->counters); k++)
+	{
+	  for (i = 0; i < h->n_bins; i++)
+	    bins[i] += h->counters[k][j * h->n_bins + i];
+	  sum += h->sums[k][j];
+	}
+
+      count = 0;
+      for (i = 0; i < h->n_bins - 1; i++)
+	{
+	  count += bins[i];
+	  fformat (stream, "%s_bucket{index=\"%d\",le=\"%llu\"} %llu\n",
+		   prom_string (res->name), j,
+		   vlib_stats_histogram_bin_bound (res->type, h, i), count);
+	}
+      count += bins[h->n_bins - 1];
+      fformat (stream, "%s_bucket{index=\"%d\",le=\"+Inf\"} %llu\n",
+	       prom_string (res->name), j, count);
+      fformat (stream, "%s_sum{index=\"%d\"} %llu\n",
+	       prom_string (res->name), j, sum);
+      fformat (stream, "%s_count{index=\"%d\"} %llu\n",
+	       prom_string (res->name), j, count);
+    }
+
+  vec_free (bins);
+}
+
 static void
 print_metric_v1 (FILE *stream, stat_segment_data_t *res)
 {
@@ -81,6 +125,20 @@ print_metric_v1 (FILE *stream, stat_segment_data_t *res)
 		     res->combined_counter_vec[k][j].bytes);
 	  }
       break;
+    case STAT_DIR_TYPE_GAUGE_VECTOR:
+      fformat (stream, "# TYPE %s gauge\n", prom_string (res->name));
+      for (k = 0; k < vec_len (res->simple_counter_vec); k++)
+	for (j = 0; j < vec_len (res->simple_counter_vec[k]); j++)
+	  fformat (stream, "%s{thread=\"%d\",index=\"%d\"} %lld\n",
+		   prom_string (res->name), k, j,
+		   res->simple_counter_vec[k][j]);
+      break;
+
+    case STAT_DIR_TYPE_HISTOGRAM_LOG2:
+    case STAT_DIR_TYPE_HISTOGRAM_LINEAR:
+      print_histogram (stream, res);
+      break;
+
     case STAT_DIR_TYPE_SCALAR_INDEX:
       fformat (stream, "# TYPE %s counter\n", prom_string (res->name));
       fformat (stream, "%s %.2f\n", prom_string (res->name),
@@ -155,6 +213,7 @@ print_metric_v2 (FILE *stream, stat_segment_data_t *res)
   switch (res->type)
     {
     case STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE:
+    case STAT_DIR_TYPE_GAUGE_VECTOR:
       if (res->simple_counter_vec == 0)
 	return;
       for (k = 0; k < vec_len (res->simple_counter_vec); k++)
@@ -284,6 +343,11 @@ print_metric_v2 (FILE *stream, stat_segment_data_t *res)
 	}
       break;
 
+    case STAT_DIR_TYPE_HISTOGRAM_LOG2:
+    case STAT_DIR_TYPE_HISTOGRAM_LINEAR:
+      print_histogram (stream, res);
+      break;
+
     default:;
       fformat (stderr, "Unhandled type %d name %s\n", res->type, res->name);
     }
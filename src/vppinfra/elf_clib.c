@@ -238,7 +238,6 @@ add_section (struct dl_phdr_info *info, size_t size, void *opaque)
 	  clib_error ("failed to find %s on PATH", cem->exec_path);
 	  return 0;
 	}
-      addr = 0;
     }
 
   error = clib_elf_parse_file (cem, name, addr);
@@ -74,3 +74,43 @@ _pool_init_fixed (void **pool_ptr, uword elt_size, uword max_elts, uword align)
   *pool_ptr = v;
 }
 
+__clib_export void
+_pool_seg_grow (pool_seg_t *sp)
+{
+  uword n_elts = 1ULL << (sp->log2_first_seg + sp->n_segments);
+  uword *bm = 0;
+  void *seg;
+
+  if (sp->n_segments == POOL_SEG_N_SEGMENTS)
+    {
+      clib_warning ("can't expand segmented pool");
+      os_out_of_memory ();
+    }
+
+  seg = clib_mem_alloc_aligned (n_elts * sp->elt_sz, sp->align);
+  clib_mem_poison (seg, n_elts * sp->elt_sz);
+
+  clib_bitmap_alloc (bm, n_elts);
+
+  /* readers only see the segment once it is in the directory */
+  clib_atomic_store_rel_n (&sp->free_bitmaps[sp->n_segments], bm);
+  clib_atomic_store_rel_n (&sp->segments[sp->n_segments], seg);
+  sp->n_segments++;
+}
+
+__clib_export void
+pool_seg_free (pool_seg_t *sp)
+{
+  u32 i;
+
+  for (i = 0; i < sp->n_segments; i++)
+    {
+      uword n_bytes = (sp->elt_sz << sp->log2_first_seg) << i;
+      clib_mem_unpoison (sp->segments[i], n_bytes);
+      clib_mem_free (sp->segments[i]);
+      clib_bitmap_free (sp->free_bitmaps[i]);
+    }
+
+  vec_free (sp->free_indices);
+  clib_memset (sp, 0, sizeof (sp[0]));
+}
@@ -602,6 +602,220 @@ do {									\
   vec_free(_pool_var(dv));                              \
 }
 
+/** Segmented pools.
+
+    A pool whose element addresses never change. Storage is a fixed
+    directory of segments, segment k holding 2^(log2_first_seg + k)
+    elements, so growing the pool adds a segment and never moves an
+    existing one. Index to pointer is O(1): the segment is the most
+    significant bit of the biased index.
+
+    Each segment has its own free bitmap, allocated with it and never
+    resized, so other threads may look elements up, test indices and walk
+    the pool while the main thread adds to it, without a barrier. Get, put,
+    and the free index bookkeeping remain single writer.
+*/
+
+#define POOL_SEG_N_SEGMENTS 32
+
+typedef struct
+{
+  /** Segment directory, segment k is 2^(log2_first_seg + k) elements. */
+  void *segments[POOL_SEG_N_SEGMENTS];
+
+  /** Bitmap of free objects of each segment, sized with the segment. */
+  uword *free_bitmaps[POOL_SEG_N_SEGMENTS];
+
+  /** Vector of free indices.  One element for each set bit in bitmaps. */
+  u32 *free_indices;
+
+  /** One past the highest index ever allocated. */
+  u32 len;
+
+  /** Element size and alignment, in bytes. */
+  u32 elt_sz;
+  u32 align;
+
+  u8 log2_first_seg;
+  u8 n_segments;
+} pool_seg_t;
+
+/** Static initializer, for pools used before any init function runs. */
+#define POOL_SEG_INIT_ALIGNED(T, A, L)                                        \
+  {                                                                           \
+    .elt_sz = sizeof (T),                                                     \
+    .align = (A) > __alignof__(T) ? (A) : __alignof__(T),                     \
+    .log2_first_seg = (L),                                                    \
+  }
+
+void _pool_seg_grow (pool_seg_t *sp);
+
+/** Initialize a segmented pool of ELT_SZ byte elements. */
+always_inline void
+pool_seg_init (pool_seg_t *sp, uword elt_sz, uword align,
+	       uword log2_first_seg)
+{
+  ASSERT (log2_first_seg > 0 && log2_first_seg < POOL_SEG_N_SEGMENTS);
+
+  clib_memset (sp, 0, sizeof (sp[0]));
+  sp->elt_sz = elt_sz;
+  sp->align = clib_max (align, 1);
+  sp->log2_first_seg = log2_first_seg;
+}
+
+#define pool_seg_init_aligned(SP, T, A, L)                                    \
+  pool_seg_init (SP, sizeof (T), clib_max (A, __alignof__(T)), L)
+#define pool_seg_init_type(SP, T, L) pool_seg_init_aligned (SP, T, 0, L)
+
+/** Number of elements the current segments can hold. */
+always_inline uword
+pool_seg_capacity (pool_seg_t *sp)
+{
+  return ((1ULL << sp->n_segments) - 1) << sp->log2_first_seg;
+}
+
+/** Segment holding the given index, and the index within it. */
+static_always_inline uword
+pool_seg_index_split (pool_seg_t *sp, uword index, uword *offset)
+{
+  uword j = index + (1ULL << sp->log2_first_seg);
+  uword msb = min_log2 (j);
+
+  *offset = j - (1ULL << msb);
+  return msb - sp->log2_first_seg;
+}
+
+/** Returns pointer to element at given index. Safe on any thread. */
+static_always_inline void *
+pool_seg_elt_at_index (pool_seg_t *sp, uword index)
+{
+  uword seg, offset;
+  void *base;
+
+  ASSERT (index < sp->len);
+
+  seg = pool_seg_index_split (sp, index, &offset);
+  /* pairs with the release store in _pool_seg_grow */
+  base = clib_atomic_load_acq_n (&sp->segments[seg]);
+
+  return base + offset * sp->elt_sz;
+}
+
+always_inline int
+pool_seg_is_free_index (pool_seg_t *sp, uword index)
+{
+  uword seg, offset;
+
+  if (index >= clib_atomic_load_relax_n (&sp->len))
+    return 1;
+
+  seg = pool_seg_index_split (sp, index, &offset);
+  return clib_bitmap_get_no_check (
+    clib_atomic_load_acq_n (&sp->free_bitmaps[seg]), offset);
+}
+
+/** Number of active elements in a segmented pool. */
+always_inline uword
+pool_seg_elts (pool_seg_t *sp)
+{
+  return sp->len - vec_len (sp->free_indices);
+}
+
+always_inline int
+pool_seg_get_will_expand (pool_seg_t *sp)
+{
+  return vec_len (sp->free_indices) == 0 &&
+	 sp->len == pool_seg_capacity (sp);
+}
+
+/** Allocate an element, returning its pointer and index. */
+static_always_inline void *
+pool_seg_get (pool_seg_t *sp, u32 *index)
+{
+  uword n_free = vec_len (sp->free_indices);
+  uword seg, offset;
+  u32 i;
+  void *e;
+
+  if (n_free)
+    {
+      i = sp->free_indices[n_free - 1];
+      seg = pool_seg_index_split (sp, i, &offset);
+      clib_bitmap_set_no_check (sp->free_bitmaps[seg], offset, 0);
+      vec_set_len (sp->free_indices, n_free - 1);
+    }
+  else
+    {
+      if (sp->len == pool_seg_capacity (sp))
+	_pool_seg_grow (sp);
+      i = sp->len;
+      clib_atomic_store_rel_n (&sp->len, i + 1);
+    }
+
+  e = pool_seg_elt_at_index (sp, i);
+  clib_mem_unpoison (e, sp->elt_sz);
+
+  *index = i;
+  return e;
+}
+
+static_always_inline void *
+pool_seg_get_zero (pool_seg_t *sp, u32 *index)
+{
+  void *e = pool_seg_get (sp, index);
+  clib_memset_u8 (e, 0, sp->elt_sz);
+  return e;
+}
+
+/** Free the element at the given index. */
+static_always_inline void
+pool_seg_put_index (pool_seg_t *sp, uword index)
+{
+  uword seg, offset;
+
+  ASSERT (!pool_seg_is_free_index (sp, index));
+
+  seg = pool_seg_index_split (sp, index, &offset);
+  clib_bitmap_set_no_check (sp->free_bitmaps[seg], offset, 1);
+  vec_add1 (sp->free_indices, index);
+
+  clib_mem_poison (pool_seg_elt_at_index (sp, index), sp->elt_sz);
+}
+
+/** Free all segments, the pool must be re-initialized before reuse. */
+void pool_seg_free (pool_seg_t *sp);
+
+/** First active index at or after the given one, or one past the end. */
+always_inline uword
+pool_seg_next_index (pool_seg_t *sp, uword index)
+{
+  uword len = clib_atomic_load_acq_n (&sp->len);
+
+  while (index < len)
+    {
+      uword seg, offset, first, n;
+      uword *bm;
+
+      seg = pool_seg_index_split (sp, index, &offset);
+      bm = clib_atomic_load_acq_n (&sp->free_bitmaps[seg]);
+      first = ((1ULL << seg) - 1) << sp->log2_first_seg;
+      n = 1ULL << (sp->log2_first_seg + seg);
+
+      offset = clib_bitmap_next_clear (bm, offset);
+      if (offset < n)
+	return clib_min (first + offset, len);
+
+      index = first + n;
+    }
+
+  return len;
+}
+
+/** Iterate over the indices of the active elements. */
+#define pool_seg_foreach_index(i, sp)                                         \
+  for (i = pool_seg_next_index (sp, 0); i < (sp)->len;                        \
+       i = pool_seg_next_index (sp, i + 1))
+
 #endif /* included_pool_h */
 
 /*
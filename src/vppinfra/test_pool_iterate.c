@@ -16,6 +16,8 @@
 
 #include <vppinfra/mem.h>
 #include <vppinfra/pool.h>
+#include <vppinfra/random.h>
+#include <vppinfra/time.h>
 
 #ifdef __KERNEL__
 #include <linux/unistd.h>
@@ -23,6 +25,101 @@
 #include <unistd.h>
 #endif
 
+typedef struct
+{
+  u64 a, b;
+  u32 c;
+} test_pool_elt_t;
+
+/*
+ * Compare the segmented pool against a plain one: fill, random index
+ * lookups, and iteration, in clocks per element. Also checks that
+ * element addresses survive growth.
+ */
+static void
+test_pool_seg (u32 n_elts, u32 n_lookups)
+{
+  test_pool_elt_t *pool = 0, *e, **ptrs = 0;
+  pool_seg_t _sp, *sp = &_sp;
+  u32 *indices = 0, i, index, seed = 0xdeadbeef;
+  u64 t, sum = 0;
+
+  pool_seg_init_type (sp, test_pool_elt_t, 6);
+
+  t = clib_cpu_time_now ();
+  for (i = 0; i < n_elts; i++)
+    {
+      pool_get (pool, e);
+      e->c = i;
+    }
+  fformat (stdout, "pool_get:              %.2f clocks/elt\n",
+	   (f64) (clib_cpu_time_now () - t) / n_elts);
+
+  t = clib_cpu_time_now ();
+  for (i = 0; i < n_elts; i++)
+    {
+      e = pool_seg_get (sp, &index);
+      e->c = i;
+      vec_add1 (ptrs, e);
+    }
+  fformat (stdout, "pool_seg_get:          %.2f clocks/elt (%u segments)\n",
+	   (f64) (clib_cpu_time_now () - t) / n_elts, sp->n_segments);
+
+  for (i = 0; i < n_elts; i++)
+    if (pool_seg_elt_at_index (sp, i) != ptrs[i] || ptrs[i]->c != i)
+      clib_warning ("oops, element %d moved", i);
+
+  for (i = 0; i < n_lookups; i++)
+    vec_add1 (indices, random_u32 (&seed) % n_elts);
+
+  t = clib_cpu_time_now ();
+  for (i = 0; i < n_lookups; i++)
+    sum += pool_elt_at_index (pool, indices[i])->c;
+  fformat (stdout, "pool_elt_at_index:     %.2f clocks/lookup\n",
+	   (f64) (clib_cpu_time_now () - t) / n_lookups);
+
+  t = clib_cpu_time_now ();
+  for (i = 0; i < n_lookups; i++)
+    sum -= ((test_pool_elt_t *) pool_seg_elt_at_index (sp, indices[i]))->c;
+  fformat (stdout, "pool_seg_elt_at_index: %.2f clocks/lookup\n",
+	   (f64) (clib_cpu_time_now () - t) / n_lookups);
+
+  if (sum)
+    clib_warning ("oops, lookups disagree");
+
+  /* free every third element, iterate what is left */
+  for (i = 0; i < n_elts; i += 3)
+    {
+      pool_put_index (pool, i);
+      pool_seg_put_index (sp, i);
+    }
+
+  t = clib_cpu_time_now ();
+  pool_foreach (e, pool)
+    sum += e->c;
+  fformat (stdout, "pool_foreach:          %.2f clocks/elt\n",
+	   (f64) (clib_cpu_time_now () - t) / pool_elts (pool));
+
+  t = clib_cpu_time_now ();
+  pool_seg_foreach_index (index, sp)
+    sum -= ((test_pool_elt_t *) pool_seg_elt_at_index (sp, index))->c;
+  fformat (stdout, "pool_seg_foreach:      %.2f clocks/elt\n",
+	   (f64) (clib_cpu_time_now () - t) / pool_seg_elts (sp));
+
+  if (sum || pool_elts (pool) != pool_seg_elts (sp))
+    clib_warning ("oops, iteration disagrees");
+
+  /* freed indices are reused, in place */
+  e = pool_seg_get (sp, &index);
+  if (index % 3 || e != ptrs[index])
+    clib_warning ("oops, index %d not reused in place", index);
+
+  pool_free (pool);
+  pool_seg_free (sp);
+  vec_free (ptrs);
+  vec_free (indices);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -32,7 +129,7 @@ main (int argc, char *argv[])
   u32 *tp = 0;
   u32 *junk;
 
-  clib_mem_init (0, 64ULL << 20);
+  clib_mem_init (0, 256ULL << 20);
 
   for (i = 0; i < 70; i++)
     {
@@ -96,6 +193,8 @@ main (int argc, char *argv[])
   }
   /* *INDENT-ON* */
 
+  test_pool_seg (argc > 1 ? atoi (argv[1]) : 1 << 20, 1 << 22);
+
   return 0;
 }
 
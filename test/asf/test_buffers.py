@@ -27,3 +27,11 @@ class TestBuffers(VppAsfTestCase):
         if error:
             self.logger.critical(error)
             self.assertNotIn("failed", error)
+
+    def test_dev_rx_burst(self):
+        """Device RX Burst Helpers"""
+        error = self.vapi.cli("test dev rx-burst")
+
+        if error:
+            self.logger.critical(error)
+            self.assertNotIn("failed", error)
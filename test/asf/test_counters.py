@@ -2,6 +2,10 @@
 
 from asfframework import VppAsfTestCase, tag_fixme_vpp_workers
 
+STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE = 2
+STAT_DIR_TYPE_GAUGE_VECTOR = 7
+STAT_DIR_TYPE_HISTOGRAM_LINEAR = 9
+
 
 @tag_fixme_vpp_workers
 class TestCounters(VppAsfTestCase):
@@ -36,3 +40,43 @@ class TestCounters(VppAsfTestCase):
         if error:
             self.logger.critical(error)
             self.assertNotIn("failed", error)
+
+    def test_counter_gauge(self):
+        """Gauge Vector"""
+        # a gauge holds levels, the reader must see them go down too
+        for value in [100, 5]:
+            error = self.vapi.cli(f"test counter gauge publish value {value}")
+            self.assertNotIn("failed", error)
+            self.assertEqual(
+                self.statistics["/vlib/test-gauge"],
+                [[value, value + 1, value + 2]],
+            )
+        self.assertEqual(
+            self.statistics.directory["/vlib/test-gauge"].type,
+            STAT_DIR_TYPE_GAUGE_VECTOR,
+        )
+
+        # heap usage keeps its simple counter type
+        self.assertEqual(
+            self.statistics.directory["/mem/main heap"].type,
+            STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE,
+        )
+
+    def test_counter_histogram_linear(self):
+        """Linear Histogram"""
+        error = self.vapi.cli("test counter histogram publish")
+        self.assertNotIn("failed", error)
+        self.assertNotIn("expected", error)
+
+        h = self.statistics["/vlib/test-histogram-linear"]
+        self.assertEqual(
+            self.statistics.directory["/vlib/test-histogram-linear"].type,
+            STAT_DIR_TYPE_HISTOGRAM_LINEAR,
+        )
+        self.assertEqual(h.bounds, [10, 20, 30, 40, float("inf")])
+
+        # 0, 9, 10, 25, 39, 40 and 1000 recorded at index 1
+        self.assertEqual(h[:, 1].sum(), [2, 1, 1, 1, 2])
+        self.assertEqual(h[:, 1].sum_values(), 1123)
+        self.assertEqual(h[:, 0].sum(), [0] * 5)
+        self.assertEqual(h[:, 0].sum_values(), 0)
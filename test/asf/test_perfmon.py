@@ -1,6 +1,8 @@
 from asfframework import VppAsfTestCase, VppTestRunner
 from vpp_qemu_utils import can_create_namespaces
 from config import config
+from vpp_papi_provider import CliFailedCommandError
+import re
 import unittest
 
 
@@ -43,6 +45,62 @@ class TestPerfmon(VppAsfTestCase):
         self.vapi.cli("perfmon start bundle context-switches type thread")
         self.vapi.cli("perfmon stop")
 
+    def test_perfmon_profile(self):
+        """Sampling profiler attributes samples to nodes"""
+        reply = self.vapi.cli("perfmon profile start frequency 4999")
+        if "perf_event_open" in reply:
+            self.skipTest(f"no perf sampling events: {reply}")
+
+        # keep the main thread busy for a while
+        for i in range(20):
+            self.vapi.cli("show runtime")
+            self.vapi.cli("show node counters")
+        self.sleep(0.5)
+        self.vapi.cli("perfmon profile stop")
+
+        reply = self.vapi.cli("show perfmon profile thread 0")
+        self.logger.info(reply)
+        m = re.search(r"samples (\d+) unknown (\d+)", reply)
+        self.assertIsNotNone(m)
+        n_samples, n_unknown = int(m.group(1)), int(m.group(2))
+        self.assertGreater(n_samples, 0)
+        self.assertGreater(n_samples, n_unknown)
+
+        # attributed samples are counted per node in the stats segment
+        samples = self.statistics["/perfmon/profile/samples"]
+        self.assertEqual(sum(samples[0]), n_samples - n_unknown)
+
+        # and every folded stack starts with its thread and node
+        stacks = self.vapi.cli("show perfmon profile thread 0 folded")
+        lines = stacks.splitlines()
+        self.assertGreater(len(lines), 0)
+        for line in lines:
+            self.assertRegex(line, r"^vpp_main;\[[^]]+\].* \d+$")
+        self.assertTrue(any(";[unknown]" not in line for line in lines))
+
+    def test_perfmon_analyze(self):
+        """Top-down node analysis runs its bundles back to back"""
+        bundles = self.vapi.cli("show perfmon bundle")
+        if "td-level1" not in bundles or "td-level2-backend" not in bundles:
+            self.skipTest("top-down bundles not supported on this cpu")
+
+        with self.assertRaises(CliFailedCommandError):
+            self.vapi.cli("perfmon analyze duration 0")
+
+        try:
+            reply = self.vapi.cli("perfmon analyze duration 0.2 top 5")
+        except CliFailedCommandError as e:
+            self.skipTest(f"no per node counters: {e}")
+        self.logger.info(reply)
+
+        self.assertIn("Nodes by cycles lost to stalls and waste", reply)
+        self.assertNotIn("bundle 'td-level1'", reply)
+        self.assertNotIn("bundle 'td-level2-backend'", reply)
+
+        # the bundles were stopped again
+        reply = self.vapi.cli("show perfmon active-bundle")
+        self.assertNotIn("td-level", reply)
+
 
 if __name__ == "__main__":
     unittest.main(testRunner=VppTestRunner)
@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+
+import unittest
+
+from asfframework import VppAsfTestCase, VppTestRunner
+
+GAUGE = "vpp_vlib_test_gauge"
+HISTOGRAM = "vpp_vlib_test_histogram_linear"
+
+
+class TestProm(VppAsfTestCase):
+    """Prometheus exporter"""
+
+    def setUp(self):
+        super(TestProm, self).setUp()
+        self.vapi.cli("test counter gauge publish value 100")
+        self.vapi.cli("test counter histogram publish")
+        self.vapi.cli("prom enable min-scrape-interval 0 stat-patterns /vlib/test-")
+
+    def tearDown(self):
+        self.vapi.cli("prom full-scrape")
+        super(TestProm, self).tearDown()
+
+    def metrics(self, scrape):
+        """split a scrape in the lines of each metric"""
+        metrics = {}
+        for line in scrape.splitlines():
+            if line.startswith("# TYPE "):
+                name = line.split()[2]
+                metrics[name] = []
+            elif line:
+                metrics[name].append(line)
+        return metrics
+
+    def rerendered(self):
+        """metrics re-rendered by the last delta scrape"""
+        show = self.vapi.cli("show prom").splitlines()
+        [n] = [
+            int(line.split()[-1]) for line in show if "last scrape re-rendered" in line
+        ]
+        names = set(line.strip() for line in show if line.startswith("    "))
+        self.assertEqual(len(names), n)
+        return names
+
+    def scrape(self):
+        """delta scrape, checked against a full scrape of the same state"""
+        delta = self.vapi.cli("show prom scrape")
+        full = self.vapi.cli("show prom scrape full")
+        self.assertEqual(delta, full)
+        return self.metrics(delta)
+
+    def test_prom_delta_scrape(self):
+        """Prometheus delta scrape"""
+        self.vapi.cli("prom delta-scrape")
+
+        # the first scrape renders every entry
+        before = self.scrape()
+        self.assertEqual(set(before), {GAUGE, HISTOGRAM})
+        self.assertEqual(self.rerendered(), {GAUGE, HISTOGRAM})
+        self.assertIn(GAUGE + '{thread="0",index="0"} 100', before[GAUGE])
+
+        # nothing changed, nothing is rendered again
+        self.assertEqual(self.scrape(), before)
+        self.assertEqual(self.rerendered(), set())
+
+        # only the entry whose values changed is rendered again
+        self.vapi.cli("test counter gauge publish value 5")
+        after = self.scrape()
+        self.assertEqual(self.rerendered(), {GAUGE})
+        self.assertIn(GAUGE + '{thread="0",index="0"} 5', after[GAUGE])
+        self.assertNotEqual(after[GAUGE], before[GAUGE])
+        self.assertEqual(after[HISTOGRAM], before[HISTOGRAM])
+
+
+if __name__ == "__main__":
+    unittest.main(testRunner=VppTestRunner)
@@ -1,10 +1,16 @@
 #!/usr/bin/env python3
 
+import os
 import unittest
 
+from scapy.layers.l2 import Ether
+from scapy.layers.inet import IP, ICMP
+from scapy.packet import Raw
+
 from asfframework import VppAsfTestCase, VppTestRunner
 
 from vpp_vhost_interface import VppVhostInterface
+from vhost_user_frontend import VhostUserFrontend
 
 
 class TesVhostInterface(VppAsfTestCase):
@@ -141,5 +147,80 @@ class TesVhostInterface(VppAsfTestCase):
         vhost_if.remove_vpp_config()
 
 
+class TestVhostUserTraffic(VppAsfTestCase):
+    """Vhost User traffic test case"""
+
+    # a software DMA helper thread, so copies complete asynchronously
+    extra_vpp_config = ["cpu", "{", "dma-sw", "1", "}"]
+
+    guest_mac = "02:fe:00:00:00:02"
+    guest_ip4 = "10.10.1.2"
+    vpp_ip4 = "10.10.1.1"
+
+    def _test_vhost_ping(self, use_dma=False):
+        sock = os.path.join(self.tempdir, "vhost-user.sock")
+        cli = f"create vhost-user socket {sock} server"
+        if use_dma:
+            cli += " use-dma"
+        ifname = self.vapi.cli(cli).strip()
+        self.vapi.cli(f"set int state {ifname} up")
+        self.vapi.cli(f"set int ip addr {ifname} {self.vpp_ip4}/24")
+        self.vapi.cli(f"set ip neighbor {ifname} {self.guest_ip4} {self.guest_mac}")
+        [sw_if] = [
+            i for i in self.vapi.sw_interface_dump() if i.interface_name == ifname
+        ]
+        vpp_mac = str(sw_if.l2_address)
+
+        guest = VhostUserFrontend(sock)
+        guest.connect()
+        self.sleep(0.2)
+        show = self.vapi.cli("show vhost-user")
+        if use_dma:
+            self.assertIn("DMA copies enable, config", show)
+
+        # large payloads are copied into the guest by the DMA engine, small
+        # ones stay on the cpu
+        for size in [64, 1000]:
+            pkts = [
+                Ether(src=self.guest_mac, dst=vpp_mac)
+                / IP(src=self.guest_ip4, dst=self.vpp_ip4)
+                / ICMP(id=1, seq=i)
+                / Raw(b"x" * size)
+                for i in range(64)
+            ]
+            guest.send(pkts)
+            rxs = guest.recv(len(pkts))
+            self.assertEqual(len(rxs), len(pkts))
+            for rx in rxs:
+                rx = Ether(rx)
+                self.assertEqual(rx[ICMP].type, 0)  # echo-reply
+                self.assertEqual(rx[Raw].load, b"x" * size)
+
+        # disconnect with replies still being copied, the copies must
+        # complete before the guest memory is unmapped
+        guest.send(
+            [
+                Ether(src=self.guest_mac, dst=vpp_mac)
+                / IP(src=self.guest_ip4, dst=self.vpp_ip4)
+                / ICMP(id=1, seq=i)
+                / Raw(b"x" * 1000)
+                for i in range(128)
+            ]
+        )
+        guest.close()
+        self.sleep(0.2)
+        self.assertIn("Memory regions (total 0)", self.vapi.cli("show vhost-user"))
+
+        self.vapi.delete_vhost_user_if(sw_if.sw_if_index)
+
+    def test_vhost_ping(self):
+        """Vhost User ping"""
+        self._test_vhost_ping()
+
+    def test_vhost_ping_dma(self):
+        """Vhost User ping with DMA copies to the guest"""
+        self._test_vhost_ping(use_dma=True)
+
+
 if __name__ == "__main__":
     unittest.main(testRunner=VppTestRunner)
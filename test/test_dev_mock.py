@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+
+import time
+import unittest
+
+from framework import VppTestCase
+from asfframework import VppTestRunner
+
+
+class TestDevMock(VppTestCase):
+    """Software NIC driver for the device framework"""
+
+    @classmethod
+    def setUpClass(cls):
+        super(TestDevMock, cls).setUpClass()
+
+    @classmethod
+    def tearDownClass(cls):
+        super(TestDevMock, cls).tearDownClass()
+
+    def tearDown(self):
+        self.vapi.cli("device detach mock/0")
+        super(TestDevMock, self).tearDown()
+
+    def create(self, args):
+        self.vapi.cli("device attach mock/0 driver mock")
+        self.vapi.cli(
+            "device create-interface mock/0 port 0 num-rx-queues 2 args %s" % args
+        )
+        for i in self.vapi.sw_interface_dump():
+            if i.interface_name.startswith("mock0"):
+                return i
+        self.fail("mock interface not created")
+
+    def rx_packets(self, sw_if_index):
+        return self.statistics["/if/rx"][:, sw_if_index].sum_packets()
+
+    def test_dev_mock_rx(self):
+        """Synthetic traffic is received on every rx queue"""
+        i = self.create("flows=64")
+        self.vapi.cli("trace add %s-rx 10" % i.interface_name)
+        self.vapi.cli("set interface state %s up" % i.interface_name)
+        time.sleep(0.5)
+        self.vapi.cli("set interface state %s down" % i.interface_name)
+
+        self.assertGreater(self.rx_packets(i.sw_if_index), 0)
+
+        reply = self.vapi.cli("show device")
+        self.logger.info(reply)
+        self.assertEqual(reply.count("32 flows steered here"), 2)
+
+        reply = self.vapi.cli("show trace")
+        self.assertIn("IP4_CSUM_OK L4_CSUM_OK", reply)
+        self.assertIn("UDP: 10.0.0.", reply)
+
+        self.vapi.cli("device remove-interface %s" % i.interface_name)
+
+    def test_dev_mock_rate(self):
+        """Offered load follows the configured packet rate"""
+        i = self.create("pps=1000")
+        self.vapi.cli("set interface rx-mode %s interrupt" % i.interface_name)
+        start = time.time()
+        self.vapi.cli("set interface state %s up" % i.interface_name)
+        time.sleep(1)
+        self.vapi.cli("set interface state %s down" % i.interface_name)
+        elapsed = time.time() - start
+
+        n = self.rx_packets(i.sw_if_index)
+        self.assertGreater(n, 0)
+        self.assertLessEqual(n, 1000 * elapsed + 2)
+
+        self.vapi.cli("device remove-interface %s" % i.interface_name)
+
+
+if __name__ == "__main__":
+    unittest.main(testRunner=VppTestRunner)
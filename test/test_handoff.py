@@ -0,0 +1,203 @@
+#!/usr/bin/env python3
+
+import re
+import socket
+import struct
+import unittest
+
+from scapy.layers.inet import IP, UDP, TCP, ICMP
+from scapy.layers.inet6 import IPv6
+from scapy.layers.l2 import Ether
+from scapy.packet import Raw
+from framework import VppTestCase
+from asfframework import VppTestRunner
+from vpp_ip_route import VppIpRoute, VppRoutePath
+
+# default RSS key, the one from the RSS verification suite
+RSS_KEY = bytes.fromhex(
+    "6d5a56da255b0ec24167253d43a38fb0d0ca2bcbae7b30b477cb2da38030f20c"
+    "6a42b73bbeac01fa"
+)
+
+# (src, sport, dst, dport, hash with ports, hash of addresses only)
+RSS_VECTORS_IP4 = [
+    ("66.9.149.187", 2794, "161.142.100.80", 1766, 0x51CCC178, 0x323E8FC2),
+    ("199.92.111.2", 14230, "65.69.140.83", 4739, 0xC626B0EA, 0xD718262A),
+    ("24.19.198.95", 12898, "12.22.207.184", 38024, 0x5C2B394A, 0xD2D0A5DE),
+    ("38.27.205.30", 48228, "209.142.163.6", 2217, 0xAFC7327F, 0x82989176),
+    ("153.39.163.191", 44251, "202.188.127.2", 1303, 0x10E828A2, 0x5D1809C5),
+]
+RSS_VECTORS_IP6 = [
+    (
+        "3ffe:2501:200:1fff::7",
+        2794,
+        "3ffe:2501:200:3::1",
+        1766,
+        0x40207D3D,
+        0x2CC18CD5,
+    ),
+]
+
+RETA_SIZE = 8
+N_FLOWS = 64
+
+
+def toeplitz(key, data):
+    k = int.from_bytes(key, "big")
+    n = len(key) * 8
+    h = 0
+    for i in range(len(data) * 8):
+        if data[i // 8] & (0x80 >> (i % 8)):
+            h ^= (k >> (n - 32 - i)) & 0xFFFFFFFF
+    return h
+
+
+class TestHandoffRss(VppTestCase):
+    """Worker handoff with software RSS"""
+
+    vpp_worker_count = 2
+
+    def setUp(self):
+        super(TestHandoffRss, self).setUp()
+
+        self.create_pg_interfaces(range(2))
+        for i in self.pg_interfaces:
+            i.admin_up()
+            i.config_ip4()
+            i.resolve_arp()
+            i.config_ip6()
+            i.resolve_ndp()
+
+        self.vapi.cli(
+            "set interface handoff pg0 workers 0-1 rss reta-size %d" % RETA_SIZE
+        )
+
+    def tearDown(self):
+        self.vapi.cli("set interface handoff pg0 workers 0-1 disable")
+        for i in self.pg_interfaces:
+            i.unconfig_ip4()
+            i.unconfig_ip6()
+            i.admin_down()
+        super(TestHandoffRss, self).tearDown()
+
+    def worker_tx(self):
+        tx = self.statistics.get_counter("/if/tx")
+        return [
+            tx[w + 1][self.pg1.sw_if_index]["packets"]
+            for w in range(self.vpp_worker_count)
+        ]
+
+    def trace_hashes(self):
+        trace = self.vapi.cli("show trace max 1000")
+        return set(int(h, 16) for h in re.findall(r"hash 0x([0-9a-f]{8})", trace))
+
+    def flows(self):
+        return [
+            (
+                Ether(src=self.pg0.remote_mac, dst=self.pg0.local_mac)
+                / IP(src=self.pg0.remote_ip4, dst=self.pg1.remote_ip4)
+                / UDP(sport=1024 + i, dport=5000)
+                / Raw(b"\xa5" * 100)
+            )
+            for i in range(N_FLOWS)
+        ]
+
+    def flow_hash(self, p):
+        t = socket.inet_aton(p[IP].src) + socket.inet_aton(p[IP].dst)
+        t += struct.pack("!HH", p[UDP].sport, p[UDP].dport)
+        return toeplitz(RSS_KEY, t)
+
+    def send_and_count(self, pkts, reta):
+        """send pkts and check each worker forwarded the packets the
+        redirection table maps to it"""
+        expected = [0] * self.vpp_worker_count
+        for p in pkts:
+            expected[reta[self.flow_hash(p) % RETA_SIZE]] += 1
+
+        before = self.worker_tx()
+        self.send_and_expect(self.pg0, pkts, self.pg1, worker=0)
+        after = self.worker_tx()
+
+        self.assertEqual([a - b for a, b in zip(after, before)], expected)
+        return expected
+
+    def set_reta(self, first, last, worker):
+        self.vapi.cli(
+            "set interface handoff reta pg0 entry %d-%d worker %d"
+            % (first, last, worker)
+        )
+
+    def test_rss_verification_vectors(self):
+        """Handoff RSS hash matches the verification vectors"""
+        pkts = []
+        expected = set()
+        for src, sport, dst, dport, h_l4, h_ip in RSS_VECTORS_IP4:
+            hdr = Ether(src=self.pg0.remote_mac, dst=self.pg0.local_mac) / IP(
+                src=src, dst=dst
+            )
+            pkts.append(hdr / TCP(sport=sport, dport=dport) / Raw(b"\xa5" * 64))
+            pkts.append(hdr / ICMP() / Raw(b"\xa5" * 64))
+            expected |= {h_l4, h_ip}
+        for src, sport, dst, dport, h_l4, h_ip in RSS_VECTORS_IP6:
+            hdr = Ether(src=self.pg0.remote_mac, dst=self.pg0.local_mac) / IPv6(
+                src=src, dst=dst
+            )
+            pkts.append(hdr / UDP(sport=sport, dport=dport) / Raw(b"\xa5" * 64))
+            # no next header, hashed over the addresses only
+            pkts.append(hdr / Raw(b"\xa5" * 64))
+            expected |= {h_l4, h_ip}
+
+        # and the reference implementation the other tests rely on agrees
+        for src, sport, dst, dport, h_l4, h_ip in RSS_VECTORS_IP4:
+            t = socket.inet_aton(src) + socket.inet_aton(dst)
+            self.assertEqual(toeplitz(RSS_KEY, t), h_ip)
+            self.assertEqual(
+                toeplitz(RSS_KEY, t + struct.pack("!HH", sport, dport)), h_l4
+            )
+
+        # forward everything to pg1 so the test knows when it is done
+        VppIpRoute(
+            self, "0.0.0.0", 0, [VppRoutePath(self.pg1.remote_ip4, 0xFFFFFFFF)]
+        ).add_vpp_config()
+        VppIpRoute(
+            self, "::", 0, [VppRoutePath(self.pg1.remote_ip6, 0xFFFFFFFF)]
+        ).add_vpp_config()
+
+        self.vapi.cli("clear trace")
+        self.send_and_expect(self.pg0, pkts, self.pg1, worker=0)
+        self.assertEqual(self.trace_hashes(), expected)
+
+    def test_rss_reta(self):
+        """Handoff RSS spreads flows per the redirection table"""
+        pkts = self.flows() * 4
+
+        # the default table alternates between the workers
+        reta = [i % self.vpp_worker_count for i in range(RETA_SIZE)]
+        expected = self.send_and_count(pkts, reta)
+        self.assertNotIn(0, expected)
+
+        # steer every entry to the second worker
+        self.set_reta(0, RETA_SIZE - 1, 1)
+        reta = [1] * RETA_SIZE
+        reply = self.vapi.cli("show interface handoff")
+        self.assertIn("reta    0: " + " ".join(["%2u" % w for w in reta]), reply)
+        self.assertEqual(self.send_and_count(pkts, reta), [0, len(pkts)])
+
+        # and split the table in halves
+        self.set_reta(0, RETA_SIZE // 2 - 1, 0)
+        reta = [0] * (RETA_SIZE // 2) + [1] * (RETA_SIZE // 2)
+        reply = self.vapi.cli("show interface handoff")
+        self.assertIn("reta    0: " + " ".join(["%2u" % w for w in reta]), reply)
+        expected = self.send_and_count(pkts, reta)
+        self.assertNotIn(0, expected)
+
+        # entries out of range are refused and change nothing
+        reply = self.vapi.cli(
+            "set interface handoff reta pg0 entry 0-%d worker 0" % RETA_SIZE
+        )
+        self.assertIn("out of range", reply)
+        self.assertEqual(self.send_and_count(pkts, reta), expected)
+
+
+if __name__ == "__main__":
+    unittest.main(testRunner=VppTestRunner)
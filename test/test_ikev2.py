@@ -46,8 +46,7 @@ GCM_IV_SIZE = 8
 # tuple structure is (p, g, key_len)
 DH = {
     "2048MODPgr": (
-        long_converter(
-            """
+        long_converter("""
     FFFFFFFF FFFFFFFF C90FDAA2 2168C234 C4C6628B 80DC1CD1
     29024E08 8A67CC74 020BBEA6 3B139B22 514A0879 8E3404DD
     EF9519B3 CD3A431B 302B0A6D F25F1437 4FE1356D 6D51C245
@@ -58,14 +57,12 @@ DH = {
     670C354E 4ABC9804 F1746C08 CA18217C 32905E46 2E36CE3B
     E39E772C 180E8603 9B2783A2 EC07A28F B5C55DF0 6F4C52C9
     DE2BCBF6 95581718 3995497C EA956AE5 15D22618 98FA0510
-    15728E5A 8AACAA68 FFFFFFFF FFFFFFFF"""
-        ),
+    15728E5A 8AACAA68 FFFFFFFF FFFFFFFF"""),
         2,
         256,
     ),
     "3072MODPgr": (
-        long_converter(
-            """
+        long_converter("""
     FFFFFFFF FFFFFFFF C90FDAA2 2168C234 C4C6628B 80DC1CD1
     29024E08 8A67CC74 020BBEA6 3B139B22 514A0879 8E3404DD
     EF9519B3 CD3A431B 302B0A6D F25F1437 4FE1356D 6D51C245
@@ -81,8 +78,7 @@ DH = {
     ABF5AE8C DB0933D7 1E8C94E0 4A25619D CEE3D226 1AD2EE6B
     F12FFA06 D98A0864 D8760273 3EC86A64 521F2B18 177B200C
     BBE11757 7A615D6C 770988C0 BAD946E2 08E24FA0 74E5AB31
-    43DB5BFC E0FD108E 4B82D120 A93AD2CA FFFFFFFF FFFFFFFF"""
-        ),
+    43DB5BFC E0FD108E 4B82D120 A93AD2CA FFFFFFFF FFFFFFFF"""),
         2,
         384,
     ),
@@ -666,14 +662,14 @@ class IkePeer(VppTestCase):
         )
 
     def create_packet(
-        self, src_if, msg, sport=500, dport=500, natt=False, use_ip6=False
+        self, src_if, msg, sport=500, dport=500, natt=False, use_ip6=False, src_ip=None
     ):
         if use_ip6:
-            src_ip = src_if.remote_ip6
+            src_ip = src_ip or src_if.remote_ip6
             dst_ip = src_if.local_ip6
             ip_layer = IPv6
         else:
-            src_ip = src_if.remote_ip4
+            src_ip = src_ip or src_if.remote_ip4
             dst_ip = src_if.local_ip4
             ip_layer = IP
         res = (
@@ -1281,7 +1277,7 @@ class TemplateResponder(IkePeer):
         capture = self.pg0.get_capture(1)
         self.verify_del_sa(capture[0])
 
-    def send_sa_init_req(self):
+    def create_sa_init_req(self, src_ip=None):
         tr_attr = self.sa.ike_crypto_attr()
         trans = (
             ikev2.IKEv2_payload_Transform(
@@ -1322,7 +1318,7 @@ class TemplateResponder(IkePeer):
             if self.sa.i_natt:
                 src_address = b"\x0a\x0a\x0a\x01"
             else:
-                src_address = inet_pton(socket.AF_INET, self.pg0.remote_ip4)
+                src_address = inet_pton(socket.AF_INET, src_ip or self.pg0.remote_ip4)
 
             if self.sa.r_natt:
                 dst_address = b"\x0a\x0a\x0a\x0a"
@@ -1341,14 +1337,18 @@ class TemplateResponder(IkePeer):
                 self.sa.init_req_packet / nat_src_detection / nat_dst_detection
             )
 
-        ike_msg = self.create_packet(
+        return self.create_packet(
             self.pg0,
             self.sa.init_req_packet,
             self.sa.sport,
             self.sa.dport,
             self.sa.natt,
             self.ip6,
+            src_ip,
         )
+
+    def send_sa_init_req(self):
+        ike_msg = self.create_sa_init_req()
         self.pg0.add_stream(ike_msg)
         self.pg0.enable_capture()
         self.pg_start()
@@ -1448,7 +1448,7 @@ class TemplateResponder(IkePeer):
             plain = ids / plain
         return plain, first_payload
 
-    def send_sa_auth(self):
+    def create_sa_auth(self, src_ip=None):
         plain, first_payload = self.generate_auth_payload(last_payload="Notify")
         plain = plain / ikev2.IKEv2_payload_Notify(type="INITIAL_CONTACT")
         header = ikev2.IKEv2(
@@ -1460,9 +1460,18 @@ class TemplateResponder(IkePeer):
         )
 
         ike_msg = self.encrypt_ike_msg(header, plain, first_payload)
-        packet = self.create_packet(
-            self.pg0, ike_msg, self.sa.sport, self.sa.dport, self.sa.natt, self.ip6
+        return self.create_packet(
+            self.pg0,
+            ike_msg,
+            self.sa.sport,
+            self.sa.dport,
+            self.sa.natt,
+            self.ip6,
+            src_ip,
         )
+
+    def send_sa_auth(self):
+        packet = self.create_sa_auth()
         self.pg0.add_stream(packet)
         self.pg0.enable_capture()
         self.pg_start()
@@ -2186,6 +2195,121 @@ class TestResponderRekeyRepeatKEX(TestResponderRekeyRepeat):
     WITH_KEX = True
 
 
+class TestResponderWorkerPool(TestResponderPsk):
+    """test ikev2 responder - worker pool"""
+
+    vpp_worker_count = 2
+    N_TUNNELS = 32
+
+    def config_tc(self):
+        self.vapi.ikev2_set_worker_pool(enable=True)
+        self.config_params()
+
+    def tearDown(self):
+        super(TestResponderWorkerPool, self).tearDown()
+        self.vapi.ikev2_set_worker_pool(enable=False)
+
+    def new_sa(self, i_id):
+        sa = IKEv2SA(
+            self,
+            i_id=i_id,
+            r_id=self.idr,
+            spi=os.urandom(8),
+            id_type=self.p.local_id["id_type"],
+            auth_data=b"$3cr3tpa$$w0rd",
+            local_ts=self.p.remote_ts,
+            remote_ts=self.p.local_ts,
+        )
+        sa.set_ike_props(
+            crypto="AES-CBC",
+            crypto_key_len=32,
+            integ="HMAC-SHA1-96",
+            prf="PRF_HMAC_SHA2_256",
+            dh="2048MODPgr",
+        )
+        sa.set_esp_props(crypto="AES-CBC", crypto_key_len=32, integ="HMAC-SHA1-96")
+        sa.generate_dh_data()
+        return sa
+
+    def new_peer_profile(self, i):
+        p = Profile(self, "pr-scale-%d" % i)
+        p.add_auth(method="shared-key", data=b"$3cr3tpa$$w0rd")
+        p.add_local_id(id_type="fqdn", data=self.idr)
+        p.add_remote_id(id_type="fqdn", data=b"roadwarrior%d.example.com" % i)
+        p.add_local_ts(start_addr="10.10.10.0", end_addr="10.10.10.255")
+        p.add_remote_ts(start_addr="10.0.0.0", end_addr="10.0.0.255")
+        p.add_vpp_config()
+        return p
+
+    def test_responder(self):
+        """responder on a worker, pool locked while SAs exist"""
+        # the pool can only be toggled while no IKE SA exists
+        self.send_sa_init_req()
+        with self.vapi.assert_negative_api_retval():
+            self.vapi.ikev2_set_worker_pool(enable=False)
+        self.send_sa_auth()
+        self.verify_ipsec_sas()
+        self.verify_ike_sas()
+        self.verify_counters()
+
+        # the IKE SA is owned by a worker, not the main thread
+        r = self.vapi.ikev2_sa_dump()
+        self.assertNotEqual(r[0].sa.sa_index >> 16, 0)
+
+    def test_responder_scale(self):
+        """establish tunnels with many peers at once"""
+        # peer 0 is the default one, torn down by tearDown, the others
+        # each get their own address, identity and profile
+        self.pg0.generate_remote_hosts(self.N_TUNNELS)
+        self.pg0.configure_ipv4_neighbors()
+        profiles = [self.new_peer_profile(i) for i in range(1, self.N_TUNNELS)]
+        peers = [(self.sa, self.pg0.remote_ip4)]
+        for i in range(1, self.N_TUNNELS):
+            sa = self.new_sa(b"roadwarrior%d.example.com" % i)
+            peers.append((sa, self.pg0.remote_hosts[i].ip4))
+        by_ispi = {sa.ispi: (sa, ip) for sa, ip in peers}
+        default_sa = self.sa
+
+        start = time.time()
+        # every IKE_SA_INIT goes out in one burst, then every IKE_AUTH
+        for step, verify in (
+            (self.create_sa_init_req, self.verify_sa_init),
+            (self.create_sa_auth, self.verify_sa_auth_resp),
+        ):
+            pkts = []
+            for self.sa, ip in peers:
+                pkts.append(step(src_ip=ip))
+            self.pg0.add_stream(pkts)
+            self.pg0.enable_capture()
+            self.pg_start()
+            for rx in self.pg0.get_capture(self.N_TUNNELS):
+                self.sa, ip = by_ispi[self.get_ike_header(rx).init_SPI]
+                self.assertEqual(rx[IP].dst, ip)
+                verify(rx)
+        elapsed = time.time() - start
+        self.sa = default_sa
+        self.logger.info(
+            "%d tunnels established in %.3fs (%.1f/s)"
+            % (self.N_TUNNELS, elapsed, self.N_TUNNELS / elapsed)
+        )
+
+        # all the SAs coexist and are spread over the workers by peer
+        r = self.vapi.ikev2_sa_dump()
+        self.assertEqual(len(r), self.N_TUNNELS)
+        self.assertEqual(set(x.sa.ispi.to_bytes(8, "big") for x in r), set(by_ispi))
+        threads = set(x.sa.sa_index >> 16 for x in r)
+        self.assertNotIn(0, threads)
+        self.assertEqual(len(threads), self.vpp_worker_count)
+        self.assertEqual(len(self.vapi.ipsec_sa_dump()), 2 * self.N_TUNNELS)
+        self.assert_counter(2 * self.N_TUNNELS, "processed")
+
+        # removing a profile tears its SAs down, leave only peer 0
+        for p in profiles:
+            p.remove_vpp_config()
+        self.assertEqual(len(self.vapi.ikev2_sa_dump()), 1)
+        self.verify_ipsec_sas()
+
+
 @tag_fixme_ubuntu2204
 @tag_fixme_debian11
 class TestResponderVrf(TestResponderPsk, Ikev2Params):
@@ -2269,7 +2393,6 @@ class Test_IKE_AES_CBC_128_SHA256_128_MODP2048_ESP_AES_CBC_192_SHA_384_192(
 class TestAES_CBC_128_SHA256_128_MODP3072_ESP_AES_GCM_16(
     TemplateResponder, Ikev2Params
 ):
-
     """
     IKE:AES_CBC_128_SHA256_128,DH=modp3072 ESP:AES_GCM_16
     """
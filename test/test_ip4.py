@@ -1,6 +1,8 @@
 #!/usr/bin/env python3
+import os
 import random
 import socket
+import time
 import unittest
 
 from scapy.contrib.mpls import MPLS
@@ -9,6 +11,7 @@ from scapy.layers.inet import IP, UDP, TCP, ICMP, icmptypes, icmpcodes
 from scapy.layers.inet6 import IPv6
 from scapy.layers.l2 import Ether, Dot1Q, ARP
 from scapy.packet import Raw
+from scapy.utils import wrpcap
 from six import moves
 
 from framework import VppTestCase
@@ -788,6 +791,137 @@ class TestIPv4FibCrud(VppTestCase):
         self.verify_not_in_route_dump(self.deleted_routes)
 
 
+class TestIPv4FibChurnWorkers(VppTestCase):
+    """FIB - route churn with workers forwarding
+
+    Load-balance, adjacency and uRPF pools grow, and load-balances
+    are updated and freed, while the workers are switching through
+    them, without the barrier.
+    """
+
+    vpp_worker_count = 2
+    N_ROUTES = 512
+    N_TRAFFIC = 100000
+    TRAFFIC_PPS = 20000
+
+    def setUp(self):
+        super(TestIPv4FibChurnWorkers, self).setUp()
+
+        self.create_pg_interfaces(range(2))
+
+        for i in self.pg_interfaces:
+            i.admin_up()
+            i.config_ip4()
+            i.resolve_arp()
+
+        self.pg1.generate_remote_hosts(8)
+        self.pg1.configure_ipv4_neighbors()
+
+    def tearDown(self):
+        super(TestIPv4FibChurnWorkers, self).tearDown()
+        for i in self.pg_interfaces:
+            i.unconfig_ip4()
+            i.admin_down()
+
+    def paths(self, n):
+        return [
+            VppRoutePath(self.pg1.remote_hosts[h].ip4, self.pg1.sw_if_index)
+            for h in range(n)
+        ]
+
+    def stream(self, routes):
+        return [
+            (
+                Ether(dst=self.pg0.local_mac, src=self.pg0.remote_mac)
+                / IP(src=self.pg0.remote_ip4, dst=str(r.prefix.network_address))
+                / UDP(sport=1234 + ii, dport=1234)
+                / Raw(b"\xa5" * 100)
+            )
+            for ii, r in enumerate(routes)
+        ]
+
+    def start_traffic(self, routes):
+        """Start a paced stream on each worker, running during the churn"""
+        for w in range(self.vpp_worker_count):
+            pcap = os.path.join(self.tempdir, "churn%d.pcap" % w)
+            wrpcap(pcap, self.stream(routes))
+            self.vapi.cli(
+                "packet-generator new pcap %s source pg0 name churn%d "
+                "limit %d rate %d worker %d"
+                % (pcap, w, self.N_TRAFFIC, self.TRAFFIC_PPS, w)
+            )
+        self.vapi.cli("packet-generator enable")
+
+    def stop_traffic(self):
+        deadline = time.time() + 60
+        while "Yes" in self.vapi.cli("show packet-generator"):
+            self.assertLess(time.time(), deadline)
+            self.sleep(0.1)
+        for w in range(self.vpp_worker_count):
+            self.vapi.cli("packet-generator delete churn%d" % w)
+
+    def worker_tx(self):
+        tx = self.statistics.get_counter("/if/tx")
+        return [
+            tx[w + 1][self.pg1.sw_if_index]["packets"]
+            for w in range(self.vpp_worker_count)
+        ]
+
+    def test_fib_churn(self):
+        """IP4 route add/update/delete with workers"""
+
+        routes = []
+        for ii in range(self.N_ROUTES):
+            r = VppIpRoute(self, "10.%d.%d.1" % (ii >> 8, ii & 0xFF), 32, self.paths(1))
+            r.add_vpp_config()
+            routes.append(r)
+
+        self.send_and_expect(self.pg0, self.stream(routes), self.pg1)
+
+        #
+        # the workers forward through the routes for the whole churn below,
+        # so they are switching through load-balances as they are updated
+        # and freed
+        #
+        before = self.worker_tx()
+        self.start_traffic(routes)
+
+        #
+        # grow each load-balance beyond its inline buckets, then shrink
+        # it back; the replaced bucket arrays are released later
+        #
+        for r in routes:
+            r.modify(self.paths(8))
+        for r in routes:
+            r.modify(self.paths(2))
+
+        #
+        # delete half, the freed indices are reused by the re-adds
+        #
+        for r in routes[::2]:
+            r.remove_vpp_config()
+        for r in routes[::2]:
+            r.add_vpp_config()
+
+        self.stop_traffic()
+        after = self.worker_tx()
+        for w in range(self.vpp_worker_count):
+            self.assertGreater(after[w], before[w])
+
+        #
+        # and everything still forwards, or not, as configured
+        #
+        self.send_and_expect(self.pg0, self.stream(routes), self.pg1)
+
+        for r in routes[::2]:
+            r.remove_vpp_config()
+        self.send_and_assert_no_replies(self.pg0, self.stream(routes[::2]))
+        self.send_and_expect(self.pg0, self.stream(routes[1::2]), self.pg1)
+
+        for r in routes[1::2]:
+            r.remove_vpp_config()
+
+
 class TestIPNull(VppTestCase):
     """IPv4 routes via NULL"""
 
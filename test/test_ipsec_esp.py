@@ -825,6 +825,114 @@ class TestIpsecEspAsync(TemplateIpsecEsp):
         self.p_async.spd.remove_vpp_config()
         self.p_async.sa.remove_vpp_config()
 
+    def test_work_stealing_stream(self):
+        """Async SA with a dedicated sw_scheduler crypto worker"""
+        self.vapi.cli("set sw_scheduler mode work-stealing")
+        self.vapi.crypto_sw_scheduler_set_worker(worker_index=0, crypto_enable=0)
+        self.vapi.cli("clear sw_scheduler stats")
+
+        pkts = [
+            (
+                Ether(src=self.pg1.remote_mac, dst=self.pg1.local_mac)
+                / IP(src=self.pg1.remote_ip4, dst=self.p_async.remote_tun_if_host)
+                / UDP(sport=4444, dport=4444)
+                / Raw(b"0x0" * 200)
+            )
+        ]
+        pkts *= 2047
+
+        # worker 0 submits, worker 1 does all the crypto
+        rxs = self.send_and_expect(self.pg1, pkts, self.pg0, worker=0)
+        self.assertEqual(len(rxs), len(pkts))
+
+        for rx in rxs:
+            self.assertEqual(rx[ESP].spi, self.p_async.vpp_tun_spi)
+            self.p_async.vpp_tun_sa.decrypt(rx[IP])
+
+        self.logger.info(self.vapi.cli("show sw_scheduler workers"))
+        stats = self.vapi.cli("show sw_scheduler stats")
+        self.logger.info(stats)
+        self.assertIn("work-stealing", self.vapi.cli("show sw_scheduler workers"))
+
+        # per worker: ID Name Frames Elts Stolen Completed Idle-polls Util
+        frames = {}
+        for line in stats.splitlines()[1:]:
+            fields = line.split()
+            frames[int(fields[0])] = (int(fields[2]), int(fields[4]))
+        self.assertEqual(frames[0], (0, 0))
+        self.assertGreater(frames[1][0] + frames[1][1], 0)
+
+        self.vapi.crypto_sw_scheduler_set_worker(worker_index=0, crypto_enable=1)
+        self.vapi.cli("set sw_scheduler mode round-robin")
+        self.p_sync.spd.remove_vpp_config()
+        self.p_sync.sa.remove_vpp_config()
+        self.p_async.spd.remove_vpp_config()
+        self.p_async.sa.remove_vpp_config()
+
+
+class TestIpsecEspAsyncLargeFrames(TestIpsecEspAsync):
+    """Ipsec ESP - Async tests with 256 element crypto frames"""
+
+    extra_vpp_config = ["crypto", "{", "async-frame-size", "256", "}"]
+
+    def test_frame_size(self):
+        """Async frame size from startup config"""
+        self.assertIn(
+            "async frame size: 256", self.vapi.cli("show crypto async status")
+        )
+        self.p_sync.spd.remove_vpp_config()
+        self.p_sync.sa.remove_vpp_config()
+        self.p_async.spd.remove_vpp_config()
+        self.p_async.sa.remove_vpp_config()
+
+    def test_large_frame_stream(self):
+        """Async SA with frames larger than 64 elements"""
+        # worker 0 submits and dequeues while worker 1 processes the
+        # frames chunk by chunk, so the completed chunks are handed out
+        # before the whole frame is done
+        self.vapi.cli("set sw_scheduler mode work-stealing")
+        self.vapi.crypto_sw_scheduler_set_worker(worker_index=0, crypto_enable=0)
+        self.vapi.cli("clear sw_scheduler stats")
+
+        pkts = [
+            (
+                Ether(src=self.pg1.remote_mac, dst=self.pg1.local_mac)
+                / IP(src=self.pg1.remote_ip4, dst=self.p_async.remote_tun_if_host)
+                / UDP(sport=4444, dport=4444)
+                / Raw(b"0x0" * 200)
+            )
+        ]
+        pkts *= 2047
+
+        rxs = self.send_and_expect(self.pg1, pkts, self.pg0, worker=0)
+        self.assertEqual(len(rxs), len(pkts))
+
+        # every packet comes out once, in order, whatever chunk it was in
+        seqs = []
+        for rx in rxs:
+            self.assertEqual(rx[ESP].spi, self.p_async.vpp_tun_spi)
+            seqs.append(rx[ESP].seq)
+            self.p_async.vpp_tun_sa.decrypt(rx[IP])
+        self.assertEqual(seqs, sorted(set(seqs)))
+
+        # per worker: ID Name Frames Elts Stolen Completed Idle-polls Util
+        stats = self.vapi.cli("show sw_scheduler stats")
+        self.logger.info(stats)
+        frames, elts = 0, 0
+        for line in stats.splitlines()[1:]:
+            fields = line.split()
+            frames += int(fields[2])
+            elts += int(fields[3])
+        self.assertEqual(elts, len(pkts))
+        self.assertGreater(elts, 64 * frames)
+
+        self.vapi.crypto_sw_scheduler_set_worker(worker_index=0, crypto_enable=1)
+        self.vapi.cli("set sw_scheduler mode round-robin")
+        self.p_sync.spd.remove_vpp_config()
+        self.p_sync.sa.remove_vpp_config()
+        self.p_async.spd.remove_vpp_config()
+        self.p_async.sa.remove_vpp_config()
+
 
 class TestIpsecEspHandoff(
     TemplateIpsecEsp, IpsecTun6HandoffTests, IpsecTun4HandoffTests
@@ -834,6 +942,47 @@ class TestIpsecEspHandoff(
     pass
 
 
+class TestIpsecEspInline(TemplateIpsecEsp, IpsecTun4):
+    """Ipsec ESP - inline decryption by the device"""
+
+    def setUp(self):
+        super(TestIpsecEspInline, self).setUp()
+        self.vapi.cli("packet-generator ipsec-inline %s" % self.tun_if.name)
+
+    def tearDown(self):
+        self.vapi.cli("packet-generator ipsec-inline %s disable" % self.tun_if.name)
+        super(TestIpsecEspInline, self).tearDown()
+
+    def test_tun_inline_44(self):
+        """ipsec 4o4 tunnel inline decryption"""
+        p = self.params[socket.AF_INET]
+        inline_node_name = "/err/%s/rx_inline" % self.tun4_decrypt_node_name[0]
+        integ_node_name = "/err/%s/integ_error" % self.tun4_decrypt_node_name[0]
+
+        # SAs added before the interface became capable are installed too
+        self.verify_tun_44(p, count=NUM_PKTS)
+        self.assertEqual(self.statistics.get_err_counter(inline_node_name), NUM_PKTS)
+
+        # a corrupted ICV is left for the software path to reject
+        pkt = self.gen_encrypt_pkts(
+            p,
+            p.scapy_tun_sa,
+            self.tun_if,
+            src=p.remote_tun_if_host,
+            dst=self.pg1.remote_ip4,
+        )[0]
+        raw = bytearray(bytes(pkt))
+        raw[-1] ^= 0xFF
+        self.send_and_assert_no_replies(self.tun_if, [Ether(bytes(raw))])
+        self.assertEqual(self.statistics.get_err_counter(integ_node_name), 1)
+        self.assertEqual(self.statistics.get_err_counter(inline_node_name), NUM_PKTS)
+
+        # without the capability packets are decrypted in software
+        self.vapi.cli("packet-generator ipsec-inline %s disable" % self.tun_if.name)
+        self.verify_tun_44(p, count=NUM_PKTS)
+        self.assertEqual(self.statistics.get_err_counter(inline_node_name), 0)
+
+
 class TemplateIpsecEspUdp(ConfigIpsecESP):
     """
     UDP encapped ESP
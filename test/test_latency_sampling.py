@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+
+import unittest
+
+from framework import VppTestCase
+from asfframework import VppTestRunner
+from scapy.layers.inet import IP, UDP
+from scapy.layers.l2 import Ether
+from scapy.packet import Raw
+
+N_BINS = 24
+
+
+class TestLatencySampling(VppTestCase):
+    """Packet latency sampling"""
+
+    vpp_worker_count = 1
+
+    @classmethod
+    def setUpClass(cls):
+        super(TestLatencySampling, cls).setUpClass()
+        cls.create_pg_interfaces(range(2))
+        for i in cls.pg_interfaces:
+            i.admin_up()
+            i.config_ip4()
+            i.resolve_arp()
+
+    @classmethod
+    def tearDownClass(cls):
+        for i in cls.pg_interfaces:
+            i.unconfig_ip4()
+            i.admin_down()
+        super(TestLatencySampling, cls).tearDownClass()
+
+    def tearDown(self):
+        self.vapi.cli("set latency-sampling disable")
+        super(TestLatencySampling, self).tearDown()
+
+    def samples(self, name, index):
+        bins = self.statistics[name][:, index]
+        self.assertEqual(len(bins.bounds), N_BINS)
+        self.assertEqual(bins.bounds[0], 128)
+        return sum(bins.sum())
+
+    def stream(self, n):
+        return [
+            (
+                Ether(src=self.pg0.remote_mac, dst=self.pg0.local_mac)
+                / IP(src=self.pg0.remote_ip4, dst=self.pg1.remote_ip4)
+                / UDP(sport=1234, dport=1234)
+                / Raw(b"\xa5" * 100)
+            )
+            for i in range(n)
+        ]
+
+    def test_latency_sampling(self):
+        """Sampled packets are binned per tx interface and node"""
+        node = self.vapi.cli("show node ip4-lookup").split(",")[3].split()[1]
+
+        self.vapi.cli("set latency-sampling enable interval 10")
+        self.vapi.cli("set latency-sampling node ip4-lookup")
+        self.vapi.cli("clear latency-sampling")
+
+        self.send_and_expect(self.pg0, self.stream(200), self.pg1)
+
+        self.logger.info(self.vapi.cli("show latency-sampling verbose"))
+        self.assertEqual(self.samples("/if/tx-latency", self.pg1.sw_if_index), 20)
+        self.assertEqual(self.samples("/sys/node/latency", int(node)), 20)
+        self.assertEqual(self.samples("/if/tx-latency", self.pg0.sw_if_index), 0)
+
+        # nothing is stamped once disabled
+        self.vapi.cli("set latency-sampling disable")
+        self.send_and_expect(self.pg0, self.stream(200), self.pg1)
+        self.assertEqual(self.samples("/if/tx-latency", self.pg1.sw_if_index), 20)
+
+
+if __name__ == "__main__":
+    unittest.main(testRunner=VppTestRunner)
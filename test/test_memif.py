@@ -1,3 +1,4 @@
+import re
 import unittest
 
 from scapy.layers.l2 import Ether
@@ -249,13 +250,13 @@ class TestMemif(VppTestCase):
         self.assertEqual(icmp.id, memif.if_id)
         self.assertEqual(icmp.seq, seq)
 
-    def test_memif_ping(self):
-        """Memif ping"""
-
+    def _test_memif_ping(self, use_dma=False, ring_size=0, packet_num=10):
         memif = VppMemif(
             self,
             VppEnum.vl_api_memif_role_t.MEMIF_ROLE_API_SLAVE,
             VppEnum.vl_api_memif_mode_t.MEMIF_MODE_API_ETHERNET,
+            ring_size=ring_size,
+            use_dma=use_dma,
         )
 
         remote_socket = VppSocketFilename(
@@ -268,6 +269,8 @@ class TestMemif(VppTestCase):
             VppEnum.vl_api_memif_role_t.MEMIF_ROLE_API_MASTER,
             VppEnum.vl_api_memif_mode_t.MEMIF_MODE_API_ETHERNET,
             socket_id=1,
+            ring_size=ring_size,
+            use_dma=use_dma,
         )
 
         memif.add_vpp_config()
@@ -293,7 +296,6 @@ class TestMemif(VppTestCase):
         route.add_vpp_config()
 
         # create ICMP echo-request from local pg to remote memif
-        packet_num = 10
         pkts = self._create_icmp(self.pg0, remote_memif, packet_num)
 
         self.pg0.add_stream(pkts)
@@ -306,6 +308,63 @@ class TestMemif(VppTestCase):
             seq += 1
 
         route.remove_vpp_config()
+        return memif
+
+    def test_memif_ping(self):
+        """Memif ping"""
+        self._test_memif_ping()
+
+    def test_memif_ping_dma(self):
+        """Memif ping with DMA copies on the software backend"""
+        self._test_memif_ping(use_dma=True)
+
+        # both ends have no DMA device, so the copies went to the software
+        # backend
+        for test in (self, self.remote_test):
+            reply = test.vapi.cli("show dma backends")
+            self.assertIn("software", reply)
+            reply = test.vapi.cli("show dma config 0")
+            self.assertIn("software", reply)
+            self.assertNotIn("submitted 0 ", reply)
+
+    def _zc_posted(self):
+        """(posted, limit, min) of each zero-copy rx ring"""
+        reply = self.vapi.cli("show memif")
+        self.assertIn("ring-size 4096", reply)
+        rings = re.findall(r"zero-copy posted (\d+) limit (\d+) min (\d+)", reply)
+        self.assertNotEqual(rings, [])
+        return [tuple(int(n) for n in ring) for ring in rings]
+
+    def test_memif_ping_burst(self):
+        """Memif ping burst on a large zero-copy ring"""
+        memif = self._test_memif_ping(ring_size=4096, packet_num=1000)
+
+        # the slave side receives zero-copy and only keeps part of the ring
+        # posted, however large the burst. The minimum depends on the frame
+        # size vpp was built with, so it is read back from vpp.
+        after_burst = self._zc_posted()
+        for posted, limit, zc_min in after_burst:
+            self.assertLess(posted, 4096)
+            self.assertGreaterEqual(limit, zc_min)
+            self.assertLess(limit, 4096)
+
+        # idle polls back the limit off to two frames
+        [ifname] = [
+            i.interface_name
+            for i in self.vapi.sw_interface_dump()
+            if i.sw_if_index == memif.sw_if_index
+        ]
+        self.vapi.cli(f"set interface rx-mode {ifname} polling")
+        for i in range(20):
+            idle = self._zc_posted()
+            if all(limit == zc_min for posted, limit, zc_min in idle):
+                break
+            self.sleep(0.1)
+        # buffers already posted stay on the ring until used
+        for (posted, limit, zc_min), (_, burst_limit, _) in zip(idle, after_burst):
+            self.assertEqual(limit, zc_min)
+            self.assertLessEqual(limit, burst_limit)
+            self.assertLess(posted, 4096)
 
     def test_memif_admin_up_down_up(self):
         """Memif admin up/down/up"""
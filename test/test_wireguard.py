@@ -2857,6 +2857,95 @@ class WireguardHandoffTests(TestWg):
         peer_1.remove_vpp_config()
         wg0.remove_vpp_config()
 
+    def test_wg_parallel(self):
+        """Parallel mode"""
+
+        port = 12393
+
+        self.vapi.wg_set_parallel_mode(parallel_enable=True)
+        self.assertIn("parallel: enabled", self.vapi.cli("show wireguard mode"))
+
+        # Create interfaces
+        wg0 = VppWgInterface(self, self.pg1.local_ip4, port).add_vpp_config()
+        wg0.admin_up()
+        wg0.config_ip4()
+
+        self.pg_enable_capture(self.pg_interfaces)
+        self.pg_start()
+
+        peer_1 = VppWgPeer(
+            self, wg0, self.pg1.remote_ip4, port + 1, ["10.11.3.0/24"]
+        ).add_vpp_config()
+
+        r1 = VppIpRoute(
+            self, "10.11.3.0", 24, [VppRoutePath("10.11.3.1", wg0.sw_if_index)]
+        ).add_vpp_config()
+
+        # skip the first automatic handshake
+        self.pg1.get_capture(1, timeout=HANDSHAKE_JITTER)
+
+        # a handshake with a bad mac1 is dropped on the worker
+        p = peer_1.mk_handshake(self.pg1)
+        p[WireguardInitiation].mac1 = b"\x00" * 16
+        mac4_err = self.statistics.get_err_counter(self.mac4_error)
+        self.pg_send(self.pg1, [p], worker=1)
+        self.pg1.assert_nothing_captured()
+        self.assertEqual(
+            mac4_err + 1, self.statistics.get_err_counter(self.mac4_error)
+        )
+
+        # a valid handshake is handed off to the main thread
+        p = peer_1.mk_handshake(self.pg1)
+        rx = self.send_and_expect(self.pg1, [p], self.pg1, worker=1)
+        peer_1.consume_response(rx[0])
+
+        # decrypt data packets on both workers without handoff
+        pkts = [
+            peer_1.mk_tunnel_header(self.pg1)
+            / (
+                Wireguard(message_type=4, reserved_zero=0)
+                / WireguardTransport(
+                    receiver_index=peer_1.sender,
+                    counter=ii,
+                    encrypted_encapsulated_packet=peer_1.encrypt_transport(
+                        IP(src="10.11.3.1", dst=self.pg0.remote_ip4, ttl=20)
+                        / UDP(sport=222, dport=223)
+                        / Raw()
+                    ),
+                )
+            )
+            for ii in range(256)
+        ]
+        for worker, first in ((0, 0), (1, 128)):
+            rxs = self.send_and_expect(
+                self.pg1, pkts[first : first + 128], self.pg0, worker=worker
+            )
+            for rx in rxs:
+                self.assertEqual(rx[IP].dst, self.pg0.remote_ip4)
+                self.assertEqual(rx[IP].ttl, 19)
+
+        # replays are caught whichever worker they arrive on
+        for worker, ii in ((1, 5), (0, 200)):
+            self.pg_send(self.pg1, [pkts[ii]], worker=worker)
+            self.pg0.assert_nothing_captured()
+
+        # encrypt on both workers, whole ranges of send counters are
+        # reserved per worker so the nonces stay in order here
+        pe = (
+            Ether(dst=self.pg0.local_mac, src=self.pg0.remote_mac)
+            / IP(src=self.pg0.remote_ip4, dst="10.11.3.2")
+            / UDP(sport=555, dport=556)
+            / Raw(b"\x00" * 80)
+        )
+        for worker in (1, 0):
+            rxs = self.send_and_expect(self.pg0, pe * 256, self.pg1, worker=worker)
+            peer_1.validate_encapped(rxs, pe)
+
+        r1.remove_vpp_config()
+        peer_1.remove_vpp_config()
+        wg0.remove_vpp_config()
+        self.vapi.wg_set_parallel_mode(parallel_enable=False)
+
     @unittest.skip("test disabled")
     def test_wg_multi_interface(self):
         """Multi-tunnel on the same port"""
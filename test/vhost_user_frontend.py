@@ -0,0 +1,166 @@
+"""
+Minimal vhost-user frontend, standing in for a VM in tests.
+
+Guest memory is a memfd shared with VPP, there is a single queue pair with
+split rings and kicks / calls go through eventfds. Rx buffers are posted
+once at setup and reposted after each receive.
+"""
+
+import ctypes
+import mmap
+import os
+import select
+import socket
+import struct
+import time
+
+
+class VhostUserFrontend:
+    GET_FEATURES = 1
+    SET_FEATURES = 2
+    SET_OWNER = 3
+    SET_MEM_TABLE = 5
+    SET_VRING_NUM = 8
+    SET_VRING_ADDR = 9
+    SET_VRING_BASE = 10
+    SET_VRING_KICK = 12
+    SET_VRING_CALL = 13
+
+    F_VERSION_1 = 1 << 32
+    DESC_F_WRITE = 2
+
+    RING_SZ = 256
+    BUF_SZ = 2048
+    HDR_SZ = 12
+    VRING_MEM_SZ = 1 << 20
+    MEM_SZ = 2 * VRING_MEM_SZ
+
+    # offsets within the memory of a vring
+    DESC_OFF = 0
+    AVAIL_OFF = 0x1000
+    USED_OFF = 0x2000
+    BUF_OFF = 0x4000
+
+    RX = 0  # VPP to guest
+    TX = 1  # guest to VPP
+
+    def __init__(self, sock_filename):
+        self.memfd = os.memfd_create("vhost-user-guest")
+        os.ftruncate(self.memfd, self.MEM_SZ)
+        self.mem = mmap.mmap(self.memfd, self.MEM_SZ)
+        self.base = ctypes.addressof(ctypes.c_char.from_buffer(self.mem))
+        self.kick = [os.eventfd(0, os.EFD_NONBLOCK) for q in range(2)]
+        self.call = [os.eventfd(0, os.EFD_NONBLOCK) for q in range(2)]
+        self.avail_idx = [0, 0]
+        self.used_idx = [0, 0]
+        self.sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        self.sock.connect(sock_filename)
+
+    def _send(self, request, payload=b"", fds=None):
+        msg = struct.pack("=III", request, 1, len(payload)) + payload
+        if fds:
+            socket.send_fds(self.sock, [msg], fds)
+        else:
+            self.sock.sendall(msg)
+
+    def _recv_u64(self, request):
+        hdr = self.sock.recv(12)
+        req, flags, size = struct.unpack("=III", hdr)
+        assert req == request and size == 8
+        return struct.unpack("=Q", self.sock.recv(size))[0]
+
+    def _gpa(self, q, off):
+        # guest physical addresses are offsets in the memfd
+        return q * self.VRING_MEM_SZ + off
+
+    def _put(self, q, off, fmt, *args):
+        struct.pack_into(fmt, self.mem, self._gpa(q, off), *args)
+
+    def _get(self, q, off, fmt):
+        return struct.unpack_from(fmt, self.mem, self._gpa(q, off))
+
+    def _add_desc(self, q, data=None):
+        """Post buffer number avail_idx on vring q and publish it"""
+        slot = self.avail_idx[q] % self.RING_SZ
+        addr = self._gpa(q, self.BUF_OFF + slot * self.BUF_SZ)
+        if data is None:
+            self._put(
+                q,
+                self.DESC_OFF + slot * 16,
+                "=QIHH",
+                addr,
+                self.BUF_SZ,
+                self.DESC_F_WRITE,
+                0,
+            )
+        else:
+            self.mem[addr : addr + len(data)] = data
+            self._put(q, self.DESC_OFF + slot * 16, "=QIHH", addr, len(data), 0, 0)
+        self._put(q, self.AVAIL_OFF + 4 + slot * 2, "=H", slot)
+        self.avail_idx[q] += 1
+        self._put(q, self.AVAIL_OFF + 2, "=H", self.avail_idx[q] & 0xFFFF)
+
+    def connect(self):
+        self._send(self.GET_FEATURES)
+        features = self._recv_u64(self.GET_FEATURES) & self.F_VERSION_1
+        self._send(self.SET_OWNER)
+        self._send(self.SET_FEATURES, struct.pack("=Q", features))
+        self._send(
+            self.SET_MEM_TABLE,
+            struct.pack("=IIQQQQ", 1, 0, 0, self.MEM_SZ, self.base, 0),
+            [self.memfd],
+        )
+        for q in (self.RX, self.TX):
+            self._send(self.SET_VRING_CALL, struct.pack("=Q", q), [self.call[q]])
+            self._send(self.SET_VRING_NUM, struct.pack("=II", q, self.RING_SZ))
+            self._send(self.SET_VRING_BASE, struct.pack("=II", q, 0))
+            self._send(
+                self.SET_VRING_ADDR,
+                struct.pack(
+                    "=IIQQQQ",
+                    q,
+                    0,
+                    self.base + self._gpa(q, self.DESC_OFF),
+                    self.base + self._gpa(q, self.USED_OFF),
+                    self.base + self._gpa(q, self.AVAIL_OFF),
+                    0,
+                ),
+            )
+            self._send(self.SET_VRING_KICK, struct.pack("=Q", q), [self.kick[q]])
+
+        for i in range(self.RING_SZ):
+            self._add_desc(self.RX)
+
+        # the first kick starts the queues
+        for q in (self.RX, self.TX):
+            os.eventfd_write(self.kick[q], 1)
+
+    def send(self, pkts):
+        """Queue ethernet frames on the tx vring and kick VPP"""
+        for p in pkts:
+            self._add_desc(self.TX, bytes(self.HDR_SZ) + bytes(p))
+        os.eventfd_write(self.kick[self.TX], 1)
+
+    def recv(self, n, timeout=2):
+        """Wait for n ethernet frames on the rx vring"""
+        pkts = []
+        deadline = time.time() + timeout
+        while len(pkts) < n and time.time() < deadline:
+            used = self._get(self.RX, self.USED_OFF + 2, "=H")[0]
+            if used == self.used_idx[self.RX] & 0xFFFF:
+                # calls are coalesced, so do not rely on them alone
+                if select.select([self.call[self.RX]], [], [], 0.01)[0]:
+                    os.eventfd_read(self.call[self.RX])
+                continue
+            slot = self.used_idx[self.RX] % self.RING_SZ
+            desc, length = self._get(self.RX, self.USED_OFF + 4 + slot * 8, "=II")
+            addr = self._gpa(self.RX, self.BUF_OFF + desc * self.BUF_SZ)
+            pkts.append(bytes(self.mem[addr + self.HDR_SZ : addr + length]))
+            self.used_idx[self.RX] += 1
+            self._add_desc(self.RX)
+        return pkts
+
+    def close(self):
+        self.sock.close()
+        for fd in self.kick + self.call + [self.memfd]:
+            os.close(fd)
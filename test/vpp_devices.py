@@ -7,10 +7,11 @@ class VppTAPInterface(VppInterface):
         """TAP id"""
         return self._tap_id
 
-    def __init__(self, test, tap_id=0xFFFFFFFF, mac_addr=None):
+    def __init__(self, test, tap_id=0xFFFFFFFF, mac_addr=None, tap_flags=0):
         self._test = test
         self._tap_id = tap_id
         self._mac_addr = mac_addr
+        self._tap_flags = tap_flags
 
     def get_vpp_dump(self):
         dump = self._test.vapi.sw_interface_tap_v2_dump(sw_if_index=self.sw_if_index)
@@ -21,6 +22,7 @@ class VppTAPInterface(VppInterface):
             id=self._tap_id,
             use_random_mac=bool(self._mac_addr),
             mac_address=self._mac_addr,
+            tap_flags=self._tap_flags,
         )
         self.set_sw_if_index(reply.sw_if_index)
         self._test.registry.register(self, self.test.logger)
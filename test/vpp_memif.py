@@ -69,6 +69,7 @@ class VppMemif(VppObject):
         ring_size=0,
         buffer_size=0,
         hw_addr="",
+        use_dma=False,
     ):
         self._test = test
         self.role = role
@@ -81,13 +82,14 @@ class VppMemif(VppObject):
         self.ring_size = ring_size
         self.buffer_size = buffer_size
         self.hw_addr = hw_addr
+        self.use_dma = use_dma
         self.sw_if_index = None
         self.ip_prefix = IPv4Network(
             "192.168.%d.%d/24" % (self.if_id + 1, self.role + 1), strict=False
         )
 
     def add_vpp_config(self):
-        rv = self._test.vapi.memif_create(
+        args = dict(
             role=self.role,
             mode=self.mode,
             rx_queues=self.rx_queues,
@@ -99,6 +101,10 @@ class VppMemif(VppObject):
             buffer_size=self.buffer_size,
             hw_addr=self.hw_addr,
         )
+        if self.use_dma:
+            rv = self._test.vapi.memif_create_v2(use_dma=True, **args)
+        else:
+            rv = self._test.vapi.memif_create(**args)
         try:
             self.sw_if_index = rv.sw_if_index
         except AttributeError: